@@ -0,0 +1,63 @@
+/// @file binary.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+#include "adm/export.h"
+
+namespace adm {
+
+  class Document;
+
+  /// @brief Version of the binary format written by `saveBinary()`
+  const std::uint32_t BINARY_FORMAT_VERSION = 1;
+
+  /**
+   * @brief Append a binary snapshot of @a document to @a buffer
+   *
+   * The binary format is a compact alternative to XML for caching documents,
+   * for example between the stages of a processing pipeline. It contains all
+   * elements of the document, including the common definitions if they have
+   * been added to it, with every parameter which has been set. References
+   * are stored as indices into the tables of elements, so loading the
+   * snapshot needs neither text parsing nor ID lookups.
+   *
+   * The format is versioned (see `BINARY_FORMAT_VERSION`) and independent
+   * of the platform, but not meant for long term storage or exchange; use
+   * XML for that.
+   * @ingroup xml
+   */
+  ADM_EXPORT void saveBinary(std::vector<char>& buffer,
+                             std::shared_ptr<const Document> document);
+  /// @brief Write a binary snapshot of @a document to @a stream
+  ADM_EXPORT void saveBinary(std::ostream& stream,
+                             std::shared_ptr<const Document> document);
+  /// @brief Write a binary snapshot of @a document to the file @a filename
+  ADM_EXPORT void saveBinary(const std::string& filename,
+                             std::shared_ptr<const Document> document);
+
+  /**
+   * @brief Load a document from a binary snapshot written by `saveBinary()`
+   *
+   * The snapshot is read directly from the @a size bytes at @a data, which
+   * may for example be a memory mapped file; the data is not modified and
+   * not referenced by the loaded document.
+   *
+   * Writing the loaded document as XML gives exactly the same result as
+   * writing the document which was saved.
+   *
+   * @throws std::runtime_error if the data is not a binary snapshot, is
+   * truncated or was written by an incompatible version.
+   * @ingroup xml
+   */
+  ADM_EXPORT std::shared_ptr<Document> loadBinary(const char* data,
+                                                  std::size_t size);
+  /// @brief Load a document from a binary snapshot read from @a stream
+  ADM_EXPORT std::shared_ptr<Document> loadBinary(std::istream& stream);
+  /// @brief Load a document from the binary snapshot file @a filename
+  ADM_EXPORT std::shared_ptr<Document> loadBinary(const std::string& filename);
+
+}  // namespace adm
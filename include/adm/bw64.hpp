@@ -0,0 +1,199 @@
+/// @file bw64.hpp
+#pragma once
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "adm/elements/audio_channel_format_id.hpp"
+#include "adm/elements/audio_pack_format_id.hpp"
+#include "adm/elements/audio_track_format_id.hpp"
+#include "adm/elements/audio_track_uid_id.hpp"
+#include "adm/export.h"
+#include "adm/parse.hpp"
+
+namespace adm {
+
+  class Document;
+
+  /**
+   * @brief Entry (`audioID`) of the `chna` chunk of a BW64 file
+   *
+   * Assigns the audioTrackUID @a audioTrackUidId to the track
+   * @a trackIndex of the file, counted from 1. The track is described
+   * either by an audioTrackFormat or, as allowed since ADM version 2, by
+   * an audioChannelFormat.
+   * @ingroup xml
+   */
+  struct ChnaEntry {
+    std::uint16_t trackIndex;
+    AudioTrackUidId audioTrackUidId;
+    boost::optional<AudioTrackFormatId> audioTrackFormatId;
+    boost::optional<AudioChannelFormatId> audioChannelFormatId;
+    boost::optional<AudioPackFormatId> audioPackFormatId;
+  };
+
+  /**
+   * @brief Parse the contents of a `chna` chunk
+   *
+   * Unused entries, which have a track index of 0, are skipped.
+   * @param data the chunk data, without the chunk header
+   * @param size size of the chunk data
+   * @throws std::runtime_error if the chunk is truncated or contains an
+   * invalid ID
+   * @ingroup xml
+   */
+  ADM_EXPORT std::vector<ChnaEntry> parseChna(const char* data,
+                                              std::size_t size);
+
+  /**
+   * @brief Layout of an entry (`audioID`) of the `chna` chunk
+   *
+   * The IDs are stored without NUL terminator and padded with NULs. In the
+   * chunk, `trackIndex` is stored little endian; in this struct it is in
+   * the byte order of the platform.
+   * @ingroup xml
+   */
+  struct ChnaAudioId {
+    std::uint16_t trackIndex;
+    char audioTrackUid[12];
+    /// audioTrackFormatID or audioChannelFormatID
+    char trackReference[14];
+    char packReference[11];
+    char pad;
+  };
+  static_assert(sizeof(ChnaAudioId) == 40,
+                "ChnaAudioId must have the size of an audioID");
+
+  /**
+   * @brief Create the `chna` entries of the audioTrackUIDs of @a document
+   *
+   * The tracks are numbered from 1 in the order of the audioTrackUIDs in
+   * the document, which is the order in which they are written to XML.
+   * The audioTrackFormat and audioPackFormat referenced by each
+   * audioTrackUID are used for the track and pack references; references
+   * which are not set are left empty.
+   *
+   * The document is traversed once, without any ID lookups.
+   * @throws std::runtime_error if there are more than 65535 audioTrackUIDs
+   * @ingroup xml
+   */
+  ADM_EXPORT std::vector<ChnaEntry> createChnaEntries(
+      std::shared_ptr<const Document> document);
+
+  /**
+   * @brief Convert @a entry to the layout of the `chna` chunk
+   *
+   * An audioChannelFormat is used as track reference if the entry has no
+   * audioTrackFormat, matching how `parseChna()` distinguishes the two.
+   * @ingroup xml
+   */
+  ADM_EXPORT ChnaAudioId makeChnaAudioId(const ChnaEntry& entry);
+
+  /**
+   * @brief Create the packed `chna` entries of the audioTrackUIDs of
+   * @a document, see `createChnaEntries()`
+   * @ingroup xml
+   */
+  ADM_EXPORT std::vector<ChnaAudioId> createChnaAudioIds(
+      std::shared_ptr<const Document> document);
+
+  /**
+   * @brief Format the data of a `chna` chunk, without the chunk header
+   *
+   * The number of tracks is the number of distinct non-zero track indices.
+   * The result can be read back with `parseChna()`.
+   * @ingroup xml
+   */
+  ADM_EXPORT std::vector<char> formatChna(
+      const std::vector<ChnaAudioId>& audioIds);
+  /// @brief Format the data of the `chna` chunk for @a document
+  ADM_EXPORT std::vector<char> formatChna(
+      std::shared_ptr<const Document> document);
+
+  /**
+   * @brief Chunk of a RIFF/WAVE, RF64 or BW64 file
+   * @ingroup xml
+   */
+  struct Bw64Chunk {
+    /// four character chunk ID, e.g. "axml"
+    std::string id;
+    /// offset of the chunk data in the file, after the chunk header
+    std::uint64_t offset;
+    /// size of the chunk data, taken from the `ds64` chunk if necessary
+    std::uint64_t size;
+  };
+
+  /**
+   * @brief Reader of the ADM metadata of BW64, RF64 and RIFF/WAVE files
+   *
+   * The constructor only reads the chunk headers, seeking from one chunk
+   * to the next, so opening a file does not depend on the amount of audio
+   * data in it. 64 bit chunk sizes are taken from the `ds64` chunk of RF64
+   * and BW64 files. A chunk which extends past the end of the file, e.g.
+   * the `data` chunk of an unfinished recording, ends the chunk table; it
+   * is listed, but reading it throws.
+   *
+   * `parseAxml()` memory maps the `axml` chunk where supported and parses
+   * the XML in place; as the mapping is private, the file is not modified.
+   * No audio data is read or decoded.
+   *
+   * @code
+   * adm::Bw64MetadataReader reader("input.wav");
+   * auto document = reader.parseAxml();
+   * for (auto& entry : reader.readChna()) {
+   *   // entry.trackIndex, entry.audioTrackUidId, ...
+   * }
+   * @endcode
+   * @ingroup xml
+   */
+  class Bw64MetadataReader {
+   public:
+    /**
+     * @brief Read the chunk table of @a filename
+     * @throws std::runtime_error if the file cannot be read or is not a
+     * RIFF/WAVE, RF64 or BW64 file
+     */
+    ADM_EXPORT explicit Bw64MetadataReader(const std::string& filename);
+
+    /// @brief All chunks of the file, in the order of the file
+    ADM_EXPORT const std::vector<Bw64Chunk>& getChunks() const;
+    /// @brief Check if the file has a chunk with the ID @a id
+    ADM_EXPORT bool hasChunk(const std::string& id) const;
+    /**
+     * @brief Read the data of the first chunk with the ID @a id
+     * @throws std::runtime_error if there is no such chunk, or if it
+     * extends past the end of the file
+     */
+    ADM_EXPORT std::vector<char> readChunk(const std::string& id) const;
+
+    /**
+     * @brief Parse the XML of the `axml` chunk
+     *
+     * The document contains the common definitions, like the one returned
+     * by `parseXml()`.
+     * @param options Options to influence the XML parser behaviour
+     * @throws std::runtime_error if there is no `axml` chunk, or if it
+     * extends past the end of the file
+     */
+    ADM_EXPORT std::shared_ptr<Document> parseAxml(
+        xml::ParserOptions options = xml::ParserOptions::none) const;
+    /**
+     * @brief Parse the `chna` chunk, see `parseChna()`
+     * @throws std::runtime_error if there is no `chna` chunk, or if it
+     * extends past the end of the file
+     */
+    ADM_EXPORT std::vector<ChnaEntry> readChna() const;
+
+   private:
+    const Bw64Chunk& findChunk(const std::string& id) const;
+    /// Throw if @a chunk extends past the end of the file
+    void checkChunkSize(const Bw64Chunk& chunk) const;
+
+    std::string filename_;
+    std::uint64_t fileSize_ = 0;
+    std::vector<Bw64Chunk> chunks_;
+  };
+
+}  // namespace adm
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace adm {
+  namespace detail {
+
+    class ContentHasher;
+
+    /// content hashes of the elements visited by one `getContentHash()` call
+    struct ContentHashMemo {
+      std::unordered_map<const void*, std::uint64_t> hashes;
+      /// false if any of the hashes depends on audioBlockFormats which can
+      /// be modified without changing the revision, so it must not be cached
+      bool cacheable = true;
+    };
+
+    /**
+     * @brief Hash of the parameters of an element, with the revision of
+     * the element it was computed for
+     *
+     * Used by the `getContentHash()` methods. The cache may be read and
+     * written by several threads calling const methods at once; all of
+     * them compute the same hash for the same revision, so it is enough
+     * to publish the revision after the value.
+     */
+    class ContentHashCache {
+     public:
+      ContentHashCache() = default;
+      ContentHashCache(const ContentHashCache& other)
+          : revision_(other.revision_.load(std::memory_order_acquire)),
+            value_(other.value_.load(std::memory_order_relaxed)) {}
+      ContentHashCache& operator=(const ContentHashCache& other) {
+        value_.store(other.value_.load(std::memory_order_relaxed),
+                     std::memory_order_relaxed);
+        revision_.store(other.revision_.load(std::memory_order_acquire),
+                        std::memory_order_release);
+        return *this;
+      }
+
+      /// the hash stored for @a revision in @a value, false if there is none
+      bool get(std::size_t revision, std::uint64_t& value) const {
+        if (revision_.load(std::memory_order_acquire) != revision + 1) {
+          return false;
+        }
+        value = value_.load(std::memory_order_relaxed);
+        return true;
+      }
+
+      void set(std::size_t revision, std::uint64_t value) {
+        value_.store(value, std::memory_order_relaxed);
+        revision_.store(revision + 1, std::memory_order_release);
+      }
+
+     private:
+      /// revision + 1, or 0 before the first hash is stored
+      std::atomic<std::size_t> revision_{0};
+      std::atomic<std::uint64_t> value_{0};
+    };
+
+  }  // namespace detail
+}  // namespace adm
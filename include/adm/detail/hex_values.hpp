@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include "adm/detail/number_formatting.hpp"
 #include "adm/export.h"
 
 namespace adm {
@@ -10,5 +11,15 @@ namespace adm {
                                           unsigned int nmbOfChars = 4);
     ADM_EXPORT std::string formatHexValue(unsigned int value,
                                           unsigned int nmbOfChars = 4);
+    /**
+     * @brief Format a value as zero padded hex string into a buffer
+     *
+     * The output is NUL terminated.
+     *
+     * @param buffer buffer of at least `FORMAT_BUFFER_SIZE` chars
+     * @returns number of characters written, without the NUL terminator
+     */
+    ADM_EXPORT std::size_t formatHexValue(char* buffer, unsigned int value,
+                                          unsigned int nmbOfChars = 4);
   }  // namespace detail
 }  // namespace adm
@@ -10,6 +10,8 @@ namespace adm {
 
   namespace detail {
 
+    class DocumentIndex;
+
     class IdAssigner {
      public:
       ADM_EXPORT AudioProgrammeId assignId(AudioProgramme& programme);
@@ -28,7 +30,12 @@ namespace adm {
      private:
       friend class adm::Document;
       ADM_EXPORT void document(Document* document_);
+      /// look up used IDs in @a index instead of the document, if not null
+      ADM_EXPORT void index(const DocumentIndex* index);
+      template <typename Id>
+      bool isUsed(const Id& id) const;
       Document* document_;
+      const DocumentIndex* index_ = nullptr;
     };
 
   }  // namespace detail
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+namespace adm {
+  namespace detail {
+
+    /**
+     * @brief Guards data of an element which is parsed on first access
+     *
+     * `pending()` can be checked without locking. If it is true, the mutex
+     * must be held while parsing, and `setPending(false)` called once done,
+     * so that concurrent const accesses parse only once. The mutex is
+     * recursive, so that parsing can use accessors which parse first.
+     *
+     * Copies share the pending state, but not the mutex.
+     */
+    class LazyGuard {
+     public:
+      LazyGuard() = default;
+      LazyGuard(const LazyGuard &other) : pending_(other.pending()) {}
+      LazyGuard &operator=(const LazyGuard &other) {
+        setPending(other.pending());
+        return *this;
+      }
+
+      bool pending() const { return pending_.load(std::memory_order_acquire); }
+      void setPending(bool pending) {
+        pending_.store(pending, std::memory_order_release);
+      }
+
+      std::recursive_mutex &mutex() const { return mutex_; }
+
+     private:
+      std::atomic<bool> pending_{false};
+      mutable std::recursive_mutex mutex_;
+    };
+
+  }  // namespace detail
+}  // namespace adm
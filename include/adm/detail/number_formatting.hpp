@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include "adm/export.h"
+
+namespace adm {
+  namespace detail {
+
+    /**
+     * @brief Minimum size of the buffers passed to the buffer based format
+     * functions
+     *
+     * This is large enough for any number, timecode or ID, including the
+     * terminating NUL character.
+     */
+    const std::size_t FORMAT_BUFFER_SIZE = 64;
+
+    /**
+     * @brief Format a float with the shortest representation which parses
+     * back to the same value
+     *
+     * Values with a magnitude between 1e-20 and 1e21 are written in fixed
+     * notation, others in scientific notation. The output is NUL terminated.
+     *
+     * @param buffer buffer of at least `FORMAT_BUFFER_SIZE` chars
+     * @returns number of characters written, without the NUL terminator
+     */
+    ADM_EXPORT std::size_t formatFloat(char* buffer, float value);
+    /// @brief Same as `formatFloat()`, but for doubles
+    ADM_EXPORT std::size_t formatDouble(char* buffer, double value);
+    /**
+     * @brief Format a signed integer in decimal notation
+     *
+     * @param buffer buffer of at least `FORMAT_BUFFER_SIZE` chars
+     * @returns number of characters written, without the NUL terminator
+     */
+    ADM_EXPORT std::size_t formatInteger(char* buffer, long long value);
+    /// @brief Same as `formatInteger()`, but for unsigned integers
+    ADM_EXPORT std::size_t formatUnsigned(char* buffer,
+                                          unsigned long long value);
+
+  }  // namespace detail
+}  // namespace adm
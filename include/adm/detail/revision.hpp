@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace adm {
+  namespace detail {
+
+    /**
+     * @brief Revision counter of an element
+     *
+     * Incrementing it also increments the generation of the Document the
+     * element belongs to, see `Document::getGeneration()`.
+     */
+    class Revision {
+     public:
+      Revision &operator++() {
+        ++value_;
+        if (generation_) {
+          ++*generation_;
+        }
+        return *this;
+      }
+
+      std::size_t get() const { return value_; }
+
+      /// set the generation of the parent Document, nullptr if there is none
+      void setGeneration(std::shared_ptr<std::size_t> generation) {
+        generation_ = std::move(generation);
+      }
+
+     private:
+      std::size_t value_ = 0;
+      std::shared_ptr<std::size_t> generation_;
+    };
+
+  }  // namespace detail
+}  // namespace adm
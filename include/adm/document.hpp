@@ -4,6 +4,8 @@
 #include <memory>
 #include <vector>
 #include "adm/elements.hpp"
+#include "adm/element_variant.hpp"
+#include "adm/detail/content_hash_cache.hpp"
 #include "adm/detail/id_assigner.hpp"
 #include "adm/export.h"
 
@@ -30,6 +32,40 @@ namespace adm {
      */
     ADM_EXPORT std::shared_ptr<Document> deepCopy() const;
 
+    /**
+     * @brief Get a hash of the content of all elements
+     *
+     * Every element and audioBlockFormat has a `getContentHash()` method,
+     * which hashes all its parameters, including its ID, and the content
+     * hashes of the elements it references, in order. Equal hashes therefore
+     * mean equal sub-graphs, also between documents, and the hash of an
+     * element changes whenever anything below it changes. The hashes are
+     * 64 bit FNV-1a hashes of the binary encoding used by `saveBinary()`,
+     * so they can be stored and compared across runs and platforms.
+     *
+     * The hash of the parameters of each element is cached until its
+     * revision changes (see `AudioObject::getRevision()`), and each element
+     * is only hashed once per call, so computing the hash again only
+     * combines the cached hashes of the sub-graph. The hash of the Document
+     * is cached until its generation changes (see getGeneration()), unless
+     * it includes audioBlockFormats handed out by the non-const
+     * `AudioChannelFormat::getElements()`, which could be modified without
+     * changing the generation. The references must not form cycles. The
+     * hashes may be computed from several threads at once, as long as
+     * nothing is modified meanwhile.
+     */
+    ADM_EXPORT std::uint64_t getContentHash() const;
+
+    /**
+     * @brief Get the generation of the Document
+     *
+     * The generation is incremented every time an element is added to or
+     * removed from the Document, and every time one of its elements is
+     * modified (see `AudioObject::getRevision()`). It can be used to check
+     * if information derived from the Document is still up to date.
+     */
+    ADM_EXPORT std::size_t getGeneration() const;
+
     /** @name Add ADM elements
      *
      * If the ADM element was already added to the Document, it will not be
@@ -52,6 +88,15 @@ namespace adm {
     ADM_EXPORT bool add(std::shared_ptr<AudioTrackFormat> trackFormat);
     /// @brief Add an AudioTrackUid
     ADM_EXPORT bool add(std::shared_ptr<AudioTrackUid> trackUid);
+    /**
+     * @brief Add several ADM elements at once
+     *
+     * Equivalent to adding each of @a elements in order, but whether an
+     * element or an ID is already part of the document is looked up in hash
+     * tables, so that adding many elements takes linear instead of quadratic
+     * time.
+     */
+    ADM_EXPORT void add(const std::vector<ElementVariant> &elements);
     ///@}
 
     /** @name Remove ADM elements
@@ -76,6 +121,16 @@ namespace adm {
     ADM_EXPORT bool remove(std::shared_ptr<AudioTrackFormat> trackFormat);
     /// @brief Remove an AudioTrackUid
     ADM_EXPORT bool remove(std::shared_ptr<AudioTrackUid> trackUid);
+    /**
+     * @brief Remove several ADM elements at once
+     *
+     * Equivalent to removing each of @a elements separately, but the
+     * elements and references of the document are only visited once, so
+     * that removing many elements takes linear instead of quadratic time.
+     *
+     * @returns the number of elements which were removed
+     */
+    ADM_EXPORT std::size_t remove(const std::vector<ElementVariant> &elements);
     ///@}
 
     /**
@@ -203,6 +258,8 @@ namespace adm {
     ///@}
 
    private:
+    friend class DocumentAttorney;
+
     ADM_EXPORT Document();
     ADM_EXPORT Document(const Document &) = default;
     ADM_EXPORT Document(Document &&) = default;
@@ -249,6 +306,11 @@ namespace adm {
     std::vector<std::shared_ptr<AudioTrackFormat>> audioTrackFormats_;
     std::vector<std::shared_ptr<AudioTrackUid>> audioTrackUids_;
     detail::IdAssigner idAssigner_;
+    /// incremented by the elements of the Document, see getGeneration()
+    std::shared_ptr<std::size_t> generation_ = std::make_shared<std::size_t>(0);
+    mutable detail::ContentHashCache contentHash_;
+    /// the index used by add() while adding several elements at once
+    detail::DocumentIndex *index_ = nullptr;
   };
 
   // ---- Implementation ---- //
@@ -2,6 +2,8 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include "adm/elements/type_descriptor.hpp"
 #include "adm/detail/named_option_helper.hpp"
@@ -83,6 +85,17 @@ namespace adm {
     template <typename Parameter>
     void unset();
 
+    /**
+     * @brief Get the AudioBlockFormatId packed into a single integral value
+     *
+     * The key contains the type in bits 48 to 63, the value in bits 32 to 47
+     * and the counter in the lower bits. Keys of valid IDs are ordered like the
+     * string representations of the IDs; values which do not fit into the
+     * string representation overlap other parts of the key, so such IDs may
+     * share keys. The comparison operators compare the parameters instead.
+     */
+    ADM_EXPORT std::uint64_t key() const;
+
     ///@{
     /**
      * @brief Operator overload
@@ -146,6 +159,17 @@ namespace adm {
   ADM_EXPORT AudioBlockFormatId parseAudioBlockFormatId(const std::string& id);
   /// @brief Format an AudioBlockFormatId object as string
   ADM_EXPORT std::string formatId(AudioBlockFormatId id);
+  /**
+   * @brief Format an AudioBlockFormatId object into a buffer
+   *
+   * The output is NUL terminated.
+   *
+   * @param buffer buffer of at least `detail::FORMAT_BUFFER_SIZE` chars
+   * @returns number of characters written, without the NUL terminator
+   */
+  ADM_EXPORT std::size_t formatId(char* buffer, const AudioBlockFormatId& id);
+  /// @brief Hash an AudioBlockFormatId without formatting it as string
+  ADM_EXPORT std::size_t hash_value(const AudioBlockFormatId& id);
 
   // ---- Implementation ---- //
   template <typename... Parameters>
@@ -179,3 +203,12 @@ namespace adm {
   }
 
 }  // namespace adm
+
+namespace std {
+  template <>
+  struct hash<adm::AudioBlockFormatId> {
+    std::size_t operator()(const adm::AudioBlockFormatId& id) const {
+      return std::hash<std::uint64_t>()(id.key());
+    }
+  };
+}  // namespace std
@@ -1,6 +1,7 @@
 /// @file audio_block_format_matrix.hpp
 #pragma once
 
+#include <cstdint>
 #include <boost/optional.hpp>
 #include "adm/elements/time.hpp"
 #include "adm/elements/audio_block_format_id.hpp"
@@ -87,6 +88,13 @@ namespace adm {
     template <typename Parameter>
     void unset();
 
+    /**
+     * @brief Get a hash of all parameters of the audioBlockFormat
+     *
+     * See `AudioChannelFormat::getContentHash()`.
+     */
+    ADM_EXPORT std::uint64_t getContentHash() const;
+
    private:
     ADM_EXPORT AudioBlockFormatId
         get(detail::ParameterTraits<AudioBlockFormatId>::tag) const;
@@ -17,12 +17,19 @@
 #include "adm/detail/named_option_helper.hpp"
 #include "adm/detail/named_type.hpp"
 #include "adm/detail/type_traits.hpp"
+#include "adm/detail/content_hash_cache.hpp"
+#include "adm/detail/lazy_guard.hpp"
+#include "adm/detail/revision.hpp"
 #include "adm/export.h"
 #include <type_traits>
 
 namespace adm {
 
   class Document;
+  namespace detail {
+    class LazyBlockFormats;
+    struct BlockFormatStorage;
+  }  // namespace detail
 
   /**
    * Helper to deduce the correct `IteratorRange` type for
@@ -82,6 +89,12 @@ namespace adm {
      * The actual copy constructor is private to ensure that an
      * AudioChannelFormat can only be created as a `std::shared_ptr`. Added
      * AudioBlockFormats will be copied too.
+     *
+     * The audioBlockFormats are copied on write: the copy shares them with
+     * the original until either of them modifies its audioBlockFormats, so
+     * copying does not depend on their number. Only if a range returned by
+     * the non-const `getElements()` could still be used to modify the
+     * audioBlockFormats of the original, they are copied immediately.
      */
     ADM_EXPORT std::shared_ptr<AudioChannelFormat> copy() const;
 
@@ -150,6 +163,14 @@ namespace adm {
      *
      * @returns ContainerProxy containing all audioBlockFormats of the given
      * type.
+     *
+     * If the element has been parsed with
+     * `xml::ParserOptions::lazy_block_formats`, the audioBlockFormats are
+     * parsed on the first call to any `getElements()`, or before the first
+     * audioBlockFormat is added or cleared; this is not a modification and
+     * does not change the revision. Parsing errors are
+     * thrown from this call then. Concurrent const accesses to the same
+     * element wait until the audioBlockFormats have been parsed once.
      */
     template <typename AudioBlockFormat>
     BlockFormatsConstRange<AudioBlockFormat> getElements() const;
@@ -178,11 +199,35 @@ namespace adm {
      */
     void print(std::ostream &os) const;
 
+    /**
+     * @brief Get the revision of the element
+     *
+     * The revision is incremented every time the element is modified,
+     * including its references and audioBlockFormats. As the
+     * audioBlockFormats can be modified through the ranges returned by the
+     * non-const `getElements()`, every call to it counts as a modification.
+     */
+    ADM_EXPORT std::size_t getRevision() const;
+
+    /**
+     * @brief Get a hash of the parameters and the audioBlockFormats of the
+     * element
+     *
+     * As the audioBlockFormats are included, the hash is only recomputed
+     * when the revision has changed. Once the non-const `getElements()` has
+     * been called, the audioBlockFormats could be modified without changing
+     * the revision, so the hash is then recomputed on every call. See
+     * `Document::getContentHash()`.
+     */
+    ADM_EXPORT std::uint64_t getContentHash() const;
+
     /// Get adm::Document this element belongs to
     ADM_EXPORT std::weak_ptr<Document> getParent() const;
 
    private:
     friend class AudioChannelFormatAttorney;
+    friend class detail::ContentHasher;
+    friend class detail::LazyBlockFormats;
 
     ADM_EXPORT AudioChannelFormat(AudioChannelFormatName name,
                                   TypeDescriptor channelType);
@@ -224,13 +269,39 @@ namespace adm {
     ADM_EXPORT bool add(detail::ParameterTraits<AudioBlockFormatBinaural>::tag,
                         const AudioBlockFormatBinaural &blockFormat);
 
+    ADM_EXPORT void materialiseBlockFormats() const;
+
+    /// the audioBlockFormats, for reading
+    const detail::BlockFormatStorage &blockFormats() const;
+    /// the audioBlockFormats, for modification; copied first if shared
+    detail::BlockFormatStorage &mutableBlockFormats();
+
     template <typename BlockFormat>
     void assignId(BlockFormat &blockFormat);
 
+    /// add a lazily parsed @a blockFormat like add(), but without changing
+    /// the revision, as parsing is not a modification
+    template <typename BlockFormat>
+    void addParsed(BlockFormat blockFormat);
+
+    /// add @a blockFormat without searching for a free ID; its ID must be
+    /// defined and must not be used by another audioBlockFormat
+    template <typename BlockFormat>
+    void addWithUnusedId(const BlockFormat &blockFormat);
+
+    /// true once the non-const getElements() has been called, after which
+    /// the audioBlockFormats can change without changing the revision
+    bool blockFormatsExposed() const;
+
+    /// like the non-const getElements(), but without marking the
+    /// audioBlockFormats as exposed, so the range must not be kept
+    template <typename BlockFormat>
+    BlockFormatsRange<BlockFormat> updateElements();
+
     template <typename BlockFormat>
-    bool idUsed(const AudioBlockFormatId &id);
+    bool idUsed(const AudioBlockFormatId &id) const;
 
-    template <typename BlockFormatProxy>
+    template <typename BlockFormat>
     void assignNewIdValue();
 
     ADM_EXPORT
@@ -267,19 +338,26 @@ namespace adm {
 
     // ----- Common ----- //
     ADM_EXPORT void setParent(std::weak_ptr<Document> document);
+    ADM_EXPORT std::uint64_t getContentHash(
+        detail::ContentHashMemo &memo) const;
 
     std::weak_ptr<Document> parent_;
+    detail::Revision revision_;
+    mutable detail::ContentHashCache contentHash_;
     AudioChannelFormatName name_;
     TypeDescriptor typeDescriptor_;
     AudioChannelFormatId id_;
     boost::optional<Frequency> frequency_;
 
-    std::vector<AudioBlockFormatDirectSpeakers>
-        audioBlockFormatsDirectSpeakers_;
-    std::vector<AudioBlockFormatMatrix> audioBlockFormatsMatrix_;
-    std::vector<AudioBlockFormatObjects> audioBlockFormatsObjects_;
-    std::vector<AudioBlockFormatHoa> audioBlockFormatsHoa_;
-    std::vector<AudioBlockFormatBinaural> audioBlockFormatsBinaural_;
+    /// audioBlockFormats, shared between copies until they are modified
+    std::shared_ptr<detail::BlockFormatStorage> blockFormats_;
+    /// audioBlockFormats which have not been parsed yet; only accessed
+    /// while holding the mutex of lazyGuard_
+    mutable std::shared_ptr<const detail::LazyBlockFormats> lazyBlockFormats_;
+    /// pending while lazyBlockFormats_ is set
+    mutable detail::LazyGuard lazyGuard_;
+    /// true if the ID has been changed before parsing the audioBlockFormats
+    bool reassignLazyBlockFormatIds_ = false;
   };
 
   // ---- Implementation ---- //
@@ -332,57 +410,4 @@ namespace adm {
     return get(Tag());
   }
 
-  template <typename BlockFormatProxy>
-  void AudioChannelFormat::assignNewIdValue() {
-    for (auto &blockFormat : getElements<BlockFormatProxy>()) {
-      auto blockFormatId = blockFormat.template get<AudioBlockFormatId>();
-      auto channelFormatIdValue = get<AudioChannelFormatId>()
-                                      .template get<AudioChannelFormatIdValue>()
-                                      .get();
-      blockFormatId.set(AudioBlockFormatIdValue(channelFormatIdValue));
-      blockFormat.set(blockFormatId);
-    }
-  }
-
-  template <typename BlockFormat>
-  bool AudioChannelFormat::idUsed(const AudioBlockFormatId &id) {
-    auto blockFormats = getElements<BlockFormat>();
-    auto it = std::find_if(
-        blockFormats.begin(), blockFormats.end(),
-        [&id](const BlockFormat &blockFormat) {
-          return blockFormat.template get<AudioBlockFormatId>() == id;
-        });
-    if (it != blockFormats.end()) {
-      return true;
-    } else {
-      return false;
-    }
-  }
-
-  template <typename BlockFormat>
-  void AudioChannelFormat::assignId(BlockFormat &blockFormat) {
-    auto id = blockFormat.template get<AudioBlockFormatId>();
-
-    TypeDescriptor typeDescriptor;
-    AudioBlockFormatIdValue value;
-    AudioBlockFormatIdCounter counter;
-
-    if (isUndefined(id)) {
-      typeDescriptor = get<TypeDescriptor>();
-      value = AudioBlockFormatIdValue(
-          get<AudioChannelFormatId>().get<AudioChannelFormatIdValue>().get());
-      counter = AudioBlockFormatIdCounter(1u);
-    } else {
-      typeDescriptor = id.template get<TypeDescriptor>();
-      value = id.template get<AudioBlockFormatIdValue>();
-      counter = id.template get<AudioBlockFormatIdCounter>();
-    }
-
-    while (idUsed<BlockFormat>(
-        AudioBlockFormatId(typeDescriptor, value, counter))) {
-      ++counter;
-    }
-    blockFormat.set(AudioBlockFormatId(typeDescriptor, value, counter));
-  }
-
 }  // namespace adm
@@ -11,6 +11,8 @@
 #include "adm/elements_fwd.hpp"
 #include "adm/helper/element_range.hpp"
 #include "adm/detail/named_option_helper.hpp"
+#include "adm/detail/content_hash_cache.hpp"
+#include "adm/detail/revision.hpp"
 #include "adm/export.h"
 
 namespace adm {
@@ -182,11 +184,29 @@ namespace adm {
      */
     void print(std::ostream &os) const;
 
+    /**
+     * @brief Get the revision of the element
+     *
+     * The revision is incremented every time the element is modified,
+     * including its references. It can be used to check if information
+     * derived from the element is still up to date.
+     */
+    ADM_EXPORT std::size_t getRevision() const;
+
+    /**
+     * @brief Get a hash of the parameters of the element and of the
+     * referenced audioObjects
+     *
+     * See `Document::getContentHash()`.
+     */
+    ADM_EXPORT std::uint64_t getContentHash() const;
+
     /// Get adm::Document this element belongs to
     ADM_EXPORT std::weak_ptr<Document> getParent() const;
 
    private:
     friend class AudioContentAttorney;
+    friend class detail::ContentHasher;
 
     ADM_EXPORT AudioContent(AudioContentName name);
     ADM_EXPORT AudioContent(const AudioContent &) = default;
@@ -246,8 +266,11 @@ namespace adm {
     ADM_EXPORT void disconnectReferences();
 
     void setParent(std::weak_ptr<Document> document);
+    std::uint64_t getContentHash(detail::ContentHashMemo &memo) const;
 
     std::weak_ptr<Document> parent_;
+    detail::Revision revision_;
+    mutable detail::ContentHashCache contentHash_;
     AudioContentId id_;
     AudioContentName name_;
     boost::optional<AudioContentLanguage> language_;
@@ -10,6 +10,8 @@
 #include "adm/helper/element_range.hpp"
 #include "adm/detail/named_option_helper.hpp"
 #include "adm/detail/named_type.hpp"
+#include "adm/detail/content_hash_cache.hpp"
+#include "adm/detail/revision.hpp"
 #include "adm/export.h"
 
 namespace adm {
@@ -152,16 +154,44 @@ namespace adm {
     template <typename Element>
     void clearReferences();
 
+    /**
+     * @brief Get the revision of the references
+     *
+     * The revision is incremented every time a reference to an
+     * AudioChannelFormat or AudioPackFormat is added or removed. It can be
+     * used to check if information derived from the referenced elements is
+     * still up to date.
+     */
+    ADM_EXPORT std::size_t getReferenceRevision() const;
+
     /**
      * @brief Print overview to ostream
      */
     void print(std::ostream &os) const;
 
+    /**
+     * @brief Get the revision of the element
+     *
+     * The revision is incremented every time the element is modified,
+     * including its references. It can be used to check if information
+     * derived from the element is still up to date.
+     */
+    ADM_EXPORT std::size_t getRevision() const;
+
+    /**
+     * @brief Get a hash of the parameters of the element and of the
+     * referenced audioChannelFormats and audioPackFormats
+     *
+     * See `Document::getContentHash()`.
+     */
+    ADM_EXPORT std::uint64_t getContentHash() const;
+
     /// Get adm::Document this element belongs to
     ADM_EXPORT std::weak_ptr<Document> getParent() const;
 
    private:
     friend class AudioPackFormatAttorney;
+    friend class detail::ContentHasher;
 
     ADM_EXPORT AudioPackFormat(AudioPackFormatName name,
                                TypeDescriptor channelType);
@@ -214,8 +244,12 @@ namespace adm {
     ADM_EXPORT void disconnectReferences();
 
     ADM_EXPORT void setParent(std::weak_ptr<Document> document);
+    ADM_EXPORT std::uint64_t getContentHash(
+        detail::ContentHashMemo &memo) const;
 
     std::weak_ptr<Document> parent_;
+    detail::Revision revision_;
+    mutable detail::ContentHashCache contentHash_;
     AudioPackFormatName name_;
     AudioPackFormatId id_;
     TypeDescriptor typeDescriptor_;
@@ -223,6 +257,7 @@ namespace adm {
     boost::optional<AbsoluteDistance> absoluteDistance_;
     std::vector<std::shared_ptr<AudioChannelFormat>> audioChannelFormats_;
     std::vector<std::shared_ptr<AudioPackFormat>> audioPackFormats_;
+    std::size_t referenceRevision_ = 0;
   };
 
   // ---- Implementation ---- //
@@ -2,6 +2,8 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include "adm/elements/type_descriptor.hpp"
 #include "adm/detail/named_option_helper.hpp"
@@ -75,6 +77,17 @@ namespace adm {
     template <typename Parameter>
     void unset();
 
+    /**
+     * @brief Get the AudioPackFormatId packed into a single integral value
+     *
+     * The key contains the type in bits 48 to 63 and the value in bits 32 to
+     * 47. Keys of valid IDs are ordered like the string representations of the
+     * IDs; values which do not fit into the string representation overlap other
+     * parts of the key, so such IDs may share keys. The comparison operators
+     * compare the parameters instead.
+     */
+    ADM_EXPORT std::uint64_t key() const;
+
     ///@{
     /**
      * @brief Operator overload
@@ -127,6 +140,17 @@ namespace adm {
   ADM_EXPORT AudioPackFormatId parseAudioPackFormatId(const std::string& id);
   /// @brief Format an AudioPackFormatId object as string
   ADM_EXPORT std::string formatId(AudioPackFormatId id);
+  /**
+   * @brief Format an AudioPackFormatId object into a buffer
+   *
+   * The output is NUL terminated.
+   *
+   * @param buffer buffer of at least `detail::FORMAT_BUFFER_SIZE` chars
+   * @returns number of characters written, without the NUL terminator
+   */
+  ADM_EXPORT std::size_t formatId(char* buffer, const AudioPackFormatId& id);
+  /// @brief Hash an AudioPackFormatId without formatting it as string
+  ADM_EXPORT std::size_t hash_value(const AudioPackFormatId& id);
 
   // ---- Implementation ---- //
   template <typename... Parameters>
@@ -160,3 +184,12 @@ namespace adm {
   }
 
 }  // namespace adm
+
+namespace std {
+  template <>
+  struct hash<adm::AudioPackFormatId> {
+    std::size_t operator()(const adm::AudioPackFormatId& id) const {
+      return std::hash<std::uint64_t>()(id.key());
+    }
+  };
+}  // namespace std
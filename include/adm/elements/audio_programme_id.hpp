@@ -2,6 +2,8 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include "adm/elements/type_descriptor.hpp"
 #include "adm/detail/named_option_helper.hpp"
@@ -73,6 +75,14 @@ namespace adm {
     template <typename Parameter>
     void unset();
 
+    /**
+     * @brief Get the AudioProgrammeId packed into a single integral value
+     *
+     * The key contains the value in the lower bits. Keys of valid IDs are
+     * ordered like the string representations of the IDs.
+     */
+    ADM_EXPORT std::uint64_t key() const;
+
     ///@{
     /**
      * @brief Operator overload
@@ -117,6 +127,17 @@ namespace adm {
   ADM_EXPORT AudioProgrammeId parseAudioProgrammeId(const std::string& id);
   /// @brief Format an AudioProgrammeId object as string
   ADM_EXPORT std::string formatId(AudioProgrammeId id);
+  /**
+   * @brief Format an AudioProgrammeId object into a buffer
+   *
+   * The output is NUL terminated.
+   *
+   * @param buffer buffer of at least `detail::FORMAT_BUFFER_SIZE` chars
+   * @returns number of characters written, without the NUL terminator
+   */
+  ADM_EXPORT std::size_t formatId(char* buffer, const AudioProgrammeId& id);
+  /// @brief Hash an AudioProgrammeId without formatting it as string
+  ADM_EXPORT std::size_t hash_value(const AudioProgrammeId& id);
 
   // ---- Implementation ---- //
   template <typename... Parameters>
@@ -150,3 +171,12 @@ namespace adm {
   }
 
 }  // namespace adm
+
+namespace std {
+  template <>
+  struct hash<adm::AudioProgrammeId> {
+    std::size_t operator()(const adm::AudioProgrammeId& id) const {
+      return std::hash<std::uint64_t>()(id.key());
+    }
+  };
+}  // namespace std
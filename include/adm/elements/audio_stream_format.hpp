@@ -11,6 +11,8 @@
 #include "adm/helper/element_range.hpp"
 #include "adm/detail/named_option_helper.hpp"
 #include "adm/detail/named_type.hpp"
+#include "adm/detail/content_hash_cache.hpp"
+#include "adm/detail/revision.hpp"
 #include "adm/export.h"
 
 namespace adm {
@@ -252,11 +254,30 @@ namespace adm {
      */
     void print(std::ostream &os) const;
 
+    /**
+     * @brief Get the revision of the element
+     *
+     * The revision is incremented every time the element is modified,
+     * including its references. It can be used to check if information
+     * derived from the element is still up to date.
+     */
+    ADM_EXPORT std::size_t getRevision() const;
+
+    /**
+     * @brief Get a hash of the parameters of the element and of the
+     * referenced audioChannelFormat and audioPackFormat
+     *
+     * The audioTrackFormats are only included by their IDs, as they refer
+     * back to this element. See `Document::getContentHash()`.
+     */
+    ADM_EXPORT std::uint64_t getContentHash() const;
+
     /// Get adm::Document this element belongs to
     ADM_EXPORT std::weak_ptr<Document> getParent() const;
 
    private:
     friend class AudioStreamFormatAttorney;
+    friend class detail::ContentHasher;
 
     ADM_EXPORT AudioStreamFormat(AudioStreamFormatName name,
                                  FormatDescriptor format);
@@ -301,8 +322,12 @@ namespace adm {
     ADM_EXPORT void disconnectReferences();
 
     ADM_EXPORT void setParent(std::weak_ptr<Document> document);
+    ADM_EXPORT std::uint64_t getContentHash(
+        detail::ContentHashMemo &memo) const;
 
     std::weak_ptr<Document> parent_;
+    detail::Revision revision_;
+    mutable detail::ContentHashCache contentHash_;
     AudioStreamFormatName name_;
     AudioStreamFormatId id_;
     FormatDescriptor format_;
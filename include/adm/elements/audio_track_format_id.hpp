@@ -2,6 +2,8 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include "adm/elements/type_descriptor.hpp"
 #include "adm/detail/named_option_helper.hpp"
@@ -83,6 +85,17 @@ namespace adm {
     template <typename Parameter>
     void unset();
 
+    /**
+     * @brief Get the AudioTrackFormatId packed into a single integral value
+     *
+     * The key contains the type in bits 48 to 63, the value in bits 32 to 47
+     * and the counter in the lower bits. Keys of valid IDs are ordered like the
+     * string representations of the IDs; values which do not fit into the
+     * string representation overlap other parts of the key, so such IDs may
+     * share keys. The comparison operators compare the parameters instead.
+     */
+    ADM_EXPORT std::uint64_t key() const;
+
     ///@{
     /**
      * @brief Operator overload
@@ -146,6 +159,17 @@ namespace adm {
   ADM_EXPORT AudioTrackFormatId parseAudioTrackFormatId(const std::string& id);
   /// @brief Format an AudioTrackFormatId object as string
   ADM_EXPORT std::string formatId(AudioTrackFormatId id);
+  /**
+   * @brief Format an AudioTrackFormatId object into a buffer
+   *
+   * The output is NUL terminated.
+   *
+   * @param buffer buffer of at least `detail::FORMAT_BUFFER_SIZE` chars
+   * @returns number of characters written, without the NUL terminator
+   */
+  ADM_EXPORT std::size_t formatId(char* buffer, const AudioTrackFormatId& id);
+  /// @brief Hash an AudioTrackFormatId without formatting it as string
+  ADM_EXPORT std::size_t hash_value(const AudioTrackFormatId& id);
 
   // ---- Implementation ---- //
   template <typename... Parameters>
@@ -179,3 +203,12 @@ namespace adm {
   }
 
 }  // namespace adm
+
+namespace std {
+  template <>
+  struct hash<adm::AudioTrackFormatId> {
+    std::size_t operator()(const adm::AudioTrackFormatId& id) const {
+      return std::hash<std::uint64_t>()(id.key());
+    }
+  };
+}  // namespace std
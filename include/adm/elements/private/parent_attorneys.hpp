@@ -15,6 +15,34 @@
 
 namespace adm {
 
+  namespace xml {
+    class XmlParser;
+    class XmlWriter;
+  }
+
+  namespace detail {
+    class BinaryLoader;
+  }
+
+  class DocumentAttorney {
+   private:
+    friend class AudioProgramme;
+    friend class AudioContent;
+    friend class AudioObject;
+    friend class AudioPackFormat;
+    friend class AudioChannelFormat;
+    friend class AudioStreamFormat;
+    friend class AudioTrackFormat;
+    friend class AudioTrackUid;
+
+    /// the generation counter of @a document, nullptr if it has expired
+    static std::shared_ptr<std::size_t> getGeneration(
+        const std::weak_ptr<Document>& document) {
+      auto parent = document.lock();
+      return parent ? parent->generation_ : nullptr;
+    }
+  };
+
   class AudioProgrammeAttorney {
    private:
     friend class Document;
@@ -67,11 +95,30 @@ namespace adm {
     friend class Document;
     friend class AudioPackFormat;
     friend class AudioStreamFormat;
+    friend class xml::XmlParser;
+    friend class xml::XmlWriter;
+    friend class detail::BinaryLoader;
 
     static void setParent(std::shared_ptr<AudioChannelFormat> channelFormat,
                           std::weak_ptr<Document> parent) {
       channelFormat->setParent(parent);
     }
+
+    template <typename BlockFormat>
+    static void addWithUnusedId(AudioChannelFormat& channelFormat,
+                                const BlockFormat& blockFormat) {
+      channelFormat.addWithUnusedId(blockFormat);
+    }
+
+    template <typename BlockFormat>
+    static BlockFormatsRange<BlockFormat> updateElements(
+        AudioChannelFormat& channelFormat) {
+      return channelFormat.updateElements<BlockFormat>();
+    }
+
+    static bool blockFormatsExposed(const AudioChannelFormat& channelFormat) {
+      return channelFormat.blockFormatsExposed();
+    }
   };
 
   class AudioStreamFormatAttorney {
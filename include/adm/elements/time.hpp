@@ -2,6 +2,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <string>
 #include "adm/detail/named_type.hpp"
 #include "adm/export.h"
@@ -30,5 +31,16 @@ namespace adm {
       const std::string& timecode);
   /// @brief Format a std::chrono::duration object as an adm timecode string
   ADM_EXPORT std::string formatTimecode(const std::chrono::nanoseconds& time);
+  /**
+   * @brief Format a std::chrono::duration object as an adm timecode into a
+   * buffer
+   *
+   * The output is NUL terminated.
+   *
+   * @param buffer buffer of at least `detail::FORMAT_BUFFER_SIZE` chars
+   * @returns number of characters written, without the NUL terminator
+   */
+  ADM_EXPORT std::size_t formatTimecode(char* buffer,
+                                        const std::chrono::nanoseconds& time);
 
 }  // namespace adm
@@ -0,0 +1,245 @@
+#pragma once
+#include "adm/element_variant.hpp"
+#include "adm/elements.hpp"
+#include "adm/route.hpp"
+#include "adm/export.h"
+#include <boost/functional/hash.hpp>
+#include <boost/mpl/begin_end.hpp>
+#include <boost/mpl/distance.hpp>
+#include <boost/mpl/find.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace adm {
+
+  namespace detail {
+    /// @brief Index of `std::shared_ptr<const Element>` in ElementConstVariant
+    template <typename Element>
+    struct ElementTypeIndex {
+      using types = ElementConstVariant::types;
+      using found = typename boost::mpl::find<
+          types, std::shared_ptr<const Element>>::type;
+      static const int value =
+          boost::mpl::distance<typename boost::mpl::begin<types>::type,
+                               found>::value;
+    };
+  }  // namespace detail
+
+  /**
+   * @brief Non-owning reference to an ADM element
+   *
+   * Stores a raw pointer to an ADM element together with its type, using the
+   * same type index as `adm::ElementConstVariant::which()`. Copying an
+   * `ElementHandle` does not touch the reference count of the element, so the
+   * element has to be kept alive by other means, usually by the
+   * `adm::Document` it belongs to.
+   */
+  class ElementHandle {
+   public:
+    ElementHandle() = default;
+
+    template <typename Element>
+    explicit ElementHandle(const Element* element)
+        : which_(detail::ElementTypeIndex<Element>::value), element_(element) {}
+
+    /// @brief Index of the element type within ElementConstVariant
+    int which() const { return which_; }
+
+    /// @brief Check if the handle refers to an element of type `Element`
+    template <typename Element>
+    bool is() const {
+      return which_ == detail::ElementTypeIndex<Element>::value;
+    }
+
+    /**
+     * @brief Get the element
+     *
+     * Returns nullptr if the handle does not refer to an element of type
+     * `Element`.
+     */
+    template <typename Element>
+    const Element* get() const {
+      if (is<Element>()) {
+        return static_cast<const Element*>(element_);
+      }
+      return nullptr;
+    }
+
+    /**
+     * @brief Get a shared pointer to the element
+     *
+     * The element must still be owned by a `std::shared_ptr`.
+     */
+    ADM_EXPORT ElementConstVariant lock() const;
+
+    /// @brief Get the raw pointer to the element
+    const void* pointer() const { return element_; }
+
+   private:
+    int which_ = -1;
+    const void* element_ = nullptr;
+  };
+
+  inline bool operator==(const ElementHandle& lhs, const ElementHandle& rhs) {
+    return lhs.which() == rhs.which() && lhs.pointer() == rhs.pointer();
+  }
+
+  inline bool operator!=(const ElementHandle& lhs, const ElementHandle& rhs) {
+    return !(lhs == rhs);
+  }
+
+  inline bool operator<(const ElementHandle& lhs, const ElementHandle& rhs) {
+    if (lhs.which() != rhs.which()) {
+      return lhs.which() < rhs.which();
+    }
+    return std::less<const void*>()(lhs.pointer(), rhs.pointer());
+  }
+
+  /**
+   * @brief Lightweight route along ADM elements within an ADM document
+   *
+   * Offers the same interface as `adm::Route`, but stores `ElementHandle`s
+   * instead of `std::shared_ptr`s. Copying, destroying and reading a
+   * `HandleRoute` therefore never touches the reference counts of the
+   * elements, which makes it a good fit for route tables which are kept for
+   * a long time or are shared between threads.
+   *
+   * A `HandleRoute` is only valid as long as the elements it refers to are
+   * alive. Use `toRoute()` to get an owning `adm::Route`.
+   *
+   * Like `adm::Route`s, `HandleRoute`s are compared and hashed using the
+   * packed keys of the element ids, not the addresses of the elements, so
+   * the hash and the order of a `HandleRoute` are equal to those of the
+   * corresponding `adm::Route`.
+   *
+   * To create `HandleRoute`s use
+   * `adm::detail::GenericRouteTracer<HandleRoute, Strategy>`.
+   */
+  class HandleRoute {
+   public:
+    typedef std::size_t hash_type;
+    typedef std::vector<ElementHandle>::const_iterator const_iterator;
+    typedef ElementHandle value_type;
+
+    HandleRoute() = default;
+    /// @brief Create a HandleRoute referring to the elements of `route`
+    ADM_EXPORT explicit HandleRoute(const Route& route);
+
+    template <typename Element>
+    void add(const Element* element) {
+      handles_.push_back(ElementHandle(element));
+      using ElementId = typename Element::id_type;
+      keys_.push_back(key_type(handles_.back().which(),
+                               element->template get<ElementId>().key()));
+      boost::hash_combine(hash_, keys_.back().first);
+      boost::hash_combine(hash_, keys_.back().second);
+    }
+
+    template <typename Element>
+    void add(const std::shared_ptr<Element>& element) {
+      add(static_cast<const Element*>(element.get()));
+    }
+
+    ADM_EXPORT void add(const ElementConstVariant& element);
+
+    template <typename Element>
+    const Element* getFirstOf() const;
+    template <typename Element>
+    const Element* getLastOf() const;
+
+    template <typename Element>
+    const_iterator findFirstOf() const;
+    template <typename Element>
+    const_iterator findLastOf() const;
+
+    const_iterator begin() const { return handles_.begin(); }
+    const_iterator end() const { return handles_.end(); }
+
+    const ElementHandle& front() const { return handles_.front(); }
+    const ElementHandle& back() const { return handles_.back(); }
+
+    std::size_t size() const { return handles_.size(); }
+
+    /// @brief Get hash value
+    hash_type hash() const { return hash_; }
+
+    /**
+     * @brief Convert to an owning `adm::Route`
+     *
+     * All elements must still be owned by a `std::shared_ptr`.
+     */
+    ADM_EXPORT Route toRoute() const;
+
+   private:
+    friend bool operator==(const HandleRoute& lhs, const HandleRoute& rhs);
+    friend bool operator<(const HandleRoute& lhs, const HandleRoute& rhs);
+    typedef std::pair<int, std::uint64_t> key_type;
+    std::vector<ElementHandle> handles_;
+    std::vector<key_type> keys_;
+    hash_type hash_ = 0;
+  };
+
+  template <typename Element>
+  HandleRoute::const_iterator HandleRoute::findFirstOf() const {
+    return std::find_if(
+        handles_.begin(), handles_.end(),
+        [](const ElementHandle& handle) { return handle.is<Element>(); });
+  }
+
+  template <typename Element>
+  HandleRoute::const_iterator HandleRoute::findLastOf() const {
+    auto foundLast = std::find_if(
+        handles_.rbegin(), handles_.rend(),
+        [](const ElementHandle& handle) { return handle.is<Element>(); });
+    if (foundLast == handles_.rend()) {
+      return handles_.end();
+    }
+    return foundLast.base() - 1;
+  }
+
+  template <typename Element>
+  const Element* HandleRoute::getFirstOf() const {
+    auto foundFirst = findFirstOf<Element>();
+    if (foundFirst != handles_.end()) {
+      return foundFirst->template get<Element>();
+    }
+    return nullptr;
+  }
+
+  template <typename Element>
+  const Element* HandleRoute::getLastOf() const {
+    auto foundLast = findLastOf<Element>();
+    if (foundLast != handles_.end()) {
+      return foundLast->template get<Element>();
+    }
+    return nullptr;
+  }
+
+  inline bool operator==(const HandleRoute& lhs, const HandleRoute& rhs) {
+    return lhs.hash() == rhs.hash() && lhs.keys_ == rhs.keys_;
+  }
+
+  inline bool operator!=(const HandleRoute& lhs, const HandleRoute& rhs) {
+    return !(lhs == rhs);
+  }
+
+  inline bool operator<(const HandleRoute& lhs, const HandleRoute& rhs) {
+    if (lhs.hash() != rhs.hash()) {
+      return lhs.hash() < rhs.hash();
+    }
+    return lhs.keys_ < rhs.keys_;
+  }
+}  // namespace adm
+
+namespace std {
+  template <>
+  struct hash<adm::HandleRoute> {
+    std::size_t operator()(const adm::HandleRoute& route) const {
+      return route.hash();
+    }
+  };
+}  // namespace std
@@ -1,5 +1,7 @@
 /// @file xml_parser.hpp
 #pragma once
+#include <cstddef>
+#include <functional>
 #include <string>
 #include <memory>
 #include <iosfwd>
@@ -33,6 +35,137 @@ namespace adm {
       none = 0x0,  ///< default behaviour
       recursive_node_search =
           0x1,  ///< recursively search whole xml for audioFormatExtended node
+      /**
+       * Keep the audioBlockFormats of each audioChannelFormat in a compact
+       * pre-tokenised form and only parse them on the first call to
+       * `AudioChannelFormat::getElements()`. Errors in audioBlockFormats
+       * are thrown from that call instead of the parser. Has no effect on
+       * `FrameParser`, which needs the audioBlockFormats for merging.
+       */
+      lazy_block_formats = 0x2,
+    };
+
+    /**
+     * @brief Function supplying XML data to the parser
+     *
+     * Called with a buffer and its size, it should store up to `size`
+     * characters in the buffer and return their number. Returning 0 signals
+     * the end of the data.
+     * @ingroup xml
+     */
+    typedef std::function<std::size_t(char* buffer, std::size_t size)>
+        ReadFunction;
+
+    class XmlParser;
+    class ParserFilter;
+
+    /**
+     * @brief Reusable XML parser
+     *
+     * Parses any number of XML documents one after another, with the same
+     * result as `parseXml()`. The input buffer and the memory used for the
+     * XML nodes are kept between the calls, so parsing many similar
+     * documents with the same `Parser` avoids most of the memory allocations
+     * which are made by every call to `parseXml()`. The memory is released
+     * when the `Parser` is destroyed.
+     *
+     * A `Parser` must not be used by multiple threads at the same time.
+     * @ingroup xml
+     */
+    class Parser {
+     public:
+      /// @param options Options to influence the XML parser behaviour
+      ADM_EXPORT explicit Parser(ParserOptions options = ParserOptions::none);
+      ADM_EXPORT ~Parser();
+      Parser(const Parser&) = delete;
+      Parser& operator=(const Parser&) = delete;
+
+      /// @brief Parse ADM data from an `std::istream`
+      ADM_EXPORT std::shared_ptr<Document> parse(std::istream& stream);
+      /// @brief Parse ADM data from the XML file @a filename
+      ADM_EXPORT std::shared_ptr<Document> parseFile(
+          const std::string& filename);
+      /// @brief Parse ADM data supplied in chunks by @a read
+      ADM_EXPORT std::shared_ptr<Document> parse(const ReadFunction& read);
+
+     private:
+      std::unique_ptr<XmlParser> parser_;
+      std::unique_ptr<XmlParser> commonDefinitionsParser_;
+      std::string commonDefinitionsXml_;
+    };
+
+    /**
+     * @brief Parser applying serial ADM frames to a document
+     *
+     * Serial ADM (ITU-R BS.2125) transmits the metadata of a live stream as
+     * a sequence of small `<frame>` documents, e.g. as written by
+     * `FrameWriter`. Instead of building a new document for every frame,
+     * `parseFrame()` merges each frame into the same document:
+     *
+     *  - elements with new IDs are added to the document;
+     *  - the audioBlockFormats of an existing audioChannelFormat are
+     *    replaced by the ones of the frame with the same ID, and the other
+     *    block formats of the frame are appended;
+     *  - the parameters and references of the other existing elements are
+     *    set to the ones of the frame, without replacing the element
+     *    objects, so pointers to them stay valid.
+     *
+     * Elements and block formats which are not part of a frame are kept.
+     * Block formats are found by their ID in a hash table, so the time to
+     * apply a frame does not grow with the length of the stream.
+     *
+     * The XML of the elements of the previous frame is remembered, so an
+     * element which is the same as in the previous frame is neither parsed
+     * nor modified; in a typical stream only the audioChannelFormats have
+     * to be parsed. With local times, audioChannelFormats are only the same
+     * if both frames also have the same start. Note
+     * that this means that changes made to the document between the
+     * frames are only overwritten once the element changes in the stream.
+     *
+     * The times of frames with `timeReference="local"` are converted to
+     * total times by adding the start of the frame to the block formats.
+     *
+     * If a frame cannot be parsed, an exception is thrown and the elements
+     * of the frame before the error may already have been applied.
+     *
+     * A `FrameParser` must not be used by multiple threads at the same
+     * time.
+     * @ingroup xml
+     */
+    class FrameParser {
+     public:
+      /**
+       * @brief Parser for a new document containing the common definitions
+       * @param options Options to influence the XML parser behaviour
+       */
+      ADM_EXPORT explicit FrameParser(
+          ParserOptions options = ParserOptions::none);
+      /**
+       * @brief Parser applying the frames to @a document
+       *
+       * The elements referenced by the frames which are not part of them,
+       * like the common definitions, have to be in @a document already.
+       * @param document document to apply the frames to
+       * @param options Options to influence the XML parser behaviour
+       */
+      ADM_EXPORT explicit FrameParser(
+          std::shared_ptr<Document> document,
+          ParserOptions options = ParserOptions::none);
+      ADM_EXPORT ~FrameParser();
+      FrameParser(const FrameParser&) = delete;
+      FrameParser& operator=(const FrameParser&) = delete;
+
+      /// @brief Apply the frame read from @a stream to the document
+      ADM_EXPORT void parseFrame(std::istream& stream);
+      /// @brief Apply the @a size characters of XML at @a xml to the document
+      ADM_EXPORT void parseFrame(const char* xml, std::size_t size);
+
+      /// @brief The document the frames are applied to
+      ADM_EXPORT std::shared_ptr<Document> getDocument() const;
+
+     private:
+      std::shared_ptr<Document> document_;
+      std::unique_ptr<XmlParser> parser_;
     };
   }  // namespace xml
 
@@ -64,6 +197,62 @@ namespace adm {
       std::istream& stream,
       xml::ParserOptions options = xml::ParserOptions::none);
 
+  /**
+   * @brief Parse the elements of an XML file selected by @a filter
+   *
+   * See `xml::ParserFilter` for the available filters, e.g. to parse only
+   * the elements of one audioProgramme.
+   * @param filename XML file to read and parse
+   * @param filter Selection of the elements to parse
+   * @param options Options to influence the XML parser behaviour
+   */
+  ADM_EXPORT std::shared_ptr<Document> parseXml(
+      const std::string& filename, const xml::ParserFilter& filter,
+      xml::ParserOptions options = xml::ParserOptions::none);
+
+  /**
+   * @brief Parse the elements of the XML from @a stream selected by
+   * @a filter
+   *
+   * See `parseXml(const std::string&, const xml::ParserFilter&,
+   * xml::ParserOptions)`.
+   */
+  ADM_EXPORT std::shared_ptr<Document> parseXml(
+      std::istream& stream, const xml::ParserFilter& filter,
+      xml::ParserOptions options = xml::ParserOptions::none);
+
+  /**
+   * @brief Parse an XML representation of the Audio Definition Model
+   * supplied in chunks
+   *
+   * Unlike `parseXml(std::istream&)`, this does not read the whole input
+   * before parsing. The data is requested from @a read in chunks of 64 KiB,
+   * and each top level element (e.g. an `audioObject`) is parsed as soon as
+   * it is complete, so reading and parsing overlap and the memory used for
+   * the XML data is bounded by the size of the largest top level element.
+   * This is useful for non-seekable inputs like pipes, e.g.:
+   *
+   * @code
+   * auto document = adm::parseXml([fd](char* buffer, std::size_t size) {
+   *   auto count = ::read(fd, buffer, size);
+   *   if (count < 0) {
+   *     throw std::runtime_error("read failed");
+   *   }
+   *   return static_cast<std::size_t>(count);
+   * });
+   * @endcode
+   *
+   * Everything after the `audioFormatExtended` element is ignored. The line
+   * numbers in parsing errors are relative to the start of the top level
+   * element containing the error.
+   *
+   * @param read function supplying the XML data
+   * @param options Options to influence the XML parser behaviour
+   */
+  ADM_EXPORT std::shared_ptr<Document> parseXml(
+      const xml::ReadFunction& read,
+      xml::ParserOptions options = xml::ParserOptions::none);
+
   /**
    * @}
    */
@@ -0,0 +1,79 @@
+/// @file parser_filter.hpp
+#pragma once
+#include <boost/optional.hpp>
+#include <functional>
+#include <set>
+#include <typeindex>
+#include "adm/element_variant.hpp"
+#include "adm/elements/audio_programme_id.hpp"
+#include "adm/export.h"
+
+namespace adm {
+  namespace xml {
+
+    /**
+     * @brief Selection of the ADM elements which are parsed
+     *
+     * By default all elements are parsed. Elements which are filtered out
+     * are skipped after reading their ID, without converting the rest of
+     * their XML. References to them are dropped, unless the referenced
+     * element is already part of the destination document, like the
+     * common definitions.
+     *
+     * The filters can be combined; an element is parsed only if it passes
+     * all of them:
+     *
+     * @code
+     * adm::xml::ParserFilter filter;
+     * filter.setProgramme(adm::parseAudioProgrammeId("APR_1002"))
+     *     .skip<adm::AudioTrackUid>();
+     * auto document = adm::parseXml("input.xml", filter);
+     * @endcode
+     * @ingroup xml
+     */
+    class ParserFilter {
+     public:
+      /**
+       * @brief Only parse the audioProgramme @a id and the elements it
+       * references directly or indirectly
+       *
+       * References are not followed through elements rejected by the
+       * other filters. Parsing throws if the audioProgramme is missing.
+       */
+      ADM_EXPORT ParserFilter& setProgramme(AudioProgrammeId id);
+      /// @brief The audioProgramme set with `setProgramme()`, if any
+      ADM_EXPORT const boost::optional<AudioProgrammeId>& getProgramme() const;
+
+      /// @brief Skip all elements of the type @a Element
+      template <typename Element>
+      ParserFilter& skip() {
+        skippedIdTypes_.insert(typeid(typename Element::id_type));
+        return *this;
+      }
+
+      /**
+       * @brief Only parse the elements whose ID @a predicate returns true
+       * for
+       */
+      ADM_EXPORT ParserFilter& setIdPredicate(
+          std::function<bool(const ElementIdVariant&)> predicate);
+
+      /// @brief true if no filter has been set
+      ADM_EXPORT bool acceptsAll() const;
+      /**
+       * @brief Check if the element @a id passes the element type and ID
+       * filters
+       *
+       * Whether it is referenced by the audioProgramme is checked by the
+       * parser.
+       */
+      ADM_EXPORT bool accepts(const ElementIdVariant& id) const;
+
+     private:
+      boost::optional<AudioProgrammeId> programme_;
+      std::set<std::type_index> skippedIdTypes_;
+      std::function<bool(const ElementIdVariant&)> predicate_;
+    };
+
+  }  // namespace xml
+}  // namespace adm
@@ -3,6 +3,9 @@
 #include "adm/elements_fwd.hpp"
 #include "adm/element_variant.hpp"
 #include <boost/functional/hash.hpp>
+#include <cstdint>
+#include <functional>
+#include <utility>
 #include <vector>
 #include <memory>
 #include <algorithm>
@@ -39,7 +42,8 @@ namespace adm {
     template <typename AdmId>
     void add(AdmId id) {
       elements_.push_back(id);
-      boost::hash_combine(hash_, formatId(id));
+      keys_.push_back(key_type(elements_.back().which(), id.key()));
+      boost::hash_combine(hash_, keys_.back());
     }
 
     template <typename Element>
@@ -73,7 +77,9 @@ namespace adm {
    private:
     friend bool operator==(const Path& lhs, const Path& rhs);
     friend bool operator<(const Path& lhs, const Path& rhs);
+    typedef std::pair<int, std::uint64_t> key_type;
     std::vector<ElementIdVariant> elements_;
+    std::vector<key_type> keys_;
     hash_type hash_ = 0;
   };
 
@@ -113,7 +119,7 @@ namespace adm {
   }
 
   inline bool operator==(const Path& lhs, const Path& rhs) {
-    return lhs.hash() == rhs.hash() && lhs.elements_ == rhs.elements_;
+    return lhs.hash() == rhs.hash() && lhs.keys_ == rhs.keys_;
   }
 
   inline bool operator!=(const Path& lhs, const Path& rhs) {
@@ -124,10 +130,15 @@ namespace adm {
     if (lhs.hash() != rhs.hash()) {
       return lhs.hash() < rhs.hash();
     } else {
-      return std::lexicographical_compare(
-          lhs.elements_.begin(), lhs.elements_.end(), rhs.elements_.begin(),
-          rhs.elements_.end());
+      return lhs.keys_ < rhs.keys_;
     }
   }
 
 }  // namespace adm
+
+namespace std {
+  template <>
+  struct hash<adm::Path> {
+    std::size_t operator()(const adm::Path& path) const { return path.hash(); }
+  };
+}  // namespace std
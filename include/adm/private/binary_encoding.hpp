@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+#include "adm/elements.hpp"
+
+namespace adm {
+  namespace detail {
+
+    /**
+     * @brief Append the encoding of the parameters of an element to
+     * @a buffer
+     *
+     * This is the encoding used by `saveBinary()`, without references and
+     * audioBlockFormats. Two elements of the same type have the same
+     * encoding if and only if all their parameters which are set and not
+     * default are equal.
+     */
+    void encodeParameters(std::vector<char>& buffer,
+                          const AudioProgramme& element);
+    void encodeParameters(std::vector<char>& buffer,
+                          const AudioContent& element);
+    void encodeParameters(std::vector<char>& buffer,
+                          const AudioObject& element);
+    void encodeParameters(std::vector<char>& buffer,
+                          const AudioPackFormat& element);
+    void encodeParameters(std::vector<char>& buffer,
+                          const AudioChannelFormat& element);
+    void encodeParameters(std::vector<char>& buffer,
+                          const AudioStreamFormat& element);
+    void encodeParameters(std::vector<char>& buffer,
+                          const AudioTrackFormat& element);
+    void encodeParameters(std::vector<char>& buffer,
+                          const AudioTrackUid& element);
+    void encodeParameters(std::vector<char>& buffer,
+                          const AudioBlockFormatDirectSpeakers& blockFormat);
+    void encodeParameters(std::vector<char>& buffer,
+                          const AudioBlockFormatMatrix& blockFormat);
+    void encodeParameters(std::vector<char>& buffer,
+                          const AudioBlockFormatObjects& blockFormat);
+    void encodeParameters(std::vector<char>& buffer,
+                          const AudioBlockFormatHoa& blockFormat);
+    void encodeParameters(std::vector<char>& buffer,
+                          const AudioBlockFormatBinaural& blockFormat);
+
+
+    /**
+     * @brief Append the encoding of the parameters of an element to
+     * @a buffer, without its ID
+     *
+     * Like `encodeParameters()`, for finding elements which only differ in
+     * their IDs. For audioChannelFormats, the audioBlockFormats have to be
+     * encoded separately.
+     */
+    void encodeParametersWithoutId(std::vector<char>& buffer,
+                                   const AudioPackFormat& element);
+    void encodeParametersWithoutId(std::vector<char>& buffer,
+                                   const AudioChannelFormat& element);
+    void encodeParametersWithoutId(std::vector<char>& buffer,
+                                   const AudioStreamFormat& element);
+    void encodeParametersWithoutId(std::vector<char>& buffer,
+                                   const AudioTrackFormat& element);
+    void encodeParametersWithoutId(
+        std::vector<char>& buffer,
+        const AudioBlockFormatDirectSpeakers& blockFormat);
+    void encodeParametersWithoutId(std::vector<char>& buffer,
+                                   const AudioBlockFormatMatrix& blockFormat);
+    void encodeParametersWithoutId(std::vector<char>& buffer,
+                                   const AudioBlockFormatObjects& blockFormat);
+    void encodeParametersWithoutId(std::vector<char>& buffer,
+                                   const AudioBlockFormatHoa& blockFormat);
+    void encodeParametersWithoutId(
+        std::vector<char>& buffer, const AudioBlockFormatBinaural& blockFormat);
+
+  }  // namespace detail
+}  // namespace adm
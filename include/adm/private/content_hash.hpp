@@ -0,0 +1,127 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "adm/detail/content_hash_cache.hpp"
+#include "adm/private/binary_encoding.hpp"
+
+namespace adm {
+  namespace detail {
+
+    /**
+     * @brief 64 bit FNV-1a hash of a sequence of values
+     *
+     * Unlike `std::hash`, the result only depends on the values, and not on
+     * the platform, so that content hashes can be stored.
+     */
+    class ContentHasher {
+     public:
+      ContentHasher() = default;
+      /**
+       * The content hashes of referenced elements are looked up in and
+       * added to @a memo, so that shared sub-graphs are only hashed once.
+       */
+      explicit ContentHasher(ContentHashMemo& memo) : memo_(&memo) {}
+
+      void add(const char* data, std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+          value_ ^= static_cast<unsigned char>(data[i]);
+          value_ *= 0x100000001b3ull;
+        }
+      }
+
+      void add(std::uint64_t value) {
+        char bytes[8];
+        for (std::size_t i = 0; i < 8; ++i) {
+          bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+        add(bytes, 8);
+      }
+
+      /// add the parameters of an element or audioBlockFormat
+      template <typename Element>
+      void addParameters(const Element& element) {
+        buffer_.clear();
+        encodeParameters(buffer_, element);
+        add(buffer_.size());
+        add(buffer_.data(), buffer_.size());
+      }
+
+      /// add the parameters of all audioBlockFormats in a range
+      template <typename Range>
+      void addBlockFormats(const Range& blockFormats) {
+        add(blockFormats.size());
+        for (const auto& blockFormat : blockFormats) {
+          addParameters(blockFormat);
+        }
+      }
+
+      /// add the content hashes of some elements, in order
+      template <typename Element>
+      void addContentHashes(
+          const std::vector<std::shared_ptr<Element>>& elements) {
+        add(elements.size());
+        for (const auto& element : elements) {
+          add(contentHash(*element));
+        }
+      }
+
+      /// add the content hash of an optional element
+      template <typename Element>
+      void addContentHash(const std::shared_ptr<Element>& element) {
+        add(element ? contentHash(*element) : 0u);
+      }
+
+      std::uint64_t get() const { return value_; }
+
+     private:
+      template <typename Element>
+      std::uint64_t contentHash(const Element& element) {
+        if (!memo_) {
+          ContentHashMemo memo;
+          return element.getContentHash(memo);
+        }
+        auto it = memo_->hashes.find(&element);
+        if (it != memo_->hashes.end()) {
+          return it->second;
+        }
+        auto value = element.getContentHash(*memo_);
+        memo_->hashes.emplace(&element, value);
+        return value;
+      }
+
+      std::uint64_t value_ = 0xcbf29ce484222325ull;
+      std::vector<char> buffer_;
+      ContentHashMemo* memo_ = nullptr;
+    };
+
+    /**
+     * @brief Hash of the parameters of @a element, from @a cache if its
+     * revision has not changed since
+     *
+     * @a addParameters is called with a ContentHasher to compute the hash.
+     */
+    template <typename Element, typename AddParameters>
+    std::uint64_t cachedParameterHash(const Element& element,
+                                      ContentHashCache& cache,
+                                      AddParameters addParameters) {
+      std::uint64_t value;
+      if (!cache.get(element.getRevision(), value)) {
+        ContentHasher hasher;
+        addParameters(hasher);
+        value = hasher.get();
+        cache.set(element.getRevision(), value);
+      }
+      return value;
+    }
+
+    template <typename Element>
+    std::uint64_t cachedParameterHash(const Element& element,
+                                      ContentHashCache& cache) {
+      return cachedParameterHash(
+          element, cache,
+          [&element](ContentHasher& hasher) { hasher.addParameters(element); });
+    }
+
+  }  // namespace detail
+}  // namespace adm
@@ -2,8 +2,8 @@
 
 #include <algorithm>
 #include <boost/variant.hpp>
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include "adm/elements.hpp"
 #include "adm/element_variant.hpp"
 
@@ -12,85 +12,52 @@ namespace adm {
   std::vector<ElementVariant> copyAllElements(
       std::shared_ptr<const Document> document);
 
-  template <typename C>
-  class AddTo : public boost::static_visitor<> {
-   public:
-    AddTo(C& target) : target_(target) {}
-
-    template <typename T>
-    void operator()(const T& element) const {
-      target_->add(element);
-    }
-
-   private:
-    C& target_;
-  };
-
-  namespace visitor {
-    template <typename C>
-    AddTo<C> addTo(C& target) {
-      return AddTo<C>(target);
-    }
-  }  // namespace visitor
-
-  template <typename Target>
-  void addElements(std::vector<ElementVariant> elements,
-                   std::shared_ptr<Target> target) {
-    for (auto& element : elements) {
-      boost::apply_visitor(visitor::addTo(target), element);
-    }
-  }
+  /// The copy of each element of one type, by the original element
+  template <typename Element>
+  using ElementCopies =
+      std::unordered_map<const Element*, std::shared_ptr<Element>>;
 
   template <typename ElementSrc, typename ElementDest>
-  void resolveReferences(
-      std::shared_ptr<const ElementSrc> element,
-      std::map<std::shared_ptr<const ElementSrc>, std::shared_ptr<ElementSrc>>
-          mappingSrc,
-      std::map<std::shared_ptr<const ElementDest>, std::shared_ptr<ElementDest>>
-          mappingDest) {
-    for (auto reference : element->template getReferences<ElementDest>()) {
-      mappingSrc.at(element)->addReference(mappingDest.at(reference));
+  void resolveReferences(const std::shared_ptr<const ElementSrc>& element,
+                         const ElementCopies<ElementSrc>& mappingSrc,
+                         const ElementCopies<ElementDest>& mappingDest) {
+    auto& copy = mappingSrc.at(element.get());
+    for (auto& reference : element->template getReferences<ElementDest>()) {
+      copy->addReference(mappingDest.at(reference.get()));
     }
   }
 
   inline void resolveReferences(
-      std::shared_ptr<const AudioStreamFormat> element,
-      std::map<std::shared_ptr<const AudioStreamFormat>,
-               std::shared_ptr<AudioStreamFormat>>
-          mappingSrc,
-      std::map<std::shared_ptr<const AudioTrackFormat>,
-               std::shared_ptr<AudioTrackFormat>>
-          mappingDest) {
-    for (auto weakReference : element->getAudioTrackFormatReferences()) {
+      const std::shared_ptr<const AudioStreamFormat>& element,
+      const ElementCopies<AudioStreamFormat>& mappingSrc,
+      const ElementCopies<AudioTrackFormat>& mappingDest) {
+    auto& copy = mappingSrc.at(element.get());
+    for (auto& weakReference : element->getAudioTrackFormatReferences()) {
       auto reference = weakReference.lock();
       if (reference) {
-        mappingSrc.at(element)->addReference(
-            std::weak_ptr<AudioTrackFormat>(mappingDest.at(reference)));
+        copy->addReference(
+            std::weak_ptr<AudioTrackFormat>(mappingDest.at(reference.get())));
       }
     }
   }
 
   template <typename ElementSrc, typename ElementDest>
-  void resolveReference(
-      std::shared_ptr<const ElementSrc> element,
-      std::map<std::shared_ptr<const ElementSrc>, std::shared_ptr<ElementSrc>>
-          mappingSrc,
-      std::map<std::shared_ptr<const ElementDest>, std::shared_ptr<ElementDest>>
-          mappingDest) {
+  void resolveReference(const std::shared_ptr<const ElementSrc>& element,
+                        const ElementCopies<ElementSrc>& mappingSrc,
+                        const ElementCopies<ElementDest>& mappingDest) {
     if (auto reference = element->template getReference<ElementDest>()) {
-      mappingSrc.at(element)->setReference(mappingDest.at(reference));
+      mappingSrc.at(element.get())
+          ->setReference(mappingDest.at(reference.get()));
     }
   }
 
   template <typename ElementSrc, typename ElementDest>
-  void resolveComplementaries(
-      std::shared_ptr<const ElementSrc> element,
-      std::map<std::shared_ptr<const ElementSrc>, std::shared_ptr<ElementSrc>>
-          mappingSrc,
-      std::map<std::shared_ptr<const ElementDest>, std::shared_ptr<ElementDest>>
-          mappingDest) {
-    for (auto reference : element->getComplementaryObjects()) {
-      mappingSrc.at(element)->addComplementary(mappingDest.at(reference));
+  void resolveComplementaries(const std::shared_ptr<const ElementSrc>& element,
+                              const ElementCopies<ElementSrc>& mappingSrc,
+                              const ElementCopies<ElementDest>& mappingDest) {
+    auto& copy = mappingSrc.at(element.get());
+    for (auto& reference : element->getComplementaryObjects()) {
+      copy->addComplementary(mappingDest.at(reference.get()));
     }
   }
 
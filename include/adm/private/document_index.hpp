@@ -0,0 +1,106 @@
+#pragma once
+
+#include <memory>
+#include <unordered_set>
+#include "adm/elements.hpp"
+
+namespace adm {
+
+  class Document;
+
+  namespace detail {
+
+    /// The elements of one type in a DocumentIndex, and their IDs
+    template <typename Element>
+    struct ElementIndex {
+      typedef typename Element::id_type Id;
+
+      void insert(const Element& element) {
+        elements.insert(&element);
+        ids.insert(element.template get<Id>());
+      }
+
+      std::unordered_set<const Element*> elements;
+      std::unordered_set<Id> ids;
+    };
+
+    /**
+     * @brief Hash sets of the elements of a Document and their IDs
+     *
+     * Used while adding many elements to a Document at once, so that
+     * checking whether an element or an ID is already part of the document
+     * takes constant instead of linear time. Elements which are added to the
+     * document have to be inserted, and the index must not be used after
+     * any other modification of the document.
+     */
+    class DocumentIndex {
+     public:
+      explicit DocumentIndex(const Document& document);
+
+      template <typename Element>
+      bool contains(const std::shared_ptr<Element>& element) const {
+        return get(element.get()).elements.count(element.get()) != 0;
+      }
+
+      template <typename Element>
+      void insert(const Element& element) {
+        get(&element).insert(element);
+      }
+
+      bool isUsed(const AudioProgrammeId& id) const {
+        return programmes_.ids.count(id) != 0;
+      }
+      bool isUsed(const AudioContentId& id) const {
+        return contents_.ids.count(id) != 0;
+      }
+      bool isUsed(const AudioObjectId& id) const {
+        return objects_.ids.count(id) != 0;
+      }
+      bool isUsed(const AudioPackFormatId& id) const {
+        return packFormats_.ids.count(id) != 0;
+      }
+      bool isUsed(const AudioChannelFormatId& id) const {
+        return channelFormats_.ids.count(id) != 0;
+      }
+      bool isUsed(const AudioStreamFormatId& id) const {
+        return streamFormats_.ids.count(id) != 0;
+      }
+      bool isUsed(const AudioTrackFormatId& id) const {
+        return trackFormats_.ids.count(id) != 0;
+      }
+      bool isUsed(const AudioTrackUidId& id) const {
+        return trackUids_.ids.count(id) != 0;
+      }
+
+     private:
+      // clang-format off
+      ElementIndex<AudioProgramme>& get(const AudioProgramme*) { return programmes_; }
+      ElementIndex<AudioContent>& get(const AudioContent*) { return contents_; }
+      ElementIndex<AudioObject>& get(const AudioObject*) { return objects_; }
+      ElementIndex<AudioPackFormat>& get(const AudioPackFormat*) { return packFormats_; }
+      ElementIndex<AudioChannelFormat>& get(const AudioChannelFormat*) { return channelFormats_; }
+      ElementIndex<AudioStreamFormat>& get(const AudioStreamFormat*) { return streamFormats_; }
+      ElementIndex<AudioTrackFormat>& get(const AudioTrackFormat*) { return trackFormats_; }
+      ElementIndex<AudioTrackUid>& get(const AudioTrackUid*) { return trackUids_; }
+      const ElementIndex<AudioProgramme>& get(const AudioProgramme*) const { return programmes_; }
+      const ElementIndex<AudioContent>& get(const AudioContent*) const { return contents_; }
+      const ElementIndex<AudioObject>& get(const AudioObject*) const { return objects_; }
+      const ElementIndex<AudioPackFormat>& get(const AudioPackFormat*) const { return packFormats_; }
+      const ElementIndex<AudioChannelFormat>& get(const AudioChannelFormat*) const { return channelFormats_; }
+      const ElementIndex<AudioStreamFormat>& get(const AudioStreamFormat*) const { return streamFormats_; }
+      const ElementIndex<AudioTrackFormat>& get(const AudioTrackFormat*) const { return trackFormats_; }
+      const ElementIndex<AudioTrackUid>& get(const AudioTrackUid*) const { return trackUids_; }
+      // clang-format on
+
+      ElementIndex<AudioProgramme> programmes_;
+      ElementIndex<AudioContent> contents_;
+      ElementIndex<AudioObject> objects_;
+      ElementIndex<AudioPackFormat> packFormats_;
+      ElementIndex<AudioChannelFormat> channelFormats_;
+      ElementIndex<AudioStreamFormat> streamFormats_;
+      ElementIndex<AudioTrackFormat> trackFormats_;
+      ElementIndex<AudioTrackUid> trackUids_;
+    };
+
+  }  // namespace detail
+}  // namespace adm
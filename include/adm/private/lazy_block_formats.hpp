@@ -0,0 +1,53 @@
+#pragma once
+#include <memory>
+#include <string>
+#include "adm/elements/type_descriptor.hpp"
+#include "rapidxml/rapidxml.hpp"
+
+namespace adm {
+
+  class AudioChannelFormat;
+
+  namespace detail {
+
+    /**
+     * @brief audioBlockFormats of an AudioChannelFormat which have not been
+     * parsed yet
+     *
+     * The audioBlockFormat nodes are stored in a compact, pre-tokenised
+     * form: the names, attribute values and texts of the nodes, each
+     * terminated by a NUL, in a single string. When the audioBlockFormats
+     * are first accessed, rapidxml nodes pointing into this string are
+     * rebuilt one audioBlockFormat at a time and parsed with the usual
+     * parser functions, so the result is the same as with eager parsing.
+     *
+     * The tokens are never modified, so they can be shared between copies
+     * of an AudioChannelFormat.
+     */
+    class LazyBlockFormats {
+     public:
+      /**
+       * Store the audioBlockFormat children of the audioChannelFormat
+       * @a node, if audioBlockFormats of the type @a typeDescriptor are
+       * supported by the parser.
+       */
+      LazyBlockFormats(rapidxml::xml_node<>* node,
+                       TypeDescriptor typeDescriptor);
+
+      /// true if there are no audioBlockFormats to parse
+      bool empty() const { return tokens_.empty(); }
+
+      /// Parse the audioBlockFormats and add them to @a channelFormat
+      void addTo(AudioChannelFormat& channelFormat) const;
+
+      /// Add the audioBlockFormats to @a channelFormat on first access
+      static void attach(AudioChannelFormat& channelFormat,
+                         std::shared_ptr<const LazyBlockFormats> blockFormats);
+
+     private:
+      TypeDescriptor typeDescriptor_;
+      std::string tokens_;
+    };
+
+  }  // namespace detail
+}  // namespace adm
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace adm {
+
+  /**
+   * @brief Writable, NUL terminated copy-on-write view of a part of a file
+   *
+   * Where supported, the range is memory mapped privately: only the pages
+   * which are actually modified are copied, and the file itself is never
+   * changed. Otherwise, or if there is no byte after the range which can
+   * be replaced by the terminating NUL, the range is read into memory.
+   */
+  class MappedFileRange {
+   public:
+    /// Map @a size bytes at @a offset of the file @a filename
+    MappedFileRange(const std::string& filename, std::uint64_t offset,
+                    std::size_t size);
+    ~MappedFileRange();
+    MappedFileRange(const MappedFileRange&) = delete;
+    MappedFileRange& operator=(const MappedFileRange&) = delete;
+
+    /// The data, followed by a NUL character
+    char* data() { return data_; }
+    std::size_t size() const { return size_; }
+    /// true if the data is memory mapped, false if it has been read
+    bool isMapped() const { return mapping_ != nullptr; }
+
+   private:
+    void read(const std::string& filename, std::uint64_t offset);
+
+    char* data_ = nullptr;
+    std::size_t size_;
+    void* mapping_ = nullptr;
+    std::size_t mappingSize_ = 0;
+    std::vector<char> buffer_;
+  };
+
+}  // namespace adm
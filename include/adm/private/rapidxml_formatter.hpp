@@ -1,6 +1,8 @@
 #pragma once
 #include "adm/elements.hpp"
+#include "adm/detail/number_formatting.hpp"
 #include <string>
+#include <type_traits>
 
 namespace adm {
   namespace xml {
@@ -34,6 +36,10 @@ namespace adm {
     void formatAudioChannelFormat(
         XmlNode &node,
         const std::shared_ptr<const AudioChannelFormat> channelFormat);
+    /// Format an audioChannelFormat without its audioBlockFormats
+    void formatAudioChannelFormatHeader(
+        XmlNode &node,
+        const std::shared_ptr<const AudioChannelFormat> channelFormat);
     void formatAudioStreamFormat(
         XmlNode &node,
         const std::shared_ptr<const AudioStreamFormat> streamFormat);
@@ -68,40 +74,64 @@ namespace adm {
     void formatJumpPosition(XmlNode &node, const JumpPosition &jumpPosition);
 
     namespace detail {
-      std::string toString(const std::string &string);
-      std::string toString(const std::chrono::nanoseconds &time);
-      std::string toString(const AudioProgrammeId &id);
-      std::string toString(const AudioContentId &id);
-      std::string toString(const AudioObjectId &id);
-      std::string toString(const AudioPackFormatId &id);
-      std::string toString(const AudioChannelFormatId &id);
-      std::string toString(const AudioBlockFormatId &id);
-      std::string toString(const AudioStreamFormatId &id);
-      std::string toString(const AudioTrackFormatId &id);
-      std::string toString(const AudioTrackUidId &id);
 
-      template <typename T, typename std::enable_if<
-                                std::is_integral<T>::value>::type * = nullptr>
-      std::string toString(T value) {
-        return std::to_string(value);
-      }
+      /**
+       * @brief Text representation of a value for the XML writer
+       *
+       * Numbers, IDs and timecodes are formatted into a fixed-size buffer
+       * within the object, strings are referenced. This is only meant to be
+       * used as a temporary argument, so it can not be copied.
+       */
+      class FormattedValue {
+       public:
+        explicit FormattedValue(const std::string &string)
+            : data_(string.c_str()), size_(string.size()) {}
+        explicit FormattedValue(const std::chrono::nanoseconds &time);
+        explicit FormattedValue(const AudioProgrammeId &id);
+        explicit FormattedValue(const AudioContentId &id);
+        explicit FormattedValue(const AudioObjectId &id);
+        explicit FormattedValue(const AudioPackFormatId &id);
+        explicit FormattedValue(const AudioChannelFormatId &id);
+        explicit FormattedValue(const AudioBlockFormatId &id);
+        explicit FormattedValue(const AudioStreamFormatId &id);
+        explicit FormattedValue(const AudioTrackFormatId &id);
+        explicit FormattedValue(const AudioTrackUidId &id);
+        explicit FormattedValue(float value);
+        explicit FormattedValue(double value);
+
+        template <typename T,
+                  typename std::enable_if<std::is_integral<T>::value &&
+                                          std::is_signed<T>::value>::type * =
+                      nullptr>
+        explicit FormattedValue(T value)
+            : data_(buffer_),
+              size_(adm::detail::formatInteger(buffer_, value)) {}
+
+        template <typename T,
+                  typename std::enable_if<std::is_integral<T>::value &&
+                                          !std::is_signed<T>::value>::type * =
+                      nullptr>
+        explicit FormattedValue(T value)
+            : data_(buffer_),
+              size_(adm::detail::formatUnsigned(buffer_, value)) {}
+
+        template <typename T, typename Tag, typename Validator>
+        explicit FormattedValue(
+            const adm::detail::NamedType<T, Tag, Validator> &value)
+            : FormattedValue(value.get()) {}
+
+        FormattedValue(const FormattedValue &) = delete;
+        FormattedValue &operator=(const FormattedValue &) = delete;
 
-      template <typename T,
-                typename std::enable_if<std::is_floating_point<T>::value>::type
-                    * = nullptr>
-      std::string toString(T value) {
-        return std::to_string(value);
-      }
+        const char *data() const { return data_; }
+        std::size_t size() const { return size_; }
 
-      template <typename T, typename Tag>
-      std::string toString(adm::detail::NamedType<T, Tag> value) {
-        return toString(value.get());
-      }
+       private:
+        char buffer_[adm::detail::FORMAT_BUFFER_SIZE];
+        const char *data_;
+        std::size_t size_;
+      };
 
-      template <typename T, typename Tag, typename Validator>
-      std::string toString(adm::detail::NamedType<T, Tag, Validator> value) {
-        return toString(value.get());
-      }
     }  // namespace detail
   }  // namespace xml
 }  // namespace adm
@@ -10,10 +10,10 @@ namespace adm {
       return std::count(begin, end, '\n');
     }
 
-    int getDocumentLine(rapidxml::xml_node<>* node) {
+    inline int getDocumentLine(rapidxml::xml_node<>* node) {
       return countLines(node->document()->first_node()->name(), node->name());
     }
-    int getDocumentLine(rapidxml::xml_attribute<>* attr) {
+    inline int getDocumentLine(rapidxml::xml_attribute<>* attr) {
       return countLines(attr->document()->first_node()->name(), attr->name());
     }
   }  // namespace xml
@@ -1,55 +1,154 @@
 #pragma once
 #include "adm/document.hpp"
-#include "rapidxml/rapidxml.hpp"
-#include "rapidxml/rapidxml_print.hpp"
-#include "rapidxml/rapidxml_utils.hpp"
-
 #include "adm/elements.hpp"
 #include "adm/utilities/id_assignment.hpp"
 #include "adm/private/rapidxml_formatter.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace adm {
   namespace xml {
 
-    using NodePtr = rapidxml::xml_node<> *;
-
     class XmlNode;
 
+    /**
+     * @brief Streaming XML document writer
+     *
+     * Elements, attributes and values are written to the output stream as
+     * soon as they are added, without building a DOM first. The output is
+     * identical to printing a rapidxml DOM with the same content.
+     *
+     * As a consequence, the document has to be built in document order:
+     * attributes and the value of an element have to be set before any
+     * child element is added, and an element cannot be changed anymore once
+     * one of its following siblings has been added.
+     *
+     * The output is collected in an internal buffer and passed on in chunks
+     * of about 64 KiB, either to an output stream or to an `OutputFunction`.
+     */
     class XmlDocument {
      public:
-      XmlDocument() = default;
+      /// Function receiving the written XML data in chunks
+      typedef std::function<void(const char *, std::size_t)> OutputFunction;
+
+      explicit XmlDocument(std::ostream &stream);
+      explicit XmlDocument(OutputFunction output);
+      XmlDocument(const XmlDocument &) = delete;
+      XmlDocument &operator=(const XmlDocument &) = delete;
+
       XmlNode addNode(const std::string &name);
 
-      XmlNode addDeclaration();
+      void addDeclaration();
       XmlNode addItuStructure();
       XmlNode addEbuStructure();
+      /**
+       * @brief Add the structure of a serial ADM frame
+       *
+       * Adds a `<frame>` element with a `frameHeader` describing frame
+       * number @a frameIndex (counted from 0) of the given time window, and
+       * returns its `audioFormatExtended` node.
+       */
+      XmlNode addFrameStructure(std::uint64_t frameIndex,
+                                std::chrono::nanoseconds start,
+                                std::chrono::nanoseconds duration);
 
       void setDiscardDefaults(bool value) { discardDefaultValues_ = value; }
 
-     private:
-      friend std::ostream &operator<<(std::ostream &os, XmlDocument const &doc);
+      /**
+       * @brief Start a document fragment
+       *
+       * Returns a node which stands for an element at @a depth whose start
+       * tag has already been written elsewhere. Only the children of this
+       * node are written, indented as they would be in the full document,
+       * so that the output can later be inserted using
+       * `XmlNode::addFragment()`. Must be called before anything else is
+       * added to the document.
+       */
+      XmlNode addFragmentRoot(int depth);
+
+      /// Close all open elements and flush the remaining output
+      void finish();
+
+      /**
+       * @brief Start a new document written to @a output
+       *
+       * Discards any unfinished output. The internal buffers keep their
+       * capacity, so that writing many documents with one XmlDocument does
+       * not allocate once the buffers are large enough.
+       */
+      void reset(OutputFunction output);
 
-      rapidxml::xml_document<> doc_;
+     private:
+      friend class XmlNode;
+
+      struct OpenElement {
+        std::string name;
+        std::string value;
+        unsigned long serial;
+        bool startTagOpen;
+      };
+
+      XmlNode addNode(int parentDepth, const std::string &name);
+      void addAttribute(int depth, unsigned long serial,
+                        const std::string &name, const char *value,
+                        std::size_t size);
+      void setValue(int depth, unsigned long serial, const char *value,
+                    std::size_t size);
+      void addFragment(int depth, unsigned long serial, const char *xml,
+                       std::size_t size);
+
+      OpenElement &openElement(int depth, unsigned long serial);
+      void closeElementsBelow(int depth);
+      void closeElement();
+      void writeIndent(int depth);
+      void writeEscaped(const char *text, std::size_t size, char noexpand);
+      void flush();
+
+      OutputFunction output_;
+      std::string buffer_;
+      std::vector<OpenElement> openElements_;
+      std::size_t openElementCount_ = 0;
+      unsigned long nextSerial_ = 0;
+      int fragmentDepth_ = -1;
       bool discardDefaultValues_ = false;
     };
 
+    /**
+     * @brief Handle to an element of an XmlDocument
+     *
+     * XmlNodes are lightweight handles, which may be copied freely. They
+     * refer to an element which is still open in the XmlDocument.
+     */
     class XmlNode {
      public:
       XmlNode() = default;
-      XmlNode(NodePtr node, bool discardDefaults);
+
+      int depth() const { return depth_; }
 
       // --- GENERAL ---- //
       XmlNode addNode(const std::string &name);
       void setValue(const std::string &value);
+      void setValue(const detail::FormattedValue &value);
+      /**
+       * @brief Add already written child elements
+       *
+       * @a xml must have been created by an XmlDocument using
+       * `XmlDocument::addFragmentRoot()` with the depth of this node.
+       */
+      void addFragment(const std::string &xml);
 
       template <typename ValueType>
       void setValue(const ValueType &value);
 
       // --- ATTRIBUTES ---- //
       void addAttribute(const std::string &name, const std::string &value);
+      void addAttribute(const std::string &name,
+                        const detail::FormattedValue &value);
 
       template <typename AttributeType, typename Source, typename Callable>
       void addAttribute(const Source &src, const std::string &key,
@@ -65,6 +164,8 @@ namespace adm {
 
       // --- ELEMENTS ---- //
       void addElement(const std::string &name, const std::string &value);
+      void addElement(const std::string &name,
+                      const detail::FormattedValue &value);
 
       template <typename ElementType, typename Source>
       void addElement(const Source &src, const std::string &name);
@@ -96,6 +197,10 @@ namespace adm {
                 typename Callable>
       void addBaseElements(const Source &src, const std::string &name,
                            Callable formatter);
+      /// Same as above, but only for the elements in @a range
+      template <typename ElementTypeId, typename Range, typename Callable>
+      void addBaseElementRange(const Range &range, const std::string &name,
+                               Callable formatter);
 
       template <typename ElementType, typename AdmIdType, typename Source>
       void addReference(const Source &src, const std::string &name);
@@ -111,19 +216,21 @@ namespace adm {
           const std::string &name);
 
      private:
-      NodePtr node_;
+      friend class XmlDocument;
+      XmlNode(XmlDocument *document, int depth, unsigned long serial,
+              bool discardDefaults);
+
+      XmlDocument *document_ = nullptr;
+      int depth_ = -1;
+      unsigned long serial_ = 0;
       bool discardDefaultValues_ = true;
     };
 
-    inline std::ostream &operator<<(std::ostream &os, XmlDocument const &doc) {
-      return os << doc.doc_;
-    }
-
     // ---- Implementation ---- //
 
     template <typename ValueType>
     void XmlNode::setValue(const ValueType &value) {
-      setValue(detail::toString(value));
+      setValue(detail::FormattedValue(value));
     }
 
     template <typename AttributeType, typename Source>
@@ -131,7 +238,7 @@ namespace adm {
       if (!(discardDefaultValues_ &&
             src->template isDefault<AttributeType>())) {
         auto value = src->template get<AttributeType>();
-        addAttribute(key, detail::toString(value));
+        addAttribute(key, detail::FormattedValue(value));
       }
     }
 
@@ -152,7 +259,7 @@ namespace adm {
             src->template isDefault<AttributeType>())) {
         if (src->template has<AttributeType>()) {
           auto value = src->template get<AttributeType>();
-          addAttribute(key, detail::toString(value));
+          addAttribute(key, detail::FormattedValue(value));
         }
       }
     }
@@ -174,7 +281,7 @@ namespace adm {
     void XmlNode::addElement(const Source &src, const std::string &name) {
       if (!(discardDefaultValues_ && src->template isDefault<ElementType>())) {
         auto value = src->template get<ElementType>();
-        addElement(name, detail::toString(value));
+        addElement(name, detail::FormattedValue(value));
       }
     }
 
@@ -191,7 +298,7 @@ namespace adm {
       if (!(discardDefaultValues_ && src->template isDefault<ElementType>())) {
         if (src->template has<ElementType>()) {
           auto value = src->template get<ElementType>();
-          addElement(name, detail::toString(value));
+          addElement(name, detail::FormattedValue(value));
         }
       }
     }
@@ -241,7 +348,15 @@ namespace adm {
               typename Callable>
     void XmlNode::addBaseElements(const Source &src, const std::string &name,
                                   Callable formatter) {
-      for (auto &element : src->template getElements<ElementType>()) {
+      addBaseElementRange<ElementTypeId>(
+          src->template getElements<ElementType>(), name, formatter);
+    }
+
+    template <typename ElementTypeId, typename Range, typename Callable>
+    void XmlNode::addBaseElementRange(const Range &range,
+                                      const std::string &name,
+                                      Callable formatter) {
+      for (auto &element : range) {
         auto id = element->template get<ElementTypeId>();
         if (!isCommonDefinitionsId(id)) {
           addElement(element, name, formatter);
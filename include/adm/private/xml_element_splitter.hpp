@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace adm {
+  namespace xml {
+
+    /**
+     * @brief Splits XML data arriving in chunks into the children of the
+     * audioFormatExtended element
+     *
+     * The data is passed to `write()` in arbitrary chunks. As soon as a
+     * child element of the audioFormatExtended element is complete, it is
+     * passed to the `ElementHandler` as a NUL terminated string, which may
+     * be parsed in place.
+     *
+     * Only the data of the element which is currently incomplete is kept,
+     * so the memory used is bounded by the size of the largest top level
+     * element plus the size of a chunk, not by the size of the document.
+     *
+     * The XML is only tokenised as far as necessary to find the element
+     * boundaries; everything else is left to the parser of the elements.
+     */
+    class XmlElementSplitter {
+     public:
+      /// Receives a complete element of @a size characters at @a xml
+      typedef std::function<void(char* xml, std::size_t size)> ElementHandler;
+
+      /**
+       * @param recursiveSearch accept the first audioFormatExtended element
+       * anywhere in the document, instead of only
+       * ebuCoreMain/coreMetadata/format/audioFormatExtended
+       * @param handler called for every child of audioFormatExtended
+       */
+      XmlElementSplitter(bool recursiveSearch, ElementHandler handler);
+
+      /// Add the next @a size characters of the document
+      void write(const char* data, std::size_t size);
+      /// Signal the end of the document; throws if it is incomplete
+      void finish();
+
+      /// Has the start of the audioFormatExtended element been found?
+      bool foundAudioFormatExtended() const { return rootDepth_ >= 0; }
+
+     private:
+      /// Scan `buffer_` from `scanPos_` as far as it is complete
+      void scan();
+      /**
+       * Find the end of the markup starting with '<' at @a pos; returns the
+       * position after it, or 0 if the markup is incomplete.
+       */
+      std::size_t findMarkupEnd(std::size_t pos) const;
+      std::size_t findString(std::size_t pos, const char* str) const;
+      void startElement(std::size_t begin, std::size_t end, bool empty);
+      void endElement(std::size_t end);
+      void emitElement(std::size_t begin, std::size_t end);
+      bool isAudioFormatExtended(const std::string& name) const;
+      /// Remove everything before `keepFrom()` from `buffer_`
+      void discardProcessed();
+
+      bool recursiveSearch_;
+      ElementHandler handler_;
+      std::vector<char> buffer_;
+      /// copy of the current element for the handler, reused
+      std::vector<char> element_;
+      std::size_t scanPos_ = 0;
+      /// start of the current child of audioFormatExtended, or npos
+      std::size_t elementStart_;
+      /// names of the open elements, until audioFormatExtended is found
+      std::vector<std::string> path_;
+      int depth_ = 0;
+      int rootDepth_ = -1;
+      bool rootClosed_ = false;
+    };
+
+  }  // namespace xml
+}  // namespace adm
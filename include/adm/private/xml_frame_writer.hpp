@@ -0,0 +1,79 @@
+#pragma once
+#include "adm/write.hpp"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace adm {
+  class Document;
+  namespace xml {
+
+    class XmlDocument;
+    class XmlNode;
+
+    /**
+     * @brief Writer of an ADM document as serial ADM frames
+     *
+     * See `FrameWriter` for the contents of the frames.
+     */
+    class XmlFrameWriter {
+     public:
+      XmlFrameWriter(std::shared_ptr<const Document> document,
+                     std::chrono::nanoseconds framePeriod,
+                     WriterOptions options);
+      ~XmlFrameWriter();
+      XmlFrameWriter(const XmlFrameWriter&) = delete;
+      XmlFrameWriter& operator=(const XmlFrameWriter&) = delete;
+
+      /// Write the next frame to `output`
+      void writeFrame(std::function<void(const char*, std::size_t)> output);
+
+      std::uint64_t frameIndex() const { return frameIndex_; }
+      std::chrono::nanoseconds frameStart() const {
+        return framePeriod_ * static_cast<std::int64_t>(frameIndex_);
+      }
+
+     private:
+      /// State of an element which influences the cached XML
+      struct ElementState {
+        const void* element;
+        std::size_t revision;
+        std::uint64_t idKey;
+
+        bool operator==(const ElementState& other) const {
+          return element == other.element && revision == other.revision &&
+                 idKey == other.idKey;
+        }
+      };
+
+      /// Update the cached XML if any element has changed
+      void updateCache(int depth);
+      void addChannelFormats(XmlNode& root, std::chrono::nanoseconds start,
+                             std::chrono::nanoseconds end);
+
+      std::shared_ptr<const Document> document_;
+      std::chrono::nanoseconds framePeriod_;
+      WriterOptions options_;
+      std::uint64_t frameIndex_ = 0;
+      std::unique_ptr<XmlDocument> xmlDocument_;
+
+      /// XML of the elements before and after the audioChannelFormats
+      std::string elementsBefore_;
+      std::string elementsAfter_;
+      std::vector<ElementState> cachedState_;
+      std::vector<ElementState> currentState_;
+      bool cacheValid_ = false;
+
+      /**
+       * Index of the first block format of each audioChannelFormat which may
+       * overlap the next frame
+       */
+      std::unordered_map<const void*, std::size_t> firstBlockFormats_;
+    };
+
+  }  // namespace xml
+}  // namespace adm
@@ -1,13 +1,18 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
 #include <iosfwd>
 #include <map>
+#include <set>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "adm/document.hpp"
 #include "adm/elements.hpp"
 #include "adm/errors.hpp"
 #include "adm/parse.hpp"
+#include "adm/parser_filter.hpp"
 #include "rapidxml/rapidxml.hpp"
 #include "rapidxml/rapidxml_utils.hpp"
 
@@ -46,23 +51,144 @@ namespace adm {
     SpeakerPosition parseSpeakerPosition(std::vector<NodePtr> node);
     SpeakerLabel parseSpeakerLabel(NodePtr node);
 
+    /// Get the XML of the common definitions embedded into the library
+    std::string getCommonDefinitionsXml();
+
     NodePtr findAudioFormatExtendedNodeEbuCore(NodePtr root);
     NodePtr findAudioFormatExtendedNodeFullRecursive(NodePtr root);
+    NodePtr findAudioFormatExtendedNodeFrame(NodePtr root);
 
+    /**
+     * @brief XML parser
+     *
+     * An XmlParser may either be constructed with its input and destination
+     * document and be used once, or be constructed with the options only
+     * and be used for any number of inputs.
+     *
+     * The input buffer and the memory blocks used by rapidxml are kept
+     * between calls and reused, so parsing similar documents one after
+     * another does not allocate memory for these again.
+     */
     class XmlParser {
      public:
+      explicit XmlParser(ParserOptions options = ParserOptions::none);
       XmlParser(const std::string& filename,
                 ParserOptions options = ParserOptions::none,
                 std::shared_ptr<Document> destDocument = Document::create());
       XmlParser(std::istream& stream,
                 ParserOptions options = ParserOptions::none,
                 std::shared_ptr<Document> destDocument = Document::create());
+      ~XmlParser();
+      XmlParser(const XmlParser&) = delete;
+      XmlParser& operator=(const XmlParser&) = delete;
 
+      /// Parse the input given to the constructor
       std::shared_ptr<Document> parse();
+      /// Parse the XML from @a stream into @a destDocument
+      std::shared_ptr<Document> parse(std::istream& stream,
+                                      std::shared_ptr<Document> destDocument);
+      /// Parse the XML file @a filename into @a destDocument
+      std::shared_ptr<Document> parseFile(
+          const std::string& filename, std::shared_ptr<Document> destDocument);
+      /// Parse @a size characters of XML at @a xml into @a destDocument
+      std::shared_ptr<Document> parse(const char* xml, std::size_t size,
+                                      std::shared_ptr<Document> destDocument);
+      /**
+       * @brief Parse the NUL terminated XML at @a xml into @a destDocument
+       *
+       * The XML is parsed in place without being copied, so it is modified
+       * by the parser. The data must not be changed or released until this
+       * function returns.
+       */
+      std::shared_ptr<Document> parseInPlace(
+          char* xml, std::shared_ptr<Document> destDocument);
+      /**
+       * @brief Parse the XML returned by @a read into @a destDocument
+       *
+       * The data is requested in chunks, and every top level element is
+       * added to @a destDocument as soon as it is complete. References are
+       * resolved at the end.
+       */
+      std::shared_ptr<Document> parse(const ReadFunction& read,
+                                      std::shared_ptr<Document> destDocument);
+
+      /**
+       * @brief Apply the serial ADM frame at @a xml to @a destDocument
+       *
+       * See `FrameParser` for how the elements of the frame are merged
+       * into the document. The XML of the elements of every frame is
+       * remembered, so the elements which have not changed since the
+       * previous frame parsed by this parser are skipped.
+       */
+      void parseFrame(const char* xml, std::size_t size,
+                      std::shared_ptr<Document> destDocument);
+      /// Apply the serial ADM frame read from @a stream to @a destDocument
+      void parseFrame(std::istream& stream,
+                      std::shared_ptr<Document> destDocument);
 
       bool hasUnresolvedReferences();
 
+      /**
+       * @brief Only parse the elements selected by @a filter
+       *
+       * The audioProgramme filter needs the whole document, so it is not
+       * supported by `parse(const ReadFunction&, std::shared_ptr<Document>)`.
+       */
+      void setFilter(ParserFilter filter);
+
      private:
+      void readStream(std::istream& stream);
+      void readFile(const std::string& filename);
+      /// Parse the NUL terminated @a xml into `document_`
+      void parseData(char* xml);
+      /// Merge the frame in `data_` into `document_`
+      void parseFrameData();
+      /// Release everything referring to the last document
+      void reset();
+      /// Parse a child of audioFormatExtended and add it to `document_`
+      void parseElement(NodePtr node);
+      template <typename Element, typename ElementId>
+      void addElement(NodePtr node, const char* idAttribute,
+                      ElementId (*parseId)(const std::string&),
+                      std::shared_ptr<Element> (XmlParser::*parse)(NodePtr));
+      /// Check if the element @a id is selected by `filter_`
+      bool accepts(const ElementIdVariant& id) const;
+      /// Find the IDs of the elements referenced by the filtered programme
+      void findProgrammeElements(NodePtr root);
+      /// Parse a child of audioFormatExtended and merge it into `document_`
+      void parseFrameElement(NodePtr node);
+      template <typename Element, typename ElementId>
+      void mergeElement(NodePtr node, const char* idAttribute,
+                        ElementId (*parseId)(const std::string&),
+                        std::shared_ptr<Element> (XmlParser::*parse)(NodePtr));
+      /// position of each audioBlockFormat in its AudioChannelFormat, by ID
+      typedef std::unordered_map<AudioBlockFormatId, std::size_t>
+          BlockFormatPositions;
+      /**
+       * Replace the audioBlockFormats of @a existing with the ones of
+       * @a parsed which have the same ID, and add the others. @a positions
+       * is updated, and rebuilt if it does not match @a existing.
+       */
+      template <typename BlockFormat>
+      void mergeBlockFormats(AudioChannelFormat& existing,
+                             const AudioChannelFormat& parsed,
+                             BlockFormatPositions& positions);
+      /// Apply @a parsed to @a existing, including its references
+      // clang-format off
+      void update(const std::shared_ptr<AudioProgramme>& existing, const std::shared_ptr<AudioProgramme>& parsed);
+      void update(const std::shared_ptr<AudioContent>& existing, const std::shared_ptr<AudioContent>& parsed);
+      void update(const std::shared_ptr<AudioObject>& existing, const std::shared_ptr<AudioObject>& parsed);
+      void update(const std::shared_ptr<AudioPackFormat>& existing, const std::shared_ptr<AudioPackFormat>& parsed);
+      void update(const std::shared_ptr<AudioChannelFormat>& existing, const std::shared_ptr<AudioChannelFormat>& parsed);
+      void update(const std::shared_ptr<AudioStreamFormat>& existing, const std::shared_ptr<AudioStreamFormat>& parsed);
+      void update(const std::shared_ptr<AudioTrackFormat>& existing, const std::shared_ptr<AudioTrackFormat>& parsed);
+      void update(const std::shared_ptr<AudioTrackUid>& existing, const std::shared_ptr<AudioTrackUid>& parsed);
+      // clang-format on
+      /// Throw if an element with @a id is already in `document_`
+      template <typename ElementId>
+      void checkDuplicateId(const ElementId& id, NodePtr node);
+      void resolveAllReferences();
+
       std::shared_ptr<AudioProgramme> parseAudioProgramme(NodePtr node);
       std::shared_ptr<AudioContent> parseAudioContent(NodePtr node);
       std::shared_ptr<AudioObject> parseAudioObject(NodePtr node);
@@ -72,9 +198,37 @@ namespace adm {
       std::shared_ptr<AudioTrackUid> parseAudioTrackUid(NodePtr node);
       std::shared_ptr<AudioChannelFormat> parseAudioChannelFormat(NodePtr node);
 
-      rapidxml::file<> xmlFile_;
       ParserOptions options_;
+      ParserFilter filter_;
+      /// IDs of the elements referenced by the programme of `filter_`
+      std::set<ElementIdVariant> programmeElements_;
       std::shared_ptr<Document> document_;
+      /// NUL terminated input, parsed in place by rapidxml
+      std::vector<char> data_;
+      /// memory blocks given back by the rapidxml memory pool, with their size
+      std::vector<std::pair<char*, std::size_t>> poolBlocks_;
+      rapidxml::xml_document<> xmlDocument_;
+
+      /// true while a frame is parsed, whose elements may already exist
+      bool mergeFrame_ = false;
+      /// offset added to the block format times of the current frame
+      std::chrono::nanoseconds frameTimeOffset_{0};
+      /// XML of an element in the previous frame
+      struct FrameElementState {
+        std::weak_ptr<const void> element;
+        std::string xml;
+        /// number of the last frame which contained the element
+        unsigned long frame = 0;
+        /// for AudioChannelFormats, which only contain audioBlockFormats of
+        /// their own type
+        BlockFormatPositions blockFormatPositions;
+        /// revision of the AudioChannelFormat after the last merge
+        std::size_t blockFormatRevision = 0;
+      };
+      std::unordered_map<const void*, FrameElementState> frameElements_;
+      /// number of the frame which is being parsed
+      unsigned long frameNumber_ = 0;
+      std::string elementXml_;
 
       // clang-format off
       std::map<std::shared_ptr<AudioProgramme>, std::vector<AudioContentId>> programmeContentRefs_;
@@ -93,12 +247,12 @@ namespace adm {
       // clang-format on
 
       template <typename Src, typename TargetId>
-      void resolveReferences(std::map<Src, std::vector<TargetId>> map) {
-        for (auto entry : map) {
-          for (auto id : entry.second) {
+      void resolveReferences(const std::map<Src, std::vector<TargetId>>& map) {
+        for (auto& entry : map) {
+          for (auto& id : entry.second) {
             if (auto element = document_->lookup(id)) {
               entry.first->addReference(element);
-            } else {
+            } else if (accepts(id)) {
               throw error::XmlParsingUnresolvedReference(formatId(id));
             }
           }
@@ -106,12 +260,12 @@ namespace adm {
       }
 
       template <typename Src, typename Target>
-      void resolveReference(std::map<Src, Target> map) {
-        for (auto entry : map) {
-          auto id = entry.second;
+      void resolveReference(const std::map<Src, Target>& map) {
+        for (auto& entry : map) {
+          auto& id = entry.second;
           if (auto element = document_->lookup(id)) {
             entry.first->setReference(element);
-          } else {
+          } else if (accepts(id)) {
             throw error::XmlParsingUnresolvedReference(formatId(id));
           }
         }
@@ -1,19 +1,90 @@
 #pragma once
 #include "adm/write.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace adm {
   class Document;
   namespace xml {
 
+    class XmlDocument;
+    class XmlNode;
+
+    class WriterCacheImpl {
+     public:
+      struct Entry {
+        std::weak_ptr<const void> element;
+        std::size_t revision = 0;
+        std::uint64_t idKey = 0;
+        unsigned long generation = 0;
+        std::string xml;
+      };
+
+      std::unordered_map<const void*, Entry> entries;
+      WriterOptions options = WriterOptions::none;
+      /// incremented on every write, to find entries of removed elements
+      unsigned long generation = 0;
+    };
+
+    /**
+     * @brief Writer of ADM documents to XML
+     *
+     * The XmlDocument used for writing is kept between calls, so that
+     * writing many documents with one XmlWriter reuses its buffers.
+     */
     class XmlWriter {
      public:
       XmlWriter(WriterOptions options = WriterOptions::none);
+      ~XmlWriter();
+      XmlWriter(const XmlWriter&) = delete;
+      XmlWriter& operator=(const XmlWriter&) = delete;
 
       std::ostream& write(std::shared_ptr<const Document> document,
                           std::ostream& stream);
 
+      /// Write the XML, reusing the XML of unchanged elements from `cache`
+      std::ostream& write(std::shared_ptr<const Document> document,
+                          std::ostream& stream, WriterCache& cache);
+
+      /// Append the XML to `buffer`, formatting the document only once
+      void write(std::shared_ptr<const Document> document,
+                 std::vector<char>& buffer);
+      /// Append the XML to `buffer`, formatting the document only once
+      void write(std::shared_ptr<const Document> document,
+                 std::string& buffer);
+
+      /// Get the number of characters `write()` would produce
+      std::size_t measure(std::shared_ptr<const Document> document);
+
+      /**
+       * Set the maximum number of threads used with
+       * `WriterOptions::parallel`, including the calling thread; 0, the
+       * default, uses one thread per hardware thread
+       */
+      void setThreadCount(unsigned threadCount);
+
      private:
+      /// Reset the retained XmlDocument to write to `output`
+      XmlDocument& startDocument(
+          std::function<void(const char*, std::size_t)> output);
+      void write(std::shared_ptr<const Document> document,
+                 XmlDocument& xmlDocument,
+                 WriterCacheImpl* cache = nullptr);
+      void writeSequential(std::shared_ptr<const Document> document,
+                           XmlNode& root);
+      void writeCached(std::shared_ptr<const Document> document,
+                       XmlNode& root, WriterCacheImpl& cache);
+      /// Format chunks of the top level elements on multiple threads
+      void writeParallel(std::shared_ptr<const Document> document,
+                         XmlNode& root);
+
       WriterOptions options_;
+      unsigned threadCount_ = 0;
+      std::unique_ptr<XmlDocument> xmlDocument_;
     };
 
   }  // namespace xml
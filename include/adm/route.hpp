@@ -2,6 +2,9 @@
 #include "adm/element_variant.hpp"
 #include "adm/elements.hpp"
 #include <boost/functional/hash.hpp>
+#include <cstdint>
+#include <functional>
+#include <utility>
 #include <vector>
 #include <algorithm>
 #include <memory>
@@ -27,6 +30,11 @@ namespace adm {
    * might become invalid. Instead the `adm::Path` stores the (coded) element
    * ids, which are also used to check if `adm::Path`s are equal or not.
    *
+   * Like `adm::Path`s, `adm::Route`s are compared and hashed using the
+   * packed keys of the element ids, so two routes are equal if they pass
+   * elements with the same ids, in the same order. `adm::HandleRoute`s are
+   * compared in the same way.
+   *
    * To easily create an `adm::Route` you may use the `adm::RouteTracer`.
    */
 
@@ -41,11 +49,13 @@ namespace adm {
     Route() = default;
 
     template <typename Element>
-    void add(std::shared_ptr<Element> element) {
+    void add(const std::shared_ptr<Element>& element) {
       route_.push_back(element);
       using ElementId = typename Element::id_type;
-      auto id = element->template get<ElementId>();
-      boost::hash_combine(hash_, adm::formatId(id));
+      keys_.push_back(key_type(route_.back().which(),
+                               element->template get<ElementId>().key()));
+      boost::hash_combine(hash_, keys_.back().first);
+      boost::hash_combine(hash_, keys_.back().second);
     }
 
     void add(adm::ElementConstVariant element) {
@@ -89,7 +99,9 @@ namespace adm {
 
     friend bool operator==(const Route& lhs, const Route& rhs);
     friend bool operator<(const Route& lhs, const Route& rhs);
+    typedef std::pair<int, std::uint64_t> key_type;
     std::vector<adm::ElementConstVariant> route_;
+    std::vector<key_type> keys_;
     hash_type hash_ = 0;
   };
 
@@ -137,7 +149,7 @@ namespace adm {
   };
 
   inline bool operator==(const Route& lhs, const Route& rhs) {
-    return lhs.hash() == rhs.hash() && lhs.route_ == rhs.route_;
+    return lhs.hash() == rhs.hash() && lhs.keys_ == rhs.keys_;
   }
 
   inline bool operator!=(const Route& lhs, const Route& rhs) {
@@ -148,8 +160,16 @@ namespace adm {
     if (lhs.hash() != rhs.hash()) {
       return lhs.hash() < rhs.hash();
     } else {
-      return std::lexicographical_compare(lhs.route_.begin(), lhs.route_.end(),
-                                          rhs.route_.begin(), rhs.route_.end());
+      return lhs.keys_ < rhs.keys_;
     }
   }
 }  // namespace adm
+
+namespace std {
+  template <>
+  struct hash<adm::Route> {
+    std::size_t operator()(const adm::Route& route) const {
+      return route.hash();
+    }
+  };
+}  // namespace std
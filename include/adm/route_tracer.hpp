@@ -1,8 +1,14 @@
 #pragma once
 
+#include "adm/element_variant.hpp"
 #include "adm/elements.hpp"
+#include "adm/errors.hpp"
 #include "adm/route.hpp"
+#include <functional>
+#include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace adm {
   namespace detail {
@@ -34,164 +40,320 @@ namespace adm {
       }
     };
 
+    /**
+     * @brief Depth first tracer for `adm::Route`s and `adm::Path`s
+     *
+     * The elements of the route currently being traced are kept on a single
+     * stack which is pushed to and popped from while recursing. A `Route` is
+     * only created once the `Strategy` signals the end of a route, so the
+     * prefixes shared between routes are not copied at every step.
+     *
+     * `Route` has to be default constructible and provide an
+     * `add(ElementConstVariant)` method.
+     *
+     * If caching is enabled, the routes found below an `AudioPackFormat` are
+     * stored and reused when the same `AudioPackFormat` is reached again,
+     * either via another element or in a later call to `run()`. A cache entry
+     * is discarded as soon as the references of the `AudioPackFormat` or of
+     * any `AudioPackFormat` below it have changed. The cache assumes that the
+     * decisions of the `Strategy` below an `AudioPackFormat` do not depend on
+     * how it has been reached.
+     */
     template <typename Route, class Strategy>
     class GenericRouteTracer : public Strategy {
      public:
       typedef std::vector<Route> result_type;
       GenericRouteTracer() = default;
+      /// @brief Trace all routes starting at `startPoint`
       template <typename Element>
       std::vector<Route> run(std::shared_ptr<Element> startPoint) {
-        admRoutes_.clear();
-        trace(startPoint, Route());
-        return admRoutes_;
+        std::vector<Route> routes;
+        run(startPoint, [&routes](Route&& route) {
+          routes.push_back(std::move(route));
+          return true;
+        });
+        return routes;
       }
 
-     private:
-      void trace(std::shared_ptr<const AudioProgramme> audioProgramme,
-                 Route admRoute) {
-        if (this->shouldAdd(audioProgramme)) {
-          admRoute.add(audioProgramme);
+      /**
+       * @brief Trace routes starting at `startPoint` one at a time
+       *
+       * Instead of collecting all routes first, `visitor` is called with
+       * each route as soon as it has been found. Only the route which is
+       * currently traced is kept in memory. If `visitor` returns false the
+       * tracing stops without looking at the remaining elements.
+       *
+       * @returns false if the tracing has been stopped by the visitor, true
+       * otherwise
+       * @throws error::AdmGenericRuntimeError if routes get deeper than
+       * `getMaxDepth()`
+       */
+      template <typename Element, typename Visitor>
+      bool run(std::shared_ptr<Element> startPoint, Visitor visitor) {
+        elements_.clear();
+        recordings_.clear();
+        depth_ = 0;
+        stopped_ = false;
+        routeVisitor_ = [&visitor](Route&& route) -> bool {
+          return visitor(std::move(route));
+        };
+        trace(std::shared_ptr<const Element>(startPoint));
+        routeVisitor_ = nullptr;
+        return !stopped_;
+      }
+
+      /**
+       * @brief Set the maximum number of nested elements
+       *
+       * Tracing throws if an element is reached via more than `maxDepth`
+       * elements, which protects against reference cycles. Defaults to 256.
+       */
+      void setMaxDepth(std::size_t maxDepth) { maxDepth_ = maxDepth; }
+      /// @brief Get the maximum number of nested elements
+      std::size_t getMaxDepth() const { return maxDepth_; }
+
+      /// @brief Enable or disable caching of the routes below AudioPackFormats
+      void setCacheEnabled(bool enabled) {
+        cacheEnabled_ = enabled;
+        if (!enabled) {
+          clearCache();
         }
+      }
+      /// @brief Check if caching of the routes is enabled
+      bool isCacheEnabled() const { return cacheEnabled_; }
+      /// @brief Remove all cached routes
+      void clearCache() { packFormatCache_.clear(); }
 
-        for (auto& subelement : audioProgramme->getReferences<AudioContent>()) {
-          if (this->shouldRecurse(audioProgramme, subelement)) {
-            trace(subelement, admRoute);
+     private:
+      using PackFormatRevision =
+          std::pair<std::weak_ptr<const AudioPackFormat>, std::size_t>;
+
+      struct PackFormatCacheEntry {
+        std::vector<PackFormatRevision> dependencies;
+        std::vector<std::vector<ElementConstVariant>> routeEnds;
+      };
+
+      struct Recording {
+        std::size_t depth;
+        PackFormatCacheEntry entry;
+      };
+
+      bool isValid(const PackFormatCacheEntry& entry) const {
+        for (auto& dependency : entry.dependencies) {
+          auto packFormat = dependency.first.lock();
+          if (!packFormat ||
+              packFormat->getReferenceRevision() != dependency.second) {
+            return false;
           }
         }
-        if (this->isEndOfRoute(audioProgramme)) {
-          admRoutes_.push_back(admRoute);
+        return true;
+      }
+
+      template <typename Element>
+      bool push(const std::shared_ptr<const Element>& element) {
+        if (depth_ >= maxDepth_) {
+          throw error::AdmGenericRuntimeError(
+              "maximum depth exceeded while tracing routes");
+        }
+        ++depth_;
+        if (this->shouldAdd(element)) {
+          elements_.push_back(element);
+          return true;
         }
+        return false;
       }
-      void trace(std::shared_ptr<const AudioContent> audioContent,
-                 Route admRoute) {
-        if (this->shouldAdd(audioContent)) {
-          admRoute.add(audioContent);
+
+      template <typename Element>
+      void pop(const std::shared_ptr<const Element>& element, bool added) {
+        if (this->isEndOfRoute(element)) {
+          addRoute(std::vector<ElementConstVariant>());
         }
+        leave(added);
+      }
 
-        for (auto& subelement : audioContent->getReferences<AudioObject>()) {
-          if (this->shouldRecurse(audioContent, subelement)) {
-            trace(subelement, admRoute);
-          }
+      void leave(bool added) {
+        --depth_;
+        if (added) {
+          elements_.pop_back();
+        }
+      }
+
+      template <typename Element, typename SubElement>
+      void recurse(const std::shared_ptr<const Element>& element,
+                   const std::shared_ptr<const SubElement>& subelement) {
+        if (!stopped_ && this->shouldRecurse(element, subelement)) {
+          trace(subelement);
+        }
+      }
+
+      void addRoute(const std::vector<ElementConstVariant>& routeEnd) {
+        if (stopped_) {
+          return;
+        }
+        Route route;
+        for (auto& routeElement : elements_) {
+          route.add(routeElement);
+        }
+        for (auto& routeElement : routeEnd) {
+          route.add(routeElement);
+        }
+        for (auto& recording : recordings_) {
+          std::vector<ElementConstVariant> recordedEnd(
+              elements_.begin() + recording.depth, elements_.end());
+          recordedEnd.insert(recordedEnd.end(), routeEnd.begin(),
+                             routeEnd.end());
+          recording.entry.routeEnds.push_back(std::move(recordedEnd));
+        }
+        if (!routeVisitor_(std::move(route))) {
+          stopped_ = true;
         }
-        if (this->isEndOfRoute(audioContent)) {
-          admRoutes_.push_back(admRoute);
+      }
+
+      void trace(const std::shared_ptr<const AudioProgramme>& audioProgramme) {
+        bool added = push(audioProgramme);
+        for (auto& subelement : audioProgramme->getReferences<AudioContent>()) {
+          recurse(audioProgramme, subelement);
         }
+        pop(audioProgramme, added);
       }
 
-      void trace(std::shared_ptr<const AudioObject> audioObject,
-                 Route admRoute) {
-        if (this->shouldAdd(audioObject)) {
-          admRoute.add(audioObject);
+      void trace(const std::shared_ptr<const AudioContent>& audioContent) {
+        bool added = push(audioContent);
+        for (auto& subelement : audioContent->getReferences<AudioObject>()) {
+          recurse(audioContent, subelement);
         }
+        pop(audioContent, added);
+      }
 
+      void trace(const std::shared_ptr<const AudioObject>& audioObject) {
+        bool added = push(audioObject);
         for (auto& subelement : audioObject->getReferences<AudioPackFormat>()) {
-          if (this->shouldRecurse(audioObject, subelement)) {
-            trace(subelement, admRoute);
-          }
+          recurse(audioObject, subelement);
         }
         for (auto& subelement : audioObject->getReferences<AudioObject>()) {
-          if (this->shouldRecurse(audioObject, subelement)) {
-            trace(subelement, admRoute);
-          }
+          recurse(audioObject, subelement);
         }
         for (auto& subelement : audioObject->getReferences<AudioTrackUid>()) {
-          if (this->shouldRecurse(audioObject, subelement)) {
-            trace(subelement, admRoute);
-          }
-        }
-        if (this->isEndOfRoute(audioObject)) {
-          admRoutes_.push_back(admRoute);
+          recurse(audioObject, subelement);
         }
+        pop(audioObject, added);
       }
 
-      void trace(std::shared_ptr<const AudioPackFormat> audioPackFormat,
-                 Route admRoute) {
-        if (this->shouldAdd(audioPackFormat)) {
-          admRoute.add(audioPackFormat);
+      void trace(const std::shared_ptr<const AudioPackFormat>& audioPackFormat) {
+        if (!cacheEnabled_) {
+          traceUncached(audioPackFormat);
+          return;
         }
 
-        for (auto& subelement :
-             audioPackFormat->getReferences<AudioChannelFormat>()) {
-          if (this->shouldRecurse(audioPackFormat, subelement)) {
-            trace(subelement, admRoute);
+        auto cached = packFormatCache_.find(audioPackFormat.get());
+        if (cached != packFormatCache_.end() && isValid(cached->second)) {
+          for (auto& routeEnd : cached->second.routeEnds) {
+            addRoute(routeEnd);
+            if (stopped_) {
+              return;
+            }
+          }
+          if (!recordings_.empty()) {
+            auto& dependencies = recordings_.back().entry.dependencies;
+            dependencies.insert(dependencies.end(),
+                                cached->second.dependencies.begin(),
+                                cached->second.dependencies.end());
           }
+          return;
         }
 
-        for (auto& subelement :
-             audioPackFormat->getReferences<AudioPackFormat>()) {
-          if (this->shouldRecurse(audioPackFormat, subelement)) {
-            trace(subelement, admRoute);
-          }
+        Recording recording;
+        recording.depth = elements_.size();
+        recording.entry.dependencies.push_back(PackFormatRevision(
+            audioPackFormat, audioPackFormat->getReferenceRevision()));
+        recordings_.push_back(std::move(recording));
+        traceUncached(audioPackFormat);
+        PackFormatCacheEntry entry = std::move(recordings_.back().entry);
+        recordings_.pop_back();
+        if (stopped_) {
+          return;
         }
-        if (this->isEndOfRoute(audioPackFormat)) {
-          admRoutes_.push_back(admRoute);
+        if (!recordings_.empty()) {
+          auto& dependencies = recordings_.back().entry.dependencies;
+          dependencies.insert(dependencies.end(), entry.dependencies.begin(),
+                              entry.dependencies.end());
         }
+        packFormatCache_[audioPackFormat.get()] = std::move(entry);
       }
-      void trace(std::shared_ptr<const AudioChannelFormat> audioChannelFormat,
-                 Route admRoute) {
-        if (this->shouldAdd(audioChannelFormat)) {
-          admRoute.add(audioChannelFormat);
+
+      void traceUncached(
+          const std::shared_ptr<const AudioPackFormat>& audioPackFormat) {
+        bool added = push(audioPackFormat);
+        for (auto& subelement :
+             audioPackFormat->getReferences<AudioChannelFormat>()) {
+          recurse(audioPackFormat, subelement);
         }
-        if (this->isEndOfRoute(audioChannelFormat)) {
-          admRoutes_.push_back(admRoute);
+        for (auto& subelement :
+             audioPackFormat->getReferences<AudioPackFormat>()) {
+          recurse(audioPackFormat, subelement);
         }
+        pop(audioPackFormat, added);
       }
 
-      void trace(std::shared_ptr<const AudioTrackUid> audioTrackUid,
-                 Route admRoute) {
-        if (this->shouldAdd(audioTrackUid)) {
-          admRoute.add(audioTrackUid);
-        }
+      void trace(
+          const std::shared_ptr<const AudioChannelFormat>& audioChannelFormat) {
+        bool added = push(audioChannelFormat);
+        pop(audioChannelFormat, added);
+      }
+
+      void trace(const std::shared_ptr<const AudioTrackUid>& audioTrackUid) {
+        bool added = push(audioTrackUid);
         auto subpack = audioTrackUid->getReference<AudioPackFormat>();
-        if (subpack && this->shouldRecurse(audioTrackUid, subpack)) {
-          trace(subpack, admRoute);
+        if (subpack) {
+          recurse(audioTrackUid, subpack);
         }
-
         auto subtrack = audioTrackUid->getReference<AudioTrackFormat>();
-        if (subtrack && this->shouldRecurse(audioTrackUid, subtrack)) {
-          trace(subtrack, admRoute);
-        }
-        if (this->isEndOfRoute(audioTrackUid)) {
-          admRoutes_.push_back(admRoute);
+        if (subtrack) {
+          recurse(audioTrackUid, subtrack);
         }
+        pop(audioTrackUid, added);
       }
 
-      void trace(std::shared_ptr<const AudioTrackFormat> audioTrackFormat,
-                 Route admRoute) {
-        if (this->shouldAdd(audioTrackFormat)) {
-          admRoute.add(audioTrackFormat);
-        }
+      void trace(
+          const std::shared_ptr<const AudioTrackFormat>& audioTrackFormat) {
+        bool added = push(audioTrackFormat);
         auto subpack = audioTrackFormat->getReference<AudioStreamFormat>();
-        if (subpack && this->shouldRecurse(audioTrackFormat, subpack)) {
-          trace(subpack, admRoute);
+        if (subpack) {
+          recurse(audioTrackFormat, subpack);
         }
+        leave(added);
       }
 
-      void trace(std::shared_ptr<const AudioStreamFormat> audioStreamFormat,
-                 Route admRoute) {
-        if (this->shouldAdd(audioStreamFormat)) {
-          admRoute.add(audioStreamFormat);
-        }
-
+      void trace(
+          const std::shared_ptr<const AudioStreamFormat>& audioStreamFormat) {
+        bool added = push(audioStreamFormat);
         auto subpack = audioStreamFormat->getReference<AudioPackFormat>();
-        if (subpack && this->shouldRecurse(audioStreamFormat, subpack)) {
-          trace(subpack, admRoute);
+        if (subpack) {
+          recurse(audioStreamFormat, subpack);
         }
         for (auto& weak_subtrack :
              audioStreamFormat->getAudioTrackFormatReferences()) {
           auto subtrack = weak_subtrack.lock();
-          if (subtrack && this->shouldRecurse(audioStreamFormat, subtrack)) {
-            trace(subpack, admRoute);
+          if (subtrack && !stopped_ &&
+              this->shouldRecurse(audioStreamFormat, subtrack)) {
+            trace(subpack);
           }
         }
-
         auto subchannel = audioStreamFormat->getReference<AudioChannelFormat>();
-        if (subchannel && this->shouldRecurse(audioStreamFormat, subchannel)) {
-          trace(subchannel, admRoute);
+        if (subchannel) {
+          recurse(audioStreamFormat, subchannel);
         }
+        leave(added);
       }
 
-      std::vector<Route> admRoutes_;
+      std::vector<ElementConstVariant> elements_;
+      std::function<bool(Route&&)> routeVisitor_;
+      std::size_t depth_ = 0;
+      std::size_t maxDepth_ = 256;
+      bool stopped_ = false;
+      bool cacheEnabled_ = false;
+      std::vector<Recording> recordings_;
+      std::map<const AudioPackFormat*, PackFormatCacheEntry> packFormatCache_;
     };
   }  // namespace detail
 
@@ -209,8 +371,15 @@ namespace adm {
    * Complementary AudioObjects are not interpreted as such. Hence for
    * every complementary audioObject an Route will be returned.
    *
-   * @warning If the ADM structure contains a reference cycle, trace will get
-   * stuck in an infinite loop.
+   * If the same documents are traced repeatedly, or many audioObjects share
+   * the same audioPackFormats, use `setCacheEnabled(true)` to reuse the routes
+   * found below each audioPackFormat.
+   *
+   * Use `run(startPoint, visitor)` to process the routes one at a time
+   * instead of collecting all of them in a `std::vector` first.
+   *
+   * @note If the ADM structure contains a reference cycle, tracing will stop
+   * with an exception once the maximum depth has been exceeded.
    */
   using RouteTracer =
       detail::GenericRouteTracer<Route, detail::DefaultFullDepthStrategy>;
@@ -4,9 +4,21 @@
 
 namespace adm {
 
+  /**
+   * @brief Copy all elements of @a document into a new Document
+   *
+   * The audioBlockFormats are shared with @a document until they are
+   * modified, see `AudioChannelFormat::copy()`.
+   */
   ADM_EXPORT std::shared_ptr<Document> deepCopy(
       std::shared_ptr<const Document> document);
 
+  /**
+   * @brief Copy all elements of @a src and add them to @a dest
+   *
+   * The copies are added with `Document::add()`, so their IDs are changed
+   * if they are already used in @a dest.
+   */
   ADM_EXPORT void deepCopyTo(std::shared_ptr<const Document> src,
                              std::shared_ptr<Document> dest);
 
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <adm/elements_fwd.hpp>
+#include <cstddef>
+#include <memory>
+#include "adm/export.h"
+
+namespace adm {
+
+  class Document;
+
+  /**
+   * @brief Merge structurally identical format elements
+   *
+   * `AudioChannelFormat`s, `AudioPackFormat`s, `AudioStreamFormat`s and
+   * `AudioTrackFormat`s which only differ in their IDs, and in the IDs of
+   * their `AudioBlockFormat`s, are identical. Of each set of identical
+   * elements, the first in the document is kept: all references to the
+   * others are redirected to it, and the others are removed from the
+   * document.
+   *
+   * References are compared after merging the referenced elements, so two
+   * `AudioTrackFormat`s are identical if their `AudioStreamFormat`s are, and
+   * so on. The order of references is significant.
+   *
+   * This is useful after merging many documents into one, which often
+   * results in many copies of the same formats. The elements are grouped
+   * by their encoded parameters in hash tables, so the run time is linear
+   * in the size of the document.
+   *
+   * @param document The document to update in-place.
+   * @returns the number of removed elements
+   */
+  ADM_EXPORT std::size_t removeDuplicateFormats(
+      std::shared_ptr<Document> document);
+
+}  // namespace adm
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <vector>
+#include "adm/element_variant.hpp"
+#include "adm/elements/audio_block_format_id.hpp"
+#include "adm/export.h"
+
+namespace adm {
+
+  class Document;
+
+  /**
+   * @brief Type of a `DocumentChange`
+   * @headerfile document_diff.hpp <adm/utilities/document_diff.hpp>
+   */
+  enum class ChangeType {
+    /// the element or audioBlockFormat only exists in the second document
+    added,
+    /// the element or audioBlockFormat only exists in the first document
+    removed,
+    /// a parameter has been added, removed or changed
+    parametersChanged,
+    /// the referenced elements or their order have changed
+    referencesChanged
+  };
+
+  /**
+   * @brief Difference between two documents, see `diff()`
+   * @headerfile document_diff.hpp <adm/utilities/document_diff.hpp>
+   */
+  struct DocumentChange {
+    ChangeType type;
+    /// the element; for audioBlockFormats, their audioChannelFormat
+    ElementIdVariant element;
+    /// the audioBlockFormat, if the change concerns one
+    boost::optional<AudioBlockFormatId> blockFormat;
+  };
+
+  /**
+   * @brief Compare two documents
+   *
+   * Elements are matched by their ID, and audioBlockFormats by their ID
+   * within the matched audioChannelFormats, using hash tables, so the
+   * run time is linear in the size of the documents. For each matched
+   * element, its parameters, its references and its audioBlockFormats are
+   * compared; references are compared by the IDs of the referenced
+   * elements, in order.
+   *
+   * The changes are ordered by element type, in the order in which the
+   * elements are written to XML. Within a type, removed and changed
+   * elements come first, in the order of @a first, followed by the added
+   * elements in the order of @a second. The changes of the audioBlockFormats
+   * follow the changes of their audioChannelFormat, in the same order.
+   *
+   * If the documents together contain more than 32768 audioBlockFormats,
+   * comparing them is spread over multiple threads; smaller documents are
+   * compared on the calling thread only. Neither document must be modified
+   * during the comparison.
+   *
+   * @returns the changes from @a first to @a second, empty if the
+   * documents are equal
+   */
+  ADM_EXPORT std::vector<DocumentChange> diff(
+      std::shared_ptr<const Document> first,
+      std::shared_ptr<const Document> second);
+
+}  // namespace adm
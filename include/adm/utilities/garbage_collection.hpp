@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "adm/element_variant.hpp"
+#include "adm/export.h"
+
+namespace adm {
+
+  class Document;
+
+  /**
+   * @brief Remove all elements which cannot be reached from @a roots
+   *
+   * Marks every element which is reachable from @a roots by following
+   * references, including the audioTrackFormat references of
+   * `AudioStreamFormat`s and the complementary objects of `AudioObject`s,
+   * and removes all other elements of @a document in a single pass. This
+   * takes time linear in the size of the document, instead of removing
+   * each element separately.
+   *
+   * This is useful to remove the unused common definitions added by
+   * `parseXml()`, and formats which are no longer used after editing a
+   * document.
+   *
+   * @param document The document to update in-place.
+   * @param roots The elements to keep, along with everything they
+   * reference.
+   * @returns the removed elements, in the order of the document, grouped by
+   * type
+   */
+  ADM_EXPORT std::vector<ElementVariant> collectGarbage(
+      std::shared_ptr<Document> document,
+      const std::vector<ElementVariant>& roots);
+
+  /**
+   * @brief Remove all elements which are not reachable from an
+   * `AudioProgramme`
+   *
+   * Same as `collectGarbage(document, roots)` with all `AudioProgramme`s of
+   * @a document as roots. A document without `AudioProgramme`s is emptied.
+   */
+  ADM_EXPORT std::vector<ElementVariant> collectGarbage(
+      std::shared_ptr<Document> document);
+
+}  // namespace adm
@@ -1,8 +1,11 @@
 /// @file write.hpp
 #pragma once
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <iosfwd>
+#include <vector>
 #include "adm/detail/enum_bitmask.hpp"
 #include "adm/export.h"
 
@@ -34,6 +37,9 @@ namespace adm {
      *                      || **options controlling default values**
      * none                 | use `<ebuCoreMain>` envelope (default)
      * write_default_values | use `<ebuCoreMain>` envelope (default)
+     *                      || **options controlling threading**
+     * none                 | write all elements on the calling thread (default)
+     * parallel             | format large documents on all hardware threads
      *
      *
      * @ingroup xml
@@ -42,6 +48,142 @@ namespace adm {
       none = 0x0,  ///< default behaviour
       itu_structure = 0x1,  ///< use ITU xml structure
       write_default_values = 0x2,  ///< write default values
+      parallel = 0x4,  ///< format elements in parallel
+    };
+
+    class WriterCacheImpl;
+    class XmlWriter;
+
+    /**
+     * @brief Cache for the XML of unchanged ADM elements
+     *
+     * When the same `WriterCache` is passed to consecutive calls of
+     * `writeXml(std::ostream&, std::shared_ptr<const Document>,
+     * WriterCache&, WriterOptions)`, the XML of the top level elements which
+     * have not been modified since the previous call is reused instead of
+     * being formatted again. An element counts as modified if its revision
+     * (e.g. `AudioObject::getRevision()`) has changed. AudioChannelFormats
+     * are always formatted again once the non-const
+     * `AudioChannelFormat::getElements()` has been called, as their
+     * audioBlockFormats can then change without changing the revision.
+     *
+     * As IDs are also written by the elements referring to them, all entries
+     * are discarded if the ID of any element has changed. The same happens
+     * if different writer options are used.
+     *
+     * The cache only holds weak references to the elements. A cache must
+     * not be used by multiple threads at the same time.
+     *
+     * @ingroup xml
+     */
+    class WriterCache {
+     public:
+      ADM_EXPORT WriterCache();
+      ADM_EXPORT ~WriterCache();
+      WriterCache(const WriterCache&) = delete;
+      WriterCache& operator=(const WriterCache&) = delete;
+
+      /// @brief Number of elements in the cache
+      ADM_EXPORT std::size_t size() const;
+      /// @brief Remove all entries
+      ADM_EXPORT void clear();
+
+     private:
+      friend class XmlWriter;
+      std::unique_ptr<WriterCacheImpl> impl_;
+    };
+
+    /**
+     * @brief Reusable XML writer
+     *
+     * Writes any number of documents one after another, with the same
+     * output as `writeXml()`. The buffers used for formatting are kept
+     * between the calls, so writing many similar documents with the same
+     * `Writer` avoids most of the memory allocations which are made by
+     * every call to `writeXml()`.
+     *
+     * A `Writer` must not be used by multiple threads at the same time.
+     * @ingroup xml
+     */
+    class Writer {
+     public:
+      /// @param options Options to influence the XML generator behaviour
+      ADM_EXPORT explicit Writer(WriterOptions options = WriterOptions::none);
+      ADM_EXPORT ~Writer();
+      Writer(const Writer&) = delete;
+      Writer& operator=(const Writer&) = delete;
+
+      /// @brief Write @a admDocument to an output stream
+      ADM_EXPORT std::ostream& write(
+          std::ostream& stream, std::shared_ptr<const Document> admDocument);
+      /**
+       * @brief Append the XML of @a admDocument to @a buffer
+       *
+       * The XML is appended as it is formatted, like
+       * `writeXml(std::vector<char>&, std::shared_ptr<const Document>,
+       * WriterOptions)` does. Reusing a cleared @a buffer for the next
+       * document avoids growing it again.
+       */
+      ADM_EXPORT void write(std::vector<char>& buffer,
+                            std::shared_ptr<const Document> admDocument);
+
+     private:
+      std::unique_ptr<XmlWriter> writer_;
+    };
+
+    class XmlFrameWriter;
+
+    /**
+     * @brief Writer of a document as a sequence of serial ADM frames
+     *
+     * Serial ADM (ITU-R BS.2125) splits the metadata of a live stream into
+     * frames of a fixed duration. Every frame written by `writeFrame()` is a
+     * complete `<frame>` document with a `frameHeader` and an
+     * `audioFormatExtended` element, which contains all elements of the
+     * document, but only the audioBlockFormats overlapping the time window
+     * of the frame. Block formats without a duration overlap every frame.
+     *
+     * The block formats of each audioChannelFormat are expected to be
+     * sorted by their start time. The `FrameWriter` remembers for every
+     * audioChannelFormat the first block format which may still overlap a
+     * frame, so writing a frame does not depend on the number of block
+     * formats before it. The XML of the other elements is formatted once
+     * and reused until one of them is modified (see `getRevision()`).
+     *
+     * The times of the block formats are not changed, so the frames use
+     * `timeReference="total"`. `WriterOptions::write_default_values` is
+     * supported; the other options are ignored.
+     *
+     * A `FrameWriter` must not be used by multiple threads at the same time.
+     * @ingroup xml
+     */
+    class FrameWriter {
+     public:
+      /**
+       * @param document document to write; it may be modified between the
+       * frames, e.g. to add block formats for the following frames
+       * @param framePeriod duration of every frame
+       * @param options Options to influence the XML generator behaviour
+       */
+      ADM_EXPORT FrameWriter(std::shared_ptr<const Document> document,
+                             std::chrono::nanoseconds framePeriod,
+                             WriterOptions options = WriterOptions::none);
+      ADM_EXPORT ~FrameWriter();
+      FrameWriter(const FrameWriter&) = delete;
+      FrameWriter& operator=(const FrameWriter&) = delete;
+
+      /// @brief Write the next frame to an output stream
+      ADM_EXPORT std::ostream& writeFrame(std::ostream& stream);
+      /// @brief Append the next frame to @a buffer
+      ADM_EXPORT void writeFrame(std::vector<char>& buffer);
+
+      /// @brief Index of the next frame, starting with 0
+      ADM_EXPORT std::uint64_t frameIndex() const;
+      /// @brief Start time of the next frame
+      ADM_EXPORT std::chrono::nanoseconds frameStart() const;
+
+     private:
+      std::unique_ptr<XmlFrameWriter> writer_;
     };
   }  // namespace xml
 
@@ -73,6 +215,67 @@ namespace adm {
       std::ostream& stream, std::shared_ptr<const Document> admDocument,
       xml::WriterOptions options = xml::WriterOptions::none);
 
+  /**
+   * @brief Write an Document to an output stream, reusing cached XML
+   *
+   * Only the elements which have been modified since the previous call
+   * using the same @a cache are formatted, see `xml::WriterCache`. The
+   * output is identical to
+   * `writeXml(std::ostream&, std::shared_ptr<const Document>, WriterOptions)`.
+   * The option `xml::WriterOptions::parallel` is ignored.
+   * @param stream output stream to write XML data
+   * @param admDocument ADM document that should be transformed into XML
+   * @param cache cache for the XML of the elements
+   * @param options Options to influence the XML generator behaviour
+   */
+  ADM_EXPORT std::ostream& writeXml(
+      std::ostream& stream, std::shared_ptr<const Document> admDocument,
+      xml::WriterCache& cache,
+      xml::WriterOptions options = xml::WriterOptions::none);
+
+  /**
+   * @brief Write an Document to a buffer
+   *
+   * The XML data is appended to @a buffer as it is formatted, in blocks of
+   * about 64 KiB, so unlike writing to a `std::ostringstream` it is not
+   * copied again afterwards. If the size is known, for example from a
+   * previous `getXmlSize()` call, @a buffer can be reserved beforehand to
+   * avoid reallocations.
+   * @param buffer buffer to append the XML data to
+   * @param admDocument ADM document that should be transformed into XML
+   * @param options Options to influence the XML generator behaviour
+   */
+  ADM_EXPORT void writeXml(
+      std::vector<char>& buffer, std::shared_ptr<const Document> admDocument,
+      xml::WriterOptions options = xml::WriterOptions::none);
+
+  /**
+   * @brief Write an Document to a string
+   *
+   * The XML data is appended to the string as it is formatted, which avoids
+   * the copies of `std::ostringstream::str()`.
+   * @param admDocument ADM document that should be transformed into XML
+   * @param options Options to influence the XML generator behaviour
+   * @returns the XML data
+   */
+  ADM_EXPORT std::string writeXmlToString(
+      std::shared_ptr<const Document> admDocument,
+      xml::WriterOptions options = xml::WriterOptions::none);
+
+  /**
+   * @brief Get the size of the XML data of an Document
+   *
+   * Runs the XML writer without storing its output and returns the exact
+   * number of characters `writeXml()` would write with the same @a options.
+   * This formats the whole document, but no memory is allocated for the
+   * output.
+   * @param admDocument ADM document that should be transformed into XML
+   * @param options Options to influence the XML generator behaviour
+   */
+  ADM_EXPORT std::size_t getXmlSize(
+      std::shared_ptr<const Document> admDocument,
+      xml::WriterOptions options = xml::WriterOptions::none);
+
   /**
    * @}
    */
@@ -0,0 +1,932 @@
+#include "adm/binary.hpp"
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/elements/private/parent_attorneys.hpp"
+#include "adm/private/binary_encoding.hpp"
+#include "adm/utilities/id_assignment.hpp"
+
+namespace adm {
+
+  namespace detail {
+
+    /// Access to the element internals used by loadBinary()
+    class BinaryLoader {
+     public:
+      template <typename BlockFormat>
+      static void addWithUnusedId(AudioChannelFormat& channelFormat,
+                                  const BlockFormat& blockFormat) {
+        AudioChannelFormatAttorney::addWithUnusedId(channelFormat,
+                                                    blockFormat);
+      }
+    };
+
+  }  // namespace detail
+
+  namespace {
+
+    const char BINARY_MAGIC[4] = {'A', 'D', 'M', 'B'};
+
+    static_assert(sizeof(float) == 4 && sizeof(double) == 8,
+                  "floating point types must be IEEE 754 single and double");
+
+    template <typename T>
+    struct Type {};
+
+    template <typename... Parameters>
+    struct ParameterList {};
+
+    /**
+     * Parameters stored for an element or a compound parameter, in the order
+     * in which they are set when loading.
+     *
+     * The stored parameters are preceded by a bit mask which says which of
+     * them are present, so adding parameters to the end of a list only needs
+     * a new BINARY_FORMAT_VERSION if old data must be rejected.
+     */
+    template <typename T>
+    struct BinaryParameters;
+
+    // clang-format off
+    template <> struct BinaryParameters<AudioProgrammeId> {
+      typedef ParameterList<AudioProgrammeIdValue> type;
+    };
+    template <> struct BinaryParameters<AudioContentId> {
+      typedef ParameterList<AudioContentIdValue> type;
+    };
+    template <> struct BinaryParameters<AudioObjectId> {
+      typedef ParameterList<AudioObjectIdValue> type;
+    };
+    template <> struct BinaryParameters<AudioPackFormatId> {
+      typedef ParameterList<TypeDescriptor, AudioPackFormatIdValue> type;
+    };
+    template <> struct BinaryParameters<AudioChannelFormatId> {
+      typedef ParameterList<TypeDescriptor, AudioChannelFormatIdValue> type;
+    };
+    template <> struct BinaryParameters<AudioBlockFormatId> {
+      typedef ParameterList<TypeDescriptor, AudioBlockFormatIdValue,
+                            AudioBlockFormatIdCounter> type;
+    };
+    template <> struct BinaryParameters<AudioStreamFormatId> {
+      typedef ParameterList<TypeDescriptor, AudioStreamFormatIdValue> type;
+    };
+    template <> struct BinaryParameters<AudioTrackFormatId> {
+      typedef ParameterList<TypeDescriptor, AudioTrackFormatIdValue,
+                            AudioTrackFormatIdCounter> type;
+    };
+    template <> struct BinaryParameters<AudioTrackUidId> {
+      typedef ParameterList<AudioTrackUidIdValue> type;
+    };
+
+    template <> struct BinaryParameters<AudioProgramme> {
+      typedef ParameterList<AudioProgrammeId, AudioProgrammeName,
+                            AudioProgrammeLanguage, Start, End,
+                            MaxDuckingDepth, LoudnessMetadata,
+                            AudioProgrammeReferenceScreen> type;
+    };
+    template <> struct BinaryParameters<AudioContent> {
+      // the content kinds must follow the DialogueId they belong to
+      typedef ParameterList<AudioContentId, AudioContentName,
+                            AudioContentLanguage, LoudnessMetadata,
+                            DialogueId, NonDialogueContentKind,
+                            DialogueContentKind, MixedContentKind> type;
+    };
+    template <> struct BinaryParameters<AudioObject> {
+      typedef ParameterList<AudioObjectId, AudioObjectName, Start, Duration,
+                            DialogueId, Importance, Interact, DisableDucking,
+                            AudioObjectInteraction> type;
+    };
+    template <> struct BinaryParameters<AudioPackFormat> {
+      typedef ParameterList<AudioPackFormatId, AudioPackFormatName,
+                            Importance, AbsoluteDistance> type;
+    };
+    template <> struct BinaryParameters<AudioChannelFormat> {
+      typedef ParameterList<AudioChannelFormatId, AudioChannelFormatName,
+                            Frequency> type;
+    };
+    template <> struct BinaryParameters<AudioStreamFormat> {
+      typedef ParameterList<AudioStreamFormatId, AudioStreamFormatName> type;
+    };
+    template <> struct BinaryParameters<AudioTrackFormat> {
+      typedef ParameterList<AudioTrackFormatId, AudioTrackFormatName> type;
+    };
+    template <> struct BinaryParameters<AudioTrackUid> {
+      typedef ParameterList<AudioTrackUidId, SampleRate, BitDepth> type;
+    };
+
+    template <> struct BinaryParameters<AudioBlockFormatDirectSpeakers> {
+      typedef ParameterList<AudioBlockFormatId, Rtime, Duration,
+                            SpeakerLabels, SpeakerPosition> type;
+    };
+    template <> struct BinaryParameters<AudioBlockFormatMatrix> {
+      typedef ParameterList<AudioBlockFormatId, Rtime, Duration> type;
+    };
+    template <> struct BinaryParameters<AudioBlockFormatObjects> {
+      // setting a position also sets Cartesian, so it has to come later
+      typedef ParameterList<AudioBlockFormatId, Rtime, Duration,
+                            SphericalPosition, CartesianPosition, Cartesian,
+                            Width, Height, Depth, ScreenEdgeLock, Gain,
+                            Diffuse, ChannelLock, ObjectDivergence,
+                            JumpPosition, ScreenRef, Importance> type;
+    };
+    template <> struct BinaryParameters<AudioBlockFormatHoa> {
+      typedef ParameterList<AudioBlockFormatId, Rtime, Duration> type;
+    };
+    template <> struct BinaryParameters<AudioBlockFormatBinaural> {
+      typedef ParameterList<AudioBlockFormatId, Rtime, Duration> type;
+    };
+
+    template <> struct BinaryParameters<AudioProgrammeReferenceScreen> {
+      typedef ParameterList<> type;
+    };
+    template <> struct BinaryParameters<LoudnessMetadata> {
+      typedef ParameterList<LoudnessMethod, LoudnessRecType,
+                            LoudnessCorrectionType, IntegratedLoudness,
+                            LoudnessRange, MaxTruePeak, MaxMomentary,
+                            MaxShortTerm, DialogueLoudness> type;
+    };
+    template <> struct BinaryParameters<AudioObjectInteraction> {
+      typedef ParameterList<OnOffInteract, GainInteract, PositionInteract,
+                            GainInteractionRange,
+                            PositionInteractionRange> type;
+    };
+    template <> struct BinaryParameters<GainInteractionRange> {
+      typedef ParameterList<GainInteractionMin, GainInteractionMax> type;
+    };
+    template <> struct BinaryParameters<PositionInteractionRange> {
+      typedef ParameterList<AzimuthInteractionMin, AzimuthInteractionMax,
+                            ElevationInteractionMin, ElevationInteractionMax,
+                            DistanceInteractionMin, DistanceInteractionMax,
+                            XInteractionMin, XInteractionMax,
+                            YInteractionMin, YInteractionMax,
+                            ZInteractionMin, ZInteractionMax> type;
+    };
+    template <> struct BinaryParameters<Frequency> {
+      typedef ParameterList<LowPass, HighPass> type;
+    };
+    template <> struct BinaryParameters<SpeakerPosition> {
+      typedef ParameterList<Azimuth, AzimuthMin, AzimuthMax, Elevation,
+                            ElevationMin, ElevationMax, Distance,
+                            DistanceMin, DistanceMax, ScreenEdgeLock> type;
+    };
+    template <> struct BinaryParameters<SphericalPosition> {
+      typedef ParameterList<Azimuth, Elevation, Distance,
+                            ScreenEdgeLock> type;
+    };
+    template <> struct BinaryParameters<CartesianPosition> {
+      typedef ParameterList<X, Y, Z, ScreenEdgeLock> type;
+    };
+    template <> struct BinaryParameters<ScreenEdgeLock> {
+      typedef ParameterList<HorizontalEdge, VerticalEdge> type;
+    };
+    template <> struct BinaryParameters<ChannelLock> {
+      typedef ParameterList<ChannelLockFlag, MaxDistance> type;
+    };
+    template <> struct BinaryParameters<ObjectDivergence> {
+      typedef ParameterList<Divergence, AzimuthRange, PositionRange> type;
+    };
+    template <> struct BinaryParameters<JumpPosition> {
+      typedef ParameterList<JumpPositionFlag, InterpolationLength> type;
+    };
+    // clang-format on
+
+    /// Bit of @a Parameter in the presence mask of @a ParameterList
+    template <typename Parameter>
+    constexpr std::uint32_t parameterBit(ParameterList<>) {
+      return 0;
+    }
+    template <typename Parameter, typename First, typename... Rest>
+    constexpr std::uint32_t parameterBit(ParameterList<First, Rest...>) {
+      return std::is_same<Parameter, First>::value
+                 ? 1u
+                 : parameterBit<Parameter>(ParameterList<Rest...>()) << 1;
+    }
+
+    template <typename Parameter, typename Element>
+    bool isStored(const Element& element) {
+      return element.template has<Parameter>() &&
+             !element.template isDefault<Parameter>();
+    }
+
+    // ---- writing ---- //
+
+    /// Appends little endian values to a buffer
+    class BinaryWriter {
+     public:
+      explicit BinaryWriter(std::vector<char>& buffer) : buffer_(buffer) {}
+
+      void writeUnsigned(std::uint64_t value, std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+          buffer_.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+      }
+
+      void writeBytes(const char* data, std::size_t size) {
+        buffer_.insert(buffer_.end(), data, data + size);
+      }
+
+     private:
+      std::vector<char>& buffer_;
+    };
+
+    void writeUint32(BinaryWriter& writer, std::size_t value) {
+      if (value > 0xffffffffu) {
+        throw std::runtime_error("value too large for binary ADM format");
+      }
+      writer.writeUnsigned(value, 4);
+    }
+
+    void writeValue(BinaryWriter& writer, bool value) {
+      writer.writeUnsigned(value ? 1 : 0, 1);
+    }
+    void writeValue(BinaryWriter& writer, int value) {
+      writer.writeUnsigned(static_cast<std::uint32_t>(value), 4);
+    }
+    void writeValue(BinaryWriter& writer, unsigned value) {
+      writer.writeUnsigned(value, 4);
+    }
+    void writeValue(BinaryWriter& writer, float value) {
+      std::uint32_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      writer.writeUnsigned(bits, 4);
+    }
+    void writeValue(BinaryWriter& writer, double value) {
+      std::uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      writer.writeUnsigned(bits, 8);
+    }
+    void writeValue(BinaryWriter& writer, std::chrono::nanoseconds value) {
+      writer.writeUnsigned(static_cast<std::uint64_t>(value.count()), 8);
+    }
+    void writeValue(BinaryWriter& writer, const std::string& value) {
+      writeUint32(writer, value.size());
+      writer.writeBytes(value.data(), value.size());
+    }
+
+    template <typename T, typename Tag, typename Validator>
+    void writeValue(BinaryWriter& writer,
+                    const detail::NamedType<T, Tag, Validator>& value) {
+      writeValue(writer, value.get());
+    }
+
+    template <typename T>
+    void writeValue(BinaryWriter& writer, const std::vector<T>& values) {
+      writeUint32(writer, values.size());
+      for (const auto& value : values) {
+        writeValue(writer, value);
+      }
+    }
+
+    template <typename Element>
+    std::uint32_t presenceMask(const Element&, ParameterList<>) {
+      return 0;
+    }
+    template <typename Element, typename First, typename... Rest>
+    std::uint32_t presenceMask(const Element& element,
+                               ParameterList<First, Rest...>) {
+      return (isStored<First>(element) ? 1u : 0u) |
+             presenceMask(element, ParameterList<Rest...>()) << 1;
+    }
+
+    template <typename Element>
+    void writeStored(BinaryWriter&, const Element&, ParameterList<>) {}
+    template <typename Element, typename First, typename... Rest>
+    void writeStored(BinaryWriter& writer, const Element& element,
+                     ParameterList<First, Rest...>) {
+      if (isStored<First>(element)) {
+        writeValue(writer, element.template get<First>());
+      }
+      writeStored(writer, element, ParameterList<Rest...>());
+    }
+
+    /// Element or compound parameter: presence mask and stored parameters
+    template <typename Element>
+    void writeValue(BinaryWriter& writer, const Element& element) {
+      typedef typename BinaryParameters<Element>::type Parameters;
+      writer.writeUnsigned(presenceMask(element, Parameters()), 4);
+      writeStored(writer, element, Parameters());
+    }
+
+    /// Parameters needed to create an element
+    template <typename Element>
+    void writeCreationParameters(BinaryWriter&, const Element&) {}
+    void writeCreationParameters(BinaryWriter& writer,
+                                 const AudioPackFormat& element) {
+      writeValue(writer, element.get<TypeDescriptor>());
+    }
+    void writeCreationParameters(BinaryWriter& writer,
+                                 const AudioChannelFormat& element) {
+      writeValue(writer, element.get<TypeDescriptor>());
+    }
+    void writeCreationParameters(BinaryWriter& writer,
+                                 const AudioStreamFormat& element) {
+      writeValue(writer, element.get<FormatDescriptor>());
+    }
+    void writeCreationParameters(BinaryWriter& writer,
+                                 const AudioTrackFormat& element) {
+      writeValue(writer, element.get<FormatDescriptor>());
+    }
+
+    template <typename BlockFormat>
+    void writeBlockFormats(BinaryWriter& writer,
+                           const AudioChannelFormat& channelFormat) {
+      auto blockFormats = channelFormat.getElements<BlockFormat>();
+      writeUint32(writer, blockFormats.size());
+      for (const auto& blockFormat : blockFormats) {
+        writeValue(writer, blockFormat);
+      }
+    }
+
+    template <typename Element>
+    void writeChildren(BinaryWriter&, const Element&) {}
+    void writeChildren(BinaryWriter& writer,
+                       const AudioChannelFormat& channelFormat) {
+      writeBlockFormats<AudioBlockFormatDirectSpeakers>(writer, channelFormat);
+      writeBlockFormats<AudioBlockFormatMatrix>(writer, channelFormat);
+      writeBlockFormats<AudioBlockFormatObjects>(writer, channelFormat);
+      writeBlockFormats<AudioBlockFormatHoa>(writer, channelFormat);
+      writeBlockFormats<AudioBlockFormatBinaural>(writer, channelFormat);
+    }
+
+    /// Position of every element within the table of its type
+    class ElementIndices {
+     public:
+      template <typename Element>
+      void add(const Element& elements) {
+        std::uint32_t index = 0;
+        for (const auto& element : elements) {
+          indices_[element.get()] = index++;
+        }
+      }
+
+      std::uint32_t get(const void* element) const {
+        auto it = indices_.find(element);
+        if (it == indices_.end()) {
+          throw std::runtime_error(
+              "referenced ADM element is not part of the document");
+        }
+        return it->second;
+      }
+
+     private:
+      std::unordered_map<const void*, std::uint32_t> indices_;
+    };
+
+    template <typename Element>
+    void writeElements(BinaryWriter& writer, const Document& document,
+                       ElementIndices& indices) {
+      auto elements = document.getElements<Element>();
+      indices.add(elements);
+      writeUint32(writer, elements.size());
+      for (const auto& element : elements) {
+        writeCreationParameters(writer, *element);
+        writeValue(writer, *element);
+        writeChildren(writer, *element);
+      }
+    }
+
+    template <typename Element>
+    void writeReference(BinaryWriter& writer, const ElementIndices& indices,
+                        const std::shared_ptr<const Element>& reference) {
+      writer.writeUnsigned(reference ? indices.get(reference.get()) + 1 : 0,
+                           4);
+    }
+
+    template <typename Range>
+    void writeReferences(BinaryWriter& writer, const ElementIndices& indices,
+                         const Range& references) {
+      writeUint32(writer, references.size());
+      for (const auto& reference : references) {
+        writer.writeUnsigned(indices.get(reference.get()), 4);
+      }
+    }
+
+    void writeReferences(BinaryWriter& writer, const Document& document,
+                         const ElementIndices& indices) {
+      for (auto programme : document.getElements<AudioProgramme>()) {
+        writeReferences(writer, indices,
+                        programme->getReferences<AudioContent>());
+      }
+      for (auto content : document.getElements<AudioContent>()) {
+        writeReferences(writer, indices,
+                        content->getReferences<AudioObject>());
+      }
+      for (auto object : document.getElements<AudioObject>()) {
+        writeReferences(writer, indices, object->getReferences<AudioObject>());
+        writeReferences(writer, indices,
+                        object->getReferences<AudioPackFormat>());
+        writeReferences(writer, indices,
+                        object->getReferences<AudioTrackUid>());
+        writeReferences(writer, indices, object->getComplementaryObjects());
+      }
+      for (auto packFormat : document.getElements<AudioPackFormat>()) {
+        writeReferences(writer, indices,
+                        packFormat->getReferences<AudioPackFormat>());
+        writeReferences(writer, indices,
+                        packFormat->getReferences<AudioChannelFormat>());
+      }
+      for (auto streamFormat : document.getElements<AudioStreamFormat>()) {
+        writeReference(writer, indices,
+                       streamFormat->getReference<AudioPackFormat>());
+        writeReference(writer, indices,
+                       streamFormat->getReference<AudioChannelFormat>());
+        std::vector<std::shared_ptr<const AudioTrackFormat>> trackFormats;
+        for (auto& weakReference :
+             streamFormat->getAudioTrackFormatReferences()) {
+          if (auto reference = weakReference.lock()) {
+            trackFormats.push_back(reference);
+          }
+        }
+        writeReferences(writer, indices, trackFormats);
+      }
+      for (auto trackFormat : document.getElements<AudioTrackFormat>()) {
+        writeReference(writer, indices,
+                       trackFormat->getReference<AudioStreamFormat>());
+      }
+      for (auto trackUid : document.getElements<AudioTrackUid>()) {
+        writeReference(writer, indices,
+                       trackUid->getReference<AudioTrackFormat>());
+        writeReference(writer, indices,
+                       trackUid->getReference<AudioPackFormat>());
+      }
+    }
+
+    // ---- reading ---- //
+
+    /// Reads little endian values from a buffer, checking its bounds
+    class BinaryReader {
+     public:
+      BinaryReader(const char* data, std::size_t size)
+          : position_(data), end_(data + size) {}
+
+      const char* readBytes(std::size_t size) {
+        if (size > static_cast<std::size_t>(end_ - position_)) {
+          throw std::runtime_error("binary ADM data is truncated");
+        }
+        auto data = position_;
+        position_ += size;
+        return data;
+      }
+
+      std::uint64_t readUnsigned(std::size_t size) {
+        auto data = reinterpret_cast<const unsigned char*>(readBytes(size));
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+          value |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+        }
+        return value;
+      }
+
+      std::size_t remaining() const {
+        return static_cast<std::size_t>(end_ - position_);
+      }
+
+     private:
+      const char* position_;
+      const char* end_;
+    };
+
+    std::uint32_t readUint32(BinaryReader& reader) {
+      return static_cast<std::uint32_t>(reader.readUnsigned(4));
+    }
+
+    bool readValue(BinaryReader& reader, Type<bool>) {
+      return reader.readUnsigned(1) != 0;
+    }
+    int readValue(BinaryReader& reader, Type<int>) {
+      return static_cast<int>(readUint32(reader));
+    }
+    unsigned readValue(BinaryReader& reader, Type<unsigned>) {
+      return readUint32(reader);
+    }
+    float readValue(BinaryReader& reader, Type<float>) {
+      auto bits = readUint32(reader);
+      float value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+    double readValue(BinaryReader& reader, Type<double>) {
+      auto bits = reader.readUnsigned(8);
+      double value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+    std::chrono::nanoseconds readValue(BinaryReader& reader,
+                                       Type<std::chrono::nanoseconds>) {
+      return std::chrono::nanoseconds(
+          static_cast<std::int64_t>(reader.readUnsigned(8)));
+    }
+    std::string readValue(BinaryReader& reader, Type<std::string>) {
+      auto size = readUint32(reader);
+      return std::string(reader.readBytes(size), size);
+    }
+
+    template <typename T, typename Tag, typename Validator>
+    detail::NamedType<T, Tag, Validator> readValue(
+        BinaryReader& reader, Type<detail::NamedType<T, Tag, Validator>>) {
+      return detail::NamedType<T, Tag, Validator>(readValue(reader, Type<T>()));
+    }
+
+    template <typename T>
+    std::vector<T> readValue(BinaryReader& reader, Type<std::vector<T>>) {
+      auto size = readUint32(reader);
+      std::vector<T> values;
+      values.reserve(std::min<std::size_t>(size, reader.remaining()));
+      for (std::uint32_t i = 0; i < size; ++i) {
+        values.push_back(readValue(reader, Type<T>()));
+      }
+      return values;
+    }
+
+    /// Value which is overwritten by the stored parameters
+    template <typename T>
+    T makeDefault(Type<T>) {
+      return T();
+    }
+    AudioObjectInteraction makeDefault(Type<AudioObjectInteraction>) {
+      return AudioObjectInteraction(OnOffInteract(false));
+    }
+    AudioBlockFormatObjects makeDefault(Type<AudioBlockFormatObjects>) {
+      return AudioBlockFormatObjects(SphericalPosition());
+    }
+
+    template <typename Element, typename Parameter>
+    void setValue(Element& element, Parameter value) {
+      element.set(std::move(value));
+    }
+    void setValue(AudioBlockFormatDirectSpeakers& blockFormat,
+                  const SpeakerLabels& labels) {
+      for (const auto& label : labels) {
+        blockFormat.add(label);
+      }
+    }
+
+    template <typename Element>
+    void readStored(BinaryReader&, Element&, std::uint32_t, ParameterList<>) {
+    }
+    template <typename Element, typename First, typename... Rest>
+    void readStored(BinaryReader& reader, Element& element, std::uint32_t mask,
+                    ParameterList<First, Rest...>) {
+      if (mask & 1u) {
+        setValue(element, readValue(reader, Type<First>()));
+      }
+      readStored(reader, element, mask >> 1, ParameterList<Rest...>());
+    }
+
+    /// Read the stored parameters into @a element; returns the presence mask
+    template <typename Element>
+    std::uint32_t readParameters(BinaryReader& reader, Element& element) {
+      typedef typename BinaryParameters<Element>::type Parameters;
+      auto mask = readUint32(reader);
+      readStored(reader, element, mask, Parameters());
+      return mask;
+    }
+
+    template <typename T>
+    T readValue(BinaryReader& reader, Type<T>) {
+      auto value = makeDefault(Type<T>());
+      readParameters(reader, value);
+      return value;
+    }
+
+    AudioBlockFormatObjects readValue(BinaryReader& reader,
+                                      Type<AudioBlockFormatObjects>) {
+      typedef BinaryParameters<AudioBlockFormatObjects>::type Parameters;
+      auto blockFormat = makeDefault(Type<AudioBlockFormatObjects>());
+      auto mask = readParameters(reader, blockFormat);
+      if (!(mask & parameterBit<Cartesian>(Parameters()))) {
+        blockFormat.unset<Cartesian>();
+      }
+      return blockFormat;
+    }
+
+    std::shared_ptr<AudioProgramme> createElement(BinaryReader&,
+                                                  Type<AudioProgramme>) {
+      return AudioProgramme::create(AudioProgrammeName(""));
+    }
+    std::shared_ptr<AudioContent> createElement(BinaryReader&,
+                                                Type<AudioContent>) {
+      return AudioContent::create(AudioContentName(""));
+    }
+    std::shared_ptr<AudioObject> createElement(BinaryReader&,
+                                               Type<AudioObject>) {
+      return AudioObject::create(AudioObjectName(""));
+    }
+    std::shared_ptr<AudioPackFormat> createElement(BinaryReader& reader,
+                                                   Type<AudioPackFormat>) {
+      auto typeDescriptor = readValue(reader, Type<TypeDescriptor>());
+      return AudioPackFormat::create(AudioPackFormatName(""), typeDescriptor);
+    }
+    std::shared_ptr<AudioChannelFormat> createElement(
+        BinaryReader& reader, Type<AudioChannelFormat>) {
+      auto typeDescriptor = readValue(reader, Type<TypeDescriptor>());
+      return AudioChannelFormat::create(AudioChannelFormatName(""),
+                                        typeDescriptor);
+    }
+    std::shared_ptr<AudioStreamFormat> createElement(BinaryReader& reader,
+                                                     Type<AudioStreamFormat>) {
+      auto formatDescriptor = readValue(reader, Type<FormatDescriptor>());
+      return AudioStreamFormat::create(AudioStreamFormatName(""),
+                                       formatDescriptor);
+    }
+    std::shared_ptr<AudioTrackFormat> createElement(BinaryReader& reader,
+                                                    Type<AudioTrackFormat>) {
+      auto formatDescriptor = readValue(reader, Type<FormatDescriptor>());
+      return AudioTrackFormat::create(AudioTrackFormatName(""),
+                                      formatDescriptor);
+    }
+    std::shared_ptr<AudioTrackUid> createElement(BinaryReader&,
+                                                 Type<AudioTrackUid>) {
+      return AudioTrackUid::create();
+    }
+
+    template <typename BlockFormat>
+    void readBlockFormats(BinaryReader& reader,
+                          AudioChannelFormat& channelFormat) {
+      // AudioChannelFormat::add() checks the ID against all the
+      // audioBlockFormats added before, which is quadratic; saved IDs are
+      // normally unique, so that only duplicates and missing IDs need it
+      const AudioChannelFormat& constChannelFormat = channelFormat;
+      std::unordered_set<AudioBlockFormatId> ids;
+      auto size = readUint32(reader);
+      for (std::uint32_t i = 0; i < size; ++i) {
+        auto blockFormat = readValue(reader, Type<BlockFormat>());
+        auto id = blockFormat.template get<AudioBlockFormatId>();
+        if (!isUndefined(id) && ids.insert(id).second) {
+          detail::BinaryLoader::addWithUnusedId(channelFormat, blockFormat);
+        } else {
+          channelFormat.add(blockFormat);
+          ids.insert(constChannelFormat.getElements<BlockFormat>()
+                         .back()
+                         .template get<AudioBlockFormatId>());
+        }
+      }
+    }
+
+    template <typename Element>
+    void readChildren(BinaryReader&, Element&) {}
+    void readChildren(BinaryReader& reader, AudioChannelFormat& channelFormat) {
+      readBlockFormats<AudioBlockFormatDirectSpeakers>(reader, channelFormat);
+      readBlockFormats<AudioBlockFormatMatrix>(reader, channelFormat);
+      readBlockFormats<AudioBlockFormatObjects>(reader, channelFormat);
+      readBlockFormats<AudioBlockFormatHoa>(reader, channelFormat);
+      readBlockFormats<AudioBlockFormatBinaural>(reader, channelFormat);
+    }
+
+    /// Read elements, which are appended to @a added to be added to the
+    /// document at once
+    ///
+    /// Document::add assigns an ID to elements without one, which would not
+    /// be there in the saved document; @a restoreIds undoes that.
+    template <typename Element>
+    std::vector<std::shared_ptr<Element>> readElements(
+        BinaryReader& reader, std::vector<ElementVariant>& added,
+        std::vector<std::function<void()>>& restoreIds) {
+      auto size = readUint32(reader);
+      std::vector<std::shared_ptr<Element>> elements;
+      elements.reserve(std::min<std::size_t>(size, reader.remaining()));
+      for (std::uint32_t i = 0; i < size; ++i) {
+        auto element = createElement(reader, Type<Element>());
+        readParameters(reader, *element);
+        readChildren(reader, *element);
+        added.push_back(element);
+        auto id = element->template get<typename Element::id_type>();
+        if (isUndefined(id)) {
+          restoreIds.push_back([element, id]() { element->set(id); });
+        }
+        elements.push_back(std::move(element));
+      }
+      return elements;
+    }
+
+    template <typename Element>
+    std::shared_ptr<Element> readReference(
+        BinaryReader& reader,
+        const std::vector<std::shared_ptr<Element>>& elements) {
+      auto index = readUint32(reader);
+      if (index >= elements.size()) {
+        throw std::runtime_error("invalid reference in binary ADM data");
+      }
+      return elements[index];
+    }
+
+    template <typename Element>
+    std::shared_ptr<Element> readOptionalReference(
+        BinaryReader& reader,
+        const std::vector<std::shared_ptr<Element>>& elements) {
+      auto index = readUint32(reader);
+      if (index > elements.size()) {
+        throw std::runtime_error("invalid reference in binary ADM data");
+      }
+      return index ? elements[index - 1] : nullptr;
+    }
+
+    template <typename Element, typename Reference>
+    void readReferences(
+        BinaryReader& reader, Element& element,
+        const std::vector<std::shared_ptr<Reference>>& references) {
+      auto size = readUint32(reader);
+      for (std::uint32_t i = 0; i < size; ++i) {
+        element->addReference(readReference(reader, references));
+      }
+    }
+
+  }  // namespace
+
+  void saveBinary(std::vector<char>& buffer,
+                  std::shared_ptr<const Document> document) {
+    BinaryWriter writer(buffer);
+    writer.writeBytes(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    writer.writeUnsigned(BINARY_FORMAT_VERSION, 4);
+    ElementIndices indices;
+    writeElements<AudioProgramme>(writer, *document, indices);
+    writeElements<AudioContent>(writer, *document, indices);
+    writeElements<AudioObject>(writer, *document, indices);
+    writeElements<AudioPackFormat>(writer, *document, indices);
+    writeElements<AudioChannelFormat>(writer, *document, indices);
+    writeElements<AudioStreamFormat>(writer, *document, indices);
+    writeElements<AudioTrackFormat>(writer, *document, indices);
+    writeElements<AudioTrackUid>(writer, *document, indices);
+    writeReferences(writer, *document, indices);
+  }
+
+  void saveBinary(std::ostream& stream,
+                  std::shared_ptr<const Document> document) {
+    std::vector<char> buffer;
+    saveBinary(buffer, document);
+    stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  }
+
+  void saveBinary(const std::string& filename,
+                  std::shared_ptr<const Document> document) {
+    std::ofstream stream(filename, std::ios::binary);
+    if (!stream) {
+      throw std::runtime_error("cannot open file: " + filename);
+    }
+    saveBinary(stream, document);
+  }
+
+  std::shared_ptr<Document> loadBinary(const char* data, std::size_t size) {
+    BinaryReader reader(data, size);
+    if (size < sizeof(BINARY_MAGIC) ||
+        std::memcmp(reader.readBytes(sizeof(BINARY_MAGIC)), BINARY_MAGIC,
+                    sizeof(BINARY_MAGIC)) != 0) {
+      throw std::runtime_error("not a binary ADM snapshot");
+    }
+    auto version = readUint32(reader);
+    if (version != BINARY_FORMAT_VERSION) {
+      throw std::runtime_error("unsupported binary ADM format version " +
+                               std::to_string(version));
+    }
+
+    // all elements are added before any references are set, so that the
+    // referenced elements are already in the document
+    std::vector<ElementVariant> added;
+    std::vector<std::function<void()>> restoreIds;
+    auto programmes = readElements<AudioProgramme>(reader, added, restoreIds);
+    auto contents = readElements<AudioContent>(reader, added, restoreIds);
+    auto objects = readElements<AudioObject>(reader, added, restoreIds);
+    auto packFormats = readElements<AudioPackFormat>(reader, added, restoreIds);
+    auto channelFormats =
+        readElements<AudioChannelFormat>(reader, added, restoreIds);
+    auto streamFormats =
+        readElements<AudioStreamFormat>(reader, added, restoreIds);
+    auto trackFormats =
+        readElements<AudioTrackFormat>(reader, added, restoreIds);
+    auto trackUids = readElements<AudioTrackUid>(reader, added, restoreIds);
+    auto document = Document::create();
+    document->add(added);
+    for (auto& restoreId : restoreIds) {
+      restoreId();
+    }
+
+    for (auto& programme : programmes) {
+      readReferences(reader, programme, contents);
+    }
+    for (auto& content : contents) {
+      readReferences(reader, content, objects);
+    }
+    for (auto& object : objects) {
+      readReferences(reader, object, objects);
+      readReferences(reader, object, packFormats);
+      readReferences(reader, object, trackUids);
+      auto size = readUint32(reader);
+      for (std::uint32_t i = 0; i < size; ++i) {
+        object->addComplementary(readReference(reader, objects));
+      }
+    }
+    for (auto& packFormat : packFormats) {
+      readReferences(reader, packFormat, packFormats);
+      readReferences(reader, packFormat, channelFormats);
+    }
+    for (auto& streamFormat : streamFormats) {
+      if (auto packFormat = readOptionalReference(reader, packFormats)) {
+        streamFormat->setReference(packFormat);
+      }
+      if (auto channelFormat = readOptionalReference(reader, channelFormats)) {
+        streamFormat->setReference(channelFormat);
+      }
+      auto size = readUint32(reader);
+      for (std::uint32_t i = 0; i < size; ++i) {
+        streamFormat->addReference(std::weak_ptr<AudioTrackFormat>(
+            readReference(reader, trackFormats)));
+      }
+    }
+    for (auto& trackFormat : trackFormats) {
+      if (auto streamFormat = readOptionalReference(reader, streamFormats)) {
+        trackFormat->setReference(streamFormat);
+      }
+    }
+    for (auto& trackUid : trackUids) {
+      if (auto trackFormat = readOptionalReference(reader, trackFormats)) {
+        trackUid->setReference(trackFormat);
+      }
+      if (auto packFormat = readOptionalReference(reader, packFormats)) {
+        trackUid->setReference(packFormat);
+      }
+    }
+
+    if (reader.remaining() != 0) {
+      throw std::runtime_error("unexpected data after binary ADM snapshot");
+    }
+    return document;
+  }
+
+  std::shared_ptr<Document> loadBinary(std::istream& stream) {
+    std::vector<char> buffer((std::istreambuf_iterator<char>(stream)),
+                             std::istreambuf_iterator<char>());
+    return loadBinary(buffer.data(), buffer.size());
+  }
+
+  std::shared_ptr<Document> loadBinary(const std::string& filename) {
+    std::ifstream stream(filename, std::ios::binary);
+    if (!stream) {
+      throw std::runtime_error("cannot open file: " + filename);
+    }
+    return loadBinary(stream);
+  }
+
+  namespace detail {
+
+    namespace {
+      template <typename Element>
+      void encode(std::vector<char>& buffer, const Element& element) {
+        BinaryWriter writer(buffer);
+        writeCreationParameters(writer, element);
+        writeValue(writer, element);
+      }
+
+      /// the ID is always the first parameter of an element
+      template <typename Element, typename Id, typename... Rest>
+      void encodeWithoutId(std::vector<char>& buffer, const Element& element,
+                           ParameterList<Id, Rest...>) {
+        BinaryWriter writer(buffer);
+        writeCreationParameters(writer, element);
+        writer.writeUnsigned(presenceMask(element, ParameterList<Rest...>()),
+                             4);
+        writeStored(writer, element, ParameterList<Rest...>());
+      }
+
+      template <typename Element>
+      void encodeWithoutId(std::vector<char>& buffer, const Element& element) {
+        encodeWithoutId(buffer, element,
+                        typename BinaryParameters<Element>::type());
+      }
+    }  // namespace
+
+    // clang-format off
+    void encodeParameters(std::vector<char>& buffer, const AudioProgramme& element) { encode(buffer, element); }
+    void encodeParameters(std::vector<char>& buffer, const AudioContent& element) { encode(buffer, element); }
+    void encodeParameters(std::vector<char>& buffer, const AudioObject& element) { encode(buffer, element); }
+    void encodeParameters(std::vector<char>& buffer, const AudioPackFormat& element) { encode(buffer, element); }
+    void encodeParameters(std::vector<char>& buffer, const AudioChannelFormat& element) { encode(buffer, element); }
+    void encodeParameters(std::vector<char>& buffer, const AudioStreamFormat& element) { encode(buffer, element); }
+    void encodeParameters(std::vector<char>& buffer, const AudioTrackFormat& element) { encode(buffer, element); }
+    void encodeParameters(std::vector<char>& buffer, const AudioTrackUid& element) { encode(buffer, element); }
+    void encodeParameters(std::vector<char>& buffer, const AudioBlockFormatDirectSpeakers& blockFormat) { encode(buffer, blockFormat); }
+    void encodeParameters(std::vector<char>& buffer, const AudioBlockFormatMatrix& blockFormat) { encode(buffer, blockFormat); }
+    void encodeParameters(std::vector<char>& buffer, const AudioBlockFormatObjects& blockFormat) { encode(buffer, blockFormat); }
+    void encodeParameters(std::vector<char>& buffer, const AudioBlockFormatHoa& blockFormat) { encode(buffer, blockFormat); }
+    void encodeParameters(std::vector<char>& buffer, const AudioBlockFormatBinaural& blockFormat) { encode(buffer, blockFormat); }
+
+    void encodeParametersWithoutId(std::vector<char>& buffer, const AudioPackFormat& element) { encodeWithoutId(buffer, element); }
+    void encodeParametersWithoutId(std::vector<char>& buffer, const AudioChannelFormat& element) { encodeWithoutId(buffer, element); }
+    void encodeParametersWithoutId(std::vector<char>& buffer, const AudioStreamFormat& element) { encodeWithoutId(buffer, element); }
+    void encodeParametersWithoutId(std::vector<char>& buffer, const AudioTrackFormat& element) { encodeWithoutId(buffer, element); }
+    void encodeParametersWithoutId(std::vector<char>& buffer, const AudioBlockFormatDirectSpeakers& blockFormat) { encodeWithoutId(buffer, blockFormat); }
+    void encodeParametersWithoutId(std::vector<char>& buffer, const AudioBlockFormatMatrix& blockFormat) { encodeWithoutId(buffer, blockFormat); }
+    void encodeParametersWithoutId(std::vector<char>& buffer, const AudioBlockFormatObjects& blockFormat) { encodeWithoutId(buffer, blockFormat); }
+    void encodeParametersWithoutId(std::vector<char>& buffer, const AudioBlockFormatHoa& blockFormat) { encodeWithoutId(buffer, blockFormat); }
+    void encodeParametersWithoutId(std::vector<char>& buffer, const AudioBlockFormatBinaural& blockFormat) { encodeWithoutId(buffer, blockFormat); }
+    // clang-format on
+
+  }  // namespace detail
+
+}  // namespace adm
@@ -0,0 +1,319 @@
+#include "adm/bw64.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "adm/common_definitions.hpp"
+#include "adm/detail/number_formatting.hpp"
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/private/mapped_file.hpp"
+#include "adm/private/xml_parser.hpp"
+
+namespace adm {
+
+  namespace {
+    /// size of an `audioID` entry in the `chna` chunk
+    const std::size_t CHNA_ENTRY_SIZE = 40;
+    /// value of a 32 bit chunk size which is stored in the `ds64` chunk
+    const std::uint32_t DS64_SIZE = 0xFFFFFFFF;
+
+    std::uint16_t readUint16(const char* data) {
+      auto bytes = reinterpret_cast<const unsigned char*>(data);
+      return static_cast<std::uint16_t>(bytes[0] | bytes[1] << 8);
+    }
+
+    std::uint32_t readUint32(const char* data) {
+      auto bytes = reinterpret_cast<const unsigned char*>(data);
+      return static_cast<std::uint32_t>(bytes[0]) |
+             static_cast<std::uint32_t>(bytes[1]) << 8 |
+             static_cast<std::uint32_t>(bytes[2]) << 16 |
+             static_cast<std::uint32_t>(bytes[3]) << 24;
+    }
+
+    std::uint64_t readUint64(const char* data) {
+      return static_cast<std::uint64_t>(readUint32(data)) |
+             static_cast<std::uint64_t>(readUint32(data + 4)) << 32;
+    }
+
+    /// String in a fixed size field, which is padded with NULs
+    std::string readField(const char* data, std::size_t size) {
+      auto end = std::find(data, data + size, '\0');
+      return std::string(data, end);
+    }
+
+    void writeUint16(char* data, std::uint16_t value) {
+      data[0] = static_cast<char>(value & 0xff);
+      data[1] = static_cast<char>(value >> 8);
+    }
+
+    /// Format @a id into the fixed size @a field, which is padded with NULs
+    template <typename Id, std::size_t Size>
+    void formatField(char (&field)[Size], const Id& id) {
+      char buffer[detail::FORMAT_BUFFER_SIZE];
+      auto size = std::min(formatId(buffer, id), Size);
+      std::memcpy(field, buffer, size);
+    }
+
+    void readExactly(std::istream& stream, char* data, std::size_t size,
+                     const std::string& filename) {
+      stream.read(data, static_cast<std::streamsize>(size));
+      if (static_cast<std::size_t>(stream.gcount()) != size) {
+        throw std::runtime_error("unexpected end of file " + filename);
+      }
+    }
+
+    /// Contents of the `ds64` chunk of RF64 and BW64 files
+    struct Ds64 {
+      std::uint64_t dataSize = 0;
+      std::vector<std::pair<std::string, std::uint64_t>> table;
+    };
+
+    Ds64 parseDs64(const std::vector<char>& data) {
+      // riffSize, dataSize, sampleCount, tableLength
+      if (data.size() < 28) {
+        throw std::runtime_error("ds64 chunk too short");
+      }
+      Ds64 ds64;
+      ds64.dataSize = readUint64(data.data() + 8);
+      auto tableLength = readUint32(data.data() + 24);
+      if ((data.size() - 28) / 12 < tableLength) {
+        throw std::runtime_error("ds64 chunk too short");
+      }
+      for (std::uint32_t i = 0; i < tableLength; ++i) {
+        auto entry = data.data() + 28 + 12 * i;
+        ds64.table.emplace_back(std::string(entry, 4), readUint64(entry + 4));
+      }
+      return ds64;
+    }
+
+    std::uint64_t lookupSize(const Ds64& ds64, const std::string& id) {
+      if (id == "data") {
+        return ds64.dataSize;
+      }
+      for (auto& entry : ds64.table) {
+        if (entry.first == id) {
+          return entry.second;
+        }
+      }
+      throw std::runtime_error("size of chunk " + id + " missing in ds64");
+    }
+  }  // namespace
+
+  std::vector<ChnaEntry> parseChna(const char* data, std::size_t size) {
+    if (size < 4) {
+      throw std::runtime_error("chna chunk too short");
+    }
+    auto uidCount = readUint16(data + 2);
+    if ((size - 4) / CHNA_ENTRY_SIZE < uidCount) {
+      throw std::runtime_error("chna chunk too short");
+    }
+    std::vector<ChnaEntry> entries;
+    entries.reserve(uidCount);
+    for (std::size_t i = 0; i < uidCount; ++i) {
+      auto audioId = data + 4 + CHNA_ENTRY_SIZE * i;
+      ChnaEntry entry;
+      entry.trackIndex = readUint16(audioId);
+      if (entry.trackIndex == 0) {
+        continue;
+      }
+      entry.audioTrackUidId = parseAudioTrackUidId(readField(audioId + 2, 12));
+      auto trackRef = readField(audioId + 14, 14);
+      if (trackRef.compare(0, 3, "AC_") == 0) {
+        entry.audioChannelFormatId = parseAudioChannelFormatId(trackRef);
+      } else if (!trackRef.empty()) {
+        entry.audioTrackFormatId = parseAudioTrackFormatId(trackRef);
+      }
+      auto packRef = readField(audioId + 28, 11);
+      if (!packRef.empty()) {
+        entry.audioPackFormatId = parseAudioPackFormatId(packRef);
+      }
+      entries.push_back(entry);
+    }
+    return entries;
+  }
+
+  std::vector<ChnaEntry> createChnaEntries(
+      std::shared_ptr<const Document> document) {
+    auto trackUids = document->getElements<AudioTrackUid>();
+    if (trackUids.size() > 0xFFFF) {
+      throw std::runtime_error("too many audioTrackUIDs for a chna chunk");
+    }
+    std::vector<ChnaEntry> entries;
+    entries.reserve(trackUids.size());
+    std::uint16_t trackIndex = 0;
+    for (auto& trackUid : trackUids) {
+      ChnaEntry entry;
+      entry.trackIndex = ++trackIndex;
+      entry.audioTrackUidId = trackUid->get<AudioTrackUidId>();
+      if (auto trackFormat = trackUid->getReference<AudioTrackFormat>()) {
+        entry.audioTrackFormatId = trackFormat->get<AudioTrackFormatId>();
+      }
+      if (auto packFormat = trackUid->getReference<AudioPackFormat>()) {
+        entry.audioPackFormatId = packFormat->get<AudioPackFormatId>();
+      }
+      entries.push_back(entry);
+    }
+    return entries;
+  }
+
+  ChnaAudioId makeChnaAudioId(const ChnaEntry& entry) {
+    ChnaAudioId audioId = {};
+    audioId.trackIndex = entry.trackIndex;
+    formatField(audioId.audioTrackUid, entry.audioTrackUidId);
+    if (entry.audioTrackFormatId) {
+      formatField(audioId.trackReference, *entry.audioTrackFormatId);
+    } else if (entry.audioChannelFormatId) {
+      formatField(audioId.trackReference, *entry.audioChannelFormatId);
+    }
+    if (entry.audioPackFormatId) {
+      formatField(audioId.packReference, *entry.audioPackFormatId);
+    }
+    return audioId;
+  }
+
+  std::vector<ChnaAudioId> createChnaAudioIds(
+      std::shared_ptr<const Document> document) {
+    auto entries = createChnaEntries(std::move(document));
+    std::vector<ChnaAudioId> audioIds;
+    audioIds.reserve(entries.size());
+    for (auto& entry : entries) {
+      audioIds.push_back(makeChnaAudioId(entry));
+    }
+    return audioIds;
+  }
+
+  std::vector<char> formatChna(const std::vector<ChnaAudioId>& audioIds) {
+    if (audioIds.size() > 0xFFFF) {
+      throw std::runtime_error("too many entries for a chna chunk");
+    }
+    std::vector<char> data(4 + CHNA_ENTRY_SIZE * audioIds.size());
+    std::vector<bool> usedTracks(0x10000);
+    std::uint16_t trackCount = 0;
+    auto audioIdData = data.data() + 4;
+    for (auto& audioId : audioIds) {
+      if (audioId.trackIndex != 0 && !usedTracks[audioId.trackIndex]) {
+        usedTracks[audioId.trackIndex] = true;
+        ++trackCount;
+      }
+      std::memcpy(audioIdData, &audioId, CHNA_ENTRY_SIZE);
+      writeUint16(audioIdData, audioId.trackIndex);
+      audioIdData += CHNA_ENTRY_SIZE;
+    }
+    writeUint16(data.data(), trackCount);
+    writeUint16(data.data() + 2, static_cast<std::uint16_t>(audioIds.size()));
+    return data;
+  }
+
+  std::vector<char> formatChna(std::shared_ptr<const Document> document) {
+    return formatChna(createChnaAudioIds(std::move(document)));
+  }
+
+  Bw64MetadataReader::Bw64MetadataReader(const std::string& filename)
+      : filename_(filename) {
+    std::ifstream stream(filename, std::ios::binary);
+    if (!stream) {
+      throw std::runtime_error("cannot open file " + filename);
+    }
+    stream.seekg(0, std::ios::end);
+    fileSize_ = static_cast<std::uint64_t>(stream.tellg());
+    stream.seekg(0);
+
+    char header[12];
+    readExactly(stream, header, sizeof(header), filename);
+    auto riffId = std::string(header, 4);
+    if ((riffId != "RIFF" && riffId != "RF64" && riffId != "BW64") ||
+        std::string(header + 8, 4) != "WAVE") {
+      throw std::runtime_error(filename + " is not a RIFF/WAVE file");
+    }
+    bool hasDs64 = riffId != "RIFF";
+    Ds64 ds64;
+
+    // only the chunk headers are read; the chunk data is skipped
+    std::uint64_t position = 12;
+    while (position + 8 <= fileSize_) {
+      char chunkHeader[8];
+      stream.seekg(static_cast<std::streamoff>(position));
+      readExactly(stream, chunkHeader, sizeof(chunkHeader), filename);
+      Bw64Chunk chunk;
+      chunk.id = std::string(chunkHeader, 4);
+      chunk.offset = position + 8;
+      chunk.size = readUint32(chunkHeader + 4);
+      if (chunks_.empty() && hasDs64) {
+        if (chunk.id != "ds64") {
+          throw std::runtime_error("ds64 chunk missing in " + filename);
+        }
+        checkChunkSize(chunk);
+        std::vector<char> data(static_cast<std::size_t>(chunk.size));
+        readExactly(stream, data.data(), data.size(), filename);
+        ds64 = parseDs64(data);
+      } else if (hasDs64 && chunk.size == DS64_SIZE) {
+        chunk.size = lookupSize(ds64, chunk.id);
+      }
+      chunks_.push_back(chunk);
+      // nothing can follow a chunk which extends past the end of the file;
+      // this also keeps the position from overflowing with huge sizes
+      if (chunk.size > fileSize_ - chunk.offset) {
+        break;
+      }
+      // chunks are padded to an even size
+      position = chunk.offset + chunk.size + (chunk.size & 1);
+    }
+  }
+
+  const std::vector<Bw64Chunk>& Bw64MetadataReader::getChunks() const {
+    return chunks_;
+  }
+
+  bool Bw64MetadataReader::hasChunk(const std::string& id) const {
+    return std::any_of(
+        chunks_.begin(), chunks_.end(),
+        [&id](const Bw64Chunk& chunk) { return chunk.id == id; });
+  }
+
+  const Bw64Chunk& Bw64MetadataReader::findChunk(const std::string& id) const {
+    for (auto& chunk : chunks_) {
+      if (chunk.id == id) {
+        return chunk;
+      }
+    }
+    throw std::runtime_error(id + " chunk missing in " + filename_);
+  }
+
+  void Bw64MetadataReader::checkChunkSize(const Bw64Chunk& chunk) const {
+    // the offset is at most the file size, see the constructor
+    if (chunk.size > fileSize_ - chunk.offset) {
+      throw std::runtime_error(chunk.id + " chunk extends past the end of " +
+                               filename_);
+    }
+  }
+
+  std::vector<char> Bw64MetadataReader::readChunk(const std::string& id) const {
+    auto& chunk = findChunk(id);
+    checkChunkSize(chunk);
+    std::ifstream stream(filename_, std::ios::binary);
+    if (!stream) {
+      throw std::runtime_error("cannot open file " + filename_);
+    }
+    std::vector<char> data(static_cast<std::size_t>(chunk.size));
+    stream.seekg(static_cast<std::streamoff>(chunk.offset));
+    readExactly(stream, data.data(), data.size(), filename_);
+    return data;
+  }
+
+  std::shared_ptr<Document> Bw64MetadataReader::parseAxml(
+      xml::ParserOptions options) const {
+    auto& chunk = findChunk("axml");
+    checkChunkSize(chunk);
+    MappedFileRange axml(filename_, chunk.offset,
+                         static_cast<std::size_t>(chunk.size));
+    xml::XmlParser parser(options);
+    return parser.parseInPlace(axml.data(), getCommonDefinitions());
+  }
+
+  std::vector<ChnaEntry> Bw64MetadataReader::readChna() const {
+    auto data = readChunk("chna");
+    return parseChna(data.data(), data.size());
+  }
+
+}  // namespace adm
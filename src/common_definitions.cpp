@@ -152,6 +152,14 @@ namespace adm {
                                    AudioTrackFormatIdCounter(1));
   }
 
+  namespace xml {
+    std::string getCommonDefinitionsXml() {
+      std::stringstream commonDefinitions;
+      getEmbeddedFile("common_definitions.xml", commonDefinitions);
+      return commonDefinitions.str();
+    }
+  }  // namespace xml
+
   std::shared_ptr<Document> getCommonDefinitions() {
     std::stringstream commonDefinitions;
     getEmbeddedFile("common_definitions.xml", commonDefinitions);
@@ -21,14 +21,31 @@ namespace adm {
     }
 
     std::string formatHexValue(unsigned int value, unsigned int nmbOfChars) {
-      std::stringstream stream;
-      stream << std::setfill('0') << std::setw(nmbOfChars) << std::hex << value;
-      if (stream.str().length() > nmbOfChars) {
+      char buffer[FORMAT_BUFFER_SIZE];
+      return std::string(buffer, formatHexValue(buffer, value, nmbOfChars));
+    }
+
+    std::size_t formatHexValue(char* buffer, unsigned int value,
+                               unsigned int nmbOfChars) {
+      static const char hexDigits[] = "0123456789abcdef";
+      unsigned int nmbOfDigits = 1;
+      for (unsigned int rest = value >> 4; rest != 0; rest >>= 4) {
+        ++nmbOfDigits;
+      }
+      if (nmbOfDigits > nmbOfChars) {
         std::stringstream errorString;
         errorString << "failed to convert int value to hex: " << value;
         throw std::runtime_error(errorString.str());
       }
-      return stream.str();
+      if (nmbOfChars >= FORMAT_BUFFER_SIZE) {
+        throw std::runtime_error("hex value too long for format buffer");
+      }
+      for (unsigned int i = nmbOfChars; i > 0; --i) {
+        buffer[i - 1] = hexDigits[value & 0xf];
+        value >>= 4;
+      }
+      buffer[nmbOfChars] = '\0';
+      return nmbOfChars;
     }
   }  // namespace detail
 }  // namespace adm
@@ -2,6 +2,7 @@
 #include "adm/document.hpp"
 #include "adm/utilities/id_assignment.hpp"
 #include "adm/elements.hpp"
+#include "adm/private/document_index.hpp"
 
 namespace adm {
 
@@ -11,6 +12,16 @@ namespace adm {
 
     void IdAssigner::document(Document* document) { document_ = document; }
 
+    void IdAssigner::index(const DocumentIndex* index) { index_ = index; }
+
+    template <typename Id>
+    bool IdAssigner::isUsed(const Id& id) const {
+      if (index_) {
+        return index_->isUsed(id);
+      }
+      return document().lookup(id) != nullptr;
+    }
+
     AudioProgrammeId IdAssigner::assignId(AudioProgramme& programme) {
       if (isCommonDefinitionsId(programme.get<AudioProgrammeId>())) {
         return programme.get<AudioProgrammeId>();
@@ -20,7 +31,7 @@ namespace adm {
         idValue =
             programme.get<AudioProgrammeId>().get<AudioProgrammeIdValue>();
       }
-      while (document().lookup(AudioProgrammeId(idValue))) {
+      while (isUsed(AudioProgrammeId(idValue))) {
         ++idValue;
       }
       auto id = AudioProgrammeId(idValue);
@@ -36,7 +47,7 @@ namespace adm {
       if (!isUndefined(content.get<AudioContentId>())) {
         idValue = content.get<AudioContentId>().get<AudioContentIdValue>();
       }
-      while (document().lookup(AudioContentId(idValue))) {
+      while (isUsed(AudioContentId(idValue))) {
         ++idValue;
       }
       auto id = AudioContentId(idValue);
@@ -52,7 +63,7 @@ namespace adm {
       if (!isUndefined(object.get<AudioObjectId>())) {
         idValue = object.get<AudioObjectId>().get<AudioObjectIdValue>();
       }
-      while (document().lookup(AudioObjectId(idValue))) {
+      while (isUsed(AudioObjectId(idValue))) {
         ++idValue;
       }
       auto id = AudioObjectId(idValue);
@@ -70,7 +81,7 @@ namespace adm {
         idValue =
             packFormat.get<AudioPackFormatId>().get<AudioPackFormatIdValue>();
       }
-      while (document().lookup(AudioPackFormatId(typeDescriptor, idValue))) {
+      while (isUsed(AudioPackFormatId(typeDescriptor, idValue))) {
         ++idValue;
       }
       auto id = AudioPackFormatId(typeDescriptor, idValue);
@@ -89,7 +100,7 @@ namespace adm {
         idValue = channelFormat.get<AudioChannelFormatId>()
                       .get<AudioChannelFormatIdValue>();
       }
-      while (document().lookup(AudioChannelFormatId(typeDescriptor, idValue))) {
+      while (isUsed(AudioChannelFormatId(typeDescriptor, idValue))) {
         ++idValue;
       }
       auto id = AudioChannelFormatId(typeDescriptor, idValue);
@@ -117,7 +128,7 @@ namespace adm {
           typeDescriptor = packFormat->get<TypeDescriptor>();
         }
       }
-      while (document().lookup(AudioStreamFormatId(typeDescriptor, idValue))) {
+      while (isUsed(AudioStreamFormatId(typeDescriptor, idValue))) {
         ++idValue;
       }
       auto id = AudioStreamFormatId(typeDescriptor, idValue);
@@ -148,8 +159,7 @@ namespace adm {
           typeDescriptor = streamFormatId.get<TypeDescriptor>();
         }
       }
-      while (document().lookup(
-          AudioTrackFormatId(typeDescriptor, idValue, idCounter))) {
+      while (isUsed(AudioTrackFormatId(typeDescriptor, idValue, idCounter))) {
         ++idCounter;
       }
       auto id = AudioTrackFormatId(typeDescriptor, idValue, idCounter);
@@ -165,7 +175,7 @@ namespace adm {
       if (!isUndefined(trackUid.get<AudioTrackUidId>())) {
         idValue = trackUid.get<AudioTrackUidId>().get<AudioTrackUidIdValue>();
       }
-      while (document().lookup(AudioTrackUidId(idValue))) {
+      while (isUsed(AudioTrackUidId(idValue))) {
         ++idValue;
       }
       auto id = AudioTrackUidId(idValue);
@@ -0,0 +1,136 @@
+#include "adm/detail/number_formatting.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace adm {
+  namespace detail {
+
+    namespace {
+      /**
+       * Rewrite a number printed with "%.*e" in the shortest form.
+       *
+       * Trailing zeros of the mantissa are removed, and numbers with a
+       * moderate exponent are written in fixed notation.
+       */
+      std::size_t rewriteScientific(char* buffer, const char* scientific) {
+        char* out = buffer;
+        const char* in = scientific;
+        if (*in == '-') {
+          *out++ = *in++;
+        }
+        char digits[FORMAT_BUFFER_SIZE];
+        std::size_t nDigits = 0;
+        for (; *in != 'e'; ++in) {
+          if (*in != '.') {
+            digits[nDigits++] = *in;
+          }
+        }
+        int exponent = std::atoi(in + 1);
+        while (nDigits > 1 && digits[nDigits - 1] == '0') {
+          --nDigits;
+        }
+
+        if (exponent < -20 || exponent > 20) {
+          *out++ = digits[0];
+          if (nDigits > 1) {
+            *out++ = '.';
+            std::memcpy(out, digits + 1, nDigits - 1);
+            out += nDigits - 1;
+          }
+          out += std::sprintf(out, "e%d", exponent);
+          return static_cast<std::size_t>(out - buffer);
+        }
+
+        if (exponent < 0) {
+          *out++ = '0';
+          *out++ = '.';
+          for (int i = -1; i > exponent; --i) {
+            *out++ = '0';
+          }
+          std::memcpy(out, digits, nDigits);
+          out += nDigits;
+        } else {
+          std::size_t nIntegerDigits = static_cast<std::size_t>(exponent) + 1;
+          for (std::size_t i = 0; i < nIntegerDigits; ++i) {
+            *out++ = i < nDigits ? digits[i] : '0';
+          }
+          if (nDigits > nIntegerDigits) {
+            *out++ = '.';
+            std::memcpy(out, digits + nIntegerDigits, nDigits - nIntegerDigits);
+            out += nDigits - nIntegerDigits;
+          }
+        }
+        *out = '\0';
+        return static_cast<std::size_t>(out - buffer);
+      }
+
+      /**
+       * Format with the fewest significant digits between minDigits and
+       * maxDigits for which the correctly rounded decimal parses back to the
+       * same value.
+       *
+       * If a representation with fewer than minDigits digits exists, printing
+       * with minDigits digits yields it padded with zeros, which are removed
+       * again.
+       */
+      template <typename T, typename Parse>
+      std::size_t formatShortest(char* buffer, T value, int minDigits,
+                                 int maxDigits, Parse parse) {
+        if (!std::isfinite(value)) {
+          return static_cast<std::size_t>(std::snprintf(
+              buffer, FORMAT_BUFFER_SIZE, "%g", static_cast<double>(value)));
+        }
+        char scientific[FORMAT_BUFFER_SIZE];
+        for (int digits = minDigits; digits < maxDigits; ++digits) {
+          std::snprintf(scientific, FORMAT_BUFFER_SIZE, "%.*e", digits - 1,
+                        static_cast<double>(value));
+          if (parse(scientific) == value) {
+            return rewriteScientific(buffer, scientific);
+          }
+        }
+        std::snprintf(scientific, FORMAT_BUFFER_SIZE, "%.*e", maxDigits - 1,
+                      static_cast<double>(value));
+        return rewriteScientific(buffer, scientific);
+      }
+    }  // namespace
+
+    std::size_t formatFloat(char* buffer, float value) {
+      return formatShortest(buffer, value, 6, 9, [](const char* str) {
+        return std::strtof(str, nullptr);
+      });
+    }
+
+    std::size_t formatDouble(char* buffer, double value) {
+      return formatShortest(buffer, value, 15, 17, [](const char* str) {
+        return std::strtod(str, nullptr);
+      });
+    }
+
+    std::size_t formatInteger(char* buffer, long long value) {
+      if (value < 0) {
+        *buffer = '-';
+        // negate in unsigned arithmetic to handle the minimum value
+        auto magnitude = 0ull - static_cast<unsigned long long>(value);
+        return 1 + formatUnsigned(buffer + 1, magnitude);
+      }
+      return formatUnsigned(buffer, static_cast<unsigned long long>(value));
+    }
+
+    std::size_t formatUnsigned(char* buffer, unsigned long long value) {
+      char reversed[FORMAT_BUFFER_SIZE];
+      std::size_t size = 0;
+      do {
+        reversed[size++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+      } while (value != 0);
+      for (std::size_t i = 0; i < size; ++i) {
+        buffer[i] = reversed[size - 1 - i];
+      }
+      buffer[size] = '\0';
+      return size;
+    }
+
+  }  // namespace detail
+}  // namespace adm
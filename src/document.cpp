@@ -5,10 +5,108 @@
 #include "adm/utilities/copy.hpp"
 #include "adm/utilities/lookup.hpp"
 #include "adm/detail/id_assigner.hpp"
+#include "adm/private/content_hash.hpp"
+#include "adm/private/document_index.hpp"
 
 #include <algorithm>
+#include <unordered_set>
 
 namespace adm {
+
+  namespace {
+    /// true if @a element is in @a elements, looked up in @a index if set
+    template <typename Element>
+    bool contains(const std::vector<std::shared_ptr<Element>>& elements,
+                  const std::shared_ptr<Element>& element,
+                  const detail::DocumentIndex* index) {
+      if (index) {
+        return index->contains(element);
+      }
+      return std::find(elements.begin(), elements.end(), element) !=
+             elements.end();
+    }
+
+    template <typename Element>
+    void insert(std::vector<std::shared_ptr<Element>>& elements,
+                const std::shared_ptr<Element>& element,
+                detail::DocumentIndex* index) {
+      elements.push_back(element);
+      if (index) {
+        index->insert(*element);
+      }
+    }
+
+    struct AddElement : public boost::static_visitor<> {
+      explicit AddElement(Document& document) : document_(document) {}
+
+      template <typename Element>
+      void operator()(const std::shared_ptr<Element>& element) const {
+        document_.add(element);
+      }
+
+     private:
+      Document& document_;
+    };
+
+    typedef std::unordered_set<const void*> RemovedElements;
+
+    struct InsertRemoved : public boost::static_visitor<> {
+      explicit InsertRemoved(RemovedElements& removed) : removed_(removed) {}
+
+      template <typename Element>
+      void operator()(const std::shared_ptr<Element>& element) const {
+        removed_.insert(element.get());
+      }
+
+     private:
+      RemovedElements& removed_;
+    };
+
+    template <typename Element>
+    std::size_t eraseRemoved(std::vector<std::shared_ptr<Element>>& elements,
+                             const RemovedElements& removed) {
+      auto end = std::remove_if(
+          elements.begin(), elements.end(),
+          [&removed](const std::shared_ptr<Element>& element) {
+            return removed.count(element.get()) != 0;
+          });
+      auto count = static_cast<std::size_t>(elements.end() - end);
+      elements.erase(end, elements.end());
+      return count;
+    }
+
+    /// remove the references of type `Referenced` to removed elements
+    template <typename Referenced, typename Element>
+    void removeReferences(
+        const std::vector<std::shared_ptr<Element>>& elements,
+        const RemovedElements& removed) {
+      for (auto& element : elements) {
+        std::vector<std::shared_ptr<Referenced>> references;
+        for (auto& reference :
+             element->template getReferences<Referenced>()) {
+          if (removed.count(reference.get())) {
+            references.push_back(reference);
+          }
+        }
+        for (auto& reference : references) {
+          element->removeReference(reference);
+        }
+      }
+    }
+
+    /// remove the single reference of type `Referenced` if it was removed
+    template <typename Referenced, typename Element>
+    void removeReference(const std::vector<std::shared_ptr<Element>>& elements,
+                         const RemovedElements& removed) {
+      for (auto& element : elements) {
+        auto reference = element->template getReference<Referenced>();
+        if (reference && removed.count(reference.get())) {
+          element->template removeReference<Referenced>();
+        }
+      }
+    }
+  }  // namespace
+
   Document::Document() { idAssigner_.document(this); }
 
   std::shared_ptr<Document> Document::create() {
@@ -19,6 +117,29 @@ namespace adm {
     return adm::deepCopy(shared_from_this());
   }
 
+  std::size_t Document::getGeneration() const { return *generation_; }
+
+  std::uint64_t Document::getContentHash() const {
+    std::uint64_t value;
+    if (contentHash_.get(*generation_, value)) {
+      return value;
+    }
+    detail::ContentHashMemo memo;
+    detail::ContentHasher hasher(memo);
+    hasher.addContentHashes(audioProgrammes_);
+    hasher.addContentHashes(audioContents_);
+    hasher.addContentHashes(audioObjects_);
+    hasher.addContentHashes(audioPackFormats_);
+    hasher.addContentHashes(audioChannelFormats_);
+    hasher.addContentHashes(audioStreamFormats_);
+    hasher.addContentHashes(audioTrackFormats_);
+    hasher.addContentHashes(audioTrackUids_);
+    if (memo.cacheable) {
+      contentHash_.set(*generation_, hasher.get());
+    }
+    return hasher.get();
+  }
+
   // ---- add elements ---- //
   bool Document::add(std::shared_ptr<AudioProgramme> programme) {
     if (programme->getParent().lock() &&
@@ -26,12 +147,11 @@ namespace adm {
       throw std::runtime_error(
           "AudioProgramme already belongs to another Document");
     }
-    auto it =
-        std::find(audioProgrammes_.begin(), audioProgrammes_.end(), programme);
-    if (it == audioProgrammes_.end()) {
+    if (!contains(audioProgrammes_, programme, index_)) {
       idAssigner_.assignId(*programme);
       AudioProgrammeAttorney::setParent(programme, shared_from_this());
-      audioProgrammes_.push_back(programme);
+      insert(audioProgrammes_, programme, index_);
+      ++*generation_;
       for (auto& reference : programme->getReferences<AudioContent>()) {
         add(reference);
       }
@@ -47,11 +167,11 @@ namespace adm {
       throw std::runtime_error(
           "AudioContent already belongs to another Document");
     }
-    auto it = std::find(audioContents_.begin(), audioContents_.end(), content);
-    if (it == audioContents_.end()) {
+    if (!contains(audioContents_, content, index_)) {
       idAssigner_.assignId(*content);
       AudioContentAttorney::setParent(content, shared_from_this());
-      audioContents_.push_back(content);
+      insert(audioContents_, content, index_);
+      ++*generation_;
       for (auto& reference : content->getReferences<AudioObject>()) {
         add(reference);
       }
@@ -67,11 +187,11 @@ namespace adm {
       throw std::runtime_error(
           "AudioObject already belongs to another Document");
     }
-    auto it = std::find(audioObjects_.begin(), audioObjects_.end(), object);
-    if (it == audioObjects_.end()) {
+    if (!contains(audioObjects_, object, index_)) {
       idAssigner_.assignId(*object);
       AudioObjectAttorney::setParent(object, shared_from_this());
-      audioObjects_.push_back(object);
+      insert(audioObjects_, object, index_);
+      ++*generation_;
       for (auto& reference : object->getReferences<AudioObject>()) {
         add(reference);
       }
@@ -96,12 +216,11 @@ namespace adm {
       throw std::runtime_error(
           "AudioPackFormat already belongs to another Document");
     }
-    auto it = std::find(audioPackFormats_.begin(), audioPackFormats_.end(),
-                        packFormat);
-    if (it == audioPackFormats_.end()) {
+    if (!contains(audioPackFormats_, packFormat, index_)) {
       idAssigner_.assignId(*packFormat);
       AudioPackFormatAttorney::setParent(packFormat, shared_from_this());
-      audioPackFormats_.push_back(packFormat);
+      insert(audioPackFormats_, packFormat, index_);
+      ++*generation_;
       for (auto& reference : packFormat->getReferences<AudioPackFormat>()) {
         add(reference);
       }
@@ -120,12 +239,11 @@ namespace adm {
       throw std::runtime_error(
           "AudioChannelFormat already belongs to another Document");
     }
-    auto it = std::find(audioChannelFormats_.begin(),
-                        audioChannelFormats_.end(), channelFormat);
-    if (it == audioChannelFormats_.end()) {
+    if (!contains(audioChannelFormats_, channelFormat, index_)) {
       idAssigner_.assignId(*channelFormat);
       AudioChannelFormatAttorney::setParent(channelFormat, shared_from_this());
-      audioChannelFormats_.push_back(channelFormat);
+      insert(audioChannelFormats_, channelFormat, index_);
+      ++*generation_;
       return true;
     } else {
       return false;
@@ -138,12 +256,11 @@ namespace adm {
       throw std::runtime_error(
           "AudioStreamFormat already belongs to another Document");
     }
-    auto it = std::find(audioStreamFormats_.begin(), audioStreamFormats_.end(),
-                        streamFormat);
-    if (it == audioStreamFormats_.end()) {
+    if (!contains(audioStreamFormats_, streamFormat, index_)) {
       idAssigner_.assignId(*streamFormat);
       AudioStreamFormatAttorney::setParent(streamFormat, shared_from_this());
-      audioStreamFormats_.push_back(streamFormat);
+      insert(audioStreamFormats_, streamFormat, index_);
+      ++*generation_;
       auto audioChannelFormat =
           streamFormat->getReference<AudioChannelFormat>();
       if (audioChannelFormat) {
@@ -172,23 +289,20 @@ namespace adm {
       throw std::runtime_error(
           "AudioTrackFormat already belongs to another Document");
     }
-    auto it = std::find(audioTrackFormats_.begin(), audioTrackFormats_.end(),
-                        trackFormat);
-    if (it == audioTrackFormats_.end()) {
+    if (!contains(audioTrackFormats_, trackFormat, index_)) {
       // NOTE: That the id assignment works properly the AudioStreamFormats
       // have to be added before the AudioTrackFormat.
       auto audioStreamFormat = trackFormat->getReference<AudioStreamFormat>();
       if (audioStreamFormat) {
         add(audioStreamFormat);
       }
-      auto it = std::find(audioTrackFormats_.begin(), audioTrackFormats_.end(),
-                          trackFormat);
-      if (it != audioTrackFormats_.end()) {
+      if (contains(audioTrackFormats_, trackFormat, index_)) {
         return true;
       }
       idAssigner_.assignId(*trackFormat);
       AudioTrackFormatAttorney::setParent(trackFormat, shared_from_this());
-      audioTrackFormats_.push_back(trackFormat);
+      insert(audioTrackFormats_, trackFormat, index_);
+      ++*generation_;
       return true;
     } else {
       return false;
@@ -201,12 +315,11 @@ namespace adm {
       throw std::runtime_error(
           "AudioTrackUid already belongs to another Document");
     }
-    auto it =
-        std::find(audioTrackUids_.begin(), audioTrackUids_.end(), trackUid);
-    if (it == audioTrackUids_.end()) {
+    if (!contains(audioTrackUids_, trackUid, index_)) {
       idAssigner_.assignId(*trackUid);
       AudioTrackUidAttorney::setParent(trackUid, shared_from_this());
-      audioTrackUids_.push_back(trackUid);
+      insert(audioTrackUids_, trackUid, index_);
+      ++*generation_;
       auto audioTrackFormat = trackUid->getReference<AudioTrackFormat>();
       if (audioTrackFormat) {
         add(audioTrackFormat);
@@ -221,12 +334,30 @@ namespace adm {
     }
   }
 
+  void Document::add(const std::vector<ElementVariant>& elements) {
+    detail::DocumentIndex index(*this);
+    index_ = &index;
+    idAssigner_.index(&index);
+    try {
+      for (auto& element : elements) {
+        boost::apply_visitor(AddElement(*this), element);
+      }
+    } catch (...) {
+      index_ = nullptr;
+      idAssigner_.index(nullptr);
+      throw;
+    }
+    index_ = nullptr;
+    idAssigner_.index(nullptr);
+  }
+
   // ---- remove elements --- //
   bool Document::remove(std::shared_ptr<AudioProgramme> programme) {
     auto it =
         std::find(audioProgrammes_.begin(), audioProgrammes_.end(), programme);
     if (it != audioProgrammes_.end()) {
       audioProgrammes_.erase(it);
+      ++*generation_;
       return true;
     }
     return false;
@@ -236,6 +367,7 @@ namespace adm {
     auto it = std::find(audioContents_.begin(), audioContents_.end(), content);
     if (it != audioContents_.end()) {
       audioContents_.erase(it);
+      ++*generation_;
       for (auto& audioProgramme : audioProgrammes_) {
         audioProgramme->removeReference(content);
       }
@@ -248,6 +380,7 @@ namespace adm {
     auto it = std::find(audioObjects_.begin(), audioObjects_.end(), object);
     if (it != audioObjects_.end()) {
       audioObjects_.erase(it);
+      ++*generation_;
       for (auto& audioObject : audioObjects_) {
         audioObject->removeReference(object);
       }
@@ -264,6 +397,7 @@ namespace adm {
                         packFormat);
     if (it != audioPackFormats_.end()) {
       audioPackFormats_.erase(it);
+      ++*generation_;
       for (auto& audioPackFormat : audioPackFormats_) {
         audioPackFormat->removeReference(packFormat);
       }
@@ -290,6 +424,7 @@ namespace adm {
                         audioChannelFormats_.end(), channelFormat);
     if (it != audioChannelFormats_.end()) {
       audioChannelFormats_.erase(it);
+      ++*generation_;
       for (auto& audioPackFormat : audioPackFormats_) {
         audioPackFormat->removeReference(channelFormat);
       }
@@ -309,6 +444,7 @@ namespace adm {
                         streamFormat);
     if (it != audioStreamFormats_.end()) {
       audioStreamFormats_.erase(it);
+      ++*generation_;
 
       for (auto& audioTrackFormat : audioTrackFormats_) {
         if (audioTrackFormat->getReference<AudioStreamFormat>() ==
@@ -326,6 +462,7 @@ namespace adm {
                         trackFormat);
     if (it != audioTrackFormats_.end()) {
       audioTrackFormats_.erase(it);
+      ++*generation_;
 
       for (auto& audioStreamFormat : audioStreamFormats_) {
         audioStreamFormat->removeReference(trackFormat);
@@ -345,6 +482,7 @@ namespace adm {
         std::find(audioTrackUids_.begin(), audioTrackUids_.end(), trackUid);
     if (it != audioTrackUids_.end()) {
       audioTrackUids_.erase(it);
+      ++*generation_;
       for (auto& audioObject : audioObjects_) {
         audioObject->removeReference(trackUid);
       }
@@ -353,6 +491,54 @@ namespace adm {
     return false;
   }
 
+  std::size_t Document::remove(const std::vector<ElementVariant>& elements) {
+    RemovedElements removed;
+    for (auto& element : elements) {
+      boost::apply_visitor(InsertRemoved(removed), element);
+    }
+
+    std::size_t count = 0;
+    count += eraseRemoved(audioProgrammes_, removed);
+    count += eraseRemoved(audioContents_, removed);
+    count += eraseRemoved(audioObjects_, removed);
+    count += eraseRemoved(audioPackFormats_, removed);
+    count += eraseRemoved(audioChannelFormats_, removed);
+    count += eraseRemoved(audioStreamFormats_, removed);
+    count += eraseRemoved(audioTrackFormats_, removed);
+    count += eraseRemoved(audioTrackUids_, removed);
+    if (count == 0) {
+      return 0;
+    }
+    ++*generation_;
+
+    removeReferences<AudioContent>(audioProgrammes_, removed);
+    removeReferences<AudioObject>(audioContents_, removed);
+    removeReferences<AudioObject>(audioObjects_, removed);
+    removeReferences<AudioPackFormat>(audioObjects_, removed);
+    removeReferences<AudioTrackUid>(audioObjects_, removed);
+    removeReferences<AudioPackFormat>(audioPackFormats_, removed);
+    removeReferences<AudioChannelFormat>(audioPackFormats_, removed);
+    removeReference<AudioPackFormat>(audioStreamFormats_, removed);
+    removeReference<AudioChannelFormat>(audioStreamFormats_, removed);
+    removeReference<AudioStreamFormat>(audioTrackFormats_, removed);
+    removeReference<AudioTrackFormat>(audioTrackUids_, removed);
+    removeReference<AudioPackFormat>(audioTrackUids_, removed);
+    for (auto& streamFormat : audioStreamFormats_) {
+      std::vector<std::shared_ptr<AudioTrackFormat>> references;
+      for (auto& weakReference :
+           streamFormat->getAudioTrackFormatReferences()) {
+        auto reference = weakReference.lock();
+        if (reference && removed.count(reference.get())) {
+          references.push_back(reference);
+        }
+      }
+      for (auto& reference : references) {
+        streamFormat->removeReference(reference);
+      }
+    }
+    return count;
+  }
+
   // ---- get elements ---- //
   ElementRange<const AudioProgramme> Document::getElements(
       detail::ParameterTraits<AudioProgramme>::tag) const {
@@ -1,4 +1,5 @@
 #include "adm/elements/audio_block_format_direct_speakers.hpp"
+#include "adm/private/content_hash.hpp"
 
 namespace adm {
 
@@ -107,4 +108,11 @@ namespace adm {
     }
   }
 
+  // ---- Common ---- //
+  std::uint64_t AudioBlockFormatDirectSpeakers::getContentHash() const {
+    detail::ContentHasher hasher;
+    hasher.addParameters(*this);
+    return hasher.get();
+  }
+
 }  // namespace adm
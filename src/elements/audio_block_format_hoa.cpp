@@ -1,4 +1,5 @@
 #include "adm/elements/audio_block_format_hoa.hpp"
+#include "adm/private/content_hash.hpp"
 
 namespace adm {
 
@@ -50,4 +51,11 @@ namespace adm {
     duration_ = boost::none;
   }
 
+  // ---- Common ---- //
+  std::uint64_t AudioBlockFormatHoa::getContentHash() const {
+    detail::ContentHasher hasher;
+    hasher.addParameters(*this);
+    return hasher.get();
+  }
+
 }  // namespace adm
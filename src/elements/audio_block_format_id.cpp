@@ -1,7 +1,9 @@
 #include "adm/elements/audio_block_format_id.hpp"
-#include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
+#include <cstring>
 #include <regex>
 #include <sstream>
+#include <tuple>
 #include "adm/detail/hex_values.hpp"
 
 namespace adm {
@@ -94,16 +96,27 @@ namespace adm {
   }
 
   bool AudioBlockFormatId::operator<(const AudioBlockFormatId& other) const {
-    return formatId(*this) < formatId(other);
+    // not comparing the keys, as those of IDs with values out of the range
+    // of their string representation overlap
+    return std::make_tuple(get<TypeDescriptor>().get(),
+                           get<AudioBlockFormatIdValue>().get(),
+                           get<AudioBlockFormatIdCounter>().get()) <
+           std::make_tuple(other.get<TypeDescriptor>().get(),
+                           other.get<AudioBlockFormatIdValue>().get(),
+                           other.get<AudioBlockFormatIdCounter>().get());
   }
 
   // ---- Common ---- //
+  std::uint64_t AudioBlockFormatId::key() const {
+    std::uint64_t type = get<TypeDescriptor>().get();
+    std::uint64_t value = get<AudioBlockFormatIdValue>().get();
+    std::uint64_t counter = get<AudioBlockFormatIdCounter>().get();
+    return (type << 48) | (value << 32) | counter;
+  }
+
   void AudioBlockFormatId::print(std::ostream& os) const {
-    os << boost::str(
-        boost::format("AB_%1%%2%_%3%") %
-        formatTypeLabel(get<TypeDescriptor>()) %
-        detail::formatHexValue(get<AudioBlockFormatIdValue>().get()) %
-        detail::formatHexValue(get<AudioBlockFormatIdCounter>().get(), 8));
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    os.write(buffer, static_cast<std::streamsize>(formatId(buffer, *this)));
   }
 
   AudioBlockFormatId parseAudioBlockFormatId(const std::string& id) {
@@ -123,9 +136,26 @@ namespace adm {
   }
 
   std::string formatId(AudioBlockFormatId id) {
-    std::stringstream idStream;
-    id.print(idStream);
-    return idStream.str();
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    return std::string(buffer, formatId(buffer, id));
+  }
+
+  std::size_t formatId(char* buffer, const AudioBlockFormatId& id) {
+    char* out = buffer;
+    std::memcpy(out, "AB_", 3);
+    out += 3;
+    auto typeLabel = formatTypeLabel(id.get<TypeDescriptor>());
+    std::memcpy(out, typeLabel.data(), typeLabel.size());
+    out += typeLabel.size();
+    out += detail::formatHexValue(out, id.get<AudioBlockFormatIdValue>().get());
+    *out++ = '_';
+    out += detail::formatHexValue(
+        out, id.get<AudioBlockFormatIdCounter>().get(), 8);
+    return static_cast<std::size_t>(out - buffer);
+  }
+
+  std::size_t hash_value(const AudioBlockFormatId& id) {
+    return boost::hash_value(id.key());
   }
 
 }  // namespace adm
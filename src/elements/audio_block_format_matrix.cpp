@@ -1,4 +1,5 @@
 #include "adm/elements/audio_block_format_matrix.hpp"
+#include "adm/private/content_hash.hpp"
 
 namespace adm {
 
@@ -51,4 +52,11 @@ namespace adm {
     duration_ = boost::none;
   }
 
+  // ---- Common ---- //
+  std::uint64_t AudioBlockFormatMatrix::getContentHash() const {
+    detail::ContentHasher hasher;
+    hasher.addParameters(*this);
+    return hasher.get();
+  }
+
 }  // namespace adm
@@ -1,4 +1,5 @@
 #include "adm/elements/audio_block_format_objects.hpp"
+#include "adm/private/content_hash.hpp"
 
 namespace adm {
 
@@ -344,4 +345,11 @@ namespace adm {
     importance_ = boost::none;
   }
 
+  // ---- Common ---- //
+  std::uint64_t AudioBlockFormatObjects::getContentHash() const {
+    detail::ContentHasher hasher;
+    hasher.addParameters(*this);
+    return hasher.get();
+  }
+
 }  // namespace adm
@@ -1,5 +1,7 @@
 #include "adm/elements/audio_channel_format.hpp"
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <sstream>
 #include "adm/document.hpp"
 #include "adm/elements/audio_block_format_binaural.hpp"
@@ -8,12 +10,141 @@
 #include "adm/elements/audio_block_format_matrix.hpp"
 #include "adm/elements/audio_block_format_objects.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
+#include "adm/private/content_hash.hpp"
+#include "adm/private/lazy_block_formats.hpp"
 #include "adm/utilities/element_io.hpp"
 #include "adm/utilities/id_assignment.hpp"
 #include "adm/utilities/comparator.hpp"
 
 namespace adm {
 
+  namespace detail {
+
+    /// The audioBlockFormats of an AudioChannelFormat
+    struct BlockFormatStorage {
+      // clang-format off
+      std::vector<AudioBlockFormatDirectSpeakers>& get(ParameterTraits<AudioBlockFormatDirectSpeakers>::tag) { return directSpeakers; }
+      std::vector<AudioBlockFormatMatrix>& get(ParameterTraits<AudioBlockFormatMatrix>::tag) { return matrix; }
+      std::vector<AudioBlockFormatObjects>& get(ParameterTraits<AudioBlockFormatObjects>::tag) { return objects; }
+      std::vector<AudioBlockFormatHoa>& get(ParameterTraits<AudioBlockFormatHoa>::tag) { return hoa; }
+      std::vector<AudioBlockFormatBinaural>& get(ParameterTraits<AudioBlockFormatBinaural>::tag) { return binaural; }
+      const std::vector<AudioBlockFormatDirectSpeakers>& get(ParameterTraits<AudioBlockFormatDirectSpeakers>::tag) const { return directSpeakers; }
+      const std::vector<AudioBlockFormatMatrix>& get(ParameterTraits<AudioBlockFormatMatrix>::tag) const { return matrix; }
+      const std::vector<AudioBlockFormatObjects>& get(ParameterTraits<AudioBlockFormatObjects>::tag) const { return objects; }
+      const std::vector<AudioBlockFormatHoa>& get(ParameterTraits<AudioBlockFormatHoa>::tag) const { return hoa; }
+      const std::vector<AudioBlockFormatBinaural>& get(ParameterTraits<AudioBlockFormatBinaural>::tag) const { return binaural; }
+      // clang-format on
+
+      std::vector<AudioBlockFormatDirectSpeakers> directSpeakers;
+      std::vector<AudioBlockFormatMatrix> matrix;
+      std::vector<AudioBlockFormatObjects> objects;
+      std::vector<AudioBlockFormatHoa> hoa;
+      std::vector<AudioBlockFormatBinaural> binaural;
+      /// true once a mutable range has been returned, which could still be
+      /// used to modify the audioBlockFormats, so they must not be shared
+      bool exposed = false;
+    };
+
+  }  // namespace detail
+
+  // ---- AudioBlockFormat IDs ---- //
+  template <typename BlockFormat>
+  void AudioChannelFormat::assignNewIdValue() {
+    typedef typename detail::ParameterTraits<BlockFormat>::tag Tag;
+    materialiseBlockFormats();
+    for (auto& blockFormat : mutableBlockFormats().get(Tag())) {
+      auto blockFormatId = blockFormat.template get<AudioBlockFormatId>();
+      auto channelFormatIdValue = get<AudioChannelFormatId>()
+                                      .template get<AudioChannelFormatIdValue>()
+                                      .get();
+      blockFormatId.set(AudioBlockFormatIdValue(channelFormatIdValue));
+      blockFormat.set(blockFormatId);
+    }
+  }
+
+  template <typename BlockFormat>
+  bool AudioChannelFormat::idUsed(const AudioBlockFormatId& id) const {
+    typedef typename detail::ParameterTraits<BlockFormat>::tag Tag;
+    materialiseBlockFormats();
+    auto& elements = blockFormats().get(Tag());
+    auto it = std::find_if(
+        elements.begin(), elements.end(),
+        [&id](const BlockFormat& blockFormat) {
+          return blockFormat.template get<AudioBlockFormatId>() == id;
+        });
+    if (it != elements.end()) {
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  template <typename BlockFormat>
+  void AudioChannelFormat::assignId(BlockFormat& blockFormat) {
+    auto id = blockFormat.template get<AudioBlockFormatId>();
+
+    TypeDescriptor typeDescriptor;
+    AudioBlockFormatIdValue value;
+    AudioBlockFormatIdCounter counter;
+
+    if (isUndefined(id)) {
+      typeDescriptor = get<TypeDescriptor>();
+      value = AudioBlockFormatIdValue(
+          get<AudioChannelFormatId>().get<AudioChannelFormatIdValue>().get());
+      counter = AudioBlockFormatIdCounter(1u);
+    } else {
+      typeDescriptor = id.template get<TypeDescriptor>();
+      value = id.template get<AudioBlockFormatIdValue>();
+      counter = id.template get<AudioBlockFormatIdCounter>();
+    }
+
+    while (idUsed<BlockFormat>(
+        AudioBlockFormatId(typeDescriptor, value, counter))) {
+      ++counter;
+    }
+    blockFormat.set(AudioBlockFormatId(typeDescriptor, value, counter));
+  }
+
+  template <typename BlockFormat>
+  void AudioChannelFormat::addParsed(BlockFormat blockFormat) {
+    typedef typename detail::ParameterTraits<BlockFormat>::tag Tag;
+    assignId(blockFormat);
+    mutableBlockFormats().get(Tag()).push_back(blockFormat);
+  }
+
+  template <typename BlockFormat>
+  void AudioChannelFormat::addWithUnusedId(const BlockFormat& blockFormat) {
+    typedef typename detail::ParameterTraits<BlockFormat>::tag Tag;
+    materialiseBlockFormats();
+    ++revision_;
+    mutableBlockFormats().get(Tag()).push_back(blockFormat);
+  }
+
+  template <typename BlockFormat>
+  BlockFormatsRange<BlockFormat> AudioChannelFormat::updateElements() {
+    typedef typename detail::ParameterTraits<BlockFormat>::tag Tag;
+    materialiseBlockFormats();
+    ++revision_;
+    auto& elements = mutableBlockFormats().get(Tag());
+    return boost::make_iterator_range(elements.begin(), elements.end());
+  }
+
+  // instantiated here, as the storage is only defined in this file
+  // clang-format off
+  template void AudioChannelFormat::addWithUnusedId(const AudioBlockFormatDirectSpeakers&);
+  template void AudioChannelFormat::addWithUnusedId(const AudioBlockFormatMatrix&);
+  template void AudioChannelFormat::addWithUnusedId(const AudioBlockFormatObjects&);
+  template void AudioChannelFormat::addWithUnusedId(const AudioBlockFormatHoa&);
+  template void AudioChannelFormat::addWithUnusedId(const AudioBlockFormatBinaural&);
+  template void AudioChannelFormat::addParsed(AudioBlockFormatDirectSpeakers);
+  template void AudioChannelFormat::addParsed(AudioBlockFormatObjects);
+  template BlockFormatsRange<AudioBlockFormatDirectSpeakers> AudioChannelFormat::updateElements<AudioBlockFormatDirectSpeakers>();
+  template BlockFormatsRange<AudioBlockFormatMatrix> AudioChannelFormat::updateElements<AudioBlockFormatMatrix>();
+  template BlockFormatsRange<AudioBlockFormatObjects> AudioChannelFormat::updateElements<AudioBlockFormatObjects>();
+  template BlockFormatsRange<AudioBlockFormatHoa> AudioChannelFormat::updateElements<AudioBlockFormatHoa>();
+  template BlockFormatsRange<AudioBlockFormatBinaural> AudioChannelFormat::updateElements<AudioBlockFormatBinaural>();
+  // clang-format on
+
   // ---- Getter ---- //
   AudioChannelFormatId AudioChannelFormat::get(
       detail::ParameterTraits<AudioChannelFormatId>::tag) const {
@@ -38,6 +169,7 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioChannelFormat::set(AudioChannelFormatId id) {
+    ++revision_;
     if (isUndefined(id)) {
       id_ = id;
       return;
@@ -47,6 +179,11 @@ namespace adm {
     }
     if (id.get<TypeDescriptor>() == get<TypeDescriptor>()) {
       id_ = id;
+      if (lazyGuard_.pending()) {
+        // applied after the audioBlockFormats have been parsed
+        reassignLazyBlockFormatIds_ = true;
+        return;
+      }
       assignNewIdValue<AudioBlockFormatDirectSpeakers>();
       assignNewIdValue<AudioBlockFormatMatrix>();
       assignNewIdValue<AudioBlockFormatObjects>();
@@ -61,8 +198,14 @@ namespace adm {
       throw std::runtime_error(errorString.str());
     }
   }
-  void AudioChannelFormat::set(AudioChannelFormatName name) { name_ = name; }
-  void AudioChannelFormat::set(Frequency frequency) { frequency_ = frequency; }
+  void AudioChannelFormat::set(AudioChannelFormatName name) {
+    ++revision_;
+    name_ = name;
+  }
+  void AudioChannelFormat::set(Frequency frequency) {
+    ++revision_;
+    frequency_ = frequency;
+  }
 
   // ---- Has ---- //
   bool AudioChannelFormat::has(
@@ -83,93 +226,175 @@ namespace adm {
 
   // ---- Unsetter ---- //
   void AudioChannelFormat::unset(detail::ParameterTraits<Frequency>::tag) {
+    ++revision_;
     frequency_ = boost::none;
   }
 
   // ---- AudioBlocks ---- //
   void AudioChannelFormat::add(AudioBlockFormatDirectSpeakers blockFormat) {
+    materialiseBlockFormats();
+    ++revision_;
     assignId(blockFormat);
-    audioBlockFormatsDirectSpeakers_.push_back(blockFormat);
+    mutableBlockFormats().directSpeakers.push_back(blockFormat);
   }
   void AudioChannelFormat::add(AudioBlockFormatMatrix blockFormat) {
+    materialiseBlockFormats();
+    ++revision_;
     assignId(blockFormat);
-    audioBlockFormatsMatrix_.push_back(blockFormat);
+    mutableBlockFormats().matrix.push_back(blockFormat);
   }
 
   void AudioChannelFormat::add(AudioBlockFormatObjects blockFormat) {
+    materialiseBlockFormats();
+    ++revision_;
     assignId(blockFormat);
-    audioBlockFormatsObjects_.push_back(blockFormat);
+    mutableBlockFormats().objects.push_back(blockFormat);
   }
 
   void AudioChannelFormat::add(AudioBlockFormatHoa blockFormat) {
+    materialiseBlockFormats();
+    ++revision_;
     assignId(blockFormat);
-    audioBlockFormatsHoa_.push_back(blockFormat);
+    mutableBlockFormats().hoa.push_back(blockFormat);
   }
 
   void AudioChannelFormat::add(AudioBlockFormatBinaural blockFormat) {
+    materialiseBlockFormats();
+    ++revision_;
     assignId(blockFormat);
-    audioBlockFormatsBinaural_.push_back(blockFormat);
+    mutableBlockFormats().binaural.push_back(blockFormat);
   }
 
   BlockFormatsConstRange<AudioBlockFormatDirectSpeakers>
   AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatDirectSpeakers>::tag) const {
-    return boost::make_iterator_range(audioBlockFormatsDirectSpeakers_.begin(),
-                                      audioBlockFormatsDirectSpeakers_.end());
+    materialiseBlockFormats();
+    auto& elements = blockFormats().directSpeakers;
+    return boost::make_iterator_range(elements.cbegin(), elements.cend());
   }
   BlockFormatsConstRange<AudioBlockFormatMatrix> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatMatrix>::tag) const {
-    return boost::make_iterator_range(audioBlockFormatsMatrix_.begin(),
-                                      audioBlockFormatsMatrix_.end());
+    materialiseBlockFormats();
+    auto& elements = blockFormats().matrix;
+    return boost::make_iterator_range(elements.cbegin(), elements.cend());
   }
   BlockFormatsConstRange<AudioBlockFormatObjects> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatObjects>::tag) const {
-    return boost::make_iterator_range(audioBlockFormatsObjects_.begin(),
-                                      audioBlockFormatsObjects_.end());
+    materialiseBlockFormats();
+    auto& elements = blockFormats().objects;
+    return boost::make_iterator_range(elements.cbegin(), elements.cend());
   }
   BlockFormatsConstRange<AudioBlockFormatHoa> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatHoa>::tag) const {
-    return boost::make_iterator_range(audioBlockFormatsHoa_.begin(),
-                                      audioBlockFormatsHoa_.end());
+    materialiseBlockFormats();
+    auto& elements = blockFormats().hoa;
+    return boost::make_iterator_range(elements.cbegin(), elements.cend());
   }
   BlockFormatsConstRange<AudioBlockFormatBinaural> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatBinaural>::tag) const {
-    return boost::make_iterator_range(audioBlockFormatsBinaural_.begin(),
-                                      audioBlockFormatsBinaural_.end());
+    materialiseBlockFormats();
+    auto& elements = blockFormats().binaural;
+    return boost::make_iterator_range(elements.cbegin(), elements.cend());
   }
 
   BlockFormatsRange<AudioBlockFormatDirectSpeakers> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatDirectSpeakers>::tag) {
-    return boost::make_iterator_range(audioBlockFormatsDirectSpeakers_.begin(),
-                                      audioBlockFormatsDirectSpeakers_.end());
+    auto elements = updateElements<AudioBlockFormatDirectSpeakers>();
+    blockFormats_->exposed = true;
+    return elements;
   }
   BlockFormatsRange<AudioBlockFormatMatrix> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatMatrix>::tag) {
-    return boost::make_iterator_range(audioBlockFormatsMatrix_.begin(),
-                                      audioBlockFormatsMatrix_.end());
+    auto elements = updateElements<AudioBlockFormatMatrix>();
+    blockFormats_->exposed = true;
+    return elements;
   }
   BlockFormatsRange<AudioBlockFormatObjects> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatObjects>::tag) {
-    return boost::make_iterator_range(audioBlockFormatsObjects_.begin(),
-                                      audioBlockFormatsObjects_.end());
+    auto elements = updateElements<AudioBlockFormatObjects>();
+    blockFormats_->exposed = true;
+    return elements;
   }
   BlockFormatsRange<AudioBlockFormatHoa> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatHoa>::tag) {
-    return boost::make_iterator_range(audioBlockFormatsHoa_.begin(),
-                                      audioBlockFormatsHoa_.end());
+    auto elements = updateElements<AudioBlockFormatHoa>();
+    blockFormats_->exposed = true;
+    return elements;
   }
   BlockFormatsRange<AudioBlockFormatBinaural> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatBinaural>::tag) {
-    return boost::make_iterator_range(audioBlockFormatsBinaural_.begin(),
-                                      audioBlockFormatsBinaural_.end());
+    auto elements = updateElements<AudioBlockFormatBinaural>();
+    blockFormats_->exposed = true;
+    return elements;
+  }
+
+  const detail::BlockFormatStorage& AudioChannelFormat::blockFormats() const {
+    return *blockFormats_;
+  }
+
+  bool AudioChannelFormat::blockFormatsExposed() const {
+    return blockFormats().exposed;
+  }
+
+  detail::BlockFormatStorage& AudioChannelFormat::mutableBlockFormats() {
+    if (blockFormats_.use_count() != 1) {
+      auto blockFormats = std::make_shared<detail::BlockFormatStorage>(
+          static_cast<const detail::BlockFormatStorage&>(*blockFormats_));
+      blockFormats->exposed = false;
+      blockFormats_ = std::move(blockFormats);
+    } else {
+      // use_count() is a relaxed load; synchronise with the release of
+      // the last copy which shared the audioBlockFormats, so that its reads
+      // happen before the following writes
+      std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *blockFormats_;
+  }
+
+  void AudioChannelFormat::materialiseBlockFormats() const {
+    if (!lazyGuard_.pending()) {
+      return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(lazyGuard_.mutex());
+    // also empty if parsed by another thread meanwhile, or while parsing
+    // on this thread, as addParsed() and assignNewIdValue() parse first
+    if (!lazyBlockFormats_) {
+      return;
+    }
+    // AudioChannelFormats are always created non-const, see create()
+    auto self = const_cast<AudioChannelFormat*>(this);
+    auto lazyBlockFormats = std::move(self->lazyBlockFormats_);
+    // every modification parses the audioBlockFormats first, so there
+    // should be none yet; only the parsed ones are removed on errors
+    auto directSpeakersCount = blockFormats().directSpeakers.size();
+    auto objectsCount = blockFormats().objects.size();
+    try {
+      lazyBlockFormats->addTo(*self);
+      if (reassignLazyBlockFormatIds_) {
+        self->assignNewIdValue<AudioBlockFormatDirectSpeakers>();
+        self->assignNewIdValue<AudioBlockFormatObjects>();
+        self->reassignLazyBlockFormatIds_ = false;
+      }
+    } catch (...) {
+      auto& blockFormats = self->mutableBlockFormats();
+      blockFormats.directSpeakers.erase(
+          blockFormats.directSpeakers.begin() + directSpeakersCount,
+          blockFormats.directSpeakers.end());
+      blockFormats.objects.erase(
+          blockFormats.objects.begin() + objectsCount,
+          blockFormats.objects.end());
+      self->lazyBlockFormats_ = std::move(lazyBlockFormats);
+      throw;
+    }
+    lazyGuard_.setPending(false);
   }
 
   void AudioChannelFormat::clearAudioBlockFormats() {
-    audioBlockFormatsDirectSpeakers_.clear();
-    audioBlockFormatsMatrix_.clear();
-    audioBlockFormatsObjects_.clear();
-    audioBlockFormatsHoa_.clear();
-    audioBlockFormatsBinaural_.clear();
+    // parsed first, so that errors are reported like with eager parsing
+    materialiseBlockFormats();
+    ++revision_;
+    // not cleared in place, as they may be shared
+    blockFormats_ = std::make_shared<detail::BlockFormatStorage>();
   }
 
   // ---- Common ---- //
@@ -187,21 +412,64 @@ namespace adm {
 
   void AudioChannelFormat::setParent(std::weak_ptr<Document> document) {
     parent_ = document;
+    revision_.setGeneration(DocumentAttorney::getGeneration(document));
   }
 
   std::weak_ptr<Document> AudioChannelFormat::getParent() const {
     return parent_;
   }
 
+  std::size_t AudioChannelFormat::getRevision() const { return revision_.get(); }
+
+  std::uint64_t AudioChannelFormat::getContentHash() const {
+    detail::ContentHashMemo memo;
+    return getContentHash(memo);
+  }
+
+  std::uint64_t AudioChannelFormat::getContentHash(
+      detail::ContentHashMemo& memo) const {
+    auto addParameters = [this](detail::ContentHasher& hasher) {
+      hasher.addParameters(*this);
+      hasher.addBlockFormats(getElements<AudioBlockFormatDirectSpeakers>());
+      hasher.addBlockFormats(getElements<AudioBlockFormatMatrix>());
+      hasher.addBlockFormats(getElements<AudioBlockFormatObjects>());
+      hasher.addBlockFormats(getElements<AudioBlockFormatHoa>());
+      hasher.addBlockFormats(getElements<AudioBlockFormatBinaural>());
+    };
+    // audioBlockFormats modified through a mutable range do not change
+    // the revision, so the hash is not cached once one was handed out
+    if (blockFormatsExposed()) {
+      memo.cacheable = false;
+      detail::ContentHasher hasher;
+      addParameters(hasher);
+      return hasher.get();
+    }
+    return detail::cachedParameterHash(*this, contentHash_, addParameters);
+  }
+
   std::shared_ptr<AudioChannelFormat> AudioChannelFormat::copy() const {
+    // const accesses may be parsing lazy audioBlockFormats meanwhile
+    std::unique_lock<std::recursive_mutex> lock(lazyGuard_.mutex(),
+                                                std::defer_lock);
+    if (lazyGuard_.pending()) {
+      lock.lock();
+    }
     auto audioChannelFormatCopy =
         std::shared_ptr<AudioChannelFormat>(new AudioChannelFormat(*this));
     audioChannelFormatCopy->setParent(std::weak_ptr<Document>());
+    if (blockFormats_->exposed) {
+      audioChannelFormatCopy->blockFormats_ =
+          std::make_shared<detail::BlockFormatStorage>(
+              static_cast<const detail::BlockFormatStorage&>(*blockFormats_));
+      audioChannelFormatCopy->blockFormats_->exposed = false;
+    }
     return audioChannelFormatCopy;
   }
 
   AudioChannelFormat::AudioChannelFormat(AudioChannelFormatName name,
                                          TypeDescriptor channelType)
-      : name_(name), typeDescriptor_(channelType) {}
+      : name_(name),
+        typeDescriptor_(channelType),
+        blockFormats_(std::make_shared<detail::BlockFormatStorage>()) {}
 
 }  // namespace adm
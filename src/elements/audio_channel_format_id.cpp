@@ -1,7 +1,9 @@
 #include "adm/elements/audio_channel_format_id.hpp"
-#include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
+#include <cstring>
 #include <regex>
 #include <sstream>
+#include <tuple>
 #include "adm/detail/hex_values.hpp"
 
 namespace adm {
@@ -75,14 +77,24 @@ namespace adm {
 
   bool AudioChannelFormatId::operator<(
       const AudioChannelFormatId& other) const {
-    return formatId(*this) < formatId(other);
+    // not comparing the keys, as those of IDs with values out of the range
+    // of their string representation overlap
+    return std::make_tuple(get<TypeDescriptor>().get(),
+                           get<AudioChannelFormatIdValue>().get()) <
+           std::make_tuple(other.get<TypeDescriptor>().get(),
+                           other.get<AudioChannelFormatIdValue>().get());
   }
 
   // ---- Common ---- //
+  std::uint64_t AudioChannelFormatId::key() const {
+    std::uint64_t type = get<TypeDescriptor>().get();
+    std::uint64_t value = get<AudioChannelFormatIdValue>().get();
+    return (type << 48) | (value << 32);
+  }
+
   void AudioChannelFormatId::print(std::ostream& os) const {
-    os << boost::str(
-        boost::format("AC_%1%%2%") % formatTypeLabel(get<TypeDescriptor>()) %
-        detail::formatHexValue(get<AudioChannelFormatIdValue>().get()));
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    os.write(buffer, static_cast<std::streamsize>(formatId(buffer, *this)));
   }
 
   AudioChannelFormatId parseAudioChannelFormatId(const std::string& id) {
@@ -100,9 +112,24 @@ namespace adm {
   }
 
   std::string formatId(AudioChannelFormatId id) {
-    std::stringstream idStream;
-    id.print(idStream);
-    return idStream.str();
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    return std::string(buffer, formatId(buffer, id));
+  }
+
+  std::size_t formatId(char* buffer, const AudioChannelFormatId& id) {
+    char* out = buffer;
+    std::memcpy(out, "AC_", 3);
+    out += 3;
+    auto typeLabel = formatTypeLabel(id.get<TypeDescriptor>());
+    std::memcpy(out, typeLabel.data(), typeLabel.size());
+    out += typeLabel.size();
+    out += detail::formatHexValue(
+        out, id.get<AudioChannelFormatIdValue>().get());
+    return static_cast<std::size_t>(out - buffer);
+  }
+
+  std::size_t hash_value(const AudioChannelFormatId& id) {
+    return boost::hash_value(id.key());
   }
 
 }  // namespace adm
@@ -5,6 +5,7 @@
 #include "adm/elements/loudness_metadata.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
+#include "adm/private/content_hash.hpp"
 #include "adm/utilities/element_io.hpp"
 #include "adm/utilities/id_assignment.hpp"
 
@@ -89,6 +90,7 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioContent::set(AudioContentId id) {
+    ++revision_;
     if (isUndefined(id)) {
       id_ = id;
       return;
@@ -98,14 +100,20 @@ namespace adm {
     }
     id_ = id;
   }
-  void AudioContent::set(AudioContentName name) { name_ = name; }
+  void AudioContent::set(AudioContentName name) {
+    ++revision_;
+    name_ = name;
+  }
   void AudioContent::set(AudioContentLanguage language) {
+    ++revision_;
     language_ = language;
   }
   void AudioContent::set(LoudnessMetadata loudnessMetadata) {
+    ++revision_;
     loudnessMetadata_ = loudnessMetadata;
   }
   void AudioContent::set(DialogueId id) {
+    ++revision_;
     if (dialogueId_ && dialogueId_.get() == id) {
       return;
     }
@@ -120,6 +128,7 @@ namespace adm {
     }
   }
   void AudioContent::set(ContentKind kind) {
+    ++revision_;
     if (kind.which() == 0) {
       set(boost::get<NonDialogueContentKind>(kind));
     } else if (kind.which() == 1) {
@@ -129,16 +138,19 @@ namespace adm {
     }
   }
   void AudioContent::set(NonDialogueContentKind kind) {
+    ++revision_;
     unset<DialogueId>();
     nonDialogueContentKind_ = kind;
     dialogueId_ = Dialogue::NON_DIALOGUE;
   }
   void AudioContent::set(DialogueContentKind kind) {
+    ++revision_;
     unset<DialogueId>();
     dialogueContentKind_ = kind;
     dialogueId_ = Dialogue::DIALOGUE;
   }
   void AudioContent::set(MixedContentKind kind) {
+    ++revision_;
     unset<DialogueId>();
     mixedContentKind_ = kind;
     dialogueId_ = Dialogue::MIXED;
@@ -146,30 +158,41 @@ namespace adm {
 
   // ---- Unsetter ---- //
   void AudioContent::unset(detail::ParameterTraits<AudioContentLanguage>::tag) {
+    ++revision_;
     language_ = boost::none;
   }
   void AudioContent::unset(detail::ParameterTraits<LoudnessMetadata>::tag) {
+    ++revision_;
     loudnessMetadata_ = boost::none;
   }
   void AudioContent::unset(detail::ParameterTraits<DialogueId>::tag) {
+    ++revision_;
     dialogueId_ = boost::none;
     nonDialogueContentKind_ = boost::none;
     dialogueContentKind_ = boost::none;
     mixedContentKind_ = boost::none;
   }
+  void AudioContent::unset(detail::ParameterTraits<ContentKind>::tag) {
+    ++revision_;
+    unset<DialogueId>();
+  }
   void AudioContent::unset(
       detail::ParameterTraits<NonDialogueContentKind>::tag) {
+    ++revision_;
     unset<DialogueId>();
   }
   void AudioContent::unset(detail::ParameterTraits<DialogueContentKind>::tag) {
+    ++revision_;
     unset<DialogueId>();
   }
   void AudioContent::unset(detail::ParameterTraits<MixedContentKind>::tag) {
+    ++revision_;
     unset<DialogueId>();
   }
 
   // ---- References ---- //
   bool AudioContent::addReference(std::shared_ptr<AudioObject> object) {
+    ++revision_;
     autoParent(shared_from_this(), object);
     if (getParent().lock() != object->getParent().lock()) {
       throw std::runtime_error(
@@ -186,6 +209,7 @@ namespace adm {
   }
 
   void AudioContent::removeReference(std::shared_ptr<AudioObject> object) {
+    ++revision_;
     auto it = std::find(audioObjects_.begin(), audioObjects_.end(), object);
     if (it != audioObjects_.end()) {
       audioObjects_.erase(it);
@@ -196,6 +220,7 @@ namespace adm {
 
   void AudioContent::clearReferences(
       detail::ParameterTraits<AudioObject>::tag) {
+    ++revision_;
     return audioObjects_.clear();
   }
 
@@ -230,9 +255,25 @@ namespace adm {
 
   void AudioContent::setParent(std::weak_ptr<Document> document) {
     parent_ = document;
+    revision_.setGeneration(DocumentAttorney::getGeneration(document));
   }
   std::weak_ptr<Document> AudioContent::getParent() const { return parent_; }
 
+  std::size_t AudioContent::getRevision() const { return revision_.get(); }
+
+  std::uint64_t AudioContent::getContentHash() const {
+    detail::ContentHashMemo memo;
+    return getContentHash(memo);
+  }
+
+  std::uint64_t AudioContent::getContentHash(
+      detail::ContentHashMemo& memo) const {
+    detail::ContentHasher hasher(memo);
+    hasher.add(detail::cachedParameterHash(*this, contentHash_));
+    hasher.addContentHashes(audioObjects_);
+    return hasher.get();
+  }
+
   std::shared_ptr<AudioContent> AudioContent::copy() const {
     auto audioContentCopy =
         std::shared_ptr<AudioContent>(new AudioContent(*this));
@@ -1,5 +1,6 @@
 #include "adm/elements/audio_content_id.hpp"
-#include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
+#include <cstring>
 #include <regex>
 #include <sstream>
 #include "adm/detail/hex_values.hpp"
@@ -47,13 +48,17 @@ namespace adm {
   }
 
   bool AudioContentId::operator<(const AudioContentId& other) const {
-    return formatId(*this) < formatId(other);
+    return key() < other.key();
   }
 
   // ---- Common ---- //
+  std::uint64_t AudioContentId::key() const {
+    return get<AudioContentIdValue>().get();
+  }
+
   void AudioContentId::print(std::ostream& os) const {
-    os << boost::str(boost::format("ACO_%1%") %
-                     detail::formatHexValue(get<AudioContentIdValue>().get()));
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    os.write(buffer, static_cast<std::streamsize>(formatId(buffer, *this)));
   }
 
   AudioContentId parseAudioContentId(const std::string& id) {
@@ -70,9 +75,20 @@ namespace adm {
   }
 
   std::string formatId(AudioContentId id) {
-    std::stringstream idStream;
-    id.print(idStream);
-    return idStream.str();
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    return std::string(buffer, formatId(buffer, id));
+  }
+
+  std::size_t formatId(char* buffer, const AudioContentId& id) {
+    char* out = buffer;
+    std::memcpy(out, "ACO_", 4);
+    out += 4;
+    out += detail::formatHexValue(out, id.get<AudioContentIdValue>().get());
+    return static_cast<std::size_t>(out - buffer);
+  }
+
+  std::size_t hash_value(const AudioContentId& id) {
+    return boost::hash_value(id.key());
   }
 
 }  // namespace adm
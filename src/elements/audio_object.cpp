@@ -2,6 +2,7 @@
 #include "adm/document.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
+#include "adm/private/content_hash.hpp"
 #include "adm/utilities/element_io.hpp"
 #include "adm/utilities/id_assignment.hpp"
 #include "adm/errors.hpp"
@@ -83,6 +84,7 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioObject::set(AudioObjectId id) {
+    ++revision_;
     if (isUndefined(id)) {
       id_ = id;
       return;
@@ -92,40 +94,67 @@ namespace adm {
     }
     id_ = id;
   }
-  void AudioObject::set(AudioObjectName name) { name_ = name; }
-  void AudioObject::set(Start start) { start_ = start; }
-  void AudioObject::set(Duration duration) { duration_ = duration; }
-  void AudioObject::set(DialogueId id) { dialogueId_ = id; }
-  void AudioObject::set(Importance importance) { importance_ = importance; }
-  void AudioObject::set(Interact interact) { interact_ = interact; }
+  void AudioObject::set(AudioObjectName name) {
+    ++revision_;
+    name_ = name;
+  }
+  void AudioObject::set(Start start) {
+    ++revision_;
+    start_ = start;
+  }
+  void AudioObject::set(Duration duration) {
+    ++revision_;
+    duration_ = duration;
+  }
+  void AudioObject::set(DialogueId id) {
+    ++revision_;
+    dialogueId_ = id;
+  }
+  void AudioObject::set(Importance importance) {
+    ++revision_;
+    importance_ = importance;
+  }
+  void AudioObject::set(Interact interact) {
+    ++revision_;
+    interact_ = interact;
+  }
   void AudioObject::set(DisableDucking disableDucking) {
+    ++revision_;
     disableDucking_ = disableDucking;
   }
   void AudioObject::set(AudioObjectInteraction audioObjectInteraction) {
+    ++revision_;
     audioObjectInteraction_ = audioObjectInteraction;
   }
 
   // ---- Unsetter ---- //
   void AudioObject::unset(detail::ParameterTraits<Start>::tag) {
+    ++revision_;
     start_ = boost::none;
   }
   void AudioObject::unset(detail::ParameterTraits<Duration>::tag) {
+    ++revision_;
     duration_ = boost::none;
   }
   void AudioObject::unset(detail::ParameterTraits<DialogueId>::tag) {
+    ++revision_;
     dialogueId_ = boost::none;
   }
   void AudioObject::unset(detail::ParameterTraits<Importance>::tag) {
+    ++revision_;
     importance_ = boost::none;
   }
   void AudioObject::unset(detail::ParameterTraits<Interact>::tag) {
+    ++revision_;
     interact_ = boost::none;
   }
   void AudioObject::unset(detail::ParameterTraits<DisableDucking>::tag) {
+    ++revision_;
     disableDucking_ = boost::none;
   }
   void AudioObject::unset(
       detail::ParameterTraits<AudioObjectInteraction>::tag) {
+    ++revision_;
     audioObjectInteraction_ = boost::none;
   }
 
@@ -145,6 +174,7 @@ namespace adm {
   }
 
   bool AudioObject::addReference(std::shared_ptr<AudioObject> object) {
+    ++revision_;
     if (object->isAudioObjectReferenceCycle(shared_from_this())) {
       throw error::AudioObjectReferenceCycle(this->get<AudioObjectId>(),
                                              object->get<AudioObjectId>());
@@ -167,6 +197,7 @@ namespace adm {
   }
 
   bool AudioObject::addReference(std::shared_ptr<AudioPackFormat> packFormat) {
+    ++revision_;
     autoParent(shared_from_this(), packFormat);
     if (getParent().lock() != packFormat->getParent().lock()) {
       throw std::runtime_error(
@@ -184,6 +215,7 @@ namespace adm {
   }
 
   bool AudioObject::addReference(std::shared_ptr<AudioTrackUid> trackUid) {
+    ++revision_;
     autoParent(shared_from_this(), trackUid);
     if (getParent().lock() != trackUid->getParent().lock()) {
       throw std::runtime_error(
@@ -201,6 +233,7 @@ namespace adm {
   }
 
   void AudioObject::removeReference(std::shared_ptr<AudioObject> object) {
+    ++revision_;
     auto it = std::find(audioObjects_.begin(), audioObjects_.end(), object);
     if (it != audioObjects_.end()) {
       audioObjects_.erase(it);
@@ -209,6 +242,7 @@ namespace adm {
 
   void AudioObject::removeReference(
       std::shared_ptr<AudioPackFormat> packFormat) {
+    ++revision_;
     auto it = std::find(audioPackFormats_.begin(), audioPackFormats_.end(),
                         packFormat);
     if (it != audioPackFormats_.end()) {
@@ -217,6 +251,7 @@ namespace adm {
   }
 
   void AudioObject::removeReference(std::shared_ptr<AudioTrackUid> trackUid) {
+    ++revision_;
     auto it =
         std::find(audioTrackUids_.begin(), audioTrackUids_.end(), trackUid);
     if (it != audioTrackUids_.end()) {
@@ -232,16 +267,19 @@ namespace adm {
   }
 
   void AudioObject::clearReferences(detail::ParameterTraits<AudioObject>::tag) {
+    ++revision_;
     return audioObjects_.clear();
   }
 
   void AudioObject::clearReferences(
       detail::ParameterTraits<AudioPackFormat>::tag) {
+    ++revision_;
     return audioPackFormats_.clear();
   }
 
   void AudioObject::clearReferences(
       detail::ParameterTraits<AudioTrackUid>::tag) {
+    ++revision_;
     return audioTrackUids_.clear();
   }
 
@@ -260,6 +298,7 @@ namespace adm {
   }
 
   bool AudioObject::addComplementary(std::shared_ptr<AudioObject> object) {
+    ++revision_;
     if (object->isComplementaryAudioObjectReferenceCycle(shared_from_this())) {
       throw error::AudioObjectReferenceCycle(this->get<AudioObjectId>(),
                                              object->get<AudioObjectId>());
@@ -280,6 +319,7 @@ namespace adm {
   }
 
   void AudioObject::removeComplementary(std::shared_ptr<AudioObject> object) {
+    ++revision_;
     auto it = std::find(audioComplementaryObjects_.begin(),
                         audioComplementaryObjects_.end(), object);
     if (it != audioComplementaryObjects_.end()) {
@@ -293,6 +333,7 @@ namespace adm {
   }
 
   void AudioObject::clearComplementaryObjects() {
+    ++revision_;
     return audioComplementaryObjects_.clear();
   }
 
@@ -324,10 +365,32 @@ namespace adm {
 
   void AudioObject::setParent(std::weak_ptr<Document> document) {
     parent_ = document;
+    revision_.setGeneration(DocumentAttorney::getGeneration(document));
   }
 
   std::weak_ptr<Document> AudioObject::getParent() const { return parent_; }
 
+  std::size_t AudioObject::getRevision() const { return revision_.get(); }
+
+  std::uint64_t AudioObject::getContentHash() const {
+    detail::ContentHashMemo memo;
+    return getContentHash(memo);
+  }
+
+  std::uint64_t AudioObject::getContentHash(
+      detail::ContentHashMemo& memo) const {
+    detail::ContentHasher hasher(memo);
+    hasher.add(detail::cachedParameterHash(*this, contentHash_));
+    hasher.addContentHashes(audioObjects_);
+    hasher.addContentHashes(audioPackFormats_);
+    hasher.addContentHashes(audioTrackUids_);
+    hasher.add(audioComplementaryObjects_.size());
+    for (const auto& object : audioComplementaryObjects_) {
+      hasher.add(object->get<AudioObjectId>().key());
+    }
+    return hasher.get();
+  }
+
   std::shared_ptr<AudioObject> AudioObject::copy() const {
     auto audioObjectCopy = std::shared_ptr<AudioObject>(new AudioObject(*this));
     audioObjectCopy->setParent(std::weak_ptr<Document>());
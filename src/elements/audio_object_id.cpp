@@ -1,5 +1,6 @@
 #include "adm/elements/audio_object_id.hpp"
-#include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
+#include <cstring>
 #include <regex>
 #include <sstream>
 #include "adm/detail/hex_values.hpp"
@@ -45,13 +46,17 @@ namespace adm {
   }
 
   bool AudioObjectId::operator<(const AudioObjectId& other) const {
-    return formatId(*this) < formatId(other);
+    return key() < other.key();
   }
 
   // ---- Common ---- //
+  std::uint64_t AudioObjectId::key() const {
+    return get<AudioObjectIdValue>().get();
+  }
+
   void AudioObjectId::print(std::ostream& os) const {
-    os << boost::str(boost::format("AO_%1%") %
-                     detail::formatHexValue(get<AudioObjectIdValue>().get()));
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    os.write(buffer, static_cast<std::streamsize>(formatId(buffer, *this)));
   }
 
   AudioObjectId parseAudioObjectId(const std::string& id) {
@@ -68,9 +73,20 @@ namespace adm {
   }
 
   std::string formatId(AudioObjectId id) {
-    std::stringstream idStream;
-    id.print(idStream);
-    return idStream.str();
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    return std::string(buffer, formatId(buffer, id));
+  }
+
+  std::size_t formatId(char* buffer, const AudioObjectId& id) {
+    char* out = buffer;
+    std::memcpy(out, "AO_", 3);
+    out += 3;
+    out += detail::formatHexValue(out, id.get<AudioObjectIdValue>().get());
+    return static_cast<std::size_t>(out - buffer);
+  }
+
+  std::size_t hash_value(const AudioObjectId& id) {
+    return boost::hash_value(id.key());
   }
 
 }  // namespace adm
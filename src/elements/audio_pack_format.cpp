@@ -2,6 +2,7 @@
 #include "adm/document.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
+#include "adm/private/content_hash.hpp"
 #include "adm/utilities/element_io.hpp"
 #include "adm/utilities/id_assignment.hpp"
 
@@ -34,6 +35,7 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioPackFormat::set(AudioPackFormatId id) {
+    ++revision_;
     if (isUndefined(id)) {
       id_ = id;
       return;
@@ -52,9 +54,16 @@ namespace adm {
       throw std::runtime_error(errorString.str());
     }
   }
-  void AudioPackFormat::set(AudioPackFormatName name) { name_ = name; }
-  void AudioPackFormat::set(Importance importance) { importance_ = importance; }
+  void AudioPackFormat::set(AudioPackFormatName name) {
+    ++revision_;
+    name_ = name;
+  }
+  void AudioPackFormat::set(Importance importance) {
+    ++revision_;
+    importance_ = importance;
+  }
   void AudioPackFormat::set(AbsoluteDistance absoluteDistance) {
+    ++revision_;
     absoluteDistance_ = absoluteDistance;
   }
 
@@ -81,9 +90,11 @@ namespace adm {
 
   // ---- Unsetter ---- //
   void AudioPackFormat::unset(detail::ParameterTraits<Importance>::tag) {
+    ++revision_;
     importance_ = boost::none;
   }
   void AudioPackFormat::unset(detail::ParameterTraits<AbsoluteDistance>::tag) {
+    ++revision_;
     absoluteDistance_ = boost::none;
   }
 
@@ -104,6 +115,7 @@ namespace adm {
 
   bool AudioPackFormat::addReference(
       std::shared_ptr<AudioChannelFormat> channelFormat) {
+    ++revision_;
     autoParent(shared_from_this(), channelFormat);
     if (getParent().lock() != channelFormat->getParent().lock()) {
       throw std::runtime_error(
@@ -114,6 +126,7 @@ namespace adm {
                         audioChannelFormats_.end(), channelFormat);
     if (it == audioChannelFormats_.end()) {
       audioChannelFormats_.push_back(channelFormat);
+      ++referenceRevision_;
       return true;
     } else {
       return false;
@@ -122,6 +135,7 @@ namespace adm {
 
   bool AudioPackFormat::addReference(
       std::shared_ptr<AudioPackFormat> packFormat) {
+    ++revision_;
     if (packFormat->isAudioPackFormatReferenceCycle(shared_from_this())) {
       throw std::runtime_error(
           "adding AudioPackFormat reference would create a reference cycle");
@@ -136,6 +150,7 @@ namespace adm {
                         packFormat);
     if (it == audioPackFormats_.end()) {
       audioPackFormats_.push_back(packFormat);
+      ++referenceRevision_;
       return true;
     } else {
       return false;
@@ -144,19 +159,23 @@ namespace adm {
 
   void AudioPackFormat::removeReference(
       std::shared_ptr<AudioChannelFormat> object) {
+    ++revision_;
     auto it = std::find(audioChannelFormats_.begin(),
                         audioChannelFormats_.end(), object);
     if (it != audioChannelFormats_.end()) {
       audioChannelFormats_.erase(it);
+      ++referenceRevision_;
     }
   }
 
   void AudioPackFormat::removeReference(
       std::shared_ptr<AudioPackFormat> packFormat) {
+    ++revision_;
     auto it = std::find(audioPackFormats_.begin(), audioPackFormats_.end(),
                         packFormat);
     if (it != audioPackFormats_.end()) {
       audioPackFormats_.erase(it);
+      ++referenceRevision_;
     }
   }
 
@@ -167,12 +186,20 @@ namespace adm {
 
   void AudioPackFormat::clearReferences(
       detail::ParameterTraits<AudioChannelFormat>::tag) {
+    ++revision_;
     audioChannelFormats_.clear();
+    ++referenceRevision_;
   }
 
   void AudioPackFormat::clearReferences(
       detail::ParameterTraits<AudioPackFormat>::tag) {
+    ++revision_;
     audioPackFormats_.clear();
+    ++referenceRevision_;
+  }
+
+  std::size_t AudioPackFormat::getReferenceRevision() const {
+    return referenceRevision_;
   }
 
   // ---- Common ---- //
@@ -193,10 +220,27 @@ namespace adm {
 
   void AudioPackFormat::setParent(std::weak_ptr<Document> document) {
     parent_ = document;
+    revision_.setGeneration(DocumentAttorney::getGeneration(document));
   }
 
   std::weak_ptr<Document> AudioPackFormat::getParent() const { return parent_; }
 
+  std::size_t AudioPackFormat::getRevision() const { return revision_.get(); }
+
+  std::uint64_t AudioPackFormat::getContentHash() const {
+    detail::ContentHashMemo memo;
+    return getContentHash(memo);
+  }
+
+  std::uint64_t AudioPackFormat::getContentHash(
+      detail::ContentHashMemo& memo) const {
+    detail::ContentHasher hasher(memo);
+    hasher.add(detail::cachedParameterHash(*this, contentHash_));
+    hasher.addContentHashes(audioChannelFormats_);
+    hasher.addContentHashes(audioPackFormats_);
+    return hasher.get();
+  }
+
   std::shared_ptr<AudioPackFormat> AudioPackFormat::copy() const {
     auto audioPackFormatCopy =
         std::shared_ptr<AudioPackFormat>(new AudioPackFormat(*this));
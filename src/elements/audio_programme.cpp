@@ -6,6 +6,7 @@
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
 #include "adm/elements/private/auto_parent.hpp"
+#include "adm/private/content_hash.hpp"
 #include "adm/utilities/element_io.hpp"
 #include "adm/utilities/id_assignment.hpp"
 
@@ -87,6 +88,7 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioProgramme::set(AudioProgrammeId id) {
+    ++revision_;
     if (isUndefined(id)) {
       id_ = id;
       return;
@@ -97,44 +99,66 @@ namespace adm {
     id_ = id;
   }
 
-  void AudioProgramme::set(AudioProgrammeName name) { name_ = name; }
+  void AudioProgramme::set(AudioProgrammeName name) {
+    ++revision_;
+    name_ = name;
+  }
   void AudioProgramme::set(AudioProgrammeLanguage language) {
+    ++revision_;
     language_ = language;
   }
-  void AudioProgramme::set(Start start) { start_ = start; }
-  void AudioProgramme::set(End end) { end_ = end; }
+  void AudioProgramme::set(Start start) {
+    ++revision_;
+    start_ = start;
+  }
+  void AudioProgramme::set(End end) {
+    ++revision_;
+    end_ = end;
+  }
   void AudioProgramme::set(LoudnessMetadata loudnessMetadata) {
+    ++revision_;
     loudnessMetadata_ = loudnessMetadata;
   }
-  void AudioProgramme::set(MaxDuckingDepth depth) { maxDuckingDepth_ = depth; }
+  void AudioProgramme::set(MaxDuckingDepth depth) {
+    ++revision_;
+    maxDuckingDepth_ = depth;
+  }
   void AudioProgramme::set(AudioProgrammeReferenceScreen refScreen) {
+    ++revision_;
     refScreen_ = refScreen;
   }
 
   // ---- Unsetter ---- //
   void AudioProgramme::unset(
       detail::ParameterTraits<AudioProgrammeLanguage>::tag) {
+    ++revision_;
     language_ = boost::none;
   }
   void AudioProgramme::unset(detail::ParameterTraits<Start>::tag) {
+    ++revision_;
     start_ = boost::none;
   }
   void AudioProgramme::unset(detail::ParameterTraits<End>::tag) {
+    ++revision_;
     end_ = boost::none;
   }
   void AudioProgramme::unset(detail::ParameterTraits<LoudnessMetadata>::tag) {
+    ++revision_;
     loudnessMetadata_ = boost::none;
   }
   void AudioProgramme::unset(detail::ParameterTraits<MaxDuckingDepth>::tag) {
+    ++revision_;
     maxDuckingDepth_ = boost::none;
   }
   void AudioProgramme::unset(
       detail::ParameterTraits<AudioProgrammeReferenceScreen>::tag) {
+    ++revision_;
     refScreen_ = boost::none;
   }
 
   // ---- References ---- //
   bool AudioProgramme::addReference(std::shared_ptr<AudioContent> content) {
+    ++revision_;
     autoParent(shared_from_this(), content);
     if (getParent().lock() != content->getParent().lock()) {
       throw std::runtime_error(
@@ -151,6 +175,7 @@ namespace adm {
   }
 
   void AudioProgramme::removeReference(std::shared_ptr<AudioContent> content) {
+    ++revision_;
     auto it = std::find(audioContents_.begin(), audioContents_.end(), content);
     if (it != audioContents_.end()) {
       audioContents_.erase(it);
@@ -163,6 +188,7 @@ namespace adm {
 
   void AudioProgramme::clearReferences(
       detail::ParameterTraits<AudioContent>::tag) {
+    ++revision_;
     audioContents_.clear();
   }
 
@@ -195,9 +221,25 @@ namespace adm {
 
   void AudioProgramme::setParent(std::weak_ptr<Document> document) {
     parent_ = document;
+    revision_.setGeneration(DocumentAttorney::getGeneration(document));
   }
   std::weak_ptr<Document> AudioProgramme::getParent() const { return parent_; };
 
+  std::size_t AudioProgramme::getRevision() const { return revision_.get(); }
+
+  std::uint64_t AudioProgramme::getContentHash() const {
+    detail::ContentHashMemo memo;
+    return getContentHash(memo);
+  }
+
+  std::uint64_t AudioProgramme::getContentHash(
+      detail::ContentHashMemo& memo) const {
+    detail::ContentHasher hasher(memo);
+    hasher.add(detail::cachedParameterHash(*this, contentHash_));
+    hasher.addContentHashes(audioContents_);
+    return hasher.get();
+  }
+
   std::shared_ptr<AudioProgramme> AudioProgramme::copy() const {
     auto audioProgrammeCopy =
         std::shared_ptr<AudioProgramme>(new AudioProgramme(*this));
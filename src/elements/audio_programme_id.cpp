@@ -1,5 +1,6 @@
 #include "adm/elements/audio_programme_id.hpp"
-#include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
+#include <cstring>
 #include <regex>
 #include <sstream>
 #include "adm/detail/hex_values.hpp"
@@ -47,14 +48,17 @@ namespace adm {
   }
 
   bool AudioProgrammeId::operator<(const AudioProgrammeId& other) const {
-    return formatId(*this) < formatId(other);
+    return key() < other.key();
   }
 
   // ---- Common ---- //
+  std::uint64_t AudioProgrammeId::key() const {
+    return get<AudioProgrammeIdValue>().get();
+  }
+
   void AudioProgrammeId::print(std::ostream& os) const {
-    os << boost::str(
-        boost::format("APR_%1%") %
-        detail::formatHexValue(get<AudioProgrammeIdValue>().get()));
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    os.write(buffer, static_cast<std::streamsize>(formatId(buffer, *this)));
   }
 
   AudioProgrammeId parseAudioProgrammeId(const std::string& id) {
@@ -71,9 +75,20 @@ namespace adm {
   }
 
   std::string formatId(AudioProgrammeId id) {
-    std::stringstream idStream;
-    id.print(idStream);
-    return idStream.str();
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    return std::string(buffer, formatId(buffer, id));
+  }
+
+  std::size_t formatId(char* buffer, const AudioProgrammeId& id) {
+    char* out = buffer;
+    std::memcpy(out, "APR_", 4);
+    out += 4;
+    out += detail::formatHexValue(out, id.get<AudioProgrammeIdValue>().get());
+    return static_cast<std::size_t>(out - buffer);
+  }
+
+  std::size_t hash_value(const AudioProgrammeId& id) {
+    return boost::hash_value(id.key());
   }
 
 }  // namespace adm
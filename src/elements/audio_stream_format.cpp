@@ -2,6 +2,7 @@
 #include "adm/document.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
+#include "adm/private/content_hash.hpp"
 #include "adm/utilities/element_io.hpp"
 #include "adm/utilities/id_assignment.hpp"
 
@@ -23,6 +24,7 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioStreamFormat::set(AudioStreamFormatId id) {
+    ++revision_;
     if (isUndefined(id)) {
       id_ = id;
       return;
@@ -32,7 +34,10 @@ namespace adm {
     }
     id_ = id;
   }
-  void AudioStreamFormat::set(AudioStreamFormatName name) { name_ = name; }
+  void AudioStreamFormat::set(AudioStreamFormatName name) {
+    ++revision_;
+    name_ = name;
+  }
 
   // ---- Has ---- //
   bool AudioStreamFormat::has(
@@ -51,6 +56,7 @@ namespace adm {
   // ---- References ---- //
   void AudioStreamFormat::setReference(
       std::shared_ptr<AudioChannelFormat> channelFormat) {
+    ++revision_;
     autoParent(shared_from_this(), channelFormat);
     if (getParent().lock() != channelFormat->getParent().lock()) {
       throw std::runtime_error(
@@ -62,6 +68,7 @@ namespace adm {
 
   void AudioStreamFormat::setReference(
       std::shared_ptr<AudioPackFormat> packFormat) {
+    ++revision_;
     autoParent(shared_from_this(), packFormat);
     if (getParent().lock() != packFormat->getParent().lock()) {
       throw std::runtime_error(
@@ -74,6 +81,7 @@ namespace adm {
   bool AudioStreamFormat::addReference(
       std::weak_ptr<AudioTrackFormat> weakTrackFormat,
       ReferenceSyncOption sync) {
+    ++revision_;
     if (sync != ReferenceSyncOption::sync_with_track_format) {
       throw std::logic_error("The given ReferenceSyncOption not implemented.");
     }
@@ -140,17 +148,20 @@ namespace adm {
 
   void AudioStreamFormat::removeReference(
       detail::ParameterTraits<AudioChannelFormat>::tag) {
+    ++revision_;
     audioChannelFormat_ = nullptr;
   }
 
   void AudioStreamFormat::removeReference(
       detail::ParameterTraits<AudioPackFormat>::tag) {
+    ++revision_;
     audioPackFormat_ = nullptr;
   }
 
   void AudioStreamFormat::removeReference(
       std::weak_ptr<AudioTrackFormat> weakTrackFormat,
       ReferenceSyncOption sync) {
+    ++revision_;
     if (sync != ReferenceSyncOption::sync_with_track_format) {
       throw std::logic_error("The given ReferenceSyncOption not implemented.");
     }
@@ -169,6 +180,7 @@ namespace adm {
 
   void AudioStreamFormat::clearReferences(
       detail::ParameterTraits<AudioTrackFormat>::tag) {
+    ++revision_;
     audioTrackFormats_.clear();
   }
 
@@ -185,12 +197,39 @@ namespace adm {
 
   void AudioStreamFormat::setParent(std::weak_ptr<Document> document) {
     parent_ = document;
+    revision_.setGeneration(DocumentAttorney::getGeneration(document));
   }
 
   std::weak_ptr<Document> AudioStreamFormat::getParent() const {
     return parent_;
   }
 
+  std::size_t AudioStreamFormat::getRevision() const { return revision_.get(); }
+
+  std::uint64_t AudioStreamFormat::getContentHash() const {
+    detail::ContentHashMemo memo;
+    return getContentHash(memo);
+  }
+
+  std::uint64_t AudioStreamFormat::getContentHash(
+      detail::ContentHashMemo& memo) const {
+    detail::ContentHasher hasher(memo);
+    hasher.add(detail::cachedParameterHash(*this, contentHash_));
+    hasher.addContentHash(audioChannelFormat_);
+    hasher.addContentHash(audioPackFormat_);
+    std::vector<std::uint64_t> trackFormatKeys;
+    for (const auto& weakTrackFormat : audioTrackFormats_) {
+      if (auto trackFormat = weakTrackFormat.lock()) {
+        trackFormatKeys.push_back(trackFormat->get<AudioTrackFormatId>().key());
+      }
+    }
+    hasher.add(trackFormatKeys.size());
+    for (auto key : trackFormatKeys) {
+      hasher.add(key);
+    }
+    return hasher.get();
+  }
+
   std::shared_ptr<AudioStreamFormat> AudioStreamFormat::copy() const {
     auto audioStreamFormatCopy =
         std::shared_ptr<AudioStreamFormat>(new AudioStreamFormat(*this));
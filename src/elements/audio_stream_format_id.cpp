@@ -1,7 +1,9 @@
 #include "adm/elements/audio_stream_format_id.hpp"
-#include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
+#include <cstring>
 #include <regex>
 #include <sstream>
+#include <tuple>
 #include "adm/detail/hex_values.hpp"
 
 namespace adm {
@@ -72,14 +74,24 @@ namespace adm {
   }
 
   bool AudioStreamFormatId::operator<(const AudioStreamFormatId& other) const {
-    return formatId(*this) < formatId(other);
+    // not comparing the keys, as those of IDs with values out of the range
+    // of their string representation overlap
+    return std::make_tuple(get<TypeDescriptor>().get(),
+                           get<AudioStreamFormatIdValue>().get()) <
+           std::make_tuple(other.get<TypeDescriptor>().get(),
+                           other.get<AudioStreamFormatIdValue>().get());
   }
 
   // ---- Common ---- //
+  std::uint64_t AudioStreamFormatId::key() const {
+    std::uint64_t type = get<TypeDescriptor>().get();
+    std::uint64_t value = get<AudioStreamFormatIdValue>().get();
+    return (type << 48) | (value << 32);
+  }
+
   void AudioStreamFormatId::print(std::ostream& os) const {
-    os << boost::str(
-        boost::format("AS_%1%%2%") % formatTypeLabel(get<TypeDescriptor>()) %
-        detail::formatHexValue(get<AudioStreamFormatIdValue>().get()));
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    os.write(buffer, static_cast<std::streamsize>(formatId(buffer, *this)));
   }
 
   AudioStreamFormatId parseAudioStreamFormatId(const std::string& id) {
@@ -97,9 +109,24 @@ namespace adm {
   }
 
   std::string formatId(AudioStreamFormatId id) {
-    std::stringstream idStream;
-    id.print(idStream);
-    return idStream.str();
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    return std::string(buffer, formatId(buffer, id));
+  }
+
+  std::size_t formatId(char* buffer, const AudioStreamFormatId& id) {
+    char* out = buffer;
+    std::memcpy(out, "AS_", 3);
+    out += 3;
+    auto typeLabel = formatTypeLabel(id.get<TypeDescriptor>());
+    std::memcpy(out, typeLabel.data(), typeLabel.size());
+    out += typeLabel.size();
+    out += detail::formatHexValue(
+        out, id.get<AudioStreamFormatIdValue>().get());
+    return static_cast<std::size_t>(out - buffer);
+  }
+
+  std::size_t hash_value(const AudioStreamFormatId& id) {
+    return boost::hash_value(id.key());
   }
 
 }  // namespace adm
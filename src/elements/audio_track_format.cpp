@@ -3,6 +3,7 @@
 #include "adm/elements/audio_stream_format.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
+#include "adm/private/content_hash.hpp"
 #include "adm/utilities/element_io.hpp"
 #include "adm/utilities/id_assignment.hpp"
 
@@ -24,6 +25,7 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioTrackFormat::set(AudioTrackFormatId id) {
+    ++revision_;
     if (isUndefined(id)) {
       id_ = id;
       return;
@@ -33,7 +35,10 @@ namespace adm {
     }
     id_ = id;
   }
-  void AudioTrackFormat::set(AudioTrackFormatName name) { name_ = name; }
+  void AudioTrackFormat::set(AudioTrackFormatName name) {
+    ++revision_;
+    name_ = name;
+  }
 
   // ---- Has ---- //
   bool AudioTrackFormat::has(
@@ -53,6 +58,7 @@ namespace adm {
   void AudioTrackFormat::setReference(
       std::shared_ptr<AudioStreamFormat> streamFormat,
       ReferenceSyncOption sync) {
+    ++revision_;
     if (sync != ReferenceSyncOption::sync_with_stream_format) {
       throw std::logic_error("The given ReferenceSyncOption not implemented.");
     }
@@ -91,6 +97,7 @@ namespace adm {
   void AudioTrackFormat::removeReference(
       detail::ParameterTraits<AudioStreamFormat>::tag,
       ReferenceSyncOption sync) {
+    ++revision_;
     if (sync != ReferenceSyncOption::sync_with_stream_format) {
       throw std::logic_error("The given ReferenceSyncOption not implemented.");
     }
@@ -117,12 +124,28 @@ namespace adm {
 
   void AudioTrackFormat::setParent(std::weak_ptr<Document> document) {
     parent_ = document;
+    revision_.setGeneration(DocumentAttorney::getGeneration(document));
   }
 
   std::weak_ptr<Document> AudioTrackFormat::getParent() const {
     return parent_;
   }
 
+  std::size_t AudioTrackFormat::getRevision() const { return revision_.get(); }
+
+  std::uint64_t AudioTrackFormat::getContentHash() const {
+    detail::ContentHashMemo memo;
+    return getContentHash(memo);
+  }
+
+  std::uint64_t AudioTrackFormat::getContentHash(
+      detail::ContentHashMemo& memo) const {
+    detail::ContentHasher hasher(memo);
+    hasher.add(detail::cachedParameterHash(*this, contentHash_));
+    hasher.addContentHash(audioStreamFormat_);
+    return hasher.get();
+  }
+
   std::shared_ptr<AudioTrackFormat> AudioTrackFormat::copy() const {
     auto audioTrackFormatCopy =
         std::shared_ptr<AudioTrackFormat>(new AudioTrackFormat(*this));
@@ -1,7 +1,9 @@
 #include "adm/elements/audio_track_format_id.hpp"
-#include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
+#include <cstring>
 #include <regex>
 #include <sstream>
+#include <tuple>
 #include "adm/detail/hex_values.hpp"
 
 namespace adm {
@@ -94,16 +96,27 @@ namespace adm {
   }
 
   bool AudioTrackFormatId::operator<(const AudioTrackFormatId& other) const {
-    return formatId(*this) < formatId(other);
+    // not comparing the keys, as those of IDs with values out of the range
+    // of their string representation overlap
+    return std::make_tuple(get<TypeDescriptor>().get(),
+                           get<AudioTrackFormatIdValue>().get(),
+                           get<AudioTrackFormatIdCounter>().get()) <
+           std::make_tuple(other.get<TypeDescriptor>().get(),
+                           other.get<AudioTrackFormatIdValue>().get(),
+                           other.get<AudioTrackFormatIdCounter>().get());
   }
 
   // ---- Common ---- //
+  std::uint64_t AudioTrackFormatId::key() const {
+    std::uint64_t type = get<TypeDescriptor>().get();
+    std::uint64_t value = get<AudioTrackFormatIdValue>().get();
+    std::uint64_t counter = get<AudioTrackFormatIdCounter>().get();
+    return (type << 48) | (value << 32) | counter;
+  }
+
   void AudioTrackFormatId::print(std::ostream& os) const {
-    os << boost::str(
-        boost::format("AT_%1%%2%_%3%") %
-        formatTypeLabel(get<TypeDescriptor>()) %
-        detail::formatHexValue(get<AudioTrackFormatIdValue>().get()) %
-        detail::formatHexValue(get<AudioTrackFormatIdCounter>().get(), 2));
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    os.write(buffer, static_cast<std::streamsize>(formatId(buffer, *this)));
   }
 
   AudioTrackFormatId parseAudioTrackFormatId(const std::string& id) {
@@ -123,9 +136,26 @@ namespace adm {
   }
 
   std::string formatId(AudioTrackFormatId id) {
-    std::stringstream idStream;
-    id.print(idStream);
-    return idStream.str();
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    return std::string(buffer, formatId(buffer, id));
+  }
+
+  std::size_t formatId(char* buffer, const AudioTrackFormatId& id) {
+    char* out = buffer;
+    std::memcpy(out, "AT_", 3);
+    out += 3;
+    auto typeLabel = formatTypeLabel(id.get<TypeDescriptor>());
+    std::memcpy(out, typeLabel.data(), typeLabel.size());
+    out += typeLabel.size();
+    out += detail::formatHexValue(out, id.get<AudioTrackFormatIdValue>().get());
+    *out++ = '_';
+    out += detail::formatHexValue(
+        out, id.get<AudioTrackFormatIdCounter>().get(), 2);
+    return static_cast<std::size_t>(out - buffer);
+  }
+
+  std::size_t hash_value(const AudioTrackFormatId& id) {
+    return boost::hash_value(id.key());
   }
 
 }  // namespace adm
@@ -2,6 +2,7 @@
 #include "adm/elements/audio_track_format.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
+#include "adm/private/content_hash.hpp"
 #include "adm/utilities/element_io.hpp"
 #include "adm/utilities/id_assignment.hpp"
 
@@ -22,6 +23,7 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioTrackUid::set(AudioTrackUidId id) {
+    ++revision_;
     if (isUndefined(id)) {
       id_ = id;
       return;
@@ -31,8 +33,14 @@ namespace adm {
     }
     id_ = id;
   }
-  void AudioTrackUid::set(SampleRate sampleRate) { sampleRate_ = sampleRate; }
-  void AudioTrackUid::set(BitDepth bitDepth) { bitDepth_ = bitDepth; }
+  void AudioTrackUid::set(SampleRate sampleRate) {
+    ++revision_;
+    sampleRate_ = sampleRate;
+  }
+  void AudioTrackUid::set(BitDepth bitDepth) {
+    ++revision_;
+    bitDepth_ = bitDepth;
+  }
 
   // ---- Has ---- //
   bool AudioTrackUid::has(detail::ParameterTraits<AudioTrackUidId>::tag) const {
@@ -47,15 +55,18 @@ namespace adm {
 
   // ---- Unsetter ---- //
   void AudioTrackUid::unset(detail::ParameterTraits<BitDepth>::tag) {
+    ++revision_;
     bitDepth_ = boost::none;
   }
   void AudioTrackUid::unset(detail::ParameterTraits<SampleRate>::tag) {
+    ++revision_;
     sampleRate_ = boost::none;
   }
 
   // ---- References ---- //
   void AudioTrackUid::setReference(
       std::shared_ptr<AudioTrackFormat> trackFormat) {
+    ++revision_;
     autoParent(shared_from_this(), trackFormat);
     if (getParent().lock() != trackFormat->getParent().lock()) {
       throw std::runtime_error(
@@ -67,6 +78,7 @@ namespace adm {
 
   void AudioTrackUid::setReference(
       std::shared_ptr<AudioPackFormat> packFormat) {
+    ++revision_;
     autoParent(shared_from_this(), packFormat);
     if (getParent().lock() != packFormat->getParent().lock()) {
       throw std::runtime_error(
@@ -103,11 +115,13 @@ namespace adm {
 
   void AudioTrackUid::removeReference(
       detail::ParameterTraits<AudioTrackFormat>::tag) {
+    ++revision_;
     audioTrackFormat_ = nullptr;
   }
 
   void AudioTrackUid::removeReference(
       detail::ParameterTraits<AudioPackFormat>::tag) {
+    ++revision_;
     audioPackFormat_ = nullptr;
   }
 
@@ -127,10 +141,27 @@ namespace adm {
 
   void AudioTrackUid::setParent(std::weak_ptr<Document> document) {
     parent_ = document;
+    revision_.setGeneration(DocumentAttorney::getGeneration(document));
   }
 
   std::weak_ptr<Document> AudioTrackUid::getParent() const { return parent_; }
 
+  std::size_t AudioTrackUid::getRevision() const { return revision_.get(); }
+
+  std::uint64_t AudioTrackUid::getContentHash() const {
+    detail::ContentHashMemo memo;
+    return getContentHash(memo);
+  }
+
+  std::uint64_t AudioTrackUid::getContentHash(
+      detail::ContentHashMemo& memo) const {
+    detail::ContentHasher hasher(memo);
+    hasher.add(detail::cachedParameterHash(*this, contentHash_));
+    hasher.addContentHash(audioTrackFormat_);
+    hasher.addContentHash(audioPackFormat_);
+    return hasher.get();
+  }
+
   std::shared_ptr<AudioTrackUid> AudioTrackUid::copy() const {
     auto audioTrackUidCopy =
         std::shared_ptr<AudioTrackUid>(new AudioTrackUid(*this));
@@ -1,5 +1,6 @@
 #include "adm/elements/audio_track_uid_id.hpp"
-#include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
+#include <cstring>
 #include <regex>
 #include <sstream>
 #include "adm/detail/hex_values.hpp"
@@ -47,14 +48,17 @@ namespace adm {
   }
 
   bool AudioTrackUidId::operator<(const AudioTrackUidId& other) const {
-    return formatId(*this) < formatId(other);
+    return key() < other.key();
   }
 
   // ---- Common ---- //
+  std::uint64_t AudioTrackUidId::key() const {
+    return get<AudioTrackUidIdValue>().get();
+  }
+
   void AudioTrackUidId::print(std::ostream& os) const {
-    os << boost::str(
-        boost::format("ATU_%1%") %
-        detail::formatHexValue(get<AudioTrackUidIdValue>().get(), 8));
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    os.write(buffer, static_cast<std::streamsize>(formatId(buffer, *this)));
   }
 
   AudioTrackUidId parseAudioTrackUidId(const std::string& id) {
@@ -71,9 +75,20 @@ namespace adm {
   }
 
   std::string formatId(AudioTrackUidId id) {
-    std::stringstream idStream;
-    id.print(idStream);
-    return idStream.str();
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    return std::string(buffer, formatId(buffer, id));
+  }
+
+  std::size_t formatId(char* buffer, const AudioTrackUidId& id) {
+    char* out = buffer;
+    std::memcpy(out, "ATU_", 4);
+    out += 4;
+    out += detail::formatHexValue(out, id.get<AudioTrackUidIdValue>().get(), 8);
+    return static_cast<std::size_t>(out - buffer);
+  }
+
+  std::size_t hash_value(const AudioTrackUidId& id) {
+    return boost::hash_value(id.key());
   }
 
 }  // namespace adm
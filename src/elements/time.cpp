@@ -1,4 +1,5 @@
 #include "adm/elements/time.hpp"
+#include "adm/detail/number_formatting.hpp"
 #include <boost/format.hpp>
 #include <iomanip>
 #include <regex>
@@ -27,18 +28,42 @@ namespace adm {
   }
 
   std::string formatTimecode(const std::chrono::nanoseconds& time) {
-    std::stringstream ss;
-    ss << std::setw(2) << std::setfill('0')
-       << std::chrono::duration_cast<std::chrono::hours>(time).count();
-    ss << ":";
-    ss << std::setw(2) << std::setfill('0')
-       << std::chrono::duration_cast<std::chrono::minutes>(time).count() % 60;
-    ss << ":";
-    ss << std::setw(2) << std::setfill('0')
-       << std::chrono::duration_cast<std::chrono::seconds>(time).count() % 60;
-    ss << ".";
-    ss << std::setw(9) << std::setfill('0') << time.count() % 1000000000;
-    return ss.str();
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    return std::string(buffer, formatTimecode(buffer, time));
+  }
+
+  namespace {
+    char* writeDigits(char* out, unsigned long long value, int nmbOfDigits) {
+      for (int i = nmbOfDigits; i > 0; --i) {
+        out[i - 1] = static_cast<char>('0' + value % 10);
+        value /= 10;
+      }
+      return out + nmbOfDigits;
+    }
+  }  // namespace
+
+  std::size_t formatTimecode(char* buffer,
+                             const std::chrono::nanoseconds& time) {
+    char* out = buffer;
+    unsigned long long count = static_cast<unsigned long long>(time.count());
+    if (time.count() < 0) {
+      *out++ = '-';
+      count = 0ull - count;
+    }
+    unsigned long long hours = count / 3600000000000ull;
+    if (hours < 100) {
+      out = writeDigits(out, hours, 2);
+    } else {
+      out += detail::formatUnsigned(out, hours);
+    }
+    *out++ = ':';
+    out = writeDigits(out, count / 60000000000ull % 60, 2);
+    *out++ = ':';
+    out = writeDigits(out, count / 1000000000ull % 60, 2);
+    *out++ = '.';
+    out = writeDigits(out, count % 1000000000ull, 9);
+    *out = '\0';
+    return static_cast<std::size_t>(out - buffer);
   }
 
 }  // namespace adm
@@ -0,0 +1,64 @@
+#include "adm/handle_route.hpp"
+
+namespace adm {
+
+  namespace {
+    struct AddHandleVisitor : public boost::static_visitor<> {
+      AddHandleVisitor(HandleRoute* route) : route_(route) {}
+
+      template <typename Element>
+      void operator()(const std::shared_ptr<Element>& element) const {
+        route_->add(element);
+      }
+
+     private:
+      HandleRoute* route_;
+    };
+
+    template <typename Element>
+    ElementConstVariant lockElement(const ElementHandle& handle) {
+      return std::shared_ptr<const Element>(
+          handle.get<Element>()->shared_from_this());
+    }
+  }  // namespace
+
+  ElementConstVariant ElementHandle::lock() const {
+    if (is<AudioProgramme>()) {
+      return lockElement<AudioProgramme>(*this);
+    } else if (is<AudioContent>()) {
+      return lockElement<AudioContent>(*this);
+    } else if (is<AudioObject>()) {
+      return lockElement<AudioObject>(*this);
+    } else if (is<AudioTrackUid>()) {
+      return lockElement<AudioTrackUid>(*this);
+    } else if (is<AudioPackFormat>()) {
+      return lockElement<AudioPackFormat>(*this);
+    } else if (is<AudioChannelFormat>()) {
+      return lockElement<AudioChannelFormat>(*this);
+    } else if (is<AudioStreamFormat>()) {
+      return lockElement<AudioStreamFormat>(*this);
+    } else if (is<AudioTrackFormat>()) {
+      return lockElement<AudioTrackFormat>(*this);
+    }
+    throw std::logic_error("ElementHandle does not refer to an element");
+  }
+
+  HandleRoute::HandleRoute(const Route& route) {
+    for (const auto& element : route) {
+      add(element);
+    }
+  }
+
+  void HandleRoute::add(const ElementConstVariant& element) {
+    boost::apply_visitor(AddHandleVisitor(this), element);
+  }
+
+  Route HandleRoute::toRoute() const {
+    Route route;
+    for (const auto& handle : handles_) {
+      route.add(handle.lock());
+    }
+    return route;
+  }
+
+}  // namespace adm
@@ -19,4 +19,82 @@ namespace adm {
     xml::XmlParser parser(stream, options, commonDefinitions);
     return parser.parse();
   }
+
+  std::shared_ptr<Document> parseXml(const std::string& filename,
+                                     const xml::ParserFilter& filter,
+                                     xml::ParserOptions options) {
+    auto commonDefinitions = getCommonDefinitions();
+    xml::XmlParser parser(filename, options, commonDefinitions);
+    parser.setFilter(filter);
+    return parser.parse();
+  }
+
+  std::shared_ptr<Document> parseXml(std::istream& stream,
+                                     const xml::ParserFilter& filter,
+                                     xml::ParserOptions options) {
+    auto commonDefinitions = getCommonDefinitions();
+    xml::XmlParser parser(stream, options, commonDefinitions);
+    parser.setFilter(filter);
+    return parser.parse();
+  }
+
+  std::shared_ptr<Document> parseXml(const xml::ReadFunction& read,
+                                     xml::ParserOptions options) {
+    xml::XmlParser parser(options);
+    return parser.parse(read, getCommonDefinitions());
+  }
+
+  namespace xml {
+
+    Parser::Parser(ParserOptions options)
+        : parser_(new XmlParser(options)),
+          commonDefinitionsParser_(
+              new XmlParser(ParserOptions::recursive_node_search)),
+          commonDefinitionsXml_(getCommonDefinitionsXml()) {}
+
+    Parser::~Parser() = default;
+
+    std::shared_ptr<Document> Parser::parse(std::istream& stream) {
+      auto document = commonDefinitionsParser_->parse(
+          commonDefinitionsXml_.data(), commonDefinitionsXml_.size(),
+          Document::create());
+      return parser_->parse(stream, document);
+    }
+
+    std::shared_ptr<Document> Parser::parseFile(const std::string& filename) {
+      auto document = commonDefinitionsParser_->parse(
+          commonDefinitionsXml_.data(), commonDefinitionsXml_.size(),
+          Document::create());
+      return parser_->parseFile(filename, document);
+    }
+
+    std::shared_ptr<Document> Parser::parse(const ReadFunction& read) {
+      auto document = commonDefinitionsParser_->parse(
+          commonDefinitionsXml_.data(), commonDefinitionsXml_.size(),
+          Document::create());
+      return parser_->parse(read, document);
+    }
+
+    FrameParser::FrameParser(ParserOptions options)
+        : FrameParser(getCommonDefinitions(), options) {}
+
+    FrameParser::FrameParser(std::shared_ptr<Document> document,
+                             ParserOptions options)
+        : document_(std::move(document)), parser_(new XmlParser(options)) {}
+
+    FrameParser::~FrameParser() = default;
+
+    void FrameParser::parseFrame(std::istream& stream) {
+      parser_->parseFrame(stream, document_);
+    }
+
+    void FrameParser::parseFrame(const char* xml, std::size_t size) {
+      parser_->parseFrame(xml, size, document_);
+    }
+
+    std::shared_ptr<Document> FrameParser::getDocument() const {
+      return document_;
+    }
+
+  }  // namespace xml
 }  // namespace adm
@@ -0,0 +1,34 @@
+#include "adm/parser_filter.hpp"
+
+namespace adm {
+  namespace xml {
+
+    ParserFilter& ParserFilter::setProgramme(AudioProgrammeId id) {
+      programme_ = id;
+      return *this;
+    }
+
+    const boost::optional<AudioProgrammeId>& ParserFilter::getProgramme()
+        const {
+      return programme_;
+    }
+
+    ParserFilter& ParserFilter::setIdPredicate(
+        std::function<bool(const ElementIdVariant&)> predicate) {
+      predicate_ = std::move(predicate);
+      return *this;
+    }
+
+    bool ParserFilter::acceptsAll() const {
+      return !programme_ && skippedIdTypes_.empty() && !predicate_;
+    }
+
+    bool ParserFilter::accepts(const ElementIdVariant& id) const {
+      if (skippedIdTypes_.count(id.type())) {
+        return false;
+      }
+      return !predicate_ || predicate_(id);
+    }
+
+  }  // namespace xml
+}  // namespace adm
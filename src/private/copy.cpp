@@ -4,55 +4,46 @@
 namespace adm {
 
   struct ElementMapping {
-    // clang-format off
-    std::map<std::shared_ptr<const AudioProgramme>, std::shared_ptr<AudioProgramme>> audioProgramme;
-    std::map<std::shared_ptr<const AudioContent>, std::shared_ptr<AudioContent>> audioContent;
-    std::map<std::shared_ptr<const AudioObject>, std::shared_ptr<AudioObject>> audioObject;
-    std::map<std::shared_ptr<const AudioPackFormat>, std::shared_ptr<AudioPackFormat>> audioPackFormat;
-    std::map<std::shared_ptr<const AudioChannelFormat>, std::shared_ptr<AudioChannelFormat>> audioChannelFormat;
-    std::map<std::shared_ptr<const AudioStreamFormat>, std::shared_ptr<AudioStreamFormat>> audioStreamFormat;
-    std::map<std::shared_ptr<const AudioTrackFormat>, std::shared_ptr<AudioTrackFormat>> audioTrackFormat;
-    std::map<std::shared_ptr<const AudioTrackUid>, std::shared_ptr<AudioTrackUid>> audioTrackUid;
-    // clang-format on
+    ElementCopies<AudioProgramme> audioProgramme;
+    ElementCopies<AudioContent> audioContent;
+    ElementCopies<AudioObject> audioObject;
+    ElementCopies<AudioPackFormat> audioPackFormat;
+    ElementCopies<AudioChannelFormat> audioChannelFormat;
+    ElementCopies<AudioStreamFormat> audioStreamFormat;
+    ElementCopies<AudioTrackFormat> audioTrackFormat;
+    ElementCopies<AudioTrackUid> audioTrackUid;
   };
 
+  namespace {
+
+    template <typename Element>
+    void copyElements(const Document& document,
+                      ElementCopies<Element>& mapping,
+                      std::vector<ElementVariant>& copiedElements) {
+      auto elements = document.getElements<Element>();
+      mapping.reserve(elements.size());
+      for (auto& element : elements) {
+        auto copy = element->copy();
+        copiedElements.push_back(copy);
+        mapping.emplace(element.get(), std::move(copy));
+      }
+    }
+
+  }  // namespace
+
   std::vector<ElementVariant> copyAllElements(
       std::shared_ptr<const Document> document) {
     ElementMapping mapping;
     std::vector<ElementVariant> copiedElements;
     // copy
-    for (auto element : document->getElements<AudioProgramme>()) {
-      mapping.audioProgramme[element] = element->copy();
-      copiedElements.push_back(mapping.audioProgramme.at(element));
-    }
-    for (auto element : document->getElements<AudioContent>()) {
-      mapping.audioContent[element] = element->copy();
-      copiedElements.push_back(mapping.audioContent.at(element));
-    }
-    for (auto element : document->getElements<AudioObject>()) {
-      mapping.audioObject[element] = element->copy();
-      copiedElements.push_back(mapping.audioObject.at(element));
-    }
-    for (auto element : document->getElements<AudioPackFormat>()) {
-      mapping.audioPackFormat[element] = element->copy();
-      copiedElements.push_back(mapping.audioPackFormat.at(element));
-    }
-    for (auto element : document->getElements<AudioChannelFormat>()) {
-      mapping.audioChannelFormat[element] = element->copy();
-      copiedElements.push_back(mapping.audioChannelFormat.at(element));
-    }
-    for (auto element : document->getElements<AudioStreamFormat>()) {
-      mapping.audioStreamFormat[element] = element->copy();
-      copiedElements.push_back(mapping.audioStreamFormat.at(element));
-    }
-    for (auto element : document->getElements<AudioTrackFormat>()) {
-      mapping.audioTrackFormat[element] = element->copy();
-      copiedElements.push_back(mapping.audioTrackFormat.at(element));
-    }
-    for (auto element : document->getElements<AudioTrackUid>()) {
-      mapping.audioTrackUid[element] = element->copy();
-      copiedElements.push_back(mapping.audioTrackUid.at(element));
-    }
+    copyElements(*document, mapping.audioProgramme, copiedElements);
+    copyElements(*document, mapping.audioContent, copiedElements);
+    copyElements(*document, mapping.audioObject, copiedElements);
+    copyElements(*document, mapping.audioPackFormat, copiedElements);
+    copyElements(*document, mapping.audioChannelFormat, copiedElements);
+    copyElements(*document, mapping.audioStreamFormat, copiedElements);
+    copyElements(*document, mapping.audioTrackFormat, copiedElements);
+    copyElements(*document, mapping.audioTrackUid, copiedElements);
 
     // resolve
     for (auto element : document->getElements<AudioProgramme>()) {
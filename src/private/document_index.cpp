@@ -0,0 +1,31 @@
+#include "adm/private/document_index.hpp"
+#include "adm/document.hpp"
+
+namespace adm {
+  namespace detail {
+
+    namespace {
+      template <typename Element>
+      void insertAll(ElementIndex<Element>& index, const Document& document) {
+        auto elements = document.getElements<Element>();
+        index.elements.reserve(elements.size());
+        index.ids.reserve(elements.size());
+        for (auto& element : elements) {
+          index.insert(*element);
+        }
+      }
+    }  // namespace
+
+    DocumentIndex::DocumentIndex(const Document& document) {
+      insertAll(programmes_, document);
+      insertAll(contents_, document);
+      insertAll(objects_, document);
+      insertAll(packFormats_, document);
+      insertAll(channelFormats_, document);
+      insertAll(streamFormats_, document);
+      insertAll(trackFormats_, document);
+      insertAll(trackUids_, document);
+    }
+
+  }  // namespace detail
+}  // namespace adm
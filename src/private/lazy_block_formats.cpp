@@ -0,0 +1,127 @@
+#include "adm/private/lazy_block_formats.hpp"
+#include <cstring>
+#include "adm/elements/audio_channel_format.hpp"
+#include "adm/private/xml_parser.hpp"
+
+namespace adm {
+  namespace detail {
+
+    namespace {
+      /// terminates the attributes of a node
+      const char ATTRIBUTES_END = '\1';
+      /// terminates the children of a node
+      const char NODE_END = '\2';
+
+      bool isBlockFormatTypeSupported(const TypeDescriptor& typeDescriptor) {
+        return typeDescriptor == TypeDefinition::DIRECT_SPEAKERS ||
+               typeDescriptor == TypeDefinition::OBJECTS;
+      }
+
+      bool hasChildElements(xml::NodePtr node) {
+        for (auto child = node->first_node(); child;
+             child = child->next_sibling()) {
+          if (child->type() == rapidxml::node_element) {
+            return true;
+          }
+        }
+        return false;
+      }
+
+      void appendToken(std::string& tokens, const char* value,
+                       std::size_t size) {
+        tokens.append(value, size);
+        tokens.push_back('\0');
+      }
+
+      /**
+       * Append @a node to @a tokens as
+       * `name {attributeName attributeValue} ATTRIBUTES_END value
+       * {child} NODE_END`; only elements are stored, and the whitespace
+       * value of nodes with child elements is dropped.
+       */
+      void appendNode(std::string& tokens, xml::NodePtr node) {
+        appendToken(tokens, node->name(), node->name_size());
+        for (auto attribute = node->first_attribute(); attribute;
+             attribute = attribute->next_attribute()) {
+          appendToken(tokens, attribute->name(), attribute->name_size());
+          appendToken(tokens, attribute->value(), attribute->value_size());
+        }
+        tokens.push_back(ATTRIBUTES_END);
+        if (hasChildElements(node)) {
+          tokens.push_back('\0');
+          for (auto child = node->first_node(); child;
+               child = child->next_sibling()) {
+            if (child->type() == rapidxml::node_element) {
+              appendNode(tokens, child);
+            }
+          }
+        } else {
+          appendToken(tokens, node->value(), node->value_size());
+        }
+        tokens.push_back(NODE_END);
+      }
+
+      const char* nextToken(const char*& token) {
+        auto current = token;
+        token += std::strlen(token) + 1;
+        return current;
+      }
+
+      /// Rebuild the node starting at @a token, advancing @a token past it
+      xml::NodePtr readNode(rapidxml::memory_pool<>& pool,
+                            const char*& token) {
+        auto node = pool.allocate_node(rapidxml::node_element);
+        node->name(nextToken(token));
+        while (*token != ATTRIBUTES_END) {
+          auto attribute = pool.allocate_attribute();
+          attribute->name(nextToken(token));
+          attribute->value(nextToken(token));
+          node->append_attribute(attribute);
+        }
+        ++token;
+        node->value(nextToken(token));
+        while (*token != NODE_END) {
+          node->append_node(readNode(pool, token));
+        }
+        ++token;
+        return node;
+      }
+    }  // namespace
+
+    LazyBlockFormats::LazyBlockFormats(xml::NodePtr node,
+                                       TypeDescriptor typeDescriptor)
+        : typeDescriptor_(typeDescriptor) {
+      if (!isBlockFormatTypeSupported(typeDescriptor)) {
+        return;
+      }
+      for (auto child = node->first_node("audioBlockFormat"); child;
+           child = child->next_sibling("audioBlockFormat")) {
+        appendNode(tokens_, child);
+      }
+    }
+
+    void LazyBlockFormats::addTo(AudioChannelFormat& channelFormat) const {
+      rapidxml::memory_pool<> pool;
+      auto token = tokens_.data();
+      auto end = token + tokens_.size();
+      while (token != end) {
+        auto node = readNode(pool, token);
+        if (typeDescriptor_ == TypeDefinition::DIRECT_SPEAKERS) {
+          channelFormat.addParsed(xml::parseAudioBlockFormatDirectSpeakers(node));
+        } else if (typeDescriptor_ == TypeDefinition::OBJECTS) {
+          channelFormat.addParsed(xml::parseAudioBlockFormatObjects(node));
+        }
+        // reuse the memory of the nodes for the next audioBlockFormat
+        pool.clear();
+      }
+    }
+
+    void LazyBlockFormats::attach(
+        AudioChannelFormat& channelFormat,
+        std::shared_ptr<const LazyBlockFormats> blockFormats) {
+      channelFormat.lazyGuard_.setPending(blockFormats != nullptr);
+      channelFormat.lazyBlockFormats_ = std::move(blockFormats);
+    }
+
+  }  // namespace detail
+}  // namespace adm
@@ -0,0 +1,76 @@
+#include "adm/private/mapped_file.hpp"
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ADM_MAPPED_FILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace adm {
+
+  MappedFileRange::MappedFileRange(const std::string& filename,
+                                   std::uint64_t offset, std::size_t size)
+      : size_(size) {
+#ifdef ADM_MAPPED_FILE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("cannot open file " + filename);
+    }
+    struct stat status;
+    if (::fstat(fd, &status) == 0) {
+      auto fileSize = static_cast<std::uint64_t>(status.st_size);
+      auto pageSize = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+      auto end = offset + size;
+      // the byte after the range is replaced by the NUL; after the end of
+      // the file, the rest of its last page is mapped as zeros
+      if (end < fileSize || (end == fileSize && end % pageSize != 0)) {
+        auto mappingOffset = offset - offset % pageSize;
+        mappingSize_ = static_cast<std::size_t>(end + 1 - mappingOffset);
+        void* mapping =
+            ::mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                   fd, static_cast<off_t>(mappingOffset));
+        if (mapping != MAP_FAILED) {
+          mapping_ = mapping;
+          data_ = static_cast<char*>(mapping) +
+                  static_cast<std::size_t>(offset - mappingOffset);
+          data_[size] = '\0';
+        }
+      }
+    }
+    ::close(fd);
+    if (mapping_) {
+      return;
+    }
+#endif
+    read(filename, offset);
+  }
+
+  MappedFileRange::~MappedFileRange() {
+#ifdef ADM_MAPPED_FILE_MMAP
+    if (mapping_) {
+      ::munmap(mapping_, mappingSize_);
+    }
+#endif
+  }
+
+  void MappedFileRange::read(const std::string& filename,
+                             std::uint64_t offset) {
+    std::ifstream stream(filename, std::ios::binary);
+    if (!stream) {
+      throw std::runtime_error("cannot open file " + filename);
+    }
+    buffer_.resize(size_ + 1);
+    stream.seekg(static_cast<std::streamoff>(offset));
+    stream.read(buffer_.data(), static_cast<std::streamsize>(size_));
+    if (static_cast<std::size_t>(stream.gcount()) != size_) {
+      throw std::runtime_error("unexpected end of file " + filename);
+    }
+    buffer_[size_] = '\0';
+    data_ = buffer_.data();
+  }
+
+}  // namespace adm
@@ -6,27 +6,30 @@ namespace adm {
 
     namespace detail {
 
-      std::string toString(const std::string &string) { return string; }
-      std::string toString(const std::chrono::nanoseconds &time) {
-        return formatTimecode(time);
-      }
-      std::string toString(const AudioProgrammeId &id) { return formatId(id); }
-      std::string toString(const AudioContentId &id) { return formatId(id); }
-      std::string toString(const AudioObjectId &id) { return formatId(id); }
-      std::string toString(const AudioPackFormatId &id) { return formatId(id); }
-      std::string toString(const AudioChannelFormatId &id) {
-        return formatId(id);
-      }
-      std::string toString(const AudioBlockFormatId &id) {
-        return formatId(id);
-      }
-      std::string toString(const AudioStreamFormatId &id) {
-        return formatId(id);
-      }
-      std::string toString(const AudioTrackFormatId &id) {
-        return formatId(id);
-      }
-      std::string toString(const AudioTrackUidId &id) { return formatId(id); }
+      FormattedValue::FormattedValue(const std::chrono::nanoseconds &time)
+          : data_(buffer_), size_(formatTimecode(buffer_, time)) {}
+      FormattedValue::FormattedValue(const AudioProgrammeId &id)
+          : data_(buffer_), size_(formatId(buffer_, id)) {}
+      FormattedValue::FormattedValue(const AudioContentId &id)
+          : data_(buffer_), size_(formatId(buffer_, id)) {}
+      FormattedValue::FormattedValue(const AudioObjectId &id)
+          : data_(buffer_), size_(formatId(buffer_, id)) {}
+      FormattedValue::FormattedValue(const AudioPackFormatId &id)
+          : data_(buffer_), size_(formatId(buffer_, id)) {}
+      FormattedValue::FormattedValue(const AudioChannelFormatId &id)
+          : data_(buffer_), size_(formatId(buffer_, id)) {}
+      FormattedValue::FormattedValue(const AudioBlockFormatId &id)
+          : data_(buffer_), size_(formatId(buffer_, id)) {}
+      FormattedValue::FormattedValue(const AudioStreamFormatId &id)
+          : data_(buffer_), size_(formatId(buffer_, id)) {}
+      FormattedValue::FormattedValue(const AudioTrackFormatId &id)
+          : data_(buffer_), size_(formatId(buffer_, id)) {}
+      FormattedValue::FormattedValue(const AudioTrackUidId &id)
+          : data_(buffer_), size_(formatId(buffer_, id)) {}
+      FormattedValue::FormattedValue(float value)
+          : data_(buffer_), size_(adm::detail::formatFloat(buffer_, value)) {}
+      FormattedValue::FormattedValue(double value)
+          : data_(buffer_), size_(adm::detail::formatDouble(buffer_, value)) {}
 
       struct MultiElementAttributeFormatter {
         MultiElementAttributeFormatter(const std::string &a,
@@ -98,7 +101,7 @@ namespace adm {
     void formatNonDialogueContentKind(
         XmlNode &node, const NonDialogueContentKind contentKind) {
       // clang-format off
-      node.addAttribute("nonDialogueContentKind", std::to_string(contentKind.get()));
+      node.addAttribute("nonDialogueContentKind", detail::FormattedValue(contentKind));
       node.setValue(std::string("0"));
       // clang-format on
     }
@@ -106,7 +109,7 @@ namespace adm {
     void formatDialogueContentKind(XmlNode &node,
                                    const DialogueContentKind contentKind) {
       // clang-format off
-      node.addAttribute("dialogueContentKind", std::to_string(contentKind.get()));
+      node.addAttribute("dialogueContentKind", detail::FormattedValue(contentKind));
       node.setValue(std::string("1"));
       // clang-format on
     }
@@ -114,7 +117,7 @@ namespace adm {
     void formatMixedContentKind(XmlNode &node,
                                 const MixedContentKind contentKind) {
       // clang-format off
-      node.addAttribute("mixedContentKind", std::to_string(contentKind.get()));
+      node.addAttribute("mixedContentKind", detail::FormattedValue(contentKind));
       node.setValue(std::string("2"));
       // clang-format on
     }
@@ -255,7 +258,7 @@ namespace adm {
       // clang-format on
     }
 
-    void formatAudioChannelFormat(
+    void formatAudioChannelFormatHeader(
         XmlNode &node,
         std::shared_ptr<const AudioChannelFormat> channelFormat) {
       // clang-format off
@@ -264,7 +267,15 @@ namespace adm {
       node.addOptionalAttribute<TypeDescriptor>(channelFormat, "typeLabel", &formatTypeLabel);
       node.addOptionalAttribute<TypeDescriptor>(channelFormat, "typeDefinition", &formatTypeDefinition);
       node.addOptionalMultiElement<Frequency>(channelFormat, "frequency", &formatFrequency);
+      // clang-format on
+    }
+
+    void formatAudioChannelFormat(
+        XmlNode &node,
+        std::shared_ptr<const AudioChannelFormat> channelFormat) {
+      formatAudioChannelFormatHeader(node, channelFormat);
 
+      // clang-format off
       auto channelType = channelFormat->get<TypeDescriptor>();
       if (channelType == TypeDefinition::DIRECT_SPEAKERS) {
         node.addElements<AudioBlockFormatDirectSpeakers>(channelFormat, "audioBlockFormat", &formatBlockFormatDirectSpeakers);
@@ -1,24 +1,44 @@
 #include "adm/private/rapidxml_wrapper.hpp"
+#include "adm/detail/hex_values.hpp"
+#include <cstring>
+#include <utility>
+#include <stdexcept>
 
 namespace adm {
   namespace xml {
 
-    // ---- XML DOCUMENT WRAPPER ---- //
+    namespace {
+      /// flush the output buffer to the output once it exceeds this size
+      const std::size_t BUFFER_FLUSH_SIZE = 64 * 1024;
+
+      /// strings are truncated at the first NUL, like rapidxml does
+      std::size_t cStringSize(const std::string &str) {
+        return std::strlen(str.c_str());
+      }
+
+      std::size_t cStringSize(const char *str, std::size_t size) {
+        auto end = static_cast<const char *>(std::memchr(str, '\0', size));
+        return end ? static_cast<std::size_t>(end - str) : size;
+      }
+    }  // namespace
+
+    // ---- XML DOCUMENT WRITER ---- //
+
+    XmlDocument::XmlDocument(std::ostream &stream)
+        : XmlDocument([&stream](const char *data, std::size_t size) {
+            stream.write(data, static_cast<std::streamsize>(size));
+          }) {}
+
+    XmlDocument::XmlDocument(OutputFunction output)
+        : output_(std::move(output)) {}
 
     XmlNode XmlDocument::addNode(const std::string &name) {
-      auto nameString = doc_.allocate_string(name.c_str());
-      auto childNode = doc_.allocate_node(rapidxml::node_element, nameString);
-      doc_.append_node(childNode);
-      return XmlNode(childNode, discardDefaultValues_);
+      return addNode(-1, name);
     }
 
-    XmlNode XmlDocument::addDeclaration() {
-      auto declaration = doc_.allocate_node(rapidxml::node_declaration);
-      declaration->append_attribute(doc_.allocate_attribute("version", "1.0"));
-      declaration->append_attribute(
-          doc_.allocate_attribute("encoding", "utf-8"));
-      doc_.append_node(declaration);
-      return XmlNode(declaration, discardDefaultValues_);
+    void XmlDocument::addDeclaration() {
+      closeElementsBelow(-1);
+      buffer_.append("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n");
     }
 
     XmlNode XmlDocument::addItuStructure() {
@@ -43,31 +63,257 @@ namespace adm {
       return audioFormatExtendedNode;
     }
 
-    // ---- XML NODE WRAPPER ---- //
+    XmlNode XmlDocument::addFrameStructure(std::uint64_t frameIndex,
+                                           std::chrono::nanoseconds start,
+                                           std::chrono::nanoseconds duration) {
+      auto frameNode = addNode("frame");
+      frameNode.addAttribute("version", "ITU-R_BS.2125-1");
+      auto frameHeaderNode = frameNode.addNode("frameHeader");
+      auto frameFormatNode = frameHeaderNode.addNode("frameFormat");
+      // the ID holds the frame number, which starts with 1
+      frameFormatNode.addAttribute(
+          "frameFormatID",
+          "FF_" + adm::detail::formatHexValue(
+                      static_cast<unsigned>(frameIndex + 1), 8));
+      frameFormatNode.addAttribute("type", "full");
+      frameFormatNode.addAttribute("start", detail::FormattedValue(start));
+      frameFormatNode.addAttribute("duration",
+                                   detail::FormattedValue(duration));
+      frameFormatNode.addAttribute("timeReference", "total");
+      return frameNode.addNode("audioFormatExtended");
+    }
+
+    XmlNode XmlDocument::addFragmentRoot(int depth) {
+      if (openElementCount_ != 0 || nextSerial_ != 0 || depth < 0) {
+        throw std::logic_error(
+            "XmlDocument: fragment root must be added to an empty document");
+      }
+      // placeholders for the elements written elsewhere; these are never
+      // closed
+      openElements_.resize(static_cast<std::size_t>(depth) + 1);
+      for (auto &element : openElements_) {
+        element.serial = ++nextSerial_;
+        element.startTagOpen = false;
+      }
+      openElementCount_ = openElements_.size();
+      fragmentDepth_ = depth;
+      return XmlNode(this, depth, nextSerial_, discardDefaultValues_);
+    }
+
+    void XmlDocument::finish() {
+      closeElementsBelow(fragmentDepth_);
+      if (fragmentDepth_ < 0) {
+        // rapidxml terminates the document node itself with a newline, too
+        buffer_.push_back('\n');
+      }
+      flush();
+    }
+
+    void XmlDocument::reset(OutputFunction output) {
+      output_ = std::move(output);
+      buffer_.clear();
+      openElementCount_ = 0;
+      nextSerial_ = 0;
+      fragmentDepth_ = -1;
+      discardDefaultValues_ = false;
+    }
+
+    XmlNode XmlDocument::addNode(int parentDepth, const std::string &name) {
+      if (parentDepth >= 0) {
+        // validate the parent before closing anything
+        openElement(parentDepth, 0);
+      }
+      closeElementsBelow(parentDepth);
+      if (parentDepth >= 0) {
+        auto &parent = openElements_[parentDepth];
+        if (parent.startTagOpen) {
+          // rapidxml ignores the value of elements with children
+          buffer_.append(">\n");
+          parent.startTagOpen = false;
+          parent.value.clear();
+        }
+      }
+
+      int depth = parentDepth + 1;
+      if (openElements_.size() <= openElementCount_) {
+        openElements_.emplace_back();
+      }
+      auto &element = openElements_[openElementCount_++];
+      element.name.assign(name.c_str(), cStringSize(name));
+      element.value.clear();
+      element.serial = ++nextSerial_;
+      element.startTagOpen = true;
+
+      writeIndent(depth);
+      buffer_.push_back('<');
+      buffer_.append(element.name);
+      return XmlNode(this, depth, element.serial, discardDefaultValues_);
+    }
+
+    void XmlDocument::addAttribute(int depth, unsigned long serial,
+                                   const std::string &name, const char *value,
+                                   std::size_t size) {
+      openElement(depth, serial);
+      closeElementsBelow(depth);
+      if (!openElements_[depth].startTagOpen) {
+        throw std::logic_error(
+            "XmlDocument: attribute added after child element");
+      }
+      buffer_.push_back(' ');
+      buffer_.append(name.c_str(), cStringSize(name));
+      buffer_.push_back('=');
+      size = cStringSize(value, size);
+      if (std::memchr(value, '"', size)) {
+        buffer_.push_back('\'');
+        writeEscaped(value, size, '"');
+        buffer_.push_back('\'');
+      } else {
+        buffer_.push_back('"');
+        writeEscaped(value, size, '\'');
+        buffer_.push_back('"');
+      }
+    }
+
+    void XmlDocument::setValue(int depth, unsigned long serial,
+                               const char *value, std::size_t size) {
+      auto &element = openElement(depth, serial);
+      // the value is only written if the element has no children
+      if (element.startTagOpen) {
+        element.value.assign(value, cStringSize(value, size));
+      }
+    }
+
+    void XmlDocument::addFragment(int depth, unsigned long serial,
+                                  const char *xml, std::size_t size) {
+      auto &parent = openElement(depth, serial);
+      closeElementsBelow(depth);
+      if (size == 0) {
+        return;
+      }
+      if (parent.startTagOpen) {
+        buffer_.append(">\n");
+        parent.startTagOpen = false;
+        parent.value.clear();
+      }
+      // pass large fragments on directly instead of copying them
+      flush();
+      output_(xml, size);
+    }
 
-    XmlNode::XmlNode(NodePtr node, bool discardDefaults)
-        : node_(node), discardDefaultValues_(discardDefaults){};
+    XmlDocument::OpenElement &XmlDocument::openElement(int depth,
+                                                       unsigned long serial) {
+      if (depth < 0 || static_cast<std::size_t>(depth) >= openElementCount_ ||
+          (serial != 0 && openElements_[depth].serial != serial)) {
+        throw std::logic_error(
+            "XmlDocument: element has already been closed");
+      }
+      return openElements_[depth];
+    }
+
+    void XmlDocument::closeElementsBelow(int depth) {
+      while (openElementCount_ > static_cast<std::size_t>(depth + 1)) {
+        closeElement();
+      }
+      if (buffer_.size() >= BUFFER_FLUSH_SIZE) {
+        flush();
+      }
+    }
+
+    void XmlDocument::flush() {
+      if (!buffer_.empty()) {
+        output_(buffer_.data(), buffer_.size());
+        buffer_.clear();
+      }
+    }
+
+    void XmlDocument::closeElement() {
+      auto &element = openElements_[--openElementCount_];
+      if (element.startTagOpen) {
+        if (element.value.empty()) {
+          buffer_.append("/>\n");
+          return;
+        }
+        buffer_.push_back('>');
+        writeEscaped(element.value.data(), element.value.size(), '\0');
+      } else {
+        writeIndent(static_cast<int>(openElementCount_));
+      }
+      buffer_.append("</");
+      buffer_.append(element.name);
+      buffer_.append(">\n");
+    }
+
+    void XmlDocument::writeIndent(int depth) {
+      buffer_.append(static_cast<std::size_t>(depth), '\t');
+    }
+
+    void XmlDocument::writeEscaped(const char *text, std::size_t size,
+                                   char noexpand) {
+      for (const char *c = text; c != text + size; ++c) {
+        if (*c == noexpand) {
+          buffer_.push_back(*c);
+          continue;
+        }
+        switch (*c) {
+          case '<':
+            buffer_.append("&lt;");
+            break;
+          case '>':
+            buffer_.append("&gt;");
+            break;
+          case '\'':
+            buffer_.append("&apos;");
+            break;
+          case '"':
+            buffer_.append("&quot;");
+            break;
+          case '&':
+            buffer_.append("&amp;");
+            break;
+          default:
+            buffer_.push_back(*c);
+        }
+      }
+    }
+
+    // ---- XML NODE ---- //
+
+    XmlNode::XmlNode(XmlDocument *document, int depth, unsigned long serial,
+                     bool discardDefaults)
+        : document_(document),
+          depth_(depth),
+          serial_(serial),
+          discardDefaultValues_(discardDefaults){};
 
     void XmlNode::setValue(const std::string &value) {
-      auto valueString = node_->document()->allocate_string(value.c_str());
-      node_->value(valueString);
+      document_->setValue(depth_, serial_, value.data(), value.size());
+    }
+
+    void XmlNode::setValue(const detail::FormattedValue &value) {
+      document_->setValue(depth_, serial_, value.data(), value.size());
+    }
+
+    void XmlNode::addFragment(const std::string &xml) {
+      document_->addFragment(depth_, serial_, xml.data(), xml.size());
     }
 
     XmlNode XmlNode::addNode(const std::string &name) {
-      auto nameString = node_->document()->allocate_string(name.c_str());
-      auto childNode =
-          node_->document()->allocate_node(rapidxml::node_element, nameString);
-      node_->append_node(childNode);
-      return XmlNode(childNode, discardDefaultValues_);
+      document_->openElement(depth_, serial_);
+      auto node = document_->addNode(depth_, name);
+      node.discardDefaultValues_ = discardDefaultValues_;
+      return node;
     }
 
     void XmlNode::addAttribute(const std::string &name,
                                const std::string &value) {
-      auto nameString = node_->document()->allocate_string(name.c_str());
-      auto valueString = node_->document()->allocate_string(value.c_str());
-      auto attribute =
-          node_->document()->allocate_attribute(nameString, valueString);
-      node_->append_attribute(attribute);
+      document_->addAttribute(depth_, serial_, name, value.data(),
+                              value.size());
+    }
+
+    void XmlNode::addAttribute(const std::string &name,
+                               const detail::FormattedValue &value) {
+      document_->addAttribute(depth_, serial_, name, value.data(),
+                              value.size());
     }
 
     void XmlNode::addElement(const std::string &name,
@@ -76,5 +322,11 @@ namespace adm {
       elementNode.setValue(value);
     }
 
+    void XmlNode::addElement(const std::string &name,
+                             const detail::FormattedValue &value) {
+      auto elementNode = addNode(name);
+      elementNode.setValue(value);
+    }
+
   }  // namespace xml
 }  // namespace adm
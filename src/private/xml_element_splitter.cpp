@@ -0,0 +1,217 @@
+#include "adm/private/xml_element_splitter.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace adm {
+  namespace xml {
+
+    namespace {
+      const std::size_t npos = static_cast<std::size_t>(-1);
+
+      bool isNameEnd(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '/' ||
+               c == '>';
+      }
+    }  // namespace
+
+    XmlElementSplitter::XmlElementSplitter(bool recursiveSearch,
+                                           ElementHandler handler)
+        : recursiveSearch_(recursiveSearch),
+          handler_(std::move(handler)),
+          elementStart_(npos) {}
+
+    void XmlElementSplitter::write(const char* data, std::size_t size) {
+      if (rootClosed_) {
+        return;
+      }
+      buffer_.insert(buffer_.end(), data, data + size);
+      scan();
+      discardProcessed();
+    }
+
+    void XmlElementSplitter::finish() {
+      if (!rootClosed_ && depth_ != 0) {
+        throw std::runtime_error("unexpected end of XML data");
+      }
+    }
+
+    void XmlElementSplitter::scan() {
+      const char* data = buffer_.data();
+      while (!rootClosed_) {
+        auto lt = static_cast<const char*>(
+            std::memchr(data + scanPos_, '<', buffer_.size() - scanPos_));
+        if (!lt) {
+          scanPos_ = buffer_.size();
+          return;
+        }
+        auto pos = static_cast<std::size_t>(lt - data);
+        auto end = findMarkupEnd(pos);
+        if (end == 0) {
+          // wait for the rest of the markup
+          scanPos_ = pos;
+          return;
+        }
+        char type = data[pos + 1];
+        if (type == '/') {
+          endElement(end);
+        } else if (type != '?' && type != '!') {
+          startElement(pos, end, data[end - 2] == '/');
+        }
+        scanPos_ = end;
+      }
+    }
+
+    std::size_t XmlElementSplitter::findMarkupEnd(std::size_t pos) const {
+      const char* data = buffer_.data();
+      const std::size_t size = buffer_.size();
+      if (pos + 1 >= size) {
+        return 0;
+      }
+      switch (data[pos + 1]) {
+        case '?':
+          return findString(pos + 2, "?>");
+        case '/':
+          return findString(pos + 2, ">");
+        case '!': {
+          for (auto markup : {std::make_pair("<!--", "-->"),
+                              std::make_pair("<![CDATA[", "]]>")}) {
+            auto length = std::strlen(markup.first);
+            auto available = std::min(length, size - pos);
+            if (std::memcmp(data + pos, markup.first, available) == 0) {
+              if (available < length) {
+                return 0;
+              }
+              return findString(pos + length, markup.second);
+            }
+          }
+          // DOCTYPE, possibly with an internal subset in brackets
+          int brackets = 0;
+          char quote = '\0';
+          for (std::size_t i = pos + 2; i < size; ++i) {
+            char c = data[i];
+            if (quote) {
+              quote = c == quote ? '\0' : quote;
+            } else if (c == '"' || c == '\'') {
+              quote = c;
+            } else if (c == '[') {
+              ++brackets;
+            } else if (c == ']') {
+              --brackets;
+            } else if (c == '>' && brackets <= 0) {
+              return i + 1;
+            }
+          }
+          return 0;
+        }
+        default: {
+          // start tag; attribute values may contain '>'
+          char quote = '\0';
+          for (std::size_t i = pos + 1; i < size; ++i) {
+            char c = data[i];
+            if (quote) {
+              quote = c == quote ? '\0' : quote;
+            } else if (c == '"' || c == '\'') {
+              quote = c;
+            } else if (c == '>') {
+              return i + 1;
+            }
+          }
+          return 0;
+        }
+      }
+    }
+
+    std::size_t XmlElementSplitter::findString(std::size_t pos,
+                                               const char* str) const {
+      auto length = std::strlen(str);
+      for (; pos + length <= buffer_.size(); ++pos) {
+        if (std::memcmp(buffer_.data() + pos, str, length) == 0) {
+          return pos + length;
+        }
+      }
+      return 0;
+    }
+
+    void XmlElementSplitter::startElement(std::size_t begin, std::size_t end,
+                                          bool empty) {
+      if (rootDepth_ < 0) {
+        std::size_t nameEnd = begin + 1;
+        while (nameEnd < end && !isNameEnd(buffer_[nameEnd])) {
+          ++nameEnd;
+        }
+        std::string name(buffer_.data() + begin + 1, nameEnd - begin - 1);
+        if (isAudioFormatExtended(name)) {
+          rootDepth_ = depth_;
+          rootClosed_ = empty;
+          path_.clear();
+        } else if (!empty) {
+          path_.push_back(std::move(name));
+        }
+      } else if (depth_ == rootDepth_ + 1) {
+        if (empty) {
+          emitElement(begin, end);
+        } else {
+          elementStart_ = begin;
+        }
+      }
+      if (!empty) {
+        ++depth_;
+      }
+    }
+
+    void XmlElementSplitter::endElement(std::size_t end) {
+      if (depth_ == 0) {
+        throw std::runtime_error("unexpected end tag in XML data");
+      }
+      --depth_;
+      if (rootDepth_ < 0) {
+        path_.pop_back();
+      } else if (depth_ == rootDepth_ + 1) {
+        emitElement(elementStart_, end);
+        elementStart_ = npos;
+      } else if (depth_ == rootDepth_) {
+        rootClosed_ = true;
+      }
+    }
+
+    void XmlElementSplitter::emitElement(std::size_t begin, std::size_t end) {
+      element_.assign(buffer_.data() + begin, buffer_.data() + end);
+      element_.push_back('\0');
+      handler_(element_.data(), end - begin);
+    }
+
+    bool XmlElementSplitter::isAudioFormatExtended(
+        const std::string& name) const {
+      if (name != "audioFormatExtended") {
+        return false;
+      }
+      return recursiveSearch_ ||
+             path_ == std::vector<std::string>{"ebuCoreMain", "coreMetadata",
+                                               "format"};
+    }
+
+    void XmlElementSplitter::discardProcessed() {
+      if (rootClosed_) {
+        // everything after audioFormatExtended is ignored
+        buffer_.clear();
+        scanPos_ = 0;
+        return;
+      }
+      auto keepFrom = elementStart_ != npos ? elementStart_ : scanPos_;
+      // only move the remaining data if that frees at least as much, so
+      // that every character is moved at most a few times
+      if (keepFrom == 0 || keepFrom < buffer_.size() - keepFrom) {
+        return;
+      }
+      buffer_.erase(buffer_.begin(),
+                    buffer_.begin() + static_cast<std::ptrdiff_t>(keepFrom));
+      scanPos_ -= keepFrom;
+      if (elementStart_ != npos) {
+        elementStart_ -= keepFrom;
+      }
+    }
+
+  }  // namespace xml
+}  // namespace adm
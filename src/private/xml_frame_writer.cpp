@@ -0,0 +1,189 @@
+#include "adm/private/xml_frame_writer.hpp"
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/private/rapidxml_formatter.hpp"
+#include "adm/private/rapidxml_wrapper.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace adm {
+  namespace xml {
+
+    namespace {
+      template <typename Element, typename ElementId, typename State>
+      void addStates(std::vector<State> &states, const Document &document,
+                     bool withRevision) {
+        for (auto &element : document.getElements<Element>()) {
+          states.push_back(
+              State{element.get(), withRevision ? element->getRevision() : 0,
+                    element->template get<ElementId>().key()});
+        }
+      }
+
+      /// Write the children of an element at `depth` into `xml`
+      void formatFragment(std::string &xml, int depth, bool discardDefaults,
+                          const std::function<void(XmlNode &)> &write) {
+        xml.clear();
+        XmlDocument fragment([&xml](const char *data, std::size_t size) {
+          xml.append(data, size);
+        });
+        fragment.setDiscardDefaults(discardDefaults);
+        auto fragmentRoot = fragment.addFragmentRoot(depth);
+        write(fragmentRoot);
+        fragment.finish();
+      }
+
+      template <typename BlockFormat>
+      bool endsBefore(const BlockFormat &blockFormat,
+                      std::chrono::nanoseconds time) {
+        return blockFormat.template has<Duration>() &&
+               blockFormat.template get<Rtime>().get() +
+                       blockFormat.template get<Duration>().get() <=
+                   time;
+      }
+
+      /**
+       * Add the block formats of `channelFormat` which overlap the time
+       * window from `start` to `end`.
+       *
+       * `first` is the index of the first block format which may overlap
+       * the window; it is updated for the next frame. As block formats may
+       * have been added or removed since the previous frame, it is moved
+       * back first if the block format before it does not end before the
+       * window.
+       */
+      template <typename BlockFormat, typename Callable>
+      void addBlockFormats(
+          XmlNode &node,
+          const std::shared_ptr<const AudioChannelFormat> &channelFormat,
+          std::size_t &first, std::chrono::nanoseconds start,
+          std::chrono::nanoseconds end, Callable formatter) {
+        auto blockFormats = channelFormat->getElements<BlockFormat>();
+        auto size = static_cast<std::size_t>(blockFormats.size());
+        first = std::min(first, size);
+        while (first > 0 && !endsBefore(blockFormats[first - 1], start)) {
+          --first;
+        }
+        while (first < size && endsBefore(blockFormats[first], start)) {
+          ++first;
+        }
+        for (auto i = first;
+             i < size && blockFormats[i].template get<Rtime>().get() < end;
+             ++i) {
+          node.addElement(blockFormats[i], "audioBlockFormat", formatter);
+        }
+      }
+    }  // namespace
+
+    XmlFrameWriter::XmlFrameWriter(std::shared_ptr<const Document> document,
+                                   std::chrono::nanoseconds framePeriod,
+                                   WriterOptions options)
+        : document_(std::move(document)),
+          framePeriod_(framePeriod),
+          options_(options) {
+      if (framePeriod_.count() <= 0) {
+        throw std::invalid_argument("frame period must be positive");
+      }
+    }
+
+    XmlFrameWriter::~XmlFrameWriter() = default;
+
+    void XmlFrameWriter::writeFrame(
+        std::function<void(const char *, std::size_t)> output) {
+      auto start = frameStart();
+      if (xmlDocument_) {
+        xmlDocument_->reset(std::move(output));
+      } else {
+        xmlDocument_.reset(new XmlDocument(std::move(output)));
+      }
+      auto &xmlDocument = *xmlDocument_;
+      xmlDocument.setDiscardDefaults(
+          !static_cast<bool>(options_ & WriterOptions::write_default_values));
+      xmlDocument.addDeclaration();
+      auto root = xmlDocument.addFrameStructure(frameIndex_, start,
+                                                framePeriod_);
+      updateCache(root.depth());
+      root.addFragment(elementsBefore_);
+      addChannelFormats(root, start, start + framePeriod_);
+      root.addFragment(elementsAfter_);
+      xmlDocument.finish();
+      ++frameIndex_;
+    }
+
+    void XmlFrameWriter::updateCache(int depth) {
+      // the audioChannelFormats are written for every frame, only their IDs
+      // are used by other elements
+      currentState_.clear();
+      // clang-format off
+      addStates<AudioProgramme, AudioProgrammeId>(currentState_, *document_, true);
+      addStates<AudioContent, AudioContentId>(currentState_, *document_, true);
+      addStates<AudioObject, AudioObjectId>(currentState_, *document_, true);
+      addStates<AudioPackFormat, AudioPackFormatId>(currentState_, *document_, true);
+      addStates<AudioChannelFormat, AudioChannelFormatId>(currentState_, *document_, false);
+      addStates<AudioStreamFormat, AudioStreamFormatId>(currentState_, *document_, true);
+      addStates<AudioTrackFormat, AudioTrackFormatId>(currentState_, *document_, true);
+      addStates<AudioTrackUid, AudioTrackUidId>(currentState_, *document_, true);
+      // clang-format on
+      if (cacheValid_ && currentState_ == cachedState_) {
+        return;
+      }
+
+      auto discardDefaults =
+          !static_cast<bool>(options_ & WriterOptions::write_default_values);
+      auto document = document_;
+      // clang-format off
+      formatFragment(elementsBefore_, depth, discardDefaults, [&document](XmlNode &root) {
+        root.addBaseElements<AudioProgramme, AudioProgrammeId>(document, "audioProgramme", &formatAudioProgramme);
+        root.addBaseElements<AudioContent, AudioContentId>(document, "audioContent", &formatAudioContent);
+        root.addBaseElements<AudioObject, AudioObjectId>(document, "audioObject", &formatAudioObject);
+        root.addBaseElements<AudioPackFormat, AudioPackFormatId>(document, "audioPackFormat", &formatAudioPackFormat);
+      });
+      formatFragment(elementsAfter_, depth, discardDefaults, [&document](XmlNode &root) {
+        root.addBaseElements<AudioStreamFormat, AudioStreamFormatId>(document, "audioStreamFormat", &formatAudioStreamFormat);
+        root.addBaseElements<AudioTrackFormat, AudioTrackFormatId>(document, "audioTrackFormat", &formatAudioTrackFormat);
+        root.addBaseElements<AudioTrackUid, AudioTrackUidId>(document, "audioTrackUID", &formatAudioTrackUid);
+      });
+      // clang-format on
+
+      // forget the audioChannelFormats which have been removed
+      std::unordered_map<const void *, std::size_t> firstBlockFormats;
+      for (auto &channelFormat : document_->getElements<AudioChannelFormat>()) {
+        firstBlockFormats[channelFormat.get()] =
+            firstBlockFormats_[channelFormat.get()];
+      }
+      firstBlockFormats_.swap(firstBlockFormats);
+
+      cachedState_.swap(currentState_);
+      cacheValid_ = true;
+    }
+
+    void XmlFrameWriter::addChannelFormats(XmlNode &root,
+                                           std::chrono::nanoseconds start,
+                                           std::chrono::nanoseconds end) {
+      for (auto &channelFormat : document_->getElements<AudioChannelFormat>()) {
+        if (isCommonDefinitionsId(
+                channelFormat->get<AudioChannelFormatId>())) {
+          continue;
+        }
+        auto node = root.addNode("audioChannelFormat");
+        formatAudioChannelFormatHeader(node, channelFormat);
+        auto &first = firstBlockFormats_[channelFormat.get()];
+        auto channelType = channelFormat->get<TypeDescriptor>();
+        // clang-format off
+        if (channelType == TypeDefinition::DIRECT_SPEAKERS) {
+          addBlockFormats<AudioBlockFormatDirectSpeakers>(node, channelFormat, first, start, end, &formatBlockFormatDirectSpeakers);
+        } else if (channelType == TypeDefinition::MATRIX) {
+          addBlockFormats<AudioBlockFormatMatrix>(node, channelFormat, first, start, end, &formatBlockFormatMatrix);
+        } else if (channelType == TypeDefinition::OBJECTS) {
+          addBlockFormats<AudioBlockFormatObjects>(node, channelFormat, first, start, end, &formatBlockFormatObjects);
+        } else if (channelType == TypeDefinition::HOA) {
+          addBlockFormats<AudioBlockFormatHoa>(node, channelFormat, first, start, end, &formatBlockFormatHoa);
+        } else if (channelType == TypeDefinition::BINAURAL) {
+          addBlockFormats<AudioBlockFormatBinaural>(node, channelFormat, first, start, end, &formatBlockFormatBinaural);
+        }
+        // clang-format on
+      }
+    }
+
+  }  // namespace xml
+}  // namespace adm
@@ -1,7 +1,14 @@
 #include "adm/private/xml_parser.hpp"
+#include "adm/private/lazy_block_formats.hpp"
 #include "adm/common_definitions.hpp"
 #include "adm/private/xml_parser_helper.hpp"
+#include "adm/private/xml_element_splitter.hpp"
 #include "adm/errors.hpp"
+#include "adm/elements/private/parent_attorneys.hpp"
+#include "adm/utilities/id_assignment.hpp"
+#include <fstream>
+#include <iterator>
+#include <type_traits>
 
 namespace adm {
   namespace xml {
@@ -17,66 +24,717 @@ namespace adm {
       return static_cast<bool>(options & flag);
     }
 
+    namespace {
+      /// size of the chunks requested from a `ReadFunction`
+      const std::size_t READ_CHUNK_SIZE = 64 * 1024;
+
+      /// memory blocks of the parser which is currently running on this
+      /// thread
+      thread_local std::vector<std::pair<char*, std::size_t>>* poolBlocks =
+          nullptr;
+
+      /// offset of the memory returned to rapidxml from the allocated block,
+      /// which stores the size of the block in front
+      const std::size_t POOL_BLOCK_HEADER = 2 * sizeof(std::size_t);
+
+      void* allocatePoolBlock(std::size_t size) {
+        if (poolBlocks) {
+          for (auto it = poolBlocks->rbegin(); it != poolBlocks->rend();
+               ++it) {
+            if (it->second >= size) {
+              char* block = it->first;
+              poolBlocks->erase(std::next(it).base());
+              return block + POOL_BLOCK_HEADER;
+            }
+          }
+        }
+        char* block = new char[size + POOL_BLOCK_HEADER];
+        *reinterpret_cast<std::size_t*>(block) = size;
+        return block + POOL_BLOCK_HEADER;
+      }
+
+      void freePoolBlock(void* memory) {
+        char* block = static_cast<char*>(memory) - POOL_BLOCK_HEADER;
+        if (poolBlocks) {
+          poolBlocks->emplace_back(block,
+                                   *reinterpret_cast<std::size_t*>(block));
+        } else {
+          delete[] block;
+        }
+      }
+
+      /// Makes the pool blocks of a parser available while it is running
+      class PoolBlocksScope {
+       public:
+        explicit PoolBlocksScope(
+            std::vector<std::pair<char*, std::size_t>>& blocks)
+            : previous_(poolBlocks) {
+          poolBlocks = &blocks;
+        }
+        ~PoolBlocksScope() { poolBlocks = previous_; }
+
+       private:
+        std::vector<std::pair<char*, std::size_t>>* previous_;
+      };
+    }  // namespace
+
+    XmlParser::XmlParser(ParserOptions options) : options_(options) {
+      xmlDocument_.set_allocator(&allocatePoolBlock, &freePoolBlock);
+    }
+
     XmlParser::XmlParser(const std::string& filename, ParserOptions options,
                          std::shared_ptr<Document> destDocument)
-        : xmlFile_(filename.c_str()),
-          options_(options),
-          document_(destDocument) {}
+        : XmlParser(options) {
+      readFile(filename);
+      document_ = destDocument;
+    }
 
     XmlParser::XmlParser(std::istream& stream, ParserOptions options,
                          std::shared_ptr<Document> destDocument)
-        : xmlFile_(stream), options_(options), document_(destDocument) {}
+        : XmlParser(options) {
+      readStream(stream);
+      document_ = destDocument;
+    }
+
+    XmlParser::~XmlParser() {
+      for (auto& block : poolBlocks_) {
+        delete[] block.first;
+      }
+    }
 
     std::shared_ptr<Document> XmlParser::parse() {
-      rapidxml::xml_document<> xmlDocument;
-      xmlDocument.parse<0>(xmlFile_.data());
+      auto document = document_;
+      parseData(data_.data());
+      return document;
+    }
+
+    std::shared_ptr<Document> XmlParser::parse(
+        std::istream& stream, std::shared_ptr<Document> destDocument) {
+      readStream(stream);
+      document_ = destDocument;
+      parseData(data_.data());
+      return destDocument;
+    }
+
+    std::shared_ptr<Document> XmlParser::parseFile(
+        const std::string& filename, std::shared_ptr<Document> destDocument) {
+      readFile(filename);
+      document_ = destDocument;
+      parseData(data_.data());
+      return destDocument;
+    }
+
+    std::shared_ptr<Document> XmlParser::parse(
+        const char* xml, std::size_t size,
+        std::shared_ptr<Document> destDocument) {
+      data_.assign(xml, xml + size);
+      data_.push_back('\0');
+      document_ = destDocument;
+      parseData(data_.data());
+      return destDocument;
+    }
+
+    std::shared_ptr<Document> XmlParser::parseInPlace(
+        char* xml, std::shared_ptr<Document> destDocument) {
+      document_ = destDocument;
+      parseData(xml);
+      return destDocument;
+    }
+
+    void XmlParser::readStream(std::istream& stream) {
+      data_.assign(std::istreambuf_iterator<char>(stream),
+                   std::istreambuf_iterator<char>());
+      if (stream.fail() || stream.bad()) {
+        throw std::runtime_error("error reading stream");
+      }
+      data_.push_back('\0');
+    }
+
+    void XmlParser::readFile(const std::string& filename) {
+      std::ifstream stream(filename, std::ios::binary);
+      if (!stream) {
+        throw std::runtime_error("cannot open file " + filename);
+      }
+      stream.seekg(0, std::ios::end);
+      auto size = static_cast<std::size_t>(stream.tellg());
+      stream.seekg(0);
+      data_.resize(size + 1);
+      stream.read(data_.data(), static_cast<std::streamsize>(size));
+      data_[size] = '\0';
+    }
+
+    void XmlParser::reset() {
+      PoolBlocksScope poolBlocksScope(poolBlocks_);
+      xmlDocument_.clear();
+      document_.reset();
+      programmeContentRefs_.clear();
+      contentObjectRefs_.clear();
+      objectObjectRefs_.clear();
+      objectPackFormatRefs_.clear();
+      objectTrackUidRefs_.clear();
+      trackUidTrackFormatRef_.clear();
+      trackUidPackFormatRef_.clear();
+      packFormatChannelFormatRefs_.clear();
+      packFormatPackFormatRefs_.clear();
+      trackFormatStreamFormatRef_.clear();
+      streamFormatChannelFormatRef_.clear();
+      streamFormatPackFormatRef_.clear();
+      streamFormatTrackFormatRefs_.clear();
+      mergeFrame_ = false;
+      frameTimeOffset_ = std::chrono::nanoseconds::zero();
+      programmeElements_.clear();
+    }
+
+    void XmlParser::parseData(char* xml) {
+      // release the document and the rapidxml nodes, even if parsing fails
+      struct ResetGuard {
+        XmlParser* parser;
+        ~ResetGuard() { parser->reset(); }
+      } resetGuard{this};
+      PoolBlocksScope poolBlocksScope(poolBlocks_);
+
+      xmlDocument_.parse<0>(xml);
       NodePtr root = nullptr;
       if (isSet(options_, ParserOptions::recursive_node_search)) {
         root =
-            findAudioFormatExtendedNodeFullRecursive(xmlDocument.first_node());
+            findAudioFormatExtendedNodeFullRecursive(xmlDocument_.first_node());
       } else {
-        root = findAudioFormatExtendedNodeEbuCore(xmlDocument.first_node());
+        root = findAudioFormatExtendedNodeEbuCore(xmlDocument_.first_node());
       }
       if (root) {
+        if (filter_.getProgramme()) {
+          findProgrammeElements(root);
+        }
         // add ADM elements to ADM document
         for (NodePtr node = root->first_node(); node;
              node = node->next_sibling()) {
-          if (std::string(node->name()) == "audioProgramme") {
-            document_->add(parseAudioProgramme(node));
-          } else if (std::string(node->name()) == "audioContent") {
-            document_->add(parseAudioContent(node));
-          } else if (std::string(node->name()) == "audioObject") {
-            document_->add(parseAudioObject(node));
-          } else if (std::string(node->name()) == "audioTrackUID") {
-            document_->add(parseAudioTrackUid(node));
-          } else if (std::string(node->name()) == "audioPackFormat") {
-            document_->add(parseAudioPackFormat(node));
-          } else if (std::string(node->name()) == "audioChannelFormat") {
-            document_->add(parseAudioChannelFormat(node));
-          } else if (std::string(node->name()) == "audioStreamFormat") {
-            document_->add(parseAudioStreamFormat(node));
-          } else if (std::string(node->name()) == "audioTrackFormat") {
-            document_->add(parseAudioTrackFormat(node));
+          parseElement(node);
+        }
+        resolveAllReferences();
+      } else {
+        throw std::runtime_error("audioFormatExtended node not found");
+      }
+    }
+
+    void XmlParser::parseElement(NodePtr node) {
+      // clang-format off
+      if (std::string(node->name()) == "audioProgramme") {
+        addElement(node, "audioProgrammeID", &parseAudioProgrammeId, &XmlParser::parseAudioProgramme);
+      } else if (std::string(node->name()) == "audioContent") {
+        addElement(node, "audioContentID", &parseAudioContentId, &XmlParser::parseAudioContent);
+      } else if (std::string(node->name()) == "audioObject") {
+        addElement(node, "audioObjectID", &parseAudioObjectId, &XmlParser::parseAudioObject);
+      } else if (std::string(node->name()) == "audioTrackUID") {
+        addElement(node, "UID", &parseAudioTrackUidId, &XmlParser::parseAudioTrackUid);
+      } else if (std::string(node->name()) == "audioPackFormat") {
+        addElement(node, "audioPackFormatID", &parseAudioPackFormatId, &XmlParser::parseAudioPackFormat);
+      } else if (std::string(node->name()) == "audioChannelFormat") {
+        addElement(node, "audioChannelFormatID", &parseAudioChannelFormatId, &XmlParser::parseAudioChannelFormat);
+      } else if (std::string(node->name()) == "audioStreamFormat") {
+        addElement(node, "audioStreamFormatID", &parseAudioStreamFormatId, &XmlParser::parseAudioStreamFormat);
+      } else if (std::string(node->name()) == "audioTrackFormat") {
+        addElement(node, "audioTrackFormatID", &parseAudioTrackFormatId, &XmlParser::parseAudioTrackFormat);
+      }
+      // clang-format on
+    }
+
+    template <typename Element, typename ElementId>
+    void XmlParser::addElement(
+        NodePtr node, const char* idAttribute,
+        ElementId (*parseId)(const std::string&),
+        std::shared_ptr<Element> (XmlParser::*parse)(NodePtr)) {
+      if (!filter_.acceptsAll() &&
+          !accepts(parseAttribute<ElementId>(node, idAttribute, parseId))) {
+        return;
+      }
+      document_->add((this->*parse)(node));
+    }
+
+    void XmlParser::setFilter(ParserFilter filter) {
+      filter_ = std::move(filter);
+    }
+
+    bool XmlParser::accepts(const ElementIdVariant& id) const {
+      if (!filter_.accepts(id)) {
+        return false;
+      }
+      return !filter_.getProgramme() || programmeElements_.count(id) != 0;
+    }
+
+    namespace {
+      /// ID of the child @a node of audioFormatExtended, if it is an element
+      boost::optional<ElementIdVariant> parseElementId(NodePtr node) {
+        // clang-format off
+        if (std::string(node->name()) == "audioProgramme") {
+          return ElementIdVariant(parseAttribute<AudioProgrammeId>(node, "audioProgrammeID", &parseAudioProgrammeId));
+        } else if (std::string(node->name()) == "audioContent") {
+          return ElementIdVariant(parseAttribute<AudioContentId>(node, "audioContentID", &parseAudioContentId));
+        } else if (std::string(node->name()) == "audioObject") {
+          return ElementIdVariant(parseAttribute<AudioObjectId>(node, "audioObjectID", &parseAudioObjectId));
+        } else if (std::string(node->name()) == "audioTrackUID") {
+          return ElementIdVariant(parseAttribute<AudioTrackUidId>(node, "UID", &parseAudioTrackUidId));
+        } else if (std::string(node->name()) == "audioPackFormat") {
+          return ElementIdVariant(parseAttribute<AudioPackFormatId>(node, "audioPackFormatID", &parseAudioPackFormatId));
+        } else if (std::string(node->name()) == "audioChannelFormat") {
+          return ElementIdVariant(parseAttribute<AudioChannelFormatId>(node, "audioChannelFormatID", &parseAudioChannelFormatId));
+        } else if (std::string(node->name()) == "audioStreamFormat") {
+          return ElementIdVariant(parseAttribute<AudioStreamFormatId>(node, "audioStreamFormatID", &parseAudioStreamFormatId));
+        } else if (std::string(node->name()) == "audioTrackFormat") {
+          return ElementIdVariant(parseAttribute<AudioTrackFormatId>(node, "audioTrackFormatID", &parseAudioTrackFormatId));
+        }
+        // clang-format on
+        return boost::none;
+      }
+
+      /// ID referenced by the child @a node of an element, if any
+      boost::optional<ElementIdVariant> parseReferenceId(NodePtr node) {
+        // clang-format off
+        if (std::string(node->name()) == "audioContentIDRef") {
+          return ElementIdVariant(parseAudioContentId(node->value()));
+        } else if (std::string(node->name()) == "audioObjectIDRef") {
+          return ElementIdVariant(parseAudioObjectId(node->value()));
+        } else if (std::string(node->name()) == "audioTrackUIDRef") {
+          return ElementIdVariant(parseAudioTrackUidId(node->value()));
+        } else if (std::string(node->name()) == "audioPackFormatIDRef") {
+          return ElementIdVariant(parseAudioPackFormatId(node->value()));
+        } else if (std::string(node->name()) == "audioChannelFormatIDRef") {
+          return ElementIdVariant(parseAudioChannelFormatId(node->value()));
+        } else if (std::string(node->name()) == "audioStreamFormatIDRef") {
+          return ElementIdVariant(parseAudioStreamFormatId(node->value()));
+        } else if (std::string(node->name()) == "audioTrackFormatIDRef") {
+          return ElementIdVariant(parseAudioTrackFormatId(node->value()));
+        }
+        // clang-format on
+        return boost::none;
+      }
+    }  // namespace
+
+    void XmlParser::findProgrammeElements(NodePtr root) {
+      std::map<ElementIdVariant, NodePtr> nodes;
+      for (NodePtr node = root->first_node(); node;
+           node = node->next_sibling()) {
+        if (auto id = parseElementId(node)) {
+          nodes[*id] = node;
+        }
+      }
+      ElementIdVariant programmeId = *filter_.getProgramme();
+      auto programme = nodes.find(programmeId);
+      if (programme == nodes.end()) {
+        throw std::runtime_error(formatId(*filter_.getProgramme()) +
+                                 " not found");
+      }
+      programmeElements_.clear();
+      programmeElements_.insert(programmeId);
+      std::vector<NodePtr> pending{programme->second};
+      while (!pending.empty()) {
+        auto node = pending.back();
+        pending.pop_back();
+        // audioChannelFormats have no references, but many audioBlockFormats
+        if (std::string(node->name()) == "audioChannelFormat") {
+          continue;
+        }
+        for (NodePtr child = node->first_node(); child;
+             child = child->next_sibling()) {
+          auto id = parseReferenceId(child);
+          if (!id || !filter_.accepts(*id) ||
+              !programmeElements_.insert(*id).second) {
+            continue;
+          }
+          auto referenced = nodes.find(*id);
+          if (referenced != nodes.end()) {
+            pending.push_back(referenced->second);
+          }
+        }
+      }
+    }
+
+    void XmlParser::resolveAllReferences() {
+      resolveReferences(programmeContentRefs_);
+      resolveReferences(contentObjectRefs_);
+      resolveReferences(objectObjectRefs_);
+      resolveReferences(objectPackFormatRefs_);
+      resolveReferences(objectTrackUidRefs_);
+      resolveReference(trackUidTrackFormatRef_);
+      resolveReference(trackUidPackFormatRef_);
+      resolveReferences(packFormatChannelFormatRefs_);
+      resolveReferences(packFormatPackFormatRefs_);
+      resolveReference(trackFormatStreamFormatRef_);
+      resolveReference(streamFormatChannelFormatRef_);
+      resolveReference(streamFormatPackFormatRef_);
+      resolveReferences(streamFormatTrackFormatRefs_);
+    }
+
+    std::shared_ptr<Document> XmlParser::parse(
+        const ReadFunction& read, std::shared_ptr<Document> destDocument) {
+      // release the document and the rapidxml nodes, even if parsing fails
+      struct ResetGuard {
+        XmlParser* parser;
+        ~ResetGuard() { parser->reset(); }
+      } resetGuard{this};
+      PoolBlocksScope poolBlocksScope(poolBlocks_);
+      if (filter_.getProgramme()) {
+        throw std::invalid_argument(
+            "the audioProgramme filter is not supported for chunked input");
+      }
+      document_ = destDocument;
+
+      XmlElementSplitter splitter(
+          isSet(options_, ParserOptions::recursive_node_search),
+          [this](char* xml, std::size_t) {
+            xmlDocument_.parse<0>(xml);
+            parseElement(xmlDocument_.first_node());
+            // give the nodes back to the pool for the next element
+            xmlDocument_.clear();
+          });
+      data_.resize(READ_CHUNK_SIZE);
+      while (auto size = read(data_.data(), data_.size())) {
+        splitter.write(data_.data(), size);
+      }
+      splitter.finish();
+      if (!splitter.foundAudioFormatExtended()) {
+        throw std::runtime_error("audioFormatExtended node not found");
+      }
+      resolveAllReferences();
+      return destDocument;
+    }
+
+    namespace {
+      /**
+       * Append the names, attributes and text of @a node and its children
+       * to @a xml, so that two nodes have the same representation if and
+       * only if they have the same contents.
+       */
+      void appendNodeContents(std::string& xml, NodePtr node) {
+        xml.append(node->name(), node->name_size());
+        for (auto attribute = node->first_attribute(); attribute;
+             attribute = attribute->next_attribute()) {
+          xml.push_back('\0');
+          xml.append(attribute->name(), attribute->name_size());
+          xml.push_back('\0');
+          xml.append(attribute->value(), attribute->value_size());
+        }
+        xml.push_back('\1');
+        for (auto child = node->first_node(); child;
+             child = child->next_sibling()) {
+          if (child->type() == rapidxml::node_element) {
+            appendNodeContents(xml, child);
+          } else if (child->type() == rapidxml::node_data ||
+                     child->type() == rapidxml::node_cdata) {
+            xml.append(child->value(), child->value_size());
           }
         }
-        resolveReferences(programmeContentRefs_);
-        resolveReferences(contentObjectRefs_);
-        resolveReferences(objectObjectRefs_);
-        resolveReferences(objectPackFormatRefs_);
-        resolveReferences(objectTrackUidRefs_);
-        resolveReference(trackUidTrackFormatRef_);
-        resolveReference(trackUidPackFormatRef_);
-        resolveReferences(packFormatChannelFormatRefs_);
-        resolveReferences(packFormatPackFormatRefs_);
-        resolveReference(trackFormatStreamFormatRef_);
-        resolveReference(streamFormatChannelFormatRef_);
-        resolveReference(streamFormatPackFormatRef_);
-        resolveReferences(streamFormatTrackFormatRefs_);
+        xml.push_back('\2');
+      }
+
+      /// Offset of the times in a frame which uses `timeReference="local"`
+      std::chrono::nanoseconds parseFrameTimeOffset(NodePtr frame) {
+        if (!frame || std::string(frame->name()) != "frame") {
+          return std::chrono::nanoseconds::zero();
+        }
+        auto frameHeader = frame->first_node("frameHeader");
+        auto frameFormat =
+            frameHeader ? frameHeader->first_node("frameFormat") : nullptr;
+        if (!frameFormat) {
+          return std::chrono::nanoseconds::zero();
+        }
+        auto timeReference = frameFormat->first_attribute("timeReference");
+        if (!timeReference || std::string(timeReference->value()) != "local") {
+          return std::chrono::nanoseconds::zero();
+        }
+        return parseAttribute<std::chrono::nanoseconds>(frameFormat, "start",
+                                                         &parseTimecode);
+      }
+
+      template <typename Element>
+      void copyParameters(const Element&, Element&) {}
+
+      /// Set the mandatory @a Parameter and @a Parameters of @a to
+      template <typename Parameter, typename... Parameters, typename Element>
+      void copyParameters(const Element& from, Element& to) {
+        to.set(from.template get<Parameter>());
+        copyParameters<Parameters...>(from, to);
+      }
+
+      template <typename Element>
+      void copyOptionalParameters(const Element&, Element&) {}
+
+      /// Set or unset the optional @a Parameter and @a Parameters of @a to
+      template <typename Parameter, typename... Parameters, typename Element>
+      void copyOptionalParameters(const Element& from, Element& to) {
+        if (from.template has<Parameter>() &&
+            !from.template isDefault<Parameter>()) {
+          to.set(from.template get<Parameter>());
+        } else if (to.template has<Parameter>() &&
+                   !to.template isDefault<Parameter>()) {
+          to.template unset<Parameter>();
+        }
+        copyOptionalParameters<Parameters...>(from, to);
+      }
+
+      /// Let the references of @a from in @a map be resolved for @a to
+      template <typename Key, typename Value>
+      void moveReferences(std::map<Key, Value>& map, const Key& from,
+                          const Key& to) {
+        auto entry = map.find(from);
+        if (entry != map.end()) {
+          map[to] = std::move(entry->second);
+          map.erase(entry);
+        }
+      }
+
+      template <typename Range>
+      void addTimeOffset(const Range& blockFormats,
+                         std::chrono::nanoseconds offset) {
+        for (auto& blockFormat : blockFormats) {
+          blockFormat.set(
+              Rtime(blockFormat.template get<Rtime>().get() + offset));
+        }
+      }
+    }  // namespace
+
+    void XmlParser::parseFrame(const char* xml, std::size_t size,
+                               std::shared_ptr<Document> destDocument) {
+      data_.assign(xml, xml + size);
+      data_.push_back('\0');
+      document_ = std::move(destDocument);
+      parseFrameData();
+    }
+
+    void XmlParser::parseFrame(std::istream& stream,
+                               std::shared_ptr<Document> destDocument) {
+      readStream(stream);
+      document_ = std::move(destDocument);
+      parseFrameData();
+    }
+
+    void XmlParser::parseFrameData() {
+      // release the rapidxml nodes, even if parsing fails
+      struct ResetGuard {
+        XmlParser* parser;
+        ~ResetGuard() { parser->reset(); }
+      } resetGuard{this};
+      PoolBlocksScope poolBlocksScope(poolBlocks_);
+
+      xmlDocument_.parse<0>(data_.data());
+      NodePtr root = nullptr;
+      if (isSet(options_, ParserOptions::recursive_node_search)) {
+        root =
+            findAudioFormatExtendedNodeFullRecursive(xmlDocument_.first_node());
       } else {
+        root = findAudioFormatExtendedNodeFrame(xmlDocument_.first_node());
+      }
+      if (!root) {
         throw std::runtime_error("audioFormatExtended node not found");
       }
-      return document_;
-    }  // namespace xml
+      mergeFrame_ = true;
+      frameTimeOffset_ = parseFrameTimeOffset(xmlDocument_.first_node());
+      ++frameNumber_;
+      for (NodePtr node = root->first_node(); node;
+           node = node->next_sibling()) {
+        parseFrameElement(node);
+      }
+      resolveAllReferences();
+      // only the elements of this frame are compared with the next one
+      for (auto it = frameElements_.begin(); it != frameElements_.end();) {
+        if (it->second.frame != frameNumber_) {
+          it = frameElements_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    void XmlParser::parseFrameElement(NodePtr node) {
+      // clang-format off
+      if (std::string(node->name()) == "audioProgramme") {
+        mergeElement(node, "audioProgrammeID", &parseAudioProgrammeId, &XmlParser::parseAudioProgramme);
+      } else if (std::string(node->name()) == "audioContent") {
+        mergeElement(node, "audioContentID", &parseAudioContentId, &XmlParser::parseAudioContent);
+      } else if (std::string(node->name()) == "audioObject") {
+        mergeElement(node, "audioObjectID", &parseAudioObjectId, &XmlParser::parseAudioObject);
+      } else if (std::string(node->name()) == "audioTrackUID") {
+        mergeElement(node, "UID", &parseAudioTrackUidId, &XmlParser::parseAudioTrackUid);
+      } else if (std::string(node->name()) == "audioPackFormat") {
+        mergeElement(node, "audioPackFormatID", &parseAudioPackFormatId, &XmlParser::parseAudioPackFormat);
+      } else if (std::string(node->name()) == "audioChannelFormat") {
+        mergeElement(node, "audioChannelFormatID", &parseAudioChannelFormatId, &XmlParser::parseAudioChannelFormat);
+      } else if (std::string(node->name()) == "audioStreamFormat") {
+        mergeElement(node, "audioStreamFormatID", &parseAudioStreamFormatId, &XmlParser::parseAudioStreamFormat);
+      } else if (std::string(node->name()) == "audioTrackFormat") {
+        mergeElement(node, "audioTrackFormatID", &parseAudioTrackFormatId, &XmlParser::parseAudioTrackFormat);
+      }
+      // clang-format on
+    }
+
+    template <typename Element, typename ElementId>
+    void XmlParser::mergeElement(
+        NodePtr node, const char* idAttribute,
+        ElementId (*parseId)(const std::string&),
+        std::shared_ptr<Element> (XmlParser::*parse)(NodePtr)) {
+      auto id = parseAttribute<ElementId>(node, idAttribute, parseId);
+      elementXml_.clear();
+      appendNodeContents(elementXml_, node);
+      if (std::is_same<Element, AudioChannelFormat>::value) {
+        // the same local times result in different audioBlockFormats if the
+        // frames start at different times
+        auto offset = frameTimeOffset_.count();
+        elementXml_.append(reinterpret_cast<const char*>(&offset),
+                           sizeof(offset));
+      }
+      auto element = document_->lookup(id);
+      if (element) {
+        auto previous = frameElements_.find(element.get());
+        if (previous != frameElements_.end() &&
+            !previous->second.element.expired() &&
+            previous->second.xml == elementXml_) {
+          previous->second.frame = frameNumber_;
+          return;
+        }
+        update(element, (this->*parse)(node));
+      } else {
+        element = (this->*parse)(node);
+        document_->add(element);
+      }
+      auto& state = frameElements_[element.get()];
+      state.element = element;
+      state.xml.swap(elementXml_);
+      state.frame = frameNumber_;
+    }
+
+    // clang-format off
+    void XmlParser::update(const std::shared_ptr<AudioProgramme>& existing,
+                           const std::shared_ptr<AudioProgramme>& parsed) {
+      copyParameters<AudioProgrammeName>(*parsed, *existing);
+      copyOptionalParameters<AudioProgrammeLanguage, Start, End, MaxDuckingDepth, LoudnessMetadata, AudioProgrammeReferenceScreen>(*parsed, *existing);
+      existing->clearReferences<AudioContent>();
+      moveReferences(programmeContentRefs_, parsed, existing);
+    }
+
+    void XmlParser::update(const std::shared_ptr<AudioContent>& existing,
+                           const std::shared_ptr<AudioContent>& parsed) {
+      copyParameters<AudioContentName>(*parsed, *existing);
+      copyOptionalParameters<AudioContentLanguage, LoudnessMetadata, ContentKind>(*parsed, *existing);
+      existing->clearReferences<AudioObject>();
+      moveReferences(contentObjectRefs_, parsed, existing);
+    }
+
+    void XmlParser::update(const std::shared_ptr<AudioObject>& existing,
+                           const std::shared_ptr<AudioObject>& parsed) {
+      copyParameters<AudioObjectName>(*parsed, *existing);
+      copyOptionalParameters<Start, Duration, DialogueId, Importance, Interact, DisableDucking, AudioObjectInteraction>(*parsed, *existing);
+      existing->clearReferences<AudioObject>();
+      existing->clearReferences<AudioPackFormat>();
+      existing->clearReferences<AudioTrackUid>();
+      moveReferences(objectObjectRefs_, parsed, existing);
+      moveReferences(objectPackFormatRefs_, parsed, existing);
+      moveReferences(objectTrackUidRefs_, parsed, existing);
+    }
+
+    void XmlParser::update(const std::shared_ptr<AudioPackFormat>& existing,
+                           const std::shared_ptr<AudioPackFormat>& parsed) {
+      copyParameters<AudioPackFormatName>(*parsed, *existing);
+      copyOptionalParameters<Importance, AbsoluteDistance>(*parsed, *existing);
+      existing->clearReferences<AudioChannelFormat>();
+      existing->clearReferences<AudioPackFormat>();
+      moveReferences(packFormatChannelFormatRefs_, parsed, existing);
+      moveReferences(packFormatPackFormatRefs_, parsed, existing);
+    }
+
+    void XmlParser::update(const std::shared_ptr<AudioChannelFormat>& existing,
+                           const std::shared_ptr<AudioChannelFormat>& parsed) {
+      auto& state = frameElements_[existing.get()];
+      // the positions are only valid if nothing else modified the element
+      // since the previous frame
+      if (state.element.lock() != existing ||
+          state.blockFormatRevision != existing->getRevision()) {
+        state.blockFormatPositions.clear();
+      }
+      copyParameters<AudioChannelFormatName>(*parsed, *existing);
+      copyOptionalParameters<Frequency>(*parsed, *existing);
+      mergeBlockFormats<AudioBlockFormatDirectSpeakers>(*existing, *parsed, state.blockFormatPositions);
+      mergeBlockFormats<AudioBlockFormatMatrix>(*existing, *parsed, state.blockFormatPositions);
+      mergeBlockFormats<AudioBlockFormatObjects>(*existing, *parsed, state.blockFormatPositions);
+      mergeBlockFormats<AudioBlockFormatHoa>(*existing, *parsed, state.blockFormatPositions);
+      mergeBlockFormats<AudioBlockFormatBinaural>(*existing, *parsed, state.blockFormatPositions);
+      state.blockFormatRevision = existing->getRevision();
+    }
+
+    void XmlParser::update(const std::shared_ptr<AudioStreamFormat>& existing,
+                           const std::shared_ptr<AudioStreamFormat>& parsed) {
+      copyParameters<AudioStreamFormatName>(*parsed, *existing);
+      existing->removeReference<AudioChannelFormat>();
+      existing->removeReference<AudioPackFormat>();
+      existing->clearReferences<AudioTrackFormat>();
+      moveReferences(streamFormatChannelFormatRef_, parsed, existing);
+      moveReferences(streamFormatPackFormatRef_, parsed, existing);
+      moveReferences(streamFormatTrackFormatRefs_, parsed, existing);
+    }
+
+    void XmlParser::update(const std::shared_ptr<AudioTrackFormat>& existing,
+                           const std::shared_ptr<AudioTrackFormat>& parsed) {
+      copyParameters<AudioTrackFormatName>(*parsed, *existing);
+      existing->removeReference<AudioStreamFormat>();
+      moveReferences(trackFormatStreamFormatRef_, parsed, existing);
+    }
+
+    void XmlParser::update(const std::shared_ptr<AudioTrackUid>& existing,
+                           const std::shared_ptr<AudioTrackUid>& parsed) {
+      copyOptionalParameters<SampleRate, BitDepth>(*parsed, *existing);
+      existing->removeReference<AudioTrackFormat>();
+      existing->removeReference<AudioPackFormat>();
+      moveReferences(trackUidTrackFormatRef_, parsed, existing);
+      moveReferences(trackUidPackFormatRef_, parsed, existing);
+    }
+    // clang-format on
+
+    template <typename BlockFormat>
+    void XmlParser::mergeBlockFormats(AudioChannelFormat& existing,
+                                      const AudioChannelFormat& parsed,
+                                      BlockFormatPositions& positions) {
+      auto parsedBlockFormats = parsed.getElements<BlockFormat>();
+      if (parsedBlockFormats.empty()) {
+        return;
+      }
+      const AudioChannelFormat& constExisting = existing;
+      auto count = static_cast<std::size_t>(
+          constExisting.getElements<BlockFormat>().size());
+      if (positions.size() != count) {
+        positions.clear();
+        std::size_t position = 0;
+        for (auto& blockFormat : constExisting.getElements<BlockFormat>()) {
+          positions[blockFormat.template get<AudioBlockFormatId>()] =
+              position++;
+        }
+      }
+      for (auto& blockFormat : parsedBlockFormats) {
+        auto id = blockFormat.template get<AudioBlockFormatId>();
+        auto position = positions.find(id);
+        if (position != positions.end()) {
+          AudioChannelFormatAttorney::updateElements<BlockFormat>(
+              existing)[position->second] = blockFormat;
+          continue;
+        }
+        if (isUndefined(id)) {
+          existing.add(blockFormat);
+          id = constExisting.getElements<BlockFormat>()
+                   .back()
+                   .template get<AudioBlockFormatId>();
+        } else {
+          // new audioBlockFormats usually follow the ones of the previous
+          // frame, and are known not to be used, so no search is needed
+          AudioChannelFormatAttorney::addWithUnusedId(existing, blockFormat);
+        }
+        positions.emplace(id, count++);
+      }
+    }
+
+    template <typename ElementId>
+    void XmlParser::checkDuplicateId(const ElementId& id, NodePtr node) {
+      // the elements of a frame are merged into the existing ones
+      if (!mergeFrame_ && document_->lookup(id) != nullptr) {
+        throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
+      }
+    }
 
     /**
      * @brief Find the top level element 'audioFormatExtended'
@@ -131,14 +789,30 @@ namespace adm {
       return nullptr;
     }
 
+    /**
+     * @brief Find the 'audioFormatExtended' element of a serial ADM frame
+     *
+     * Returns a nullptr if @a node is not a `frame` element with an
+     * audioFormatExtended child.
+     */
+    NodePtr findAudioFormatExtendedNodeFrame(NodePtr node) {
+      if (!node || std::string(node->name()) != "frame") {
+        return nullptr;
+      }
+      auto audioFormatExtendedNodes =
+          detail::findElements(node, "audioFormatExtended");
+      if (audioFormatExtendedNodes.size() != 1) {
+        return nullptr;
+      }
+      return audioFormatExtendedNodes.at(0);
+    }
+
     std::shared_ptr<AudioProgramme> XmlParser::parseAudioProgramme(
         NodePtr node) {
       // clang-format off
       auto name = parseAttribute<AudioProgrammeName>(node, "audioProgrammeName");
       AudioProgrammeId id = parseAttribute<AudioProgrammeId>(node, "audioProgrammeID", &parseAudioProgrammeId);
-      if(document_->lookup(id) != nullptr) {
-        throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
-      }
+      checkDuplicateId(id, node);
       auto audioProgramme = AudioProgramme::create(name, id);
 
       setOptionalAttribute<AudioProgrammeLanguage>(node, "audioProgrammeLanguage", audioProgramme);
@@ -158,9 +832,7 @@ namespace adm {
       // clang-format off
       auto name = parseAttribute<AudioContentName>(node, "audioContentName");
       auto id = parseAttribute<AudioContentId>(node, "audioContentID", &parseAudioContentId);
-      if(document_->lookup(id) != nullptr) {
-        throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
-      }
+      checkDuplicateId(id, node);
       auto audioContent = AudioContent::create(name, id);
 
       setOptionalAttribute<AudioContentLanguage>(node, "audioContentLanguage", audioContent);
@@ -177,9 +849,7 @@ namespace adm {
       // clang-format off
       auto name = parseAttribute<AudioObjectName>(node, "audioObjectName");
       auto id = parseAttribute<AudioObjectId>(node, "audioObjectID", &parseAudioObjectId);
-      if(document_->lookup(id) != nullptr) {
-        throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
-      }
+      checkDuplicateId(id, node);
       auto audioObject = AudioObject::create(name, id);
 
       setOptionalAttribute<Start>(node, "start", audioObject, &parseTimecode);
@@ -265,9 +935,7 @@ namespace adm {
       // clang-format off
       auto name = parseAttribute<AudioPackFormatName>(node, "audioPackFormatName");
       auto id = parseAttribute<AudioPackFormatId>(node, "audioPackFormatID", &parseAudioPackFormatId);
-      if(document_->lookup(id) != nullptr) {
-        throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
-      }
+      checkDuplicateId(id, node);
       auto audioPackFormat = AudioPackFormat::create(name, id.get<TypeDescriptor>(), id);
 
       auto typeLabel = parseOptionalAttribute<TypeDescriptor>(node, "typeLabel", &parseTypeLabel);
@@ -288,9 +956,7 @@ namespace adm {
       // clang-format off
       auto name = parseAttribute<AudioChannelFormatName>(node, "audioChannelFormatName");
       auto id = parseAttribute<AudioChannelFormatId>(node, "audioChannelFormatID", &parseAudioChannelFormatId);
-      if(document_->lookup(id) != nullptr) {
-        throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
-      }
+      checkDuplicateId(id, node);
       auto audioChannelFormat = AudioChannelFormat::create(name, id.get<TypeDescriptor>(), id);
 
       auto typeLabel = parseOptionalAttribute<TypeDescriptor>(node, "typeLabel", &parseTypeLabel);
@@ -300,6 +966,16 @@ namespace adm {
       setOptionalMultiElement<Frequency>(node, "frequency", audioChannelFormat, &parseFrequency);
       // clang-format on
 
+      if (isSet(options_, ParserOptions::lazy_block_formats) && !mergeFrame_) {
+        auto blockFormats = std::make_shared<adm::detail::LazyBlockFormats>(
+            node, audioChannelFormat->get<TypeDescriptor>());
+        if (!blockFormats->empty()) {
+          adm::detail::LazyBlockFormats::attach(*audioChannelFormat,
+                                                std::move(blockFormats));
+        }
+        return audioChannelFormat;
+      }
+
       auto elements = detail::findElements(node, "audioBlockFormat");
 
       if (audioChannelFormat->get<TypeDescriptor>() ==
@@ -328,6 +1004,14 @@ namespace adm {
         //    audioChannelFormat->add(parseAudioBlockFormatBinaural(element));
         // }
       }
+      if (frameTimeOffset_ != std::chrono::nanoseconds::zero()) {
+        addTimeOffset(AudioChannelFormatAttorney::updateElements<
+                          AudioBlockFormatDirectSpeakers>(*audioChannelFormat),
+                      frameTimeOffset_);
+        addTimeOffset(AudioChannelFormatAttorney::updateElements<
+                          AudioBlockFormatObjects>(*audioChannelFormat),
+                      frameTimeOffset_);
+      }
       return audioChannelFormat;
     }
 
@@ -336,9 +1020,7 @@ namespace adm {
       // clang-format off
       auto name = parseAttribute<AudioStreamFormatName>(node, "audioStreamFormatName");
       auto id = parseAttribute<AudioStreamFormatId>(node, "audioStreamFormatID", &parseAudioStreamFormatId);
-      if(document_->lookup(id) != nullptr) {
-        throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
-      }
+      checkDuplicateId(id, node);
 
       auto formatLabel = parseOptionalAttribute<FormatDescriptor>(node, "formatLabel", &parseFormatLabel);
       auto formatDefinition = parseOptionalAttribute<FormatDescriptor>(node, "formatDefinition", &parseFormatDefinition);
@@ -357,9 +1039,7 @@ namespace adm {
       // clang-format off
       auto name = parseAttribute<AudioTrackFormatName>(node, "audioTrackFormatName");
       auto id = parseAttribute<AudioTrackFormatId>(node, "audioTrackFormatID", &parseAudioTrackFormatId);
-      if(document_->lookup(id) != nullptr) {
-        throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
-      }
+      checkDuplicateId(id, node);
 
       auto formatLabel = parseOptionalAttribute<FormatDescriptor>(node, "formatLabel", &parseFormatLabel);
       auto formatDefinition = parseOptionalAttribute<FormatDescriptor>(node, "formatDefinition", &parseFormatDefinition);
@@ -375,9 +1055,7 @@ namespace adm {
     std::shared_ptr<AudioTrackUid> XmlParser::parseAudioTrackUid(NodePtr node) {
       // clang-format off
       auto id = parseAttribute<AudioTrackUidId>(node, "UID", &parseAudioTrackUidId);
-      if(document_->lookup(id) != nullptr) {
-        throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
-      }
+      checkDuplicateId(id, node);
       auto audioTrackUid = AudioTrackUid::create(id);
 
       setOptionalAttribute<SampleRate>(node, "sampleRate", audioTrackUid);
@@ -1,11 +1,15 @@
 #include "adm/private/xml_writer.hpp"
 #include "adm/elements.hpp"
 #include "adm/document.hpp"
+#include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/private/rapidxml_formatter.hpp"
-#include "rapidxml/rapidxml.hpp"
-#include "rapidxml/rapidxml_print.hpp"
-#include "rapidxml/rapidxml_utils.hpp"
 #include "adm/private/rapidxml_wrapper.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 namespace adm {
   namespace xml {
@@ -21,13 +25,258 @@ namespace adm {
       return static_cast<bool>(options & flag);
     }
 
-    using NodePtr = rapidxml::xml_node<>*;
+    namespace {
+      /// Rough measure for the amount of XML a chunk is allowed to contain
+      const std::size_t CHUNK_WEIGHT = 1024;
+      /// total weight of a document above which it is written on multiple
+      /// threads; below, starting the threads costs more than it saves
+      const std::size_t PARALLEL_WEIGHT = 4 * CHUNK_WEIGHT;
+
+      /// Consecutive top level elements which are written by one task
+      struct Chunk {
+        std::function<void(XmlNode &)> write;
+        std::string xml;
+      };
+
+      template <typename Element>
+      std::size_t chunkWeight(const std::shared_ptr<const Element> &) {
+        return 1;
+      }
+
+      std::size_t chunkWeight(
+          const std::shared_ptr<const AudioChannelFormat> &channelFormat) {
+        // clang-format off
+        return 1 +
+          channelFormat->getElements<AudioBlockFormatDirectSpeakers>().size() +
+          channelFormat->getElements<AudioBlockFormatMatrix>().size() +
+          channelFormat->getElements<AudioBlockFormatObjects>().size() +
+          channelFormat->getElements<AudioBlockFormatHoa>().size() +
+          channelFormat->getElements<AudioBlockFormatBinaural>().size();
+        // clang-format on
+      }
+
+      /**
+       * Split the elements of type `Element` into chunks
+       *
+       * @returns the total weight of the elements
+       */
+      template <typename Element, typename ElementId, typename Callable>
+      std::size_t addChunks(std::vector<Chunk> &chunks,
+                     const std::shared_ptr<const Document> &document,
+                     const char *name, Callable formatter) {
+        auto elements = document->getElements<Element>();
+        auto chunkBegin = elements.begin();
+        std::size_t weight = 0;
+        std::size_t totalWeight = 0;
+        for (auto it = elements.begin(); it != elements.end();) {
+          auto elementWeight = chunkWeight(*it);
+          weight += elementWeight;
+          totalWeight += elementWeight;
+          ++it;
+          if (weight >= CHUNK_WEIGHT || it == elements.end()) {
+            auto range = boost::make_iterator_range(chunkBegin, it);
+            chunks.push_back(Chunk{[range, name, formatter](XmlNode &node) {
+                                     node.addBaseElementRange<ElementId>(
+                                         range, name, formatter);
+                                   },
+                                   std::string()});
+            chunkBegin = it;
+            weight = 0;
+          }
+        }
+        return totalWeight;
+      }
+
+      /**
+       * Write all chunks into their own buffer, as children of an element
+       * at `depth`.
+       *
+       * The chunks are distributed dynamically among `threadCount` threads,
+       * including the calling thread. The first exception thrown by a
+       * chunk is rethrown after all threads have finished.
+       */
+      void writeChunks(std::vector<Chunk> &chunks, int depth,
+                       bool discardDefaults, unsigned threadCount) {
+        std::atomic<std::size_t> nextChunk(0);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        auto worker = [&]() {
+          // one document per thread, so its buffers are reused for all the
+          // chunks written by this thread
+          XmlDocument xmlDocument(nullptr);
+          for (std::size_t i = nextChunk++; i < chunks.size();
+               i = nextChunk++) {
+            auto &chunk = chunks[i];
+            try {
+              xmlDocument.reset([&chunk](const char *data, std::size_t size) {
+                chunk.xml.append(data, size);
+              });
+              xmlDocument.setDiscardDefaults(discardDefaults);
+              auto root = xmlDocument.addFragmentRoot(depth);
+              chunk.write(root);
+              xmlDocument.finish();
+            } catch (...) {
+              std::lock_guard<std::mutex> lock(errorMutex);
+              if (!error) {
+                error = std::current_exception();
+              }
+              nextChunk = chunks.size();
+            }
+          }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned i = 1; i < threadCount; ++i) {
+          threads.emplace_back(worker);
+        }
+        worker();
+        for (auto &thread : threads) {
+          thread.join();
+        }
+        if (error) {
+          std::rethrow_exception(error);
+        }
+      }
+
+      /// Check if the ID of an element with a cache entry has changed
+      template <typename Element, typename ElementId>
+      bool idsChanged(const std::shared_ptr<const Document> &document,
+                      const WriterCacheImpl &cache) {
+        for (auto &element : document->getElements<Element>()) {
+          auto entry = cache.entries.find(element.get());
+          if (entry != cache.entries.end() &&
+              entry->second.idKey != element->template get<ElementId>().key()) {
+            return true;
+          }
+        }
+        return false;
+      }
+
+      /**
+       * Add the elements of type `Element`, formatting only those which are
+       * not in the cache, have been modified since they were cached, or for
+       * which @a cacheable returns false.
+       */
+      template <typename Element, typename ElementId, typename Callable,
+                typename Cacheable>
+      void addCachedElements(XmlNode &root,
+                             const std::shared_ptr<const Document> &document,
+                             WriterCacheImpl &cache, bool discardDefaults,
+                             const char *name, Callable formatter,
+                             Cacheable cacheable) {
+        for (auto &element : document->getElements<Element>()) {
+          auto id = element->template get<ElementId>();
+          // common definitions are not written, but are kept in the cache to
+          // notice if their IDs change
+          bool isCommonDefinition = isCommonDefinitionsId(id);
+          auto &entry = cache.entries[element.get()];
+          if (entry.element.lock() != element ||
+              entry.revision != element->getRevision() ||
+              !cacheable(*element)) {
+            entry.element.reset();
+            entry.xml.clear();
+            if (!isCommonDefinition) {
+              XmlDocument fragment(
+                  [&entry](const char *data, std::size_t size) {
+                    entry.xml.append(data, size);
+                  });
+              fragment.setDiscardDefaults(discardDefaults);
+              auto fragmentRoot = fragment.addFragmentRoot(root.depth());
+              fragmentRoot.addElement(element, name, formatter);
+              fragment.finish();
+            }
+            entry.element = element;
+            entry.revision = element->getRevision();
+            entry.idKey = id.key();
+          }
+          entry.generation = cache.generation;
+          if (!isCommonDefinition) {
+            root.addFragment(entry.xml);
+          }
+        }
+      }
+
+      template <typename Element, typename ElementId, typename Callable>
+      void addCachedElements(XmlNode &root,
+                             const std::shared_ptr<const Document> &document,
+                             WriterCacheImpl &cache, bool discardDefaults,
+                             const char *name, Callable formatter) {
+        addCachedElements<Element, ElementId>(
+            root, document, cache, discardDefaults, name, formatter,
+            [](const Element &) { return true; });
+      }
+    }  // namespace
+
+    WriterCache::WriterCache() : impl_(new WriterCacheImpl()) {}
+    WriterCache::~WriterCache() = default;
+
+    std::size_t WriterCache::size() const { return impl_->entries.size(); }
+
+    void WriterCache::clear() { impl_->entries.clear(); }
 
     XmlWriter::XmlWriter(WriterOptions options) : options_(options) {}
+    XmlWriter::~XmlWriter() = default;
 
     std::ostream& XmlWriter::write(std::shared_ptr<const Document> document,
                                    std::ostream& stream) {
-      XmlDocument xmlDocument;
+      write(document, startDocument([&stream](const char* data,
+                                              std::size_t size) {
+              stream.write(data, static_cast<std::streamsize>(size));
+            }));
+      return stream;
+    }
+
+    std::ostream& XmlWriter::write(std::shared_ptr<const Document> document,
+                                   std::ostream& stream, WriterCache& cache) {
+      write(document,
+            startDocument([&stream](const char* data, std::size_t size) {
+              stream.write(data, static_cast<std::streamsize>(size));
+            }),
+            cache.impl_.get());
+      return stream;
+    }
+
+    void XmlWriter::write(std::shared_ptr<const Document> document,
+                          std::vector<char>& buffer) {
+      write(document,
+            startDocument([&buffer](const char* data, std::size_t size) {
+              buffer.insert(buffer.end(), data, data + size);
+            }));
+    }
+
+    void XmlWriter::write(std::shared_ptr<const Document> document,
+                          std::string& buffer) {
+      write(document,
+            startDocument([&buffer](const char* data, std::size_t size) {
+              buffer.append(data, size);
+            }));
+    }
+
+    std::size_t XmlWriter::measure(std::shared_ptr<const Document> document) {
+      std::size_t xmlSize = 0;
+      write(document, startDocument([&xmlSize](const char*, std::size_t size) {
+              xmlSize += size;
+            }));
+      return xmlSize;
+    }
+
+    void XmlWriter::setThreadCount(unsigned threadCount) {
+      threadCount_ = threadCount;
+    }
+
+    XmlDocument& XmlWriter::startDocument(
+        std::function<void(const char*, std::size_t)> output) {
+      if (xmlDocument_) {
+        xmlDocument_->reset(std::move(output));
+      } else {
+        xmlDocument_.reset(new XmlDocument(std::move(output)));
+      }
+      return *xmlDocument_;
+    }
+
+    void XmlWriter::write(std::shared_ptr<const Document> document,
+                          XmlDocument& xmlDocument,
+                          WriterCacheImpl* cache) {
       xmlDocument.setDiscardDefaults(
           !isSet(options_, WriterOptions::write_default_values));
       xmlDocument.addDeclaration();
@@ -37,6 +286,18 @@ namespace adm {
       } else {
         root = xmlDocument.addEbuStructure();
       }
+      if (cache) {
+        writeCached(document, root, *cache);
+      } else if (isSet(options_, WriterOptions::parallel)) {
+        writeParallel(document, root);
+      } else {
+        writeSequential(document, root);
+      }
+      xmlDocument.finish();
+    }
+
+    void XmlWriter::writeSequential(std::shared_ptr<const Document> document,
+                                    XmlNode& root) {
       // clang-format off
       root.addBaseElements<AudioProgramme, AudioProgrammeId>(document, "audioProgramme", &formatAudioProgramme);
       root.addBaseElements<AudioContent, AudioContentId>(document, "audioContent", &formatAudioContent);
@@ -47,7 +308,88 @@ namespace adm {
       root.addBaseElements<AudioTrackFormat, AudioTrackFormatId>(document, "audioTrackFormat", &formatAudioTrackFormat);
       root.addBaseElements<AudioTrackUid, AudioTrackUidId>(document, "audioTrackUID", &formatAudioTrackUid);
       // clang-format on
-      return stream << xmlDocument;
+    }
+
+    void XmlWriter::writeParallel(std::shared_ptr<const Document> document,
+                                  XmlNode& root) {
+      std::vector<Chunk> chunks;
+      std::size_t weight = 0;
+      // clang-format off
+      weight += addChunks<AudioProgramme, AudioProgrammeId>(chunks, document, "audioProgramme", &formatAudioProgramme);
+      weight += addChunks<AudioContent, AudioContentId>(chunks, document, "audioContent", &formatAudioContent);
+      weight += addChunks<AudioObject, AudioObjectId>(chunks, document, "audioObject", &formatAudioObject);
+      weight += addChunks<AudioPackFormat, AudioPackFormatId>(chunks, document, "audioPackFormat", &formatAudioPackFormat);
+      weight += addChunks<AudioChannelFormat, AudioChannelFormatId>(chunks, document, "audioChannelFormat", &formatAudioChannelFormat);
+      weight += addChunks<AudioStreamFormat, AudioStreamFormatId>(chunks, document, "audioStreamFormat", &formatAudioStreamFormat);
+      weight += addChunks<AudioTrackFormat, AudioTrackFormatId>(chunks, document, "audioTrackFormat", &formatAudioTrackFormat);
+      weight += addChunks<AudioTrackUid, AudioTrackUidId>(chunks, document, "audioTrackUID", &formatAudioTrackUid);
+      // clang-format on
+
+      // small documents are written on the calling thread only
+      if (weight <= PARALLEL_WEIGHT) {
+        writeSequential(document, root);
+        return;
+      }
+      auto threadCount = threadCount_ ? threadCount_
+                                      : std::thread::hardware_concurrency();
+      // every thread needs at least one chunk
+      threadCount = static_cast<unsigned>(std::max<std::size_t>(
+          1, std::min<std::size_t>(threadCount, chunks.size())));
+      writeChunks(chunks, root.depth(),
+                  !isSet(options_, WriterOptions::write_default_values),
+                  threadCount);
+      for (auto& chunk : chunks) {
+        root.addFragment(chunk.xml);
+        // free the memory as early as possible
+        std::string().swap(chunk.xml);
+      }
+    }
+
+    void XmlWriter::writeCached(std::shared_ptr<const Document> document,
+                                XmlNode& root, WriterCacheImpl& cache) {
+      // the parallel option does not influence the output
+      auto options = options_ & ~WriterOptions::parallel;
+      // clang-format off
+      if (cache.options != options ||
+          idsChanged<AudioProgramme, AudioProgrammeId>(document, cache) ||
+          idsChanged<AudioContent, AudioContentId>(document, cache) ||
+          idsChanged<AudioObject, AudioObjectId>(document, cache) ||
+          idsChanged<AudioPackFormat, AudioPackFormatId>(document, cache) ||
+          idsChanged<AudioChannelFormat, AudioChannelFormatId>(document, cache) ||
+          idsChanged<AudioStreamFormat, AudioStreamFormatId>(document, cache) ||
+          idsChanged<AudioTrackFormat, AudioTrackFormatId>(document, cache) ||
+          idsChanged<AudioTrackUid, AudioTrackUidId>(document, cache)) {
+        cache.entries.clear();
+      }
+      // clang-format on
+      cache.options = options;
+      ++cache.generation;
+
+      auto discardDefaults =
+          !isSet(options_, WriterOptions::write_default_values);
+      // clang-format off
+      addCachedElements<AudioProgramme, AudioProgrammeId>(root, document, cache, discardDefaults, "audioProgramme", &formatAudioProgramme);
+      addCachedElements<AudioContent, AudioContentId>(root, document, cache, discardDefaults, "audioContent", &formatAudioContent);
+      addCachedElements<AudioObject, AudioObjectId>(root, document, cache, discardDefaults, "audioObject", &formatAudioObject);
+      addCachedElements<AudioPackFormat, AudioPackFormatId>(root, document, cache, discardDefaults, "audioPackFormat", &formatAudioPackFormat);
+      // audioBlockFormats handed out by the non-const getElements() can be
+      // modified without changing the revision
+      addCachedElements<AudioChannelFormat, AudioChannelFormatId>(root, document, cache, discardDefaults, "audioChannelFormat", &formatAudioChannelFormat,
+          [](const AudioChannelFormat& channelFormat) { return !AudioChannelFormatAttorney::blockFormatsExposed(channelFormat); });
+      addCachedElements<AudioStreamFormat, AudioStreamFormatId>(root, document, cache, discardDefaults, "audioStreamFormat", &formatAudioStreamFormat);
+      addCachedElements<AudioTrackFormat, AudioTrackFormatId>(root, document, cache, discardDefaults, "audioTrackFormat", &formatAudioTrackFormat);
+      addCachedElements<AudioTrackUid, AudioTrackUidId>(root, document, cache, discardDefaults, "audioTrackUID", &formatAudioTrackUid);
+      // clang-format on
+
+      // remove the entries of elements which are not part of the document
+      // anymore
+      for (auto entry = cache.entries.begin(); entry != cache.entries.end();) {
+        if (entry->second.generation != cache.generation) {
+          entry = cache.entries.erase(entry);
+        } else {
+          ++entry;
+        }
+      }
     }
 
   }  // namespace xml
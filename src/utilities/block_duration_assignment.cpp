@@ -109,9 +109,8 @@ namespace adm {
       boost::optional<std::chrono::nanoseconds> fileLength) {
     auto programmeDuration = durationOfProgramme(programme.get(), fileLength);
     RouteTracer tracer;
-    auto result = tracer.run(programme);
     std::map<AudioChannelFormatId, std::chrono::nanoseconds> durations;
-    for (const auto& route : result) {
+    tracer.run(programme, [&](const Route& route) {
       auto duration = durationOfChannel(route, programmeDuration);
       auto channel =
           route.getLastOf<AudioChannelFormat>()->get<AudioChannelFormatId>();
@@ -121,7 +120,8 @@ namespace adm {
             "AudioChannelFormat with different effective durations detected");
       }
       durations.insert(std::make_pair(channel, duration));
-    }
+      return true;
+    });
     return durations;
   }
 
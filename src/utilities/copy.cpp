@@ -1,6 +1,5 @@
 #include "adm/utilities/copy.hpp"
 #include "adm/private/copy.hpp"
-#include <boost/variant.hpp>
 
 namespace adm {
 
@@ -12,8 +11,7 @@ namespace adm {
 
   void deepCopyTo(std::shared_ptr<const Document> src,
                   std::shared_ptr<Document> dest) {
-    auto copiedElements = copyAllElements(src);
-    addElements(copiedElements, dest);
+    dest->add(copyAllElements(src));
   }
 
 }  // namespace adm
@@ -0,0 +1,299 @@
+#include "adm/utilities/deduplication.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/errors.hpp"
+#include "adm/private/binary_encoding.hpp"
+
+namespace adm {
+
+  namespace {
+
+    /// Builds the keys which are equal for identical elements
+    class KeyBuilder {
+     public:
+      template <typename Element>
+      KeyBuilder& addParameters(const Element& element) {
+        buffer_.clear();
+        detail::encodeParametersWithoutId(buffer_, element);
+        add(buffer_.size());
+        key_.append(buffer_.data(), buffer_.size());
+        return *this;
+      }
+
+      template <typename Range>
+      KeyBuilder& addBlockFormats(const Range& blockFormats) {
+        add(blockFormats.size());
+        for (const auto& blockFormat : blockFormats) {
+          addParameters(blockFormat);
+        }
+        return *this;
+      }
+
+      /// add the identity of a (canonical) referenced element
+      template <typename Element>
+      KeyBuilder& addReference(const std::shared_ptr<Element>& element) {
+        return add(reinterpret_cast<std::uintptr_t>(element.get()));
+      }
+
+      KeyBuilder& add(std::uint64_t value) {
+        key_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return *this;
+      }
+
+      /// the key, after which the builder is empty again
+      std::string get() {
+        std::string key;
+        key.swap(key_);
+        return key;
+      }
+
+     private:
+      std::vector<char> buffer_;
+      std::string key_;
+    };
+
+    /// The element kept for each set of identical elements of one type
+    template <typename Element>
+    class CanonicalElements {
+     public:
+      /**
+       * Add @a element with @a key. If an element with the same key has been
+       * added before, @a element is a duplicate of it, and is added to
+       * @a removed.
+       */
+      void add(const std::shared_ptr<Element>& element, std::string key,
+               std::vector<ElementVariant>& removed) {
+        auto result = byKey_.emplace(std::move(key), element);
+        if (!result.second) {
+          duplicates_[element.get()] = result.first->second;
+          removed.push_back(element);
+        }
+      }
+
+      /// the element which replaces @a element
+      std::shared_ptr<Element> get(
+          const std::shared_ptr<Element>& element) const {
+        auto it = duplicates_.find(element.get());
+        return it == duplicates_.end() ? element : it->second;
+      }
+
+      bool isDuplicate(const std::shared_ptr<Element>& element) const {
+        return duplicates_.count(element.get()) != 0;
+      }
+
+     private:
+      std::unordered_map<std::string, std::shared_ptr<Element>> byKey_;
+      std::unordered_map<const Element*, std::shared_ptr<Element>>
+          duplicates_;
+    };
+
+    /**
+     * nesting depth of @a packFormat, 0 if it references no audioPackFormats
+     *
+     * The references are followed without recursion, so that deep nesting
+     * cannot overflow the stack; throws an AdmGenericRuntimeError if they
+     * contain a cycle.
+     */
+    std::size_t packFormatDepth(
+        const std::shared_ptr<AudioPackFormat>& packFormat,
+        std::unordered_map<const AudioPackFormat*, std::size_t>& depths) {
+      auto it = depths.find(packFormat.get());
+      if (it != depths.end()) {
+        return it->second;
+      }
+
+      /// an audioPackFormat whose depth is being determined
+      struct Visit {
+        std::shared_ptr<AudioPackFormat> packFormat;
+        std::size_t nextReference;
+        std::size_t depth;
+      };
+      std::vector<Visit> stack{Visit{packFormat, 0, 0}};
+      std::unordered_set<const AudioPackFormat*> visiting{packFormat.get()};
+      while (!stack.empty()) {
+        auto references =
+            stack.back().packFormat->getReferences<AudioPackFormat>();
+        if (stack.back().nextReference < references.size()) {
+          auto& reference = references[stack.back().nextReference++];
+          auto known = depths.find(reference.get());
+          if (known != depths.end()) {
+            stack.back().depth =
+                std::max(stack.back().depth, known->second + 1);
+          } else if (visiting.insert(reference.get()).second) {
+            stack.push_back(Visit{reference, 0, 0});
+          } else {
+            throw error::detail::formatElementRuntimeError(
+                reference->get<AudioPackFormatId>(),
+                "audioPackFormat references contain a cycle");
+          }
+        } else {
+          auto visited = std::move(stack.back());
+          stack.pop_back();
+          visiting.erase(visited.packFormat.get());
+          depths[visited.packFormat.get()] = visited.depth;
+          if (!stack.empty()) {
+            stack.back().depth =
+                std::max(stack.back().depth, visited.depth + 1);
+          }
+        }
+      }
+      return depths[packFormat.get()];
+    }
+
+    /**
+     * The audioPackFormats of @a document, ordered by their nesting depth,
+     * and then by their position in the document.
+     *
+     * Identical audioPackFormats have the same depth, so the referenced
+     * audioPackFormats are always merged before the referencing ones.
+     */
+    std::vector<std::shared_ptr<AudioPackFormat>> sortedPackFormats(
+        Document& document) {
+      std::unordered_map<const AudioPackFormat*, std::size_t> depths;
+      std::vector<std::pair<std::size_t, std::shared_ptr<AudioPackFormat>>>
+          packFormats;
+      for (auto& packFormat : document.getElements<AudioPackFormat>()) {
+        packFormats.emplace_back(packFormatDepth(packFormat, depths),
+                                 packFormat);
+      }
+      std::stable_sort(
+          packFormats.begin(), packFormats.end(),
+          [](const std::pair<std::size_t, std::shared_ptr<AudioPackFormat>>& a,
+             const std::pair<std::size_t, std::shared_ptr<AudioPackFormat>>&
+                 b) { return a.first < b.first; });
+      std::vector<std::shared_ptr<AudioPackFormat>> result;
+      result.reserve(packFormats.size());
+      for (auto& entry : packFormats) {
+        result.push_back(std::move(entry.second));
+      }
+      return result;
+    }
+
+    /// redirect the references of type `Referenced`, keeping their order
+    template <typename Referenced, typename Element>
+    void replaceReferences(Element& element,
+                           const CanonicalElements<Referenced>& canonical) {
+      std::vector<std::shared_ptr<Referenced>> references;
+      bool changed = false;
+      for (auto& reference : element.template getReferences<Referenced>()) {
+        references.push_back(canonical.get(reference));
+        changed = changed || references.back() != reference;
+      }
+      if (changed) {
+        element.template clearReferences<Referenced>();
+        for (auto& reference : references) {
+          element.addReference(reference);
+        }
+      }
+    }
+
+    /// redirect the single reference of type `Referenced`
+    template <typename Referenced, typename Element>
+    void replaceReference(Element& element,
+                          const CanonicalElements<Referenced>& canonical) {
+      auto reference = element.template getReference<Referenced>();
+      if (reference && canonical.isDuplicate(reference)) {
+        element.setReference(canonical.get(reference));
+      }
+    }
+
+  }  // namespace
+
+  std::size_t removeDuplicateFormats(std::shared_ptr<Document> document) {
+    std::vector<ElementVariant> removed;
+    KeyBuilder key;
+
+    CanonicalElements<AudioChannelFormat> channelFormats;
+    for (auto& channelFormat : document->getElements<AudioChannelFormat>()) {
+      std::shared_ptr<const AudioChannelFormat> constChannelFormat =
+          channelFormat;
+      key.addParameters(*channelFormat)
+          .addBlockFormats(constChannelFormat
+                               ->getElements<AudioBlockFormatDirectSpeakers>())
+          .addBlockFormats(
+              constChannelFormat->getElements<AudioBlockFormatMatrix>())
+          .addBlockFormats(
+              constChannelFormat->getElements<AudioBlockFormatObjects>())
+          .addBlockFormats(
+              constChannelFormat->getElements<AudioBlockFormatHoa>())
+          .addBlockFormats(
+              constChannelFormat->getElements<AudioBlockFormatBinaural>());
+      channelFormats.add(channelFormat, key.get(), removed);
+    }
+
+    CanonicalElements<AudioPackFormat> packFormats;
+    for (auto& packFormat : sortedPackFormats(*document)) {
+      key.addParameters(*packFormat);
+      auto channelFormatReferences =
+          packFormat->getReferences<AudioChannelFormat>();
+      key.add(channelFormatReferences.size());
+      for (auto& reference : channelFormatReferences) {
+        key.addReference(channelFormats.get(reference));
+      }
+      auto packFormatReferences = packFormat->getReferences<AudioPackFormat>();
+      key.add(packFormatReferences.size());
+      for (auto& reference : packFormatReferences) {
+        key.addReference(packFormats.get(reference));
+      }
+      packFormats.add(packFormat, key.get(), removed);
+    }
+
+    CanonicalElements<AudioStreamFormat> streamFormats;
+    for (auto& streamFormat : document->getElements<AudioStreamFormat>()) {
+      key.addParameters(*streamFormat);
+      auto channelFormat = streamFormat->getReference<AudioChannelFormat>();
+      key.addReference(channelFormat ? channelFormats.get(channelFormat)
+                                     : channelFormat);
+      auto packFormat = streamFormat->getReference<AudioPackFormat>();
+      key.addReference(packFormat ? packFormats.get(packFormat) : packFormat);
+      streamFormats.add(streamFormat, key.get(), removed);
+    }
+
+    CanonicalElements<AudioTrackFormat> trackFormats;
+    for (auto& trackFormat : document->getElements<AudioTrackFormat>()) {
+      key.addParameters(*trackFormat);
+      auto streamFormat = trackFormat->getReference<AudioStreamFormat>();
+      key.addReference(streamFormat ? streamFormats.get(streamFormat)
+                                    : streamFormat);
+      trackFormats.add(trackFormat, key.get(), removed);
+    }
+
+    if (removed.empty()) {
+      return 0;
+    }
+
+    for (auto& object : document->getElements<AudioObject>()) {
+      replaceReferences(*object, packFormats);
+    }
+    for (auto& packFormat : document->getElements<AudioPackFormat>()) {
+      if (!packFormats.isDuplicate(packFormat)) {
+        replaceReferences(*packFormat, channelFormats);
+        replaceReferences(*packFormat, packFormats);
+      }
+    }
+    for (auto& streamFormat : document->getElements<AudioStreamFormat>()) {
+      if (!streamFormats.isDuplicate(streamFormat)) {
+        replaceReference(*streamFormat, channelFormats);
+        replaceReference(*streamFormat, packFormats);
+      }
+    }
+    for (auto& trackFormat : document->getElements<AudioTrackFormat>()) {
+      if (!trackFormats.isDuplicate(trackFormat)) {
+        replaceReference(*trackFormat, streamFormats);
+      }
+    }
+    for (auto& trackUid : document->getElements<AudioTrackUid>()) {
+      replaceReference(*trackUid, trackFormats);
+      replaceReference(*trackUid, packFormats);
+    }
+
+    return document->remove(removed);
+  }
+
+}  // namespace adm
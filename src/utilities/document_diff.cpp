@@ -0,0 +1,364 @@
+#include "adm/utilities/document_diff.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/private/binary_encoding.hpp"
+
+namespace adm {
+
+  namespace {
+
+    /// number of audioBlockFormats compared by one task
+    const std::size_t BLOCK_FORMATS_PER_TASK = 4096;
+    /// number of audioBlockFormats in both documents above which they are
+    /// compared on multiple threads; below, starting the threads costs more
+    /// than it saves
+    const std::size_t PARALLEL_BLOCK_FORMATS = 8 * BLOCK_FORMATS_PER_TASK;
+
+    template <typename Element>
+    std::uint64_t idKey(const Element& element) {
+      return element.template get<typename Element::id_type>().key();
+    }
+
+    /// Buffers reused for the encodings of the two compared elements
+    struct Encodings {
+      std::vector<char> first;
+      std::vector<char> second;
+
+      template <typename Element>
+      bool equal(const Element& firstElement, const Element& secondElement) {
+        first.clear();
+        second.clear();
+        detail::encodeParameters(first, firstElement);
+        detail::encodeParameters(second, secondElement);
+        return first == second;
+      }
+    };
+
+    // ---- references ---- //
+
+    typedef std::vector<std::uint64_t> ReferenceKeys;
+
+    template <typename Element>
+    void appendReference(ReferenceKeys& keys,
+                         const std::shared_ptr<const Element>& reference) {
+      keys.push_back(reference ? 1 : 0);
+      if (reference) {
+        keys.push_back(idKey(*reference));
+      }
+    }
+
+    template <typename Range>
+    void appendReferences(ReferenceKeys& keys, const Range& references) {
+      keys.push_back(references.size());
+      for (const auto& reference : references) {
+        keys.push_back(idKey(*reference));
+      }
+    }
+
+    void appendReferences(ReferenceKeys& keys,
+                          const AudioProgramme& programme) {
+      appendReferences(keys, programme.getReferences<AudioContent>());
+    }
+    void appendReferences(ReferenceKeys& keys, const AudioContent& content) {
+      appendReferences(keys, content.getReferences<AudioObject>());
+    }
+    void appendReferences(ReferenceKeys& keys, const AudioObject& object) {
+      appendReferences(keys, object.getReferences<AudioObject>());
+      appendReferences(keys, object.getReferences<AudioPackFormat>());
+      appendReferences(keys, object.getReferences<AudioTrackUid>());
+      appendReferences(keys, object.getComplementaryObjects());
+    }
+    void appendReferences(ReferenceKeys& keys,
+                          const AudioPackFormat& packFormat) {
+      appendReferences(keys, packFormat.getReferences<AudioPackFormat>());
+      appendReferences(keys, packFormat.getReferences<AudioChannelFormat>());
+    }
+    void appendReferences(ReferenceKeys&, const AudioChannelFormat&) {}
+    void appendReferences(ReferenceKeys& keys,
+                          const AudioStreamFormat& streamFormat) {
+      appendReference(keys, streamFormat.getReference<AudioPackFormat>());
+      appendReference(keys, streamFormat.getReference<AudioChannelFormat>());
+      std::vector<std::shared_ptr<const AudioTrackFormat>> trackFormats;
+      for (auto& weakReference :
+           streamFormat.getAudioTrackFormatReferences()) {
+        if (auto reference = weakReference.lock()) {
+          trackFormats.push_back(reference);
+        }
+      }
+      appendReferences(keys, trackFormats);
+    }
+    void appendReferences(ReferenceKeys& keys,
+                          const AudioTrackFormat& trackFormat) {
+      appendReference(keys, trackFormat.getReference<AudioStreamFormat>());
+    }
+    void appendReferences(ReferenceKeys& keys, const AudioTrackUid& trackUid) {
+      appendReference(keys, trackUid.getReference<AudioTrackFormat>());
+      appendReference(keys, trackUid.getReference<AudioPackFormat>());
+    }
+
+    // ---- audioBlockFormats ---- //
+
+    typedef std::function<void(std::vector<DocumentChange>&, Encodings&)>
+        Task;
+
+    /// Position of each audioBlockFormat by its ID
+    typedef std::unordered_map<AudioBlockFormatId, std::size_t>
+        BlockFormatIndex;
+
+    template <typename Range>
+    std::shared_ptr<BlockFormatIndex> indexBlockFormats(
+        const Range& blockFormats) {
+      auto index = std::make_shared<BlockFormatIndex>();
+      index->reserve(blockFormats.size());
+      for (std::size_t i = 0; i < blockFormats.size(); ++i) {
+        auto id = blockFormats[i].template get<AudioBlockFormatId>();
+        index->emplace(id, i);
+      }
+      return index;
+    }
+
+    /**
+     * Add the tasks comparing the audioBlockFormats of type `BlockFormat`
+     * of @a first and @a second to @a tasks. The blocks of @a first are
+     * checked for removals and changes, and then the blocks of @a second
+     * for additions, each in ranges of `BLOCK_FORMATS_PER_TASK`.
+     *
+     * @returns the number of compared audioBlockFormats
+     */
+    template <typename BlockFormat>
+    std::size_t addBlockFormatTasks(
+        std::vector<Task>& tasks,
+        const std::shared_ptr<const AudioChannelFormat>& first,
+        const std::shared_ptr<const AudioChannelFormat>& second) {
+      auto firstBlocks = first->getElements<BlockFormat>();
+      auto secondBlocks = second->getElements<BlockFormat>();
+      if (firstBlocks.empty() && secondBlocks.empty()) {
+        return 0;
+      }
+      auto channelFormatId =
+          ElementIdVariant(first->get<AudioChannelFormatId>());
+      auto firstIndex = indexBlockFormats(firstBlocks);
+      auto secondIndex = indexBlockFormats(secondBlocks);
+
+      for (std::size_t begin = 0; begin < firstBlocks.size();
+           begin += BLOCK_FORMATS_PER_TASK) {
+        auto end =
+            std::min(begin + BLOCK_FORMATS_PER_TASK, firstBlocks.size());
+        tasks.push_back([=](std::vector<DocumentChange>& changes,
+                            Encodings& encodings) {
+          for (auto i = begin; i < end; ++i) {
+            auto& blockFormat = firstBlocks[i];
+            auto id = blockFormat.template get<AudioBlockFormatId>();
+            auto match = secondIndex->find(id);
+            if (match == secondIndex->end()) {
+              changes.push_back({ChangeType::removed, channelFormatId, id});
+            } else if (!encodings.equal(blockFormat,
+                                        secondBlocks[match->second])) {
+              changes.push_back(
+                  {ChangeType::parametersChanged, channelFormatId, id});
+            }
+          }
+        });
+      }
+      for (std::size_t begin = 0; begin < secondBlocks.size();
+           begin += BLOCK_FORMATS_PER_TASK) {
+        auto end =
+            std::min(begin + BLOCK_FORMATS_PER_TASK, secondBlocks.size());
+        tasks.push_back(
+            [=](std::vector<DocumentChange>& changes, Encodings&) {
+              for (auto i = begin; i < end; ++i) {
+                auto id = secondBlocks[i].template get<AudioBlockFormatId>();
+                if (firstIndex->find(id) == firstIndex->end()) {
+                  changes.push_back({ChangeType::added, channelFormatId, id});
+                }
+              }
+            });
+      }
+      return firstBlocks.size() + secondBlocks.size();
+    }
+
+    /**
+     * Run all @a tasks, each writing into its own result vector.
+     *
+     * The tasks are distributed dynamically among `threadCount` threads,
+     * including the calling thread. The first exception thrown by a task
+     * is rethrown after all threads have finished.
+     */
+    void runTasks(const std::vector<Task>& tasks,
+                  std::vector<std::vector<DocumentChange>>& results,
+                  unsigned threadCount) {
+      results.resize(tasks.size());
+      std::atomic<std::size_t> nextTask(0);
+      std::exception_ptr error;
+      std::mutex errorMutex;
+      auto worker = [&]() {
+        Encodings encodings;
+        for (std::size_t i = nextTask++; i < tasks.size(); i = nextTask++) {
+          try {
+            tasks[i](results[i], encodings);
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+              error = std::current_exception();
+            }
+            nextTask = tasks.size();
+          }
+        }
+      };
+
+      std::vector<std::thread> threads;
+      for (unsigned i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+      }
+      worker();
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+
+    // ---- elements ---- //
+
+    /// Changes of the elements, with the audioBlockFormat tasks to run
+    struct DiffState {
+      std::vector<DocumentChange> changes;
+      Encodings encodings;
+      ReferenceKeys firstReferences;
+      ReferenceKeys secondReferences;
+      /// position in `changes` before which the block changes are inserted
+      std::vector<std::size_t> blockFormatPositions;
+      /// tasks comparing the audioBlockFormats, per audioChannelFormat
+      std::vector<std::vector<Task>> blockFormatTasks;
+      /// number of audioBlockFormats compared by all tasks
+      std::size_t blockFormatCount = 0;
+    };
+
+    template <typename Element>
+    void compareChildren(DiffState&, const std::shared_ptr<const Element>&,
+                         const std::shared_ptr<const Element>&) {}
+
+    void compareChildren(
+        DiffState& state,
+        const std::shared_ptr<const AudioChannelFormat>& first,
+        const std::shared_ptr<const AudioChannelFormat>& second) {
+      std::vector<Task> tasks;
+      // clang-format off
+      state.blockFormatCount += addBlockFormatTasks<AudioBlockFormatDirectSpeakers>(tasks, first, second);
+      state.blockFormatCount += addBlockFormatTasks<AudioBlockFormatMatrix>(tasks, first, second);
+      state.blockFormatCount += addBlockFormatTasks<AudioBlockFormatObjects>(tasks, first, second);
+      state.blockFormatCount += addBlockFormatTasks<AudioBlockFormatHoa>(tasks, first, second);
+      state.blockFormatCount += addBlockFormatTasks<AudioBlockFormatBinaural>(tasks, first, second);
+      // clang-format on
+      if (!tasks.empty()) {
+        state.blockFormatPositions.push_back(state.changes.size());
+        state.blockFormatTasks.push_back(std::move(tasks));
+      }
+    }
+
+    template <typename Element>
+    void compareElements(DiffState& state, const Document& first,
+                         const Document& second) {
+      auto firstElements = first.getElements<Element>();
+      auto secondElements = second.getElements<Element>();
+      typedef typename Element::id_type Id;
+      std::unordered_map<Id, std::shared_ptr<const Element>> secondById;
+      secondById.reserve(secondElements.size());
+      for (const auto& element : secondElements) {
+        secondById.emplace(element->template get<Id>(), element);
+      }
+
+      for (const auto& element : firstElements) {
+        auto id = ElementIdVariant(element->template get<Id>());
+        auto match = secondById.find(element->template get<Id>());
+        if (match == secondById.end()) {
+          state.changes.push_back({ChangeType::removed, id, boost::none});
+          continue;
+        }
+        auto& other = match->second;
+        if (!state.encodings.equal(*element, *other)) {
+          state.changes.push_back(
+              {ChangeType::parametersChanged, id, boost::none});
+        }
+        state.firstReferences.clear();
+        state.secondReferences.clear();
+        appendReferences(state.firstReferences, *element);
+        appendReferences(state.secondReferences, *other);
+        if (state.firstReferences != state.secondReferences) {
+          state.changes.push_back(
+              {ChangeType::referencesChanged, id, boost::none});
+        }
+        compareChildren(state, element, other);
+        // matched elements are removed, so the rest has been added
+        secondById.erase(match);
+      }
+
+      for (const auto& element : secondElements) {
+        if (secondById.count(element->template get<Id>())) {
+          auto id = ElementIdVariant(element->template get<Id>());
+          state.changes.push_back({ChangeType::added, id, boost::none});
+        }
+      }
+    }
+  }  // namespace
+
+  std::vector<DocumentChange> diff(std::shared_ptr<const Document> first,
+                                   std::shared_ptr<const Document> second) {
+    DiffState state;
+    compareElements<AudioProgramme>(state, *first, *second);
+    compareElements<AudioContent>(state, *first, *second);
+    compareElements<AudioObject>(state, *first, *second);
+    compareElements<AudioPackFormat>(state, *first, *second);
+    compareElements<AudioChannelFormat>(state, *first, *second);
+    compareElements<AudioStreamFormat>(state, *first, *second);
+    compareElements<AudioTrackFormat>(state, *first, *second);
+    compareElements<AudioTrackUid>(state, *first, *second);
+
+    if (state.blockFormatTasks.empty()) {
+      return std::move(state.changes);
+    }
+
+    // all tasks of all audioChannelFormats are run together, so that both
+    // many small and a few big audioChannelFormats are spread evenly
+    std::vector<Task> tasks;
+    for (auto& channelFormatTasks : state.blockFormatTasks) {
+      for (auto& task : channelFormatTasks) {
+        tasks.push_back(std::move(task));
+      }
+    }
+    std::vector<std::vector<DocumentChange>> results;
+    // small documents are compared on the calling thread only
+    auto threadCount = state.blockFormatCount > PARALLEL_BLOCK_FORMATS
+                           ? std::max(1u, std::thread::hardware_concurrency())
+                           : 1u;
+    runTasks(tasks, results,
+             static_cast<unsigned>(
+                 std::min<std::size_t>(threadCount, tasks.size())));
+
+    std::vector<DocumentChange> changes;
+    auto result = results.begin();
+    std::size_t position = 0;
+    for (std::size_t i = 0; i < state.blockFormatTasks.size(); ++i) {
+      auto end = state.blockFormatPositions[i];
+      changes.insert(changes.end(), state.changes.begin() + position,
+                     state.changes.begin() + end);
+      position = end;
+      for (std::size_t j = 0; j < state.blockFormatTasks[i].size();
+           ++j, ++result) {
+        changes.insert(changes.end(), result->begin(), result->end());
+      }
+    }
+    changes.insert(changes.end(), state.changes.begin() + position,
+                   state.changes.end());
+    return changes;
+  }
+
+}  // namespace adm
@@ -0,0 +1,148 @@
+#include "adm/utilities/garbage_collection.hpp"
+#include <unordered_set>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+
+namespace adm {
+
+  namespace {
+
+    /// Marks the elements reachable from the added elements
+    class Marker : public boost::static_visitor<> {
+     public:
+      void mark(const ElementVariant& element) {
+        pending_.push_back(element);
+        while (!pending_.empty()) {
+          auto next = std::move(pending_.back());
+          pending_.pop_back();
+          boost::apply_visitor(*this, next);
+        }
+      }
+
+      bool isMarked(const void* element) const {
+        return marked_.count(element) != 0;
+      }
+
+      void operator()(const std::shared_ptr<AudioProgramme>& programme) {
+        if (visit(programme.get())) {
+          addAll(programme->getReferences<AudioContent>());
+        }
+      }
+
+      void operator()(const std::shared_ptr<AudioContent>& content) {
+        if (visit(content.get())) {
+          addAll(content->getReferences<AudioObject>());
+        }
+      }
+
+      void operator()(const std::shared_ptr<AudioObject>& object) {
+        if (visit(object.get())) {
+          addAll(object->getReferences<AudioObject>());
+          addAll(object->getReferences<AudioPackFormat>());
+          addAll(object->getReferences<AudioTrackUid>());
+          addAll(object->getComplementaryObjects());
+        }
+      }
+
+      void operator()(const std::shared_ptr<AudioPackFormat>& packFormat) {
+        if (visit(packFormat.get())) {
+          addAll(packFormat->getReferences<AudioPackFormat>());
+          addAll(packFormat->getReferences<AudioChannelFormat>());
+        }
+      }
+
+      void operator()(
+          const std::shared_ptr<AudioChannelFormat>& channelFormat) {
+        visit(channelFormat.get());
+      }
+
+      void operator()(const std::shared_ptr<AudioStreamFormat>& streamFormat) {
+        if (visit(streamFormat.get())) {
+          add(streamFormat->getReference<AudioChannelFormat>());
+          add(streamFormat->getReference<AudioPackFormat>());
+          for (auto& weakReference :
+               streamFormat->getAudioTrackFormatReferences()) {
+            add(weakReference.lock());
+          }
+        }
+      }
+
+      void operator()(const std::shared_ptr<AudioTrackFormat>& trackFormat) {
+        if (visit(trackFormat.get())) {
+          add(trackFormat->getReference<AudioStreamFormat>());
+        }
+      }
+
+      void operator()(const std::shared_ptr<AudioTrackUid>& trackUid) {
+        if (visit(trackUid.get())) {
+          add(trackUid->getReference<AudioTrackFormat>());
+          add(trackUid->getReference<AudioPackFormat>());
+        }
+      }
+
+     private:
+      /// mark @a element; false if it had already been marked
+      bool visit(const void* element) {
+        return marked_.insert(element).second;
+      }
+
+      template <typename Element>
+      void add(const std::shared_ptr<Element>& element) {
+        if (element && !isMarked(element.get())) {
+          pending_.push_back(element);
+        }
+      }
+
+      template <typename Range>
+      void addAll(const Range& elements) {
+        for (auto& element : elements) {
+          add(element);
+        }
+      }
+
+      std::unordered_set<const void*> marked_;
+      std::vector<ElementVariant> pending_;
+    };
+
+    template <typename Element>
+    void addUnmarked(Document& document, const Marker& marker,
+                     std::vector<ElementVariant>& unmarked) {
+      for (auto& element : document.getElements<Element>()) {
+        if (!marker.isMarked(element.get())) {
+          unmarked.push_back(element);
+        }
+      }
+    }
+
+  }  // namespace
+
+  std::vector<ElementVariant> collectGarbage(
+      std::shared_ptr<Document> document,
+      const std::vector<ElementVariant>& roots) {
+    Marker marker;
+    for (auto& root : roots) {
+      marker.mark(root);
+    }
+
+    std::vector<ElementVariant> removed;
+    addUnmarked<AudioProgramme>(*document, marker, removed);
+    addUnmarked<AudioContent>(*document, marker, removed);
+    addUnmarked<AudioObject>(*document, marker, removed);
+    addUnmarked<AudioPackFormat>(*document, marker, removed);
+    addUnmarked<AudioChannelFormat>(*document, marker, removed);
+    addUnmarked<AudioStreamFormat>(*document, marker, removed);
+    addUnmarked<AudioTrackFormat>(*document, marker, removed);
+    addUnmarked<AudioTrackUid>(*document, marker, removed);
+    document->remove(removed);
+    return removed;
+  }
+
+  std::vector<ElementVariant> collectGarbage(
+      std::shared_ptr<Document> document) {
+    auto programmes = document->getElements<AudioProgramme>();
+    return collectGarbage(
+        document, std::vector<ElementVariant>(programmes.begin(),
+                                              programmes.end()));
+  }
+
+}  // namespace adm
@@ -1,5 +1,6 @@
 #include "adm/write.hpp"
 #include <fstream>
+#include "adm/private/xml_frame_writer.hpp"
 #include "adm/private/xml_writer.hpp"
 
 namespace adm {
@@ -18,4 +19,78 @@ namespace adm {
     return writer.write(admDocument, stream);
   }
 
+  std::ostream& writeXml(std::ostream& stream,
+                         std::shared_ptr<const Document> admDocument,
+                         xml::WriterCache& cache, xml::WriterOptions options) {
+    xml::XmlWriter writer(options);
+    return writer.write(admDocument, stream, cache);
+  }
+
+  void writeXml(std::vector<char>& buffer,
+                std::shared_ptr<const Document> admDocument,
+                xml::WriterOptions options) {
+    xml::XmlWriter writer(options);
+    writer.write(admDocument, buffer);
+  }
+
+  std::string writeXmlToString(std::shared_ptr<const Document> admDocument,
+                               xml::WriterOptions options) {
+    std::string xml;
+    xml::XmlWriter writer(options);
+    writer.write(admDocument, xml);
+    return xml;
+  }
+
+  std::size_t getXmlSize(std::shared_ptr<const Document> admDocument,
+                         xml::WriterOptions options) {
+    xml::XmlWriter writer(options);
+    return writer.measure(admDocument);
+  }
+
+  namespace xml {
+
+    Writer::Writer(WriterOptions options) : writer_(new XmlWriter(options)) {}
+
+    Writer::~Writer() = default;
+
+    std::ostream& Writer::write(std::ostream& stream,
+                                std::shared_ptr<const Document> admDocument) {
+      return writer_->write(admDocument, stream);
+    }
+
+    void Writer::write(std::vector<char>& buffer,
+                       std::shared_ptr<const Document> admDocument) {
+      writer_->write(admDocument, buffer);
+    }
+
+    FrameWriter::FrameWriter(std::shared_ptr<const Document> document,
+                             std::chrono::nanoseconds framePeriod,
+                             WriterOptions options)
+        : writer_(new XmlFrameWriter(document, framePeriod, options)) {}
+
+    FrameWriter::~FrameWriter() = default;
+
+    std::ostream& FrameWriter::writeFrame(std::ostream& stream) {
+      writer_->writeFrame([&stream](const char* data, std::size_t size) {
+        stream.write(data, static_cast<std::streamsize>(size));
+      });
+      return stream;
+    }
+
+    void FrameWriter::writeFrame(std::vector<char>& buffer) {
+      writer_->writeFrame([&buffer](const char* data, std::size_t size) {
+        buffer.insert(buffer.end(), data, data + size);
+      });
+    }
+
+    std::uint64_t FrameWriter::frameIndex() const {
+      return writer_->frameIndex();
+    }
+
+    std::chrono::nanoseconds FrameWriter::frameStart() const {
+      return writer_->frameStart();
+    }
+
+  }  // namespace xml
+
 }  // namespace adm
@@ -322,6 +322,98 @@ TEST_CASE("copy_document_all_adm_elements") {
           copy->getElements<AudioChannelFormat>()[0]);
 }
 
+TEST_CASE("copy_document_to") {
+  using namespace adm;
+  auto admDocument = Document::create();
+  auto content = AudioContent::create(AudioContentName("MyContent"));
+  content->addReference(createSimpleObject("MyObject").audioObject);
+  admDocument->add(content);
+
+  auto dest = Document::create();
+  deepCopyTo(admDocument, dest);
+  deepCopyTo(admDocument, dest);
+
+  // the IDs of the second copy are changed, as by adding each element
+  REQUIRE(dest->getElements<AudioObject>().size() == 2);
+  REQUIRE(dest->lookup(parseAudioObjectId("AO_1002")) != nullptr);
+  REQUIRE(dest->lookup(parseAudioChannelFormatId("AC_00031002")) != nullptr);
+  REQUIRE(dest->lookup(parseAudioTrackFormatId("AT_00031001_02")) !=
+          nullptr);
+  auto trackUid = dest->lookup(parseAudioTrackUidId("ATU_00000002"));
+  REQUIRE(trackUid != nullptr);
+  REQUIRE(trackUid->getReference<AudioPackFormat>() ==
+          dest->lookup(parseAudioPackFormatId("AP_00031002")));
+}
+
+TEST_CASE("add_elements_batch") {
+  using namespace adm;
+  auto createHolders = []() {
+    std::vector<SimpleObjectHolder> holders;
+    for (int i = 0; i < 3; ++i) {
+      auto holder = createSimpleObject("MyObject");
+      // IDs which are already used
+      holder.audioObject->set(parseAudioObjectId("AO_1001"));
+      holder.audioChannelFormat->set(parseAudioChannelFormatId("AC_00031001"));
+      holders.push_back(holder);
+    }
+    return holders;
+  };
+
+  auto sequential = Document::create();
+  for (auto& holder : createHolders()) {
+    sequential->add(holder.audioTrackUid);
+    sequential->add(holder.audioObject);
+  }
+
+  auto batch = Document::create();
+  std::vector<ElementVariant> elements;
+  for (auto& holder : createHolders()) {
+    elements.push_back(holder.audioTrackUid);
+    elements.push_back(holder.audioObject);
+  }
+  // elements which are already in the document are skipped
+  elements.push_back(boost::get<std::shared_ptr<AudioObject>>(elements[1]));
+  batch->add(elements);
+
+  REQUIRE(batch->getElements<AudioObject>().size() == 3);
+  REQUIRE(batch->getElements<AudioTrackFormat>().size() == 3);
+  for (std::size_t i = 0; i < 3; ++i) {
+    REQUIRE(batch->getElements<AudioObject>()[i]->get<AudioObjectId>() ==
+            sequential->getElements<AudioObject>()[i]->get<AudioObjectId>());
+    REQUIRE(batch->getElements<AudioChannelFormat>()[i]
+                ->get<AudioChannelFormatId>() ==
+            sequential->getElements<AudioChannelFormat>()[i]
+                ->get<AudioChannelFormatId>());
+    REQUIRE(
+        batch->getElements<AudioTrackFormat>()[i]->get<AudioTrackFormatId>() ==
+        sequential->getElements<AudioTrackFormat>()[i]
+            ->get<AudioTrackFormatId>());
+    REQUIRE(batch->getElements<AudioTrackUid>()[i]->get<AudioTrackUidId>() ==
+            sequential->getElements<AudioTrackUid>()[i]->get<AudioTrackUidId>());
+  }
+
+  // single elements can be added again afterwards
+  REQUIRE(batch->add(AudioObject::create(AudioObjectName("Other"))));
+  REQUIRE(batch->lookup(parseAudioObjectId("AO_1004")) != nullptr);
+}
+
+TEST_CASE("copy_document_benchmark") {
+  using namespace adm;
+  auto admDocument = Document::create();
+  auto content = AudioContent::create(AudioContentName("MyContent"));
+  for (int i = 0; i < 1000; ++i) {
+    auto holder = createSimpleObject("MyObject");
+    holder.audioChannelFormat->add(AudioBlockFormatObjects(
+        SphericalPosition(), AudioBlockFormatId(TypeDefinition::OBJECTS,
+                                                AudioBlockFormatIdValue(0),
+                                                AudioBlockFormatIdCounter(1))));
+    content->addReference(holder.audioObject);
+  }
+  admDocument->add(content);
+
+  BENCHMARK("deepCopy") { return admDocument->deepCopy(); };
+}
+
 template <typename T>
 std::vector<T> asVector(std::initializer_list<T> l) {
   return std::vector<T>{l};
@@ -597,3 +689,34 @@ TEST_CASE("remove_elements") {
     REQUIRE(trackUid->getReference<AudioTrackFormat>() == nullptr);
   }
 }
+
+TEST_CASE("remove_elements_batch") {
+  using namespace adm;
+  auto admDocument = Document::create();
+  auto content = AudioContent::create(AudioContentName("My Content"));
+  auto first = createSimpleObject("First");
+  auto second = createSimpleObject("Second");
+  content->addReference(first.audioObject);
+  content->addReference(second.audioObject);
+  second.audioStreamFormat->addReference(second.audioTrackFormat);
+  admDocument->add(content);
+
+  std::vector<ElementVariant> elements{
+      second.audioObject, first.audioChannelFormat, second.audioTrackFormat,
+      // not in the document
+      AudioObject::create(AudioObjectName("Other"))};
+  REQUIRE(admDocument->remove(elements) == 3);
+  REQUIRE(admDocument->getElements<AudioObject>().size() == 1);
+  REQUIRE(admDocument->getElements<AudioChannelFormat>().size() == 1);
+  REQUIRE(admDocument->getElements<AudioTrackFormat>().size() == 1);
+  REQUIRE(admDocument->getElements<AudioPackFormat>().size() == 2);
+
+  REQUIRE(content->getReferences<AudioObject>().size() == 1);
+  REQUIRE(first.audioPackFormat->getReferences<AudioChannelFormat>().empty());
+  REQUIRE(first.audioStreamFormat->getReference<AudioChannelFormat>() ==
+          nullptr);
+  REQUIRE(second.audioStreamFormat->getAudioTrackFormatReferences().empty());
+  REQUIRE(second.audioTrackUid->getReference<AudioTrackFormat>() == nullptr);
+
+  REQUIRE(admDocument->remove(elements) == 0);
+}
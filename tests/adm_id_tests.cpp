@@ -8,6 +8,10 @@
 #include "adm/elements/audio_stream_format_id.hpp"
 #include "adm/elements/audio_track_format_id.hpp"
 #include "adm/elements/audio_track_uid_id.hpp"
+#include "adm/detail/number_formatting.hpp"
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 TEST_CASE("audio_programme_id") {
   using namespace adm;
@@ -319,3 +323,72 @@ TEST_CASE("audio_block_format_id") {
 
   REQUIRE_THROWS(parseAudioBlockFormatId("AT_0001001"));
 }
+
+TEST_CASE("id_keys") {
+  using namespace adm;
+  REQUIRE(parseAudioObjectId("AO_1001").key() == 0x1001u);
+  REQUIRE(parseAudioTrackUidId("ATU_00012345").key() == 0x12345u);
+  REQUIRE(parseAudioPackFormatId("AP_00031001").key() == 0x0003100100000000u);
+  REQUIRE(parseAudioTrackFormatId("AT_00031001_0a").key() ==
+          0x000310010000000au);
+  REQUIRE(parseAudioBlockFormatId("AB_00031001_0000000b").key() ==
+          0x000310010000000bu);
+
+  // keys have to be ordered like the formatted ids
+  std::vector<std::string> ids{"AB_00011001_00000001", "AB_00010002_00000001",
+                               "AB_00031001_00000001", "AB_00011001_0000000a",
+                               "AB_00011001_00000010", "AB_00010fff_ffffffff",
+                               "AB_00020001_00000000", "AB_00011000_00000002"};
+  for (const auto& lhs : ids) {
+    for (const auto& rhs : ids) {
+      REQUIRE((parseAudioBlockFormatId(lhs) < parseAudioBlockFormatId(rhs)) ==
+              (lhs < rhs));
+    }
+  }
+
+  std::unordered_set<AudioChannelFormatId> channelFormatIds;
+  channelFormatIds.insert(parseAudioChannelFormatId("AC_00031001"));
+  channelFormatIds.insert(parseAudioChannelFormatId("AC_00031002"));
+  channelFormatIds.insert(parseAudioChannelFormatId("AC_00031001"));
+  channelFormatIds.insert(parseAudioChannelFormatId("AC_00011001"));
+  REQUIRE(channelFormatIds.size() == 3);
+  REQUIRE(channelFormatIds.count(parseAudioChannelFormatId("AC_00031002")) ==
+          1);
+}
+
+TEST_CASE("id_comparison_out_of_range") {
+  using namespace adm;
+  // the value overlaps the type bits of the key
+  AudioBlockFormatId large(TypeDefinition::OBJECTS,
+                           AudioBlockFormatIdValue(0x10000),
+                           AudioBlockFormatIdCounter(1));
+  AudioBlockFormatId otherType(TypeDescriptor(4), AudioBlockFormatIdValue(0),
+                               AudioBlockFormatIdCounter(1));
+  REQUIRE(large != otherType);
+  REQUIRE(large < otherType);
+  REQUIRE_FALSE(otherType < large);
+
+  AudioChannelFormatId largeChannel(TypeDefinition::OBJECTS,
+                                    AudioChannelFormatIdValue(0x10000));
+  AudioChannelFormatId otherChannel(TypeDescriptor(4),
+                                    AudioChannelFormatIdValue(0));
+  REQUIRE(largeChannel < otherChannel);
+  REQUIRE_FALSE(otherChannel < largeChannel);
+
+  std::unordered_set<AudioBlockFormatId> ids{large, otherType};
+  REQUIRE(ids.size() == 2);
+}
+
+TEST_CASE("format_id_buffer") {
+  using namespace adm;
+  char buffer[detail::FORMAT_BUFFER_SIZE];
+  REQUIRE(formatId(buffer, parseAudioProgrammeId("APR_1001")) == 8);
+  REQUIRE(std::string(buffer) == "APR_1001");
+  REQUIRE(formatId(buffer, parseAudioBlockFormatId("AB_00031001_0000000a")) ==
+          20);
+  REQUIRE(std::string(buffer) == "AB_00031001_0000000a");
+  REQUIRE(formatId(buffer, parseAudioTrackFormatId("AT_00011001_0f")) == 14);
+  REQUIRE(std::string(buffer) == "AT_00011001_0f");
+  REQUIRE(formatId(buffer, parseAudioTrackUidId("ATU_0000ffff")) == 12);
+  REQUIRE(std::string(buffer) == "ATU_0000ffff");
+}
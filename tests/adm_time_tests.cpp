@@ -1,6 +1,7 @@
 #define CATCH_CONFIG_ENABLE_CHRONO_STRINGMAKER
 #include <catch2/catch.hpp>
 #include "adm/elements/time.hpp"
+#include "adm/detail/number_formatting.hpp"
 
 TEST_CASE("adm_time") {
   using namespace adm;
@@ -34,3 +35,15 @@ TEST_CASE("adm_time") {
             "23:59:59.999999999");
   }
 }
+
+TEST_CASE("adm_time_format_buffer") {
+  using namespace adm;
+  char buffer[detail::FORMAT_BUFFER_SIZE];
+  auto size = formatTimecode(buffer, parseTimecode("04:20:14.046079001"));
+  REQUIRE(std::string(buffer, size) == "04:20:14.046079001");
+  REQUIRE(buffer[size] == '\0');
+  // more than two digits for hours
+  REQUIRE(formatTimecode(std::chrono::hours(123) + std::chrono::seconds(1)) ==
+          "123:00:01.000000000");
+  REQUIRE(formatTimecode(-std::chrono::seconds(1)) == "-00:00:01.000000000");
+}
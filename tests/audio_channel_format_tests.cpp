@@ -2,6 +2,7 @@
 #include <catch2/catch.hpp>
 #include "adm/elements/audio_channel_format.hpp"
 #include "adm/utilities/comparator.hpp"
+#include "helper/block_formats.hpp"
 
 TEST_CASE("audio_channel_format") {
   using namespace adm;
@@ -91,3 +92,133 @@ TEST_CASE("audio_channel_format") {
   }
   */
 }
+
+TEST_CASE("audio_channel_format_revision") {
+  using namespace adm;
+  auto audioChannelFormat = AudioChannelFormat::create(
+      AudioChannelFormatName("MyChannelFormat"), TypeDefinition::OBJECTS);
+  auto revision = audioChannelFormat->getRevision();
+  std::shared_ptr<const AudioChannelFormat> constChannelFormat =
+      audioChannelFormat;
+  constChannelFormat->getElements<AudioBlockFormatObjects>();
+  REQUIRE(audioChannelFormat->getRevision() == revision);
+
+  audioChannelFormat->add(
+      AudioBlockFormatObjects(SphericalPosition(Azimuth(30))));
+  REQUIRE(audioChannelFormat->getRevision() != revision);
+  revision = audioChannelFormat->getRevision();
+
+  // the blocks could be modified through the mutable range
+  audioChannelFormat->getElements<AudioBlockFormatObjects>();
+  REQUIRE(audioChannelFormat->getRevision() != revision);
+  revision = audioChannelFormat->getRevision();
+
+  audioChannelFormat->clearAudioBlockFormats();
+  REQUIRE(audioChannelFormat->getRevision() != revision);
+}
+
+namespace {
+  std::shared_ptr<adm::AudioChannelFormat> createChannelFormat(
+      unsigned int count) {
+    using namespace adm;
+    auto channelFormat = AudioChannelFormat::create(
+        AudioChannelFormatName("MyChannelFormat"), TypeDefinition::OBJECTS);
+    addBlockFormats(*channelFormat, count, std::chrono::milliseconds(10), 0);
+    return channelFormat;
+  }
+
+  float firstAzimuth(const std::shared_ptr<const adm::AudioChannelFormat>&
+                         channelFormat) {
+    using namespace adm;
+    return channelFormat->getElements<AudioBlockFormatObjects>()[0]
+        .get<SphericalPosition>()
+        .get<Azimuth>()
+        .get();
+  }
+}  // namespace
+
+TEST_CASE("audio_channel_format_copy_on_write") {
+  using namespace adm;
+  auto original = createChannelFormat(3);
+  std::shared_ptr<const AudioChannelFormat> constOriginal = original;
+  auto copy = constOriginal->copy();
+  auto originalBlocks = constOriginal->getElements<AudioBlockFormatObjects>();
+  CHECK(&copy->getElements<AudioBlockFormatObjects>()[0] !=
+        &originalBlocks[0]);
+
+  SECTION("modify copy") {
+    copy->getElements<AudioBlockFormatObjects>()[0].set(
+        SphericalPosition(Azimuth(90.f)));
+    copy->add(AudioBlockFormatObjects(SphericalPosition()));
+    CHECK(firstAzimuth(copy) == 90.f);
+    CHECK(firstAzimuth(original) == -180.f);
+    CHECK(copy->getElements<AudioBlockFormatObjects>().size() == 4);
+    CHECK(constOriginal->getElements<AudioBlockFormatObjects>().size() == 3);
+    // ranges of the original stay valid
+    CHECK(originalBlocks.size() == 3);
+  }
+  SECTION("modify original") {
+    original->getElements<AudioBlockFormatObjects>()[0].set(
+        SphericalPosition(Azimuth(90.f)));
+    original->clearAudioBlockFormats();
+    CHECK(firstAzimuth(copy) == -180.f);
+    CHECK(copy->getElements<AudioBlockFormatObjects>().size() == 3);
+  }
+  SECTION("copy of copy") {
+    auto secondCopy = copy->copy();
+    original->set(AudioChannelFormatId(TypeDefinition::OBJECTS,
+                                       AudioChannelFormatIdValue(2)));
+    CHECK(constOriginal->getElements<AudioBlockFormatObjects>()[0]
+              .get<AudioBlockFormatId>()
+              .get<AudioBlockFormatIdValue>() == 2u);
+    CHECK(std::shared_ptr<const AudioChannelFormat>(secondCopy)
+              ->getElements<AudioBlockFormatObjects>()[0]
+              .get<AudioBlockFormatId>()
+              .get<AudioBlockFormatIdValue>() == 0u);
+  }
+}
+
+TEST_CASE("audio_channel_format_copy_mutable_range") {
+  using namespace adm;
+  auto original = createChannelFormat(3);
+  // this range may still be used to modify the original after copying
+  auto blockFormats = original->getElements<AudioBlockFormatObjects>();
+  auto copy = original->copy();
+  blockFormats[0].set(SphericalPosition(Azimuth(90.f)));
+  CHECK(firstAzimuth(original) == 90.f);
+  CHECK(firstAzimuth(copy) == -180.f);
+}
+
+TEST_CASE("audio_channel_format_copy_mutable_reference") {
+  using namespace adm;
+  auto original = createChannelFormat(3);
+  // the reference outlives the range it was taken from
+  auto& blockFormat = *original->getElements<AudioBlockFormatObjects>().begin();
+  auto copy = original->copy();
+  blockFormat.set(Gain(0.25f));
+  CHECK(std::shared_ptr<const AudioChannelFormat>(copy)
+            ->getElements<AudioBlockFormatObjects>()[0]
+            .get<Gain>()
+            .get() == 1.f);
+  CHECK(std::shared_ptr<const AudioChannelFormat>(original)
+            ->getElements<AudioBlockFormatObjects>()[0]
+            .get<Gain>()
+            .get() == 0.25f);
+}
+
+TEST_CASE("audio_channel_format_copy_benchmark") {
+  using namespace adm;
+  std::shared_ptr<const AudioChannelFormat> channelFormat =
+      createChannelFormat(10000);
+
+  BENCHMARK("copy") { return channelFormat->copy(); };
+
+  BENCHMARK("copy and modify") {
+    auto copy = channelFormat->copy();
+    copy->add(AudioBlockFormatObjects(
+        SphericalPosition(),
+        AudioBlockFormatId(TypeDefinition::OBJECTS, AudioBlockFormatIdValue(0),
+                           AudioBlockFormatIdCounter(10001))));
+    return copy;
+  };
+}
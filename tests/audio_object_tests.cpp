@@ -146,3 +146,29 @@ TEST_CASE("audio_object_complementary") {
   audioObject->clearComplementaryObjects();
   REQUIRE(audioObject->getComplementaryObjects().size() == 0);
 }
+
+TEST_CASE("audio_object_revision") {
+  using namespace adm;
+
+  auto audioObject = AudioObject::create(AudioObjectName("MyAudioObject"));
+  auto revision = audioObject->getRevision();
+  audioObject->get<AudioObjectName>();
+  REQUIRE(audioObject->getRevision() == revision);
+
+  audioObject->set(Importance(5));
+  REQUIRE(audioObject->getRevision() != revision);
+  revision = audioObject->getRevision();
+
+  audioObject->unset<Importance>();
+  REQUIRE(audioObject->getRevision() != revision);
+  revision = audioObject->getRevision();
+
+  auto packFormat = AudioPackFormat::create(AudioPackFormatName("MyPack"),
+                                            TypeDefinition::OBJECTS);
+  audioObject->addReference(packFormat);
+  REQUIRE(audioObject->getRevision() != revision);
+  revision = audioObject->getRevision();
+
+  audioObject->clearReferences<AudioPackFormat>();
+  REQUIRE(audioObject->getRevision() != revision);
+}
@@ -0,0 +1,232 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include "adm/binary.hpp"
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/parse.hpp"
+#include "adm/utilities/id_assignment.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "adm/write.hpp"
+#include "helper/block_formats.hpp"
+
+namespace {
+  std::shared_ptr<adm::Document> roundTrip(
+      std::shared_ptr<const adm::Document> document) {
+    std::vector<char> buffer;
+    adm::saveBinary(buffer, document);
+    return adm::loadBinary(buffer.data(), buffer.size());
+  }
+
+  /// document using as many parameters as possible
+  std::shared_ptr<adm::Document> createDetailedDocument() {
+    using namespace adm;
+    auto document = Document::create();
+    auto programme = AudioProgramme::create(
+        AudioProgrammeName("Programme"), AudioProgrammeLanguage("en"),
+        Start(std::chrono::seconds(1)), End(std::chrono::seconds(10)),
+        MaxDuckingDepth(-20.f));
+    LoudnessMetadata loudness;
+    loudness.set(LoudnessMethod("ITU-R BS.1770"));
+    loudness.set(IntegratedLoudness(-23.5f));
+    loudness.set(MaxTruePeak(-1.f));
+    programme->set(loudness);
+    auto content = AudioContent::create(AudioContentName("Content"),
+                                        DialogueContent::COMMENTARY);
+    content->set(loudness);
+    programme->addReference(content);
+
+    auto object = createSimpleObject("Object");
+    object.audioObject->set(Importance(7));
+    object.audioObject->set(Interact(true));
+    object.audioObject->set(AudioObjectInteraction(
+        OnOffInteract(true), GainInteract(true),
+        GainInteractionRange(GainInteractionMin(0.5f),
+                             GainInteractionMax(1.5f)),
+        PositionInteractionRange(AzimuthInteractionMin(-30.f),
+                                 XInteractionMax(0.5f))));
+    object.audioChannelFormat->set(Frequency(LowPass(120.f)));
+    object.audioChannelFormat->add(AudioBlockFormatObjects(
+        CartesianPosition(X(0.5f), Y(-0.25f), Z(1.f)),
+        Rtime(std::chrono::milliseconds(10)),
+        Duration(std::chrono::milliseconds(20)), Width(10.f), Gain(0.5),
+        ScreenEdgeLock(HorizontalEdge("left")),
+        ChannelLock(ChannelLockFlag(true), MaxDistance(0.5f)),
+        ObjectDivergence(Divergence(0.5f), PositionRange(0.25f)),
+        JumpPosition(JumpPositionFlag(true),
+                     InterpolationLength(std::chrono::milliseconds(5))),
+        ScreenRef(true), Importance(3)));
+    content->addReference(object.audioObject);
+
+    auto speakers = AudioObject::create(AudioObjectName("Speakers"));
+    auto packFormat = AudioPackFormat::create(
+        AudioPackFormatName("Speakers"), TypeDefinition::DIRECT_SPEAKERS);
+    auto channelFormat = AudioChannelFormat::create(
+        AudioChannelFormatName("Left"), TypeDefinition::DIRECT_SPEAKERS);
+    AudioBlockFormatDirectSpeakers speakerBlock(
+        SpeakerPosition(Azimuth(30.f), AzimuthMin(25.f), Elevation(0.f)));
+    speakerBlock.add(SpeakerLabel("M+030"));
+    speakerBlock.add(SpeakerLabel("L"));
+    channelFormat->add(speakerBlock);
+    packFormat->addReference(channelFormat);
+    speakers->addReference(packFormat);
+    speakers->addComplementary(object.audioObject);
+    content->addReference(speakers);
+
+    document->add(programme);
+    document->add(speakers);
+    document->add(
+        AudioTrackUid::create(SampleRate(48000), BitDepth(24)));
+    reassignIds(document);
+    return document;
+  }
+}  // namespace
+
+TEST_CASE("binary_round_trip") {
+  using namespace adm;
+  auto options = xml::WriterOptions::write_default_values;
+  for (auto filename : {"xml_parser/audio_block_format_direct_speakers.xml",
+                        "xml_parser/audio_block_format_objects.xml",
+                        "xml_parser/audio_channel_format.xml",
+                        "xml_parser/audio_content.xml",
+                        "xml_parser/audio_object.xml",
+                        "xml_parser/audio_object_interaction.xml",
+                        "xml_parser/audio_pack_format.xml",
+                        "xml_parser/audio_programme.xml",
+                        "xml_parser/audio_stream_format.xml",
+                        "xml_parser/audio_track_format.xml",
+                        "xml_parser/audio_track_uid.xml",
+                        "xml_parser/with_common_definitions.xml"}) {
+    auto document = parseXml(filename);
+    auto loaded = roundTrip(document);
+    CHECK(writeXmlToString(loaded, options) ==
+          writeXmlToString(document, options));
+    CHECK(writeXmlToString(loaded) == writeXmlToString(document));
+  }
+
+  auto document = createDetailedDocument();
+  auto loaded = roundTrip(document);
+  CHECK(writeXmlToString(loaded, options) ==
+        writeXmlToString(document, options));
+
+  auto object = loaded->lookup(parseAudioObjectId("AO_1002"));
+  REQUIRE(object);
+  REQUIRE(object->getComplementaryObjects().size() == 1);
+  CHECK(object->getComplementaryObjects()[0] ==
+        loaded->lookup(parseAudioObjectId("AO_1001")));
+}
+
+TEST_CASE("binary_streams") {
+  using namespace adm;
+  auto document = parseXml("xml_parser/audio_stream_format.xml");
+  std::stringstream stream;
+  saveBinary(stream, document);
+  auto loaded = loadBinary(stream);
+  CHECK(writeXmlToString(loaded) == writeXmlToString(document));
+}
+
+TEST_CASE("binary_errors") {
+  using namespace adm;
+  std::vector<char> buffer;
+  saveBinary(buffer, createDetailedDocument());
+
+  // every truncation must be detected
+  for (std::size_t size = 0; size < buffer.size(); ++size) {
+    REQUIRE_THROWS_AS(loadBinary(buffer.data(), size), std::runtime_error);
+  }
+
+  auto wrongMagic = buffer;
+  wrongMagic[0] = 'X';
+  REQUIRE_THROWS_AS(loadBinary(wrongMagic.data(), wrongMagic.size()),
+                    std::runtime_error);
+
+  auto wrongVersion = buffer;
+  wrongVersion[4] = static_cast<char>(BINARY_FORMAT_VERSION + 1);
+  REQUIRE_THROWS_AS(loadBinary(wrongVersion.data(), wrongVersion.size()),
+                    std::runtime_error);
+
+  auto trailingData = buffer;
+  trailingData.push_back('\0');
+  REQUIRE_THROWS_AS(loadBinary(trailingData.data(), trailingData.size()),
+                    std::runtime_error);
+}
+
+TEST_CASE("binary_duplicate_block_format_ids") {
+  using namespace adm;
+  auto document = Document::create();
+  auto object = createSimpleObject("Object");
+  for (unsigned int i = 0; i < 3; ++i) {
+    object.audioChannelFormat->add(
+        AudioBlockFormatObjects(SphericalPosition(Azimuth(i * 10.f))));
+  }
+  document->add(object.audioObject);
+  // duplicates can only be made through the mutable range; loading handles
+  // them like AudioChannelFormat::add() does
+  auto blockFormats =
+      object.audioChannelFormat->getElements<AudioBlockFormatObjects>();
+  blockFormats[2].set(blockFormats[0].get<AudioBlockFormatId>());
+
+  auto loaded = roundTrip(document);
+  auto channelFormat =
+      loaded->lookup(object.audioChannelFormat->get<AudioChannelFormatId>());
+  REQUIRE(channelFormat);
+  std::shared_ptr<const AudioChannelFormat> constChannelFormat =
+      channelFormat;
+  auto loadedBlockFormats =
+      constChannelFormat->getElements<AudioBlockFormatObjects>();
+  REQUIRE(loadedBlockFormats.size() == 3);
+  CHECK(formatId(loadedBlockFormats[0].get<AudioBlockFormatId>()) ==
+        "AB_00031001_00000001");
+  CHECK(formatId(loadedBlockFormats[1].get<AudioBlockFormatId>()) ==
+        "AB_00031001_00000002");
+  CHECK(formatId(loadedBlockFormats[2].get<AudioBlockFormatId>()) ==
+        "AB_00031001_00000003");
+  CHECK(loadedBlockFormats[2].get<SphericalPosition>().get<Azimuth>() ==
+        20.f);
+}
+
+TEST_CASE("binary_benchmark") {
+  using namespace adm;
+  auto document = Document::create();
+  for (unsigned int o = 0; o < 10; ++o) {
+    auto result = createSimpleObject("Object " + std::to_string(o));
+    addBlockFormats(*result.audioChannelFormat, 100);
+    document->add(result.audioObject);
+  }
+  auto xml = writeXmlToString(document);
+  std::istringstream xmlStream(xml);
+  auto parsed = parseXml(xmlStream);
+  std::vector<char> buffer;
+  saveBinary(buffer, parsed);
+  CHECK(writeXmlToString(loadBinary(buffer.data(), buffer.size())) ==
+        writeXmlToString(parsed));
+
+  BENCHMARK("parseXml 1000 audioBlockFormats") {
+    std::istringstream stream(xml);
+    return parseXml(stream);
+  };
+
+  BENCHMARK("loadBinary 1000 audioBlockFormats") {
+    return loadBinary(buffer.data(), buffer.size());
+  };
+
+  BENCHMARK("saveBinary 1000 audioBlockFormats") {
+    std::vector<char> out;
+    saveBinary(out, document);
+    return out.size();
+  };
+}
+
+TEST_CASE("binary_benchmark_scaling") {
+  using namespace adm;
+  // loading must be linear in the number of audioBlockFormats of an
+  // audioChannelFormat
+  for (unsigned int count : {5000u, 10000u, 20000u}) {
+    auto document = createObjectDocument(count);
+    std::vector<char> buffer;
+    saveBinary(buffer, document);
+
+    BENCHMARK("loadBinary " + std::to_string(count) + " audioBlockFormats") {
+      return loadBinary(buffer.data(), buffer.size());
+    };
+  }
+}
@@ -0,0 +1,330 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "adm/bw64.hpp"
+#include "adm/common_definitions.hpp"
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/parse.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "adm/write.hpp"
+
+namespace {
+  void appendUint(std::string& data, std::uint64_t value, int size) {
+    for (int i = 0; i < size; ++i) {
+      data.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+  }
+
+  std::string chunk(const std::string& id, const std::string& contents,
+                    std::uint32_t size) {
+    std::string data = id;
+    appendUint(data, size, 4);
+    data += contents;
+    if (contents.size() % 2) {
+      data.push_back('\0');
+    }
+    return data;
+  }
+
+  std::string chunk(const std::string& id, const std::string& contents) {
+    return chunk(id, contents, static_cast<std::uint32_t>(contents.size()));
+  }
+
+  /// Field of @a size characters, padded with NULs
+  std::string field(const std::string& value, std::size_t size) {
+    return value + std::string(size - value.size(), '\0');
+  }
+
+  struct Track {
+    std::uint16_t trackIndex;
+    std::string uid;
+    std::string trackRef;
+    std::string packRef;
+  };
+
+  std::string chnaContents(const std::vector<Track>& tracks,
+                           std::uint16_t trackCount) {
+    std::string data;
+    appendUint(data, trackCount, 2);
+    appendUint(data, tracks.size(), 2);
+    for (auto& track : tracks) {
+      appendUint(data, track.trackIndex, 2);
+      data += field(track.uid, 12);
+      data += field(track.trackRef, 14);
+      data += field(track.packRef, 11);
+      data.push_back('\0');
+    }
+    return data;
+  }
+
+  std::string fmtContents() {
+    std::string data;
+    appendUint(data, 1, 2);  // PCM
+    appendUint(data, 2, 2);  // channels
+    appendUint(data, 48000, 4);
+    appendUint(data, 48000 * 4, 4);
+    appendUint(data, 4, 2);
+    appendUint(data, 16, 2);
+    return data;
+  }
+
+  std::string createAxml() {
+    auto document = adm::Document::create();
+    auto result = adm::createSimpleObject("Object");
+    result.audioChannelFormat->add(
+        adm::AudioBlockFormatObjects(adm::SphericalPosition()));
+    document->add(result.audioObject);
+    return adm::writeXmlToString(document);
+  }
+
+  std::string createChna() {
+    return chnaContents({{1, "ATU_00000001", "AT_00031001_01", "AP_00031001"},
+                         {2, "ATU_00000002", "AC_00010002", "AP_00010002"},
+                         {0, "", "", ""}},
+                        2);
+  }
+
+  void writeFile(const std::string& filename, const std::string& data) {
+    std::ofstream file(filename, std::ios::binary);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+  }
+
+  std::string riffFile(const std::string& contents) {
+    std::string data = "RIFF";
+    appendUint(data, contents.size() + 4, 4);
+    return data + "WAVE" + contents;
+  }
+
+  void checkChna(const std::vector<adm::ChnaEntry>& entries) {
+    using namespace adm;
+    REQUIRE(entries.size() == 2);
+    CHECK(entries[0].trackIndex == 1);
+    CHECK(entries[0].audioTrackUidId == parseAudioTrackUidId("ATU_00000001"));
+    CHECK(entries[0].audioTrackFormatId.get() ==
+          parseAudioTrackFormatId("AT_00031001_01"));
+    CHECK_FALSE(entries[0].audioChannelFormatId.is_initialized());
+    CHECK(entries[0].audioPackFormatId.get() ==
+          parseAudioPackFormatId("AP_00031001"));
+    CHECK(entries[1].trackIndex == 2);
+    CHECK_FALSE(entries[1].audioTrackFormatId.is_initialized());
+    CHECK(entries[1].audioChannelFormatId.get() ==
+          parseAudioChannelFormatId("AC_00010002"));
+  }
+
+  void checkAxml(const std::shared_ptr<adm::Document>& document,
+                 const std::string& axml) {
+    std::istringstream stream(axml);
+    CHECK(adm::writeXmlToString(document) ==
+          adm::writeXmlToString(adm::parseXml(stream)));
+    CHECK(document->lookup(adm::parseAudioObjectId("AO_1001")) != nullptr);
+  }
+}  // namespace
+
+TEST_CASE("bw64_riff_file") {
+  using namespace adm;
+  auto axml = createAxml();
+  // odd sized data chunk, axml as last chunk of the file
+  writeFile("bw64_riff.wav",
+            riffFile(chunk("fmt ", fmtContents()) + chunk("data", "abc") +
+                     chunk("chna", createChna()) + chunk("axml", axml)));
+
+  Bw64MetadataReader reader("bw64_riff.wav");
+  auto& chunks = reader.getChunks();
+  REQUIRE(chunks.size() == 4);
+  CHECK(chunks[1].id == "data");
+  CHECK(chunks[1].size == 3);
+  CHECK(chunks[2].offset == 12 + 8 + 16 + 8 + 4 + 8);
+  CHECK(reader.hasChunk("axml"));
+  CHECK_FALSE(reader.hasChunk("bxml"));
+  auto data = reader.readChunk("data");
+  CHECK(std::string(data.begin(), data.end()) == "abc");
+
+  checkChna(reader.readChna());
+  checkAxml(reader.parseAxml(), axml);
+  // the file is not modified by parsing in place
+  auto chunkData = reader.readChunk("axml");
+  CHECK(std::string(chunkData.begin(), chunkData.end()) == axml);
+}
+
+TEST_CASE("bw64_ds64_sizes") {
+  using namespace adm;
+  auto axml = createAxml();
+  // the sizes of the data and axml chunks are only stored in ds64
+  std::string ds64;
+  appendUint(ds64, 0, 8);  // riffSize
+  appendUint(ds64, 6, 8);  // dataSize
+  appendUint(ds64, 0, 8);  // sampleCount
+  appendUint(ds64, 1, 4);  // tableLength
+  ds64 += "axml";
+  appendUint(ds64, axml.size(), 8);
+  std::string contents = "WAVE" + chunk("ds64", ds64) +
+                         chunk("fmt ", fmtContents()) +
+                         chunk("data", "abcdef", 0xFFFFFFFF) +
+                         chunk("axml", axml, 0xFFFFFFFF) +
+                         chunk("chna", createChna());
+  std::string data = "BW64";
+  appendUint(data, 0xFFFFFFFF, 4);
+  writeFile("bw64_ds64.wav", data + contents);
+
+  Bw64MetadataReader reader("bw64_ds64.wav");
+  REQUIRE(reader.getChunks().size() == 5);
+  CHECK(reader.getChunks()[2].size == 6);
+  CHECK(reader.getChunks()[3].size == axml.size());
+  checkChna(reader.readChna());
+  checkAxml(reader.parseAxml(), axml);
+}
+
+TEST_CASE("bw64_large_data_chunk") {
+  using namespace adm;
+  // a sparse file with 5 GiB of audio data before the metadata
+  const std::uint64_t dataSize = 5ull << 30;
+  auto axml = createAxml();
+  std::string ds64;
+  appendUint(ds64, 0, 8);
+  appendUint(ds64, dataSize, 8);
+  appendUint(ds64, 0, 8);
+  appendUint(ds64, 0, 4);
+  std::string header = "RF64";
+  appendUint(header, 0xFFFFFFFF, 4);
+  header += "WAVE" + chunk("ds64", ds64) + chunk("fmt ", fmtContents()) +
+            "data";
+  appendUint(header, 0xFFFFFFFF, 4);
+  {
+    std::ofstream file("bw64_large.wav", std::ios::binary);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file.seekp(static_cast<std::streamoff>(header.size() + dataSize));
+    auto metadata = chunk("axml", axml) + chunk("chna", createChna());
+    file.write(metadata.data(), static_cast<std::streamsize>(metadata.size()));
+    REQUIRE(file.good());
+  }
+
+  Bw64MetadataReader reader("bw64_large.wav");
+  REQUIRE(reader.getChunks().size() == 5);
+  CHECK(reader.getChunks()[3].offset == header.size() + dataSize + 8);
+  checkChna(reader.readChna());
+  checkAxml(reader.parseAxml(), axml);
+  std::remove("bw64_large.wav");
+}
+
+TEST_CASE("bw64_errors") {
+  using namespace adm;
+  REQUIRE_THROWS_AS(Bw64MetadataReader("does_not_exist.wav"),
+                    std::runtime_error);
+
+  writeFile("bw64_not_wave.wav", std::string("RIFF\x04\0\0\0AVI ", 12));
+  REQUIRE_THROWS_AS(Bw64MetadataReader("bw64_not_wave.wav"),
+                    std::runtime_error);
+
+  std::string data = "BW64";
+  appendUint(data, 0xFFFFFFFF, 4);
+  writeFile("bw64_no_ds64.wav", data + "WAVE" + chunk("fmt ", fmtContents()));
+  REQUIRE_THROWS_AS(Bw64MetadataReader("bw64_no_ds64.wav"),
+                    std::runtime_error);
+
+  // an axml chunk which extends past the end of the file
+  auto truncated = riffFile(chunk("fmt ", fmtContents()) +
+                            chunk("axml", "<ebuCoreMain/>", 100));
+  writeFile("bw64_truncated.wav", truncated);
+  Bw64MetadataReader reader("bw64_truncated.wav");
+  REQUIRE_THROWS_AS(reader.parseAxml(), std::runtime_error);
+  REQUIRE_THROWS_AS(reader.readChna(), std::runtime_error);
+
+  // a ds64 chunk larger than the file is not allocated
+  writeFile("bw64_large_ds64.wav",
+            data + "WAVE" + chunk("ds64", std::string(28, '\0'), 0x7FFFFFF0));
+  REQUIRE_THROWS_AS(Bw64MetadataReader("bw64_large_ds64.wav"),
+                    std::runtime_error);
+
+  // 64 bit sizes which would overflow the position of the next chunk
+  std::string ds64;
+  appendUint(ds64, 0, 8);
+  appendUint(ds64, 0, 8);
+  appendUint(ds64, 0, 8);
+  appendUint(ds64, 1, 4);
+  ds64 += "axml";
+  appendUint(ds64, 0xFFFFFFFFFFFFFFFFull, 8);
+  writeFile("bw64_overflow.wav",
+            data + "WAVE" + chunk("ds64", ds64) +
+                chunk("axml", "<ebuCoreMain/>", 0xFFFFFFFF) +
+                chunk("chna", createChna()));
+  Bw64MetadataReader overflow("bw64_overflow.wav");
+  REQUIRE(overflow.getChunks().size() == 2);
+  CHECK(overflow.getChunks()[1].size == 0xFFFFFFFFFFFFFFFFull);
+  CHECK_FALSE(overflow.hasChunk("chna"));
+  REQUIRE_THROWS_AS(overflow.readChunk("axml"), std::runtime_error);
+  REQUIRE_THROWS_AS(overflow.parseAxml(), std::runtime_error);
+
+  auto chna = createChna();
+  for (std::size_t size = 0; size < chna.size() - 40; ++size) {
+    REQUIRE_THROWS_AS(parseChna(chna.data(), size), std::runtime_error);
+  }
+  CHECK(parseChna(chna.data(), chna.size()).size() == 2);
+  auto invalid = chnaContents({{1, "ATU_0000000X", "", ""}}, 1);
+  REQUIRE_THROWS(parseChna(invalid.data(), invalid.size()));
+}
+
+TEST_CASE("chna_from_document") {
+  using namespace adm;
+  auto document = getCommonDefinitions();
+  addSimpleObjectTo(document, "Object");
+  addSimpleCommonDefinitionsObjectTo(document, "Bed", "0+2+0");
+  document->add(AudioTrackUid::create());
+
+  auto entries = createChnaEntries(document);
+  REQUIRE(entries.size() == 4);
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    CHECK(entries[i].trackIndex == i + 1);
+  }
+  CHECK(formatId(entries[0].audioTrackUidId) == "ATU_00000001");
+  CHECK(formatId(entries[0].audioTrackFormatId.get()) == "AT_00031001_01");
+  CHECK(formatId(entries[0].audioPackFormatId.get()) == "AP_00031001");
+  CHECK(formatId(entries[2].audioTrackFormatId.get()) == "AT_00010002_01");
+  CHECK(formatId(entries[2].audioPackFormatId.get()) == "AP_00010002");
+  // an audioTrackUID without references
+  CHECK_FALSE(entries[3].audioTrackFormatId.is_initialized());
+  CHECK_FALSE(entries[3].audioPackFormatId.is_initialized());
+
+  auto audioIds = createChnaAudioIds(document);
+  REQUIRE(audioIds.size() == 4);
+  CHECK(std::string(audioIds[1].audioTrackUid, 12) == "ATU_00000002");
+  CHECK(std::string(audioIds[1].trackReference, 14) == "AT_00010001_01");
+  CHECK(std::string(audioIds[1].packReference, 11) == "AP_00010002");
+  CHECK(std::string(audioIds[3].trackReference, 14) == std::string(14, '\0'));
+
+  auto chna = formatChna(document);
+  REQUIRE(chna.size() == 4 + 4 * 40);
+  CHECK(chna[0] == 4);
+  CHECK(chna[2] == 4);
+  auto parsed = parseChna(chna.data(), chna.size());
+  REQUIRE(parsed.size() == entries.size());
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    CHECK(parsed[i].trackIndex == entries[i].trackIndex);
+    CHECK(parsed[i].audioTrackUidId == entries[i].audioTrackUidId);
+    CHECK((parsed[i].audioTrackFormatId == entries[i].audioTrackFormatId));
+    CHECK((parsed[i].audioPackFormatId == entries[i].audioPackFormatId));
+  }
+}
+
+TEST_CASE("chna_channel_format_reference") {
+  using namespace adm;
+  ChnaEntry entry;
+  entry.trackIndex = 3;
+  entry.audioTrackUidId = parseAudioTrackUidId("ATU_00000005");
+  entry.audioChannelFormatId = parseAudioChannelFormatId("AC_00010001");
+  entry.audioPackFormatId = parseAudioPackFormatId("AP_00010001");
+  // two audioTrackUIDs on the same track count as one track
+  auto second = entry;
+  second.audioTrackUidId = parseAudioTrackUidId("ATU_00000006");
+
+  auto chna = formatChna({makeChnaAudioId(entry), makeChnaAudioId(second)});
+  CHECK(chna[0] == 1);
+  CHECK(chna[2] == 2);
+  auto parsed = parseChna(chna.data(), chna.size());
+  REQUIRE(parsed.size() == 2);
+  CHECK(parsed[0].trackIndex == 3);
+  CHECK((parsed[0].audioChannelFormatId == entry.audioChannelFormatId));
+  CHECK_FALSE(parsed[0].audioTrackFormatId.is_initialized());
+  CHECK(parsed[1].audioTrackUidId == second.audioTrackUidId);
+}
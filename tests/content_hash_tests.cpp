@@ -0,0 +1,242 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <thread>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/parse.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "adm/write.hpp"
+#include "helper/block_formats.hpp"
+
+namespace {
+  using namespace std::chrono;
+
+  /// document with `objects` objects with `count` block formats each
+  std::shared_ptr<adm::Document> createDocument(unsigned int objects,
+                                                unsigned int count) {
+    using namespace adm;
+    auto document = Document::create();
+    auto programme = AudioProgramme::create(AudioProgrammeName("Programme"));
+    auto content = AudioContent::create(AudioContentName("Content"));
+    for (unsigned int i = 0; i < objects; ++i) {
+      auto result = createSimpleObject("Object " + std::to_string(i));
+      addBlockFormats(*result.audioChannelFormat, count);
+      content->addReference(result.audioObject);
+    }
+    programme->addReference(content);
+    document->add(programme);
+    return document;
+  }
+}  // namespace
+
+TEST_CASE("content_hash_equal_documents") {
+  using namespace adm;
+  auto document = createDocument(2, 3);
+  auto copy = document->deepCopy();
+  CHECK(document->getContentHash() == copy->getContentHash());
+
+  std::ostringstream xml;
+  writeXml(xml, document);
+  std::istringstream firstStream(xml.str());
+  std::istringstream secondStream(xml.str());
+  auto first = parseXml(firstStream);
+  auto second = parseXml(secondStream);
+  CHECK(first->getContentHash() == second->getContentHash());
+
+  auto objectId = parseAudioObjectId("AO_1001");
+  CHECK(first->lookup(objectId)->getContentHash() ==
+        second->lookup(objectId)->getContentHash());
+  CHECK(first->lookup(objectId)->getContentHash() !=
+        first->lookup(parseAudioObjectId("AO_1002"))->getContentHash());
+}
+
+TEST_CASE("content_hash_parameters") {
+  using namespace adm;
+  auto document = createDocument(2, 3);
+  auto programme = document->lookup(parseAudioProgrammeId("APR_1001"));
+  auto object = document->lookup(parseAudioObjectId("AO_1001"));
+  auto otherObject = document->lookup(parseAudioObjectId("AO_1002"));
+  auto documentHash = document->getContentHash();
+  auto programmeHash = programme->getContentHash();
+  auto objectHash = object->getContentHash();
+  auto otherObjectHash = otherObject->getContentHash();
+
+  object->set(Importance(5));
+  CHECK(object->getContentHash() != objectHash);
+  CHECK(programme->getContentHash() != programmeHash);
+  CHECK(document->getContentHash() != documentHash);
+  CHECK(otherObject->getContentHash() == otherObjectHash);
+
+  object->unset<Importance>();
+  CHECK(object->getContentHash() == objectHash);
+  CHECK(programme->getContentHash() == programmeHash);
+  CHECK(document->getContentHash() == documentHash);
+}
+
+TEST_CASE("content_hash_references") {
+  using namespace adm;
+  auto document = createDocument(2, 3);
+  auto content = document->lookup(parseAudioContentId("ACO_1001"));
+  auto object = document->lookup(parseAudioObjectId("AO_1001"));
+  auto contentHash = content->getContentHash();
+
+  content->removeReference(object);
+  CHECK(content->getContentHash() != contentHash);
+  // the order of the references is included
+  content->addReference(object);
+  CHECK(content->getContentHash() != contentHash);
+}
+
+TEST_CASE("content_hash_block_formats") {
+  using namespace adm;
+  auto document = createDocument(1, 3);
+  auto channelFormat =
+      document->lookup(parseAudioChannelFormatId("AC_00031001"));
+  auto trackUid = document->lookup(parseAudioTrackUidId("ATU_00000001"));
+  auto channelFormatHash = channelFormat->getContentHash();
+  auto trackUidHash = trackUid->getContentHash();
+
+  auto blockFormats = channelFormat->getElements<AudioBlockFormatObjects>();
+  auto blockFormatHash = blockFormats[1].getContentHash();
+  CHECK(blockFormatHash != blockFormats[0].getContentHash());
+  blockFormats[1].set(Gain(0.5f));
+  CHECK(blockFormats[1].getContentHash() != blockFormatHash);
+  CHECK(channelFormat->getContentHash() != channelFormatHash);
+  // via audioTrackFormat and audioStreamFormat
+  CHECK(trackUid->getContentHash() != trackUidHash);
+
+  channelFormat->add(AudioBlockFormatObjects(SphericalPosition()));
+  auto addedHash = channelFormat->getContentHash();
+  CHECK(addedHash != channelFormatHash);
+  channelFormat->clearAudioBlockFormats();
+  CHECK(channelFormat->getContentHash() != addedHash);
+}
+
+TEST_CASE("content_hash_held_mutable_range") {
+  using namespace adm;
+  auto document = createDocument(1, 3);
+  auto channelFormat =
+      document->lookup(parseAudioChannelFormatId("AC_00031001"));
+  // taken before hashing, and used to modify the block formats afterwards
+  auto blockFormats = channelFormat->getElements<AudioBlockFormatObjects>();
+  auto channelFormatHash = channelFormat->getContentHash();
+  auto documentHash = document->getContentHash();
+
+  blockFormats[1].set(Gain(0.5f));
+  CHECK(channelFormat->getContentHash() != channelFormatHash);
+  CHECK(document->getContentHash() != documentHash);
+  channelFormatHash = channelFormat->getContentHash();
+  documentHash = document->getContentHash();
+  blockFormats[1].set(Gain(0.25f));
+  CHECK(channelFormat->getContentHash() != channelFormatHash);
+  CHECK(document->getContentHash() != documentHash);
+}
+
+TEST_CASE("content_hash_generation") {
+  using namespace adm;
+  auto document = createDocument(2, 3);
+  auto object = document->lookup(parseAudioObjectId("AO_1001"));
+  auto channelFormat =
+      document->lookup(parseAudioChannelFormatId("AC_00031001"));
+  auto documentHash = document->getContentHash();
+
+  auto generation = document->getGeneration();
+  CHECK(document->getContentHash() == documentHash);
+  CHECK(document->getGeneration() == generation);
+
+  object->set(Importance(5));
+  CHECK(document->getGeneration() > generation);
+  CHECK(document->getContentHash() != documentHash);
+  object->unset<Importance>();
+  CHECK(document->getContentHash() == documentHash);
+
+  generation = document->getGeneration();
+  channelFormat->add(AudioBlockFormatObjects(SphericalPosition()));
+  CHECK(document->getGeneration() > generation);
+  CHECK(document->getContentHash() != documentHash);
+
+  generation = document->getGeneration();
+  auto programme = AudioProgramme::create(AudioProgrammeName("Other"));
+  document->add(programme);
+  CHECK(document->getGeneration() > generation);
+  generation = document->getGeneration();
+  document->remove(programme);
+  CHECK(document->getGeneration() > generation);
+
+  // copies do not belong to the document
+  generation = document->getGeneration();
+  auto objectCopy = object->copy();
+  objectCopy->set(Importance(3));
+  CHECK(document->getGeneration() == generation);
+}
+
+TEST_CASE("content_hash_shared_sub_graphs") {
+  using namespace adm;
+  // every object references the same audioPackFormat
+  auto document = Document::create();
+  auto packFormat = AudioPackFormat::create(AudioPackFormatName("Pack"),
+                                            TypeDefinition::OBJECTS);
+  auto channelFormat = AudioChannelFormat::create(
+      AudioChannelFormatName("Channel"), TypeDefinition::OBJECTS);
+  packFormat->addReference(channelFormat);
+  for (int i = 0; i < 3; ++i) {
+    auto object = AudioObject::create(AudioObjectName("Object"));
+    object->addReference(packFormat);
+    document->add(object);
+  }
+  auto hash = document->getContentHash();
+
+  auto copy = document->deepCopy();
+  CHECK(copy->getContentHash() == hash);
+  channelFormat->set(AudioChannelFormatName("Changed"));
+  CHECK(document->getContentHash() != hash);
+  CHECK(copy->getContentHash() == hash);
+}
+
+TEST_CASE("content_hash_concurrent") {
+  using namespace adm;
+  auto document = createDocument(8, 100);
+  auto expected = document->deepCopy()->getContentHash();
+
+  std::vector<std::uint64_t> hashes(4);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < hashes.size(); ++i) {
+    threads.emplace_back([&document, &hashes, i]() {
+      std::shared_ptr<const Document> constDocument = document;
+      hashes[i] = constDocument->getContentHash();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto hash : hashes) {
+    CHECK(hash == expected);
+  }
+}
+
+TEST_CASE("content_hash_benchmark") {
+  using namespace adm;
+  auto document = createDocument(16, 1000);
+  auto object = document->lookup(parseAudioObjectId("AO_1001"));
+
+  BENCHMARK("hash document") { return document->getContentHash(); };
+
+  BENCHMARK("hash all objects") {
+    std::uint64_t value = 0;
+    for (const auto& object : document->getElements<AudioObject>()) {
+      value ^= object->getContentHash();
+    }
+    return value;
+  };
+
+  BENCHMARK("hash document after modification") {
+    object->set(Importance(5));
+    return document->getContentHash();
+  };
+
+  BENCHMARK("write XML") {
+    std::ostringstream stream;
+    writeXml(stream, document);
+    return stream.str().size();
+  };
+}
@@ -0,0 +1,149 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/parse.hpp"
+#include "adm/utilities/deduplication.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "adm/write.hpp"
+#include "helper/block_formats.hpp"
+
+namespace {
+  using namespace std::chrono;
+
+  /// add an object with `count` block formats; all of these are identical
+  adm::SimpleObjectHolder addObject(
+      const std::shared_ptr<adm::AudioContent>& content, unsigned int count) {
+    using namespace adm;
+    auto result = createSimpleObject("Object");
+    addBlockFormats(*result.audioChannelFormat, count);
+    content->addReference(result.audioObject);
+    return result;
+  }
+
+  /// document with `objects` identical objects with `count` block formats
+  std::shared_ptr<adm::Document> createDocument(unsigned int objects,
+                                                unsigned int count) {
+    using namespace adm;
+    auto document = Document::create();
+    auto content = AudioContent::create(AudioContentName("Content"));
+    for (unsigned int i = 0; i < objects; ++i) {
+      addObject(content, count);
+    }
+    document->add(content);
+    return document;
+  }
+}  // namespace
+
+TEST_CASE("remove_duplicate_formats") {
+  using namespace adm;
+  auto document = createDocument(4, 3);
+  REQUIRE(document->getElements<AudioChannelFormat>().size() == 4);
+
+  // one audioChannelFormat, audioPackFormat, audioStreamFormat and
+  // audioTrackFormat of each object but the first
+  CHECK(removeDuplicateFormats(document) == 12);
+  CHECK(document->getElements<AudioChannelFormat>().size() == 1);
+  CHECK(document->getElements<AudioPackFormat>().size() == 1);
+  CHECK(document->getElements<AudioStreamFormat>().size() == 1);
+  CHECK(document->getElements<AudioTrackFormat>().size() == 1);
+  CHECK(document->getElements<AudioObject>().size() == 4);
+  CHECK(document->getElements<AudioTrackUid>().size() == 4);
+
+  auto packFormat = document->getElements<AudioPackFormat>()[0];
+  auto trackFormat = document->getElements<AudioTrackFormat>()[0];
+  CHECK(packFormat->get<AudioPackFormatId>() == parseAudioPackFormatId("AP_00031001"));
+  for (auto& object : document->getElements<AudioObject>()) {
+    REQUIRE(object->getReferences<AudioPackFormat>().size() == 1);
+    CHECK(object->getReferences<AudioPackFormat>()[0] == packFormat);
+  }
+  for (auto& trackUid : document->getElements<AudioTrackUid>()) {
+    CHECK(trackUid->getReference<AudioTrackFormat>() == trackFormat);
+    CHECK(trackUid->getReference<AudioPackFormat>() == packFormat);
+  }
+
+  // nothing left to merge
+  CHECK(removeDuplicateFormats(document) == 0);
+
+  std::ostringstream xml;
+  writeXml(xml, document);
+  std::istringstream stream(xml.str());
+  auto parsed = parseXml(stream);
+  auto parsedPackFormat = parsed->lookup(packFormat->get<AudioPackFormatId>());
+  REQUIRE(parsedPackFormat != nullptr);
+  REQUIRE(parsed->getElements<AudioObject>().size() == 4);
+  for (auto& object : parsed->getElements<AudioObject>()) {
+    CHECK(object->getReferences<AudioPackFormat>()[0] == parsedPackFormat);
+  }
+}
+
+TEST_CASE("remove_duplicate_formats_differences") {
+  using namespace adm;
+  auto document = Document::create();
+  auto content = AudioContent::create(AudioContentName("Content"));
+  addObject(content, 3);
+  addObject(content, 3);
+  auto differentBlock = addObject(content, 3);
+  auto differentPack = addObject(content, 3);
+  auto differentName = addObject(content, 3);
+  document->add(content);
+
+  differentBlock.audioChannelFormat->getElements<AudioBlockFormatObjects>()[2]
+      .set(Gain(0.5f));
+  differentPack.audioPackFormat->set(Importance(3));
+  differentName.audioTrackFormat->set(AudioTrackFormatName("Other"));
+
+  // all formats of the second object are merged with the first; nothing of
+  // the object with the different block format, as all its formats refer to
+  // its audioChannelFormat; and all but the differing audioPackFormat and
+  // audioTrackFormat of the last two objects
+  CHECK(removeDuplicateFormats(document) == 4 + 0 + 3 + 3);
+  CHECK(document->getElements<AudioChannelFormat>().size() == 2);
+  CHECK(document->getElements<AudioPackFormat>().size() == 3);
+  CHECK(document->getElements<AudioStreamFormat>().size() == 2);
+  CHECK(document->getElements<AudioTrackFormat>().size() == 3);
+
+  auto channelFormats = document->getElements<AudioChannelFormat>();
+  CHECK(differentPack.audioPackFormat->getReferences<AudioChannelFormat>()[0] ==
+        channelFormats[0]);
+  CHECK(differentName.audioTrackUid->getReference<AudioTrackFormat>() ==
+        differentName.audioTrackFormat);
+  CHECK(differentName.audioTrackFormat->getReference<AudioStreamFormat>() ==
+        document->getElements<AudioStreamFormat>()[0]);
+}
+
+TEST_CASE("remove_duplicate_formats_nested_pack_formats") {
+  using namespace adm;
+  // the nesting depth is determined without recursion
+  const unsigned int depth = 1000;
+  auto document = Document::create();
+  auto content = AudioContent::create(AudioContentName("Content"));
+  for (unsigned int i = 0; i < 2; ++i) {
+    auto result = addObject(content, 1);
+    auto packFormat = result.audioPackFormat;
+    for (unsigned int j = 0; j < depth; ++j) {
+      auto parent = AudioPackFormat::create(AudioPackFormatName("Parent"),
+                                            TypeDefinition::OBJECTS);
+      parent->addReference(packFormat);
+      packFormat = parent;
+    }
+    result.audioObject->addReference(packFormat);
+  }
+  document->add(content);
+  REQUIRE(document->getElements<AudioPackFormat>().size() == 2 * depth + 2);
+
+  // both hierarchies are merged, from the innermost audioPackFormat on
+  CHECK(removeDuplicateFormats(document) == depth + 4);
+  CHECK(document->getElements<AudioPackFormat>().size() == depth + 1);
+}
+
+TEST_CASE("remove_duplicate_formats_benchmark") {
+  using namespace adm;
+  auto document = createDocument(64, 100);
+
+  BENCHMARK("remove duplicate formats") {
+    return removeDuplicateFormats(document->deepCopy());
+  };
+
+  BENCHMARK("copy") { return document->deepCopy(); };
+}
@@ -0,0 +1,195 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/utilities/document_diff.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "adm/write.hpp"
+#include "helper/block_formats.hpp"
+
+namespace {
+  using namespace std::chrono;
+
+  /// document with `objects` objects with `count` block formats each
+  std::shared_ptr<adm::Document> createDocument(unsigned int objects,
+                                                unsigned int count) {
+    using namespace adm;
+    auto document = Document::create();
+    auto content = AudioContent::create(AudioContentName("Content"));
+    for (unsigned int i = 0; i < objects; ++i) {
+      auto result = createSimpleObject("Object " + std::to_string(i));
+      addBlockFormats(*result.audioChannelFormat, count);
+      content->addReference(result.audioObject);
+    }
+    document->add(content);
+    return document;
+  }
+
+  std::shared_ptr<adm::AudioChannelFormat> getChannelFormat(
+      const std::shared_ptr<adm::Document>& document, const char* id) {
+    return document->lookup(adm::parseAudioChannelFormatId(id));
+  }
+
+  bool isChange(const adm::DocumentChange& change, adm::ChangeType type,
+                const adm::ElementIdVariant& element) {
+    return change.type == type && change.element == element &&
+           !change.blockFormat;
+  }
+
+  bool isBlockChange(const adm::DocumentChange& change, adm::ChangeType type,
+                     const char* channelFormat, const char* blockFormat) {
+    return change.type == type &&
+           change.element == adm::ElementIdVariant(
+                                 adm::parseAudioChannelFormatId(
+                                     channelFormat)) &&
+           change.blockFormat &&
+           *change.blockFormat == adm::parseAudioBlockFormatId(blockFormat);
+  }
+}  // namespace
+
+TEST_CASE("document_diff_equal") {
+  using namespace adm;
+  auto document = createDocument(3, 10);
+  CHECK(diff(document, document).empty());
+  CHECK(diff(document, document->deepCopy()).empty());
+  CHECK(diff(Document::create(), Document::create()).empty());
+}
+
+TEST_CASE("document_diff_parameters") {
+  using namespace adm;
+  auto first = createDocument(2, 1);
+  auto second = first->deepCopy();
+  auto objectId = parseAudioObjectId("AO_1002");
+  second->lookup(objectId)->set(AudioObjectName("Renamed"));
+  second->lookup(objectId)->set(Importance(3));
+
+  auto changes = diff(first, second);
+  REQUIRE(changes.size() == 1);
+  CHECK(isChange(changes[0], ChangeType::parametersChanged,
+                 ElementIdVariant(objectId)));
+}
+
+TEST_CASE("document_diff_references") {
+  using namespace adm;
+  auto first = createDocument(3, 1);
+  auto second = first->deepCopy();
+  auto contentId = parseAudioContentId("ACO_1001");
+  auto content = second->lookup(contentId);
+  auto object = second->lookup(parseAudioObjectId("AO_1001"));
+
+  SECTION("removed") {
+    content->removeReference(object);
+    auto changes = diff(first, second);
+    REQUIRE(changes.size() == 1);
+    CHECK(isChange(changes[0], ChangeType::referencesChanged,
+                   ElementIdVariant(contentId)));
+  }
+  SECTION("reordered") {
+    content->removeReference(object);
+    content->addReference(object);
+    auto changes = diff(first, second);
+    REQUIRE(changes.size() == 1);
+    CHECK(isChange(changes[0], ChangeType::referencesChanged,
+                   ElementIdVariant(contentId)));
+  }
+}
+
+TEST_CASE("document_diff_added_removed") {
+  using namespace adm;
+  auto first = createDocument(1, 1);
+  auto second = first->deepCopy();
+  auto programme = AudioProgramme::create(AudioProgrammeName("Programme"));
+  programme->addReference(second->lookup(parseAudioContentId("ACO_1001")));
+  second->add(programme);
+  second->remove(second->lookup(parseAudioTrackUidId("ATU_00000001")));
+
+  auto changes = diff(first, second);
+  REQUIRE(changes.size() == 3);
+  // ordered by element type, like the XML
+  CHECK(isChange(changes[0], ChangeType::added,
+                 ElementIdVariant(parseAudioProgrammeId("APR_1001"))));
+  CHECK(isChange(changes[1], ChangeType::referencesChanged,
+                 ElementIdVariant(parseAudioObjectId("AO_1001"))));
+  CHECK(isChange(changes[2], ChangeType::removed,
+                 ElementIdVariant(parseAudioTrackUidId("ATU_00000001"))));
+
+  auto reverse = diff(second, first);
+  REQUIRE(reverse.size() == 3);
+  CHECK(reverse[0].type == ChangeType::removed);
+  CHECK(reverse[2].type == ChangeType::added);
+}
+
+TEST_CASE("document_diff_block_formats") {
+  using namespace adm;
+  auto first = createDocument(2, 5);
+  auto second = first->deepCopy();
+  auto channelFormat = getChannelFormat(second, "AC_00031002");
+  auto blockFormats = channelFormat->getElements<AudioBlockFormatObjects>();
+  blockFormats[3].set(Gain(0.5f));
+  blockFormats[1].set(Gain(0.5f));
+  channelFormat->add(AudioBlockFormatObjects(SphericalPosition()));
+
+  auto changes = diff(first, second);
+  REQUIRE(changes.size() == 3);
+  CHECK(isBlockChange(changes[0], ChangeType::parametersChanged,
+                      "AC_00031002", "AB_00031002_00000002"));
+  CHECK(isBlockChange(changes[1], ChangeType::parametersChanged,
+                      "AC_00031002", "AB_00031002_00000004"));
+  CHECK(isBlockChange(changes[2], ChangeType::added, "AC_00031002",
+                      "AB_00031002_00000006"));
+
+  auto reverse = diff(second, first);
+  REQUIRE(reverse.size() == 3);
+  CHECK(isBlockChange(reverse[2], ChangeType::removed, "AC_00031002",
+                      "AB_00031002_00000006"));
+}
+
+TEST_CASE("document_diff_block_formats_order") {
+  using namespace adm;
+  // enough block formats to be split into several tasks
+  auto first = createDocument(3, 10000);
+  auto second = first->deepCopy();
+  auto objectId = parseAudioObjectId("AO_1003");
+  second->lookup(objectId)->set(AudioObjectName("Renamed"));
+  for (auto id : {"AC_00031001", "AC_00031003"}) {
+    auto blockFormats =
+        getChannelFormat(second, id)->getElements<AudioBlockFormatObjects>();
+    for (auto index : {9999, 5000, 0}) {
+      blockFormats[index].set(Gain(0.5f));
+    }
+  }
+
+  auto changes = diff(first, second);
+  REQUIRE(changes.size() == 7);
+  CHECK(isChange(changes[0], ChangeType::parametersChanged,
+                 ElementIdVariant(objectId)));
+  CHECK(isBlockChange(changes[1], ChangeType::parametersChanged,
+                      "AC_00031001", "AB_00031001_00000001"));
+  CHECK(isBlockChange(changes[2], ChangeType::parametersChanged,
+                      "AC_00031001", "AB_00031001_00001389"));
+  CHECK(isBlockChange(changes[3], ChangeType::parametersChanged,
+                      "AC_00031001", "AB_00031001_00002710"));
+  CHECK(isBlockChange(changes[4], ChangeType::parametersChanged,
+                      "AC_00031003", "AB_00031003_00000001"));
+  CHECK(isBlockChange(changes[6], ChangeType::parametersChanged,
+                      "AC_00031003", "AB_00031003_00002710"));
+}
+
+TEST_CASE("document_diff_benchmark") {
+  using namespace adm;
+  auto first = createDocument(8, 2000);
+  auto second = first->deepCopy();
+  auto blockFormats = getChannelFormat(second, "AC_00031004")
+                          ->getElements<AudioBlockFormatObjects>();
+  blockFormats[1000].set(Gain(0.5f));
+
+  BENCHMARK("diff") { return diff(first, second).size(); };
+
+  BENCHMARK("compare XML") {
+    std::ostringstream firstXml;
+    std::ostringstream secondXml;
+    writeXml(firstXml, first);
+    writeXml(secondXml, second);
+    return firstXml.str() == secondXml.str();
+  };
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/parse.hpp"
+#include "adm/utilities/garbage_collection.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "adm/write.hpp"
+
+namespace {
+  /// document with a programme with `used` objects, and `unused` others
+  std::shared_ptr<adm::Document> createDocument(unsigned int used,
+                                                unsigned int unused) {
+    using namespace adm;
+    auto document = Document::create();
+    auto programme = AudioProgramme::create(AudioProgrammeName("Programme"));
+    auto content = AudioContent::create(AudioContentName("Content"));
+    programme->addReference(content);
+    // add all elements at once, so that assigning IDs stays fast
+    std::vector<ElementVariant> elements{programme};
+    for (unsigned int i = 0; i < used; ++i) {
+      content->addReference(
+          createSimpleObject("Used " + std::to_string(i)).audioObject);
+    }
+    for (unsigned int i = 0; i < unused; ++i) {
+      elements.push_back(
+          createSimpleObject("Unused " + std::to_string(i)).audioObject);
+    }
+    document->add(elements);
+    return document;
+  }
+
+  template <typename Element>
+  bool contains(const std::vector<adm::ElementVariant>& elements,
+                const std::shared_ptr<Element>& element) {
+    return std::find(elements.begin(), elements.end(),
+                     adm::ElementVariant(element)) != elements.end();
+  }
+}  // namespace
+
+TEST_CASE("collect_garbage") {
+  using namespace adm;
+  auto document = createDocument(2, 1);
+  auto unused = document->lookup(parseAudioObjectId("AO_1003"));
+  auto channelFormat = AudioChannelFormat::create(
+      AudioChannelFormatName("Unused"), TypeDefinition::OBJECTS);
+  document->add(channelFormat);
+
+  auto removed = collectGarbage(document);
+  // the unused object with its formats and audioTrackUid
+  REQUIRE(removed.size() == 7);
+  CHECK(boost::get<std::shared_ptr<AudioObject>>(removed[0]) == unused);
+  CHECK(contains(removed, channelFormat));
+  CHECK(document->getElements<AudioObject>().size() == 2);
+  CHECK(document->getElements<AudioChannelFormat>().size() == 2);
+  CHECK(document->getElements<AudioTrackUid>().size() == 2);
+  CHECK(document->lookup(unused->get<AudioObjectId>()) == nullptr);
+
+  CHECK(collectGarbage(document).empty());
+}
+
+TEST_CASE("collect_garbage_roots") {
+  using namespace adm;
+  auto document = createDocument(1, 1);
+  auto unused = document->lookup(parseAudioObjectId("AO_1002"));
+
+  auto removed = collectGarbage(document, {unused});
+  // the programme, content, and the other object
+  REQUIRE(removed.size() == 8);
+  CHECK(document->getElements<AudioProgramme>().empty());
+  CHECK(document->getElements<AudioObject>().size() == 1);
+  CHECK(document->getElements<AudioObject>()[0] == unused);
+
+  // without audioProgrammes, nothing is reachable
+  collectGarbage(document);
+  CHECK(document->getElements<AudioObject>().empty());
+  CHECK(document->getElements<AudioTrackFormat>().empty());
+}
+
+TEST_CASE("collect_garbage_stream_track_formats") {
+  using namespace adm;
+  auto document = createDocument(1, 0);
+  auto streamFormat = document->getElements<AudioStreamFormat>()[0];
+  auto trackFormat = AudioTrackFormat::create(AudioTrackFormatName("Second"),
+                                              FormatDefinition::PCM);
+  trackFormat->setReference(streamFormat);
+  streamFormat->addReference(std::weak_ptr<AudioTrackFormat>(trackFormat));
+  document->add(trackFormat);
+
+  // reachable from the audioStreamFormat
+  CHECK(collectGarbage(document).empty());
+  CHECK(document->getElements<AudioTrackFormat>().size() == 2);
+}
+
+TEST_CASE("collect_garbage_common_definitions") {
+  using namespace adm;
+  std::ostringstream xml;
+  writeXml(xml, createDocument(1, 0));
+  std::istringstream stream(xml.str());
+  auto document = parseXml(stream);
+  REQUIRE(document->getElements<AudioChannelFormat>().size() > 1);
+
+  auto removed = collectGarbage(document);
+  CHECK(!removed.empty());
+  CHECK(document->getElements<AudioChannelFormat>().size() == 1);
+  CHECK(document->getElements<AudioPackFormat>().size() == 1);
+  CHECK(document->getElements<AudioTrackUid>().size() == 1);
+}
+
+TEST_CASE("collect_garbage_benchmark") {
+  using namespace adm;
+  auto document = createDocument(1000, 1000);
+
+  BENCHMARK("collect garbage") {
+    return collectGarbage(document->deepCopy()).size();
+  };
+
+  BENCHMARK("copy") { return document->deepCopy(); };
+}
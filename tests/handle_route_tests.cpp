@@ -0,0 +1,109 @@
+#include <catch2/catch.hpp>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/handle_route.hpp"
+#include "adm/route_tracer.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include <set>
+#include <unordered_set>
+
+using namespace adm;
+
+TEST_CASE("element_handle") {
+  auto object = AudioObject::create(AudioObjectName("Object"));
+  ElementHandle handle(object.get());
+  REQUIRE(handle.is<AudioObject>());
+  REQUIRE_FALSE(handle.is<AudioContent>());
+  REQUIRE(handle.get<AudioObject>() == object.get());
+  REQUIRE(handle.get<AudioContent>() == nullptr);
+  REQUIRE(handle.which() == ElementConstVariant(
+                                std::shared_ptr<const AudioObject>(object))
+                                .which());
+  REQUIRE(boost::get<std::shared_ptr<const AudioObject>>(handle.lock()) ==
+          object);
+  REQUIRE_THROWS_AS(ElementHandle().lock(), std::logic_error);
+}
+
+TEST_CASE("handle_route") {
+  auto document = Document::create();
+  auto programme = AudioProgramme::create(AudioProgrammeName("Programme"));
+  auto content = AudioContent::create(AudioContentName("Content"));
+  programme->addReference(content);
+  document->add(programme);
+  auto holderA = addSimpleObjectTo(document, "A");
+  auto holderB = addSimpleObjectTo(document, "B");
+  content->addReference(holderA.audioObject);
+  content->addReference(holderB.audioObject);
+
+  RouteTracer tracer;
+  auto routes = tracer.run(programme);
+  detail::GenericRouteTracer<HandleRoute, detail::DefaultFullDepthStrategy>
+      handleTracer;
+  auto handleRoutes = handleTracer.run(programme);
+  REQUIRE(handleRoutes.size() == 2);
+
+  HandleRoute& route = handleRoutes[0];
+  REQUIRE(route.size() == 5);
+  REQUIRE(route.getFirstOf<AudioProgramme>() == programme.get());
+  REQUIRE(route.getLastOf<AudioObject>() == holderA.audioObject.get());
+  REQUIRE(route.getLastOf<AudioChannelFormat>() ==
+          holderA.audioChannelFormat.get());
+  REQUIRE(route.getFirstOf<AudioTrackUid>() == nullptr);
+  REQUIRE(route.findFirstOf<AudioPackFormat>() == route.begin() + 3);
+  REQUIRE(route.findLastOf<AudioTrackUid>() == route.end());
+  REQUIRE(route.back().get<AudioChannelFormat>() ==
+          holderA.audioChannelFormat.get());
+
+  REQUIRE(route.hash() == routes[0].hash());
+  REQUIRE(route.toRoute() == routes[0]);
+  REQUIRE(HandleRoute(routes[1]) == handleRoutes[1]);
+  REQUIRE(handleRoutes[0] != handleRoutes[1]);
+
+  std::set<HandleRoute> routeSet(handleRoutes.begin(), handleRoutes.end());
+  routeSet.insert(HandleRoute(routes[0]));
+  REQUIRE(routeSet.size() == 2);
+  std::unordered_set<HandleRoute> unorderedRouteSet(handleRoutes.begin(),
+                                                    handleRoutes.end());
+  unorderedRouteSet.insert(HandleRoute(routes[1]));
+  REQUIRE(unorderedRouteSet.size() == 2);
+}
+
+TEST_CASE("handle_route_compares_ids") {
+  auto document = Document::create();
+  addSimpleObjectTo(document, "A");
+  addSimpleObjectTo(document, "B");
+  auto copy = document->deepCopy();
+
+  detail::GenericRouteTracer<HandleRoute, detail::DefaultFullDepthStrategy>
+      handleTracer;
+  RouteTracer tracer;
+  std::vector<HandleRoute> handleRoutes;
+  std::vector<HandleRoute> copyRoutes;
+  std::vector<Route> routes;
+  for (auto object : document->getElements<AudioObject>()) {
+    auto objectRoutes = handleTracer.run(object);
+    handleRoutes.insert(handleRoutes.end(), objectRoutes.begin(),
+                        objectRoutes.end());
+    auto ownedRoutes = tracer.run(object);
+    routes.insert(routes.end(), ownedRoutes.begin(), ownedRoutes.end());
+  }
+  for (auto object : copy->getElements<AudioObject>()) {
+    auto objectRoutes = handleTracer.run(object);
+    copyRoutes.insert(copyRoutes.end(), objectRoutes.begin(),
+                      objectRoutes.end());
+  }
+  REQUIRE(handleRoutes.size() == 2);
+  REQUIRE(copyRoutes.size() == 2);
+
+  // routes through copies of the same elements are equal, and are ordered
+  // the same way as the corresponding Routes
+  REQUIRE(handleRoutes[0] == copyRoutes[0]);
+  REQUIRE(handleRoutes[1] == copyRoutes[1]);
+  REQUIRE(handleRoutes[0] != copyRoutes[1]);
+  REQUIRE((handleRoutes[0] < handleRoutes[1]) == (routes[0] < routes[1]));
+  REQUIRE((copyRoutes[0] < copyRoutes[1]) == (routes[0] < routes[1]));
+
+  std::set<HandleRoute> routeSet(handleRoutes.begin(), handleRoutes.end());
+  routeSet.insert(copyRoutes.begin(), copyRoutes.end());
+  REQUIRE(routeSet.size() == 2);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <chrono>
+#include <memory>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/utilities/object_creation.hpp"
+
+/**
+ * Block format number `index` of consecutive block formats of `duration`,
+ * with varying positions
+ *
+ * The ID is set explicitly, so that adding many block formats does not
+ * search for free IDs. `idValue` defaults to the value of the first
+ * audioChannelFormat of a document; the audioChannelFormat replaces it
+ * when it gets a new ID.
+ */
+inline adm::AudioBlockFormatObjects createBlockFormat(
+    unsigned int index,
+    std::chrono::milliseconds duration = std::chrono::milliseconds(10),
+    unsigned int idValue = 0x1001) {
+  using namespace adm;
+  return AudioBlockFormatObjects(
+      SphericalPosition(Azimuth(static_cast<float>(index % 360) - 180.f)),
+      Rtime(duration * index), Duration(duration),
+      AudioBlockFormatId(TypeDefinition::OBJECTS,
+                         AudioBlockFormatIdValue(idValue),
+                         AudioBlockFormatIdCounter(index + 1)));
+}
+
+/// Add `count` block formats made by `createBlockFormat()`
+inline void addBlockFormats(
+    adm::AudioChannelFormat& channelFormat, unsigned int count,
+    std::chrono::milliseconds duration = std::chrono::milliseconds(10),
+    unsigned int idValue = 0x1001) {
+  for (unsigned int i = 0; i < count; ++i) {
+    channelFormat.add(createBlockFormat(i, duration, idValue));
+  }
+}
+
+/// Document with one object with `count` block formats of `duration`
+inline std::shared_ptr<adm::Document> createObjectDocument(
+    unsigned int count,
+    std::chrono::milliseconds duration = std::chrono::milliseconds(10)) {
+  auto document = adm::Document::create();
+  auto result = adm::createSimpleObject("Object");
+  addBlockFormats(*result.audioChannelFormat, count, duration);
+  document->add(result.audioObject);
+  return document;
+}
@@ -24,3 +24,13 @@ TEST_CASE("formatHexValue") {
   REQUIRE(detail::formatHexValue(65535, 8) == "0000ffff");
   REQUIRE_THROWS_AS(detail::formatHexValue(1000000), std::runtime_error);
 }
+
+TEST_CASE("formatHexValue_buffer") {
+  char buffer[detail::FORMAT_BUFFER_SIZE];
+  REQUIRE(detail::formatHexValue(buffer, 255) == 4);
+  REQUIRE(std::string(buffer) == "00ff");
+  REQUIRE(detail::formatHexValue(buffer, 0xabcdefu, 8) == 8);
+  REQUIRE(std::string(buffer) == "00abcdef");
+  REQUIRE_THROWS_AS(detail::formatHexValue(buffer, 0x10000u),
+                    std::runtime_error);
+}
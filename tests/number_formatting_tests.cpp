@@ -0,0 +1,73 @@
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include "adm/detail/number_formatting.hpp"
+
+using namespace adm;
+
+namespace {
+  std::string formatFloat(float value) {
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    auto size = detail::formatFloat(buffer, value);
+    REQUIRE(buffer[size] == '\0');
+    return std::string(buffer, size);
+  }
+
+  std::string formatDouble(double value) {
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    return std::string(buffer, detail::formatDouble(buffer, value));
+  }
+
+  std::string formatInteger(long long value) {
+    char buffer[detail::FORMAT_BUFFER_SIZE];
+    return std::string(buffer, detail::formatInteger(buffer, value));
+  }
+}  // namespace
+
+TEST_CASE("format_float") {
+  REQUIRE(formatFloat(0.f) == "0");
+  REQUIRE(formatFloat(-0.f) == "-0");
+  REQUIRE(formatFloat(30.f) == "30");
+  REQUIRE(formatFloat(-30.f) == "-30");
+  REQUIRE(formatFloat(0.1f) == "0.1");
+  REQUIRE(formatFloat(-22.5f) == "-22.5");
+  REQUIRE(formatFloat(1.f / 3.f) == "0.33333334");
+  REQUIRE(formatFloat(16777216.f) == "16777216");
+  REQUIRE(formatFloat(1e20f) == "100000000000000000000");
+  REQUIRE(formatFloat(1.5e-5f) == "0.000015");
+  REQUIRE(formatFloat(std::numeric_limits<float>::max()) ==
+          "3.4028235e38");
+  REQUIRE(formatFloat(1e-30f) == "1e-30");
+  REQUIRE(formatFloat(std::numeric_limits<float>::infinity()) == "inf");
+
+  // all formatted values parse back to the same float
+  for (float value = -1000.f; value < 1000.f; value += 0.0123f) {
+    REQUIRE(std::strtof(formatFloat(value).c_str(), nullptr) == value);
+  }
+
+  BENCHMARK("format float") { return formatFloat(-29.123456f); };
+}
+
+TEST_CASE("format_double") {
+  REQUIRE(formatDouble(0.) == "0");
+  REQUIRE(formatDouble(0.1) == "0.1");
+  REQUIRE(formatDouble(-12.25) == "-12.25");
+  REQUIRE(formatDouble(1. / 3.) == "0.3333333333333333");
+  REQUIRE(formatDouble(1e300) == "1e300");
+  for (double value = -1000.; value < 1000.; value += 0.0123) {
+    REQUIRE(std::strtod(formatDouble(value).c_str(), nullptr) == value);
+  }
+}
+
+TEST_CASE("format_integer") {
+  REQUIRE(formatInteger(0) == "0");
+  REQUIRE(formatInteger(42) == "42");
+  REQUIRE(formatInteger(-42) == "-42");
+  REQUIRE(formatInteger(std::numeric_limits<long long>::min()) ==
+          "-9223372036854775808");
+  char buffer[detail::FORMAT_BUFFER_SIZE];
+  REQUIRE(std::string(buffer, detail::formatUnsigned(
+                                  buffer, 18446744073709551615ull)) ==
+          "18446744073709551615");
+}
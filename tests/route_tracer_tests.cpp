@@ -1,7 +1,11 @@
 #include <catch2/catch.hpp>
 #include "adm/elements.hpp"
 #include "adm/utilities/object_creation.hpp"
+#include "adm/document.hpp"
+#include "adm/path.hpp"
 #include "adm/route_tracer.hpp"
+#include <set>
+#include <unordered_set>
 
 using namespace adm;
 
@@ -105,3 +109,267 @@ TEST_CASE("via_uid") {
 
   REQUIRE(route == expected_route);
 }
+
+TEST_CASE("nested_pack_formats") {
+  auto programme = AudioProgramme::create(AudioProgrammeName("Programme"));
+  auto content = AudioContent::create(AudioContentName("Content"));
+  programme->addReference(content);
+  auto object = AudioObject::create(AudioObjectName("Object"));
+  content->addReference(object);
+
+  auto outerPack = AudioPackFormat::create(AudioPackFormatName("Outer"),
+                                           TypeDefinition::OBJECTS);
+  auto innerPack = AudioPackFormat::create(AudioPackFormatName("Inner"),
+                                           TypeDefinition::OBJECTS);
+  auto outerChannel = AudioChannelFormat::create(
+      AudioChannelFormatName("OuterChannel"), TypeDefinition::OBJECTS);
+  auto innerChannelA = AudioChannelFormat::create(
+      AudioChannelFormatName("InnerChannelA"), TypeDefinition::OBJECTS);
+  auto innerChannelB = AudioChannelFormat::create(
+      AudioChannelFormatName("InnerChannelB"), TypeDefinition::OBJECTS);
+  object->addReference(outerPack);
+  outerPack->addReference(outerChannel);
+  outerPack->addReference(innerPack);
+  innerPack->addReference(innerChannelA);
+  innerPack->addReference(innerChannelB);
+
+  auto document = Document::create();
+  document->add(programme);
+
+  RouteTracer tracer;
+  auto routes = tracer.run(programme);
+  REQUIRE(routes.size() == 3);
+
+  Route expectedOuter;
+  expectedOuter.add(programme);
+  expectedOuter.add(content);
+  expectedOuter.add(object);
+  expectedOuter.add(outerPack);
+  expectedOuter.add(outerChannel);
+  REQUIRE(routes[0] == expectedOuter);
+  REQUIRE(routes[0].hash() == expectedOuter.hash());
+
+  Route expectedInnerB;
+  expectedInnerB.add(programme);
+  expectedInnerB.add(content);
+  expectedInnerB.add(object);
+  expectedInnerB.add(outerPack);
+  expectedInnerB.add(innerPack);
+  expectedInnerB.add(innerChannelB);
+  REQUIRE(routes[2] == expectedInnerB);
+  REQUIRE(routes[1] != routes[2]);
+  REQUIRE(routes[1].size() == 6);
+  REQUIRE(routes[1].getLastOf<AudioChannelFormat>() == innerChannelA);
+
+  // running the same tracer again gives the same routes
+  REQUIRE(tracer.run(programme) == routes);
+
+  SECTION("path") {
+    detail::GenericRouteTracer<Path, detail::DefaultFullDepthStrategy>
+        pathTracer;
+    auto paths = pathTracer.run(programme);
+    REQUIRE(paths.size() == 3);
+    REQUIRE(paths[0].size() == 5);
+    REQUIRE(boost::get<AudioChannelFormatId>(paths[0].back()) ==
+            outerChannel->get<AudioChannelFormatId>());
+  }
+}
+
+struct CountingStrategy : public detail::DefaultFullDepthStrategy {
+  using detail::DefaultFullDepthStrategy::shouldAdd;
+  bool shouldAdd(std::shared_ptr<const AudioChannelFormat>) {
+    ++channelFormatsVisited;
+    return true;
+  }
+  int channelFormatsVisited = 0;
+};
+
+TEST_CASE("cached_pack_formats") {
+  auto document = Document::create();
+  auto programme = AudioProgramme::create(AudioProgrammeName("Programme"));
+  auto content = AudioContent::create(AudioContentName("Content"));
+  programme->addReference(content);
+  document->add(programme);
+
+  auto bed = AudioPackFormat::create(AudioPackFormatName("Bed"),
+                                     TypeDefinition::DIRECT_SPEAKERS);
+  auto subBed = AudioPackFormat::create(AudioPackFormatName("SubBed"),
+                                        TypeDefinition::DIRECT_SPEAKERS);
+  std::vector<std::shared_ptr<AudioChannelFormat>> channels;
+  for (int i = 0; i < 4; ++i) {
+    channels.push_back(AudioChannelFormat::create(
+        AudioChannelFormatName("Channel"), TypeDefinition::DIRECT_SPEAKERS));
+  }
+  document->add(bed);
+  document->add(subBed);
+  bed->addReference(channels[0]);
+  bed->addReference(channels[1]);
+  bed->addReference(subBed);
+  subBed->addReference(channels[2]);
+
+  std::vector<std::shared_ptr<AudioObject>> objects;
+  for (int i = 0; i < 3; ++i) {
+    auto object = AudioObject::create(AudioObjectName("Object"));
+    object->addReference(bed);
+    content->addReference(object);
+    objects.push_back(object);
+  }
+
+  detail::GenericRouteTracer<Route, CountingStrategy> uncachedTracer;
+  auto expectedRoutes = uncachedTracer.run(programme);
+  REQUIRE(expectedRoutes.size() == 9);
+  REQUIRE(uncachedTracer.channelFormatsVisited == 9);
+
+  detail::GenericRouteTracer<Route, CountingStrategy> tracer;
+  REQUIRE_FALSE(tracer.isCacheEnabled());
+  tracer.setCacheEnabled(true);
+  REQUIRE(tracer.isCacheEnabled());
+
+  REQUIRE(tracer.run(programme) == expectedRoutes);
+  REQUIRE(tracer.channelFormatsVisited == 3);
+  REQUIRE(tracer.run(programme) == expectedRoutes);
+  REQUIRE(tracer.channelFormatsVisited == 3);
+
+  SECTION("nested pack format changed") {
+    subBed->addReference(channels[3]);
+    auto routes = tracer.run(programme);
+    REQUIRE(routes.size() == 12);
+    REQUIRE(tracer.channelFormatsVisited == 7);
+    REQUIRE(routes[3].getLastOf<AudioChannelFormat>() == channels[3]);
+    REQUIRE(routes[3].getFirstOf<AudioObject>() == objects[0]);
+    REQUIRE(routes[11].getFirstOf<AudioObject>() == objects[2]);
+    REQUIRE(routes == uncachedTracer.run(programme));
+  }
+
+  SECTION("pack format changed") {
+    bed->removeReference(channels[1]);
+    auto routes = tracer.run(programme);
+    REQUIRE(routes.size() == 6);
+    REQUIRE(routes == uncachedTracer.run(programme));
+  }
+
+  SECTION("cache cleared") {
+    tracer.clearCache();
+    REQUIRE(tracer.run(programme) == expectedRoutes);
+    REQUIRE(tracer.channelFormatsVisited == 6);
+  }
+
+  SECTION("cache disabled") {
+    tracer.setCacheEnabled(false);
+    REQUIRE(tracer.run(programme) == expectedRoutes);
+    REQUIRE(tracer.channelFormatsVisited == 12);
+  }
+}
+
+TEST_CASE("visitor") {
+  auto programme = AudioProgramme::create(AudioProgrammeName("Programme"));
+  auto content = AudioContent::create(AudioContentName("Content"));
+  programme->addReference(content);
+  auto parent = AudioObject::create(AudioObjectName("Parent"));
+  content->addReference(parent);
+  std::vector<SimpleObjectHolder> holders;
+  for (int i = 0; i < 4; ++i) {
+    holders.push_back(createSimpleObject("Object"));
+    parent->addReference(holders.back().audioObject);
+  }
+
+  RouteTracer tracer;
+  auto expectedRoutes = tracer.run(programme);
+  REQUIRE(expectedRoutes.size() == 4);
+
+  SECTION("all routes") {
+    std::vector<Route> routes;
+    REQUIRE(tracer.run(programme, [&routes](const Route& route) {
+      routes.push_back(route);
+      return true;
+    }));
+    REQUIRE(routes == expectedRoutes);
+  }
+
+  SECTION("early termination") {
+    std::vector<Route> routes;
+    REQUIRE_FALSE(tracer.run(programme, [&routes](const Route& route) {
+      routes.push_back(route);
+      return routes.size() < 2;
+    }));
+    REQUIRE(routes.size() == 2);
+    REQUIRE(routes[0] == expectedRoutes[0]);
+    REQUIRE(routes[1] == expectedRoutes[1]);
+  }
+
+  SECTION("early termination with cache") {
+    tracer.setCacheEnabled(true);
+    int count = 0;
+    REQUIRE_FALSE(
+        tracer.run(programme, [&count](const Route&) { return ++count < 3; }));
+    REQUIRE(count == 3);
+    REQUIRE(tracer.run(programme) == expectedRoutes);
+  }
+
+  SECTION("maximum depth") {
+    REQUIRE(tracer.getMaxDepth() == 256);
+    tracer.setMaxDepth(6);
+    REQUIRE(tracer.run(programme) == expectedRoutes);
+    tracer.setMaxDepth(5);
+    REQUIRE_THROWS_AS(tracer.run(programme), error::AdmGenericRuntimeError);
+  }
+}
+
+TEST_CASE("route_set_deduplication") {
+  auto document = Document::create();
+  auto programme = AudioProgramme::create(AudioProgrammeName("Programme"));
+  // 20 contents with 100 objects each, as in a large object-based programme
+  const std::size_t contents = 20;
+  const std::size_t objects = 100;
+  const std::size_t routeCount = contents * objects;
+  for (std::size_t c = 0; c < contents; ++c) {
+    auto content = AudioContent::create(AudioContentName("Content"));
+    programme->addReference(content);
+    for (std::size_t o = 0; o < objects; ++o) {
+      content->addReference(createSimpleObject("Object").audioObject);
+    }
+  }
+  // added in one go, so that free IDs are found in constant time
+  document->add(std::vector<ElementVariant>{programme});
+
+  RouteTracer tracer;
+  auto routes = tracer.run(programme);
+  REQUIRE(routes.size() == routeCount);
+  auto duplicatedRoutes = routes;
+  duplicatedRoutes.insert(duplicatedRoutes.end(), routes.begin(),
+                          routes.end());
+
+  std::vector<Path> paths;
+  for (const auto& route : duplicatedRoutes) {
+    Path path;
+    for (const auto& element : route) {
+      path.add(element);
+    }
+    paths.push_back(path);
+  }
+
+  std::set<Route> routeSet(duplicatedRoutes.begin(), duplicatedRoutes.end());
+  REQUIRE(routeSet.size() == routeCount);
+  std::unordered_set<Route> unorderedRouteSet(duplicatedRoutes.begin(),
+                                              duplicatedRoutes.end());
+  REQUIRE(unorderedRouteSet.size() == routeCount);
+  std::set<Path> pathSet(paths.begin(), paths.end());
+  REQUIRE(pathSet.size() == routeCount);
+  std::unordered_set<Path> unorderedPathSet(paths.begin(), paths.end());
+  REQUIRE(unorderedPathSet.size() == routeCount);
+  REQUIRE(unorderedPathSet.count(paths[0]) == 1);
+
+  BENCHMARK("deduplicate routes with std::set") {
+    return std::set<Route>(duplicatedRoutes.begin(), duplicatedRoutes.end());
+  };
+  BENCHMARK("deduplicate routes with std::unordered_set") {
+    return std::unordered_set<Route>(duplicatedRoutes.begin(),
+                                     duplicatedRoutes.end());
+  };
+  BENCHMARK("deduplicate paths with std::set") {
+    return std::set<Path>(paths.begin(), paths.end());
+  };
+  BENCHMARK("deduplicate paths with std::unordered_set") {
+    return std::unordered_set<Path>(paths.begin(), paths.end());
+  };
+}
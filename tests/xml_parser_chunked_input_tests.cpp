@@ -0,0 +1,131 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/errors.hpp"
+#include "adm/parse.hpp"
+#include "adm/private/xml_element_splitter.hpp"
+#include "adm/write.hpp"
+
+namespace {
+  /// ReadFunction returning @a xml in chunks of at most @a chunkSize
+  adm::xml::ReadFunction chunkReader(std::string xml, std::size_t chunkSize) {
+    auto position = std::make_shared<std::size_t>(0);
+    return [xml, chunkSize, position](char* buffer, std::size_t size) {
+      auto count = std::min({size, chunkSize, xml.size() - *position});
+      std::memcpy(buffer, xml.data() + *position, count);
+      *position += count;
+      return count;
+    };
+  }
+
+  std::string readFile(const std::string& filename) {
+    std::ifstream stream(filename);
+    return std::string(std::istreambuf_iterator<char>(stream),
+                       std::istreambuf_iterator<char>());
+  }
+}  // namespace
+
+TEST_CASE("chunked_input_same_as_stream") {
+  using namespace adm;
+  auto options = xml::WriterOptions::write_default_values;
+  for (auto filename : {"xml_parser/audio_block_format_objects.xml",
+                        "xml_parser/audio_channel_format.xml",
+                        "xml_parser/audio_content.xml",
+                        "xml_parser/audio_object.xml",
+                        "xml_parser/audio_pack_format.xml",
+                        "xml_parser/audio_programme.xml",
+                        "xml_parser/audio_stream_format.xml",
+                        "xml_parser/audio_track_uid.xml",
+                        "xml_parser/find_audio_format_extended_ebu_with_"
+                        "other_metadata.xml"}) {
+    auto expected = writeXmlToString(parseXml(filename), options);
+    auto xml = readFile(filename);
+    for (std::size_t chunkSize : {1, 7, 100000}) {
+      auto document = parseXml(chunkReader(xml, chunkSize));
+      CHECK(writeXmlToString(document, options) == expected);
+    }
+  }
+
+  auto itu = "xml_parser/find_audio_format_extended_itu.xml";
+  auto recursive = xml::ParserOptions::recursive_node_search;
+  auto expected = writeXmlToString(parseXml(itu, recursive), options);
+  auto document = parseXml(chunkReader(readFile(itu), 5), recursive);
+  CHECK(writeXmlToString(document, options) == expected);
+  REQUIRE_THROWS(parseXml(chunkReader(readFile(itu), 5)));
+}
+
+TEST_CASE("chunked_input_markup") {
+  using namespace adm;
+  std::string xml =
+      "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+      "<!DOCTYPE ebuCoreMain [ <!ENTITY test \"<audioObject>\"> ]>\n"
+      "<ebuCoreMain>\n"
+      "<!-- <audioFormatExtended> -->\n"
+      "<coreMetadata><format>\n"
+      "<audioFormatExtended>\n"
+      "  <!-- <audioObject audioObjectID=\"AO_1002\"> -->\n"
+      "  <audioObject audioObjectID=\"AO_1001\" audioObjectName=\"a>b\">\n"
+      "    <![CDATA[</audioObject>]]>\n"
+      "    <audioObjectLabel>label</audioObjectLabel>\n"
+      "  </audioObject>\n"
+      "  <audioContent audioContentID='ACO_1001' audioContentName='c'/>\n"
+      "</audioFormatExtended>\n"
+      "</format></coreMetadata>\n"
+      "</ebuCoreMain>\n"
+      "trailing data is ignored </ebuCoreMain>";
+  for (std::size_t chunkSize : {1, 3, 1000}) {
+    auto document = parseXml(chunkReader(xml, chunkSize));
+    auto object = document->lookup(parseAudioObjectId("AO_1001"));
+    REQUIRE(object);
+    CHECK(object->get<AudioObjectName>() == "a>b");
+    CHECK(document->lookup(parseAudioContentId("ACO_1001")));
+    CHECK_FALSE(document->lookup(parseAudioObjectId("AO_1002")));
+  }
+}
+
+TEST_CASE("chunked_input_errors") {
+  using namespace adm;
+  auto xml = readFile("xml_parser/audio_object.xml");
+  // truncated within audioFormatExtended
+  auto truncated = xml.substr(0, xml.find("</audioObject>"));
+  REQUIRE_THROWS(parseXml(chunkReader(truncated, 10)));
+  REQUIRE_THROWS(parseXml(chunkReader("<ebuCoreMain></ebuCoreMain>", 10)));
+  REQUIRE_THROWS_AS(
+      parseXml(chunkReader(
+          readFile("xml_parser/audio_object_duplicate_id.xml"), 10)),
+      error::XmlParsingDuplicateId);
+  REQUIRE_THROWS_AS(
+      parseXml(chunkReader(
+          "<ebuCoreMain><coreMetadata><format><audioFormatExtended>"
+          "<audioContent audioContentID=\"ACO_1001\" audioContentName=\"c\">"
+          "<audioObjectIDRef>AO_1001</audioObjectIDRef>"
+          "</audioContent>"
+          "</audioFormatExtended></format></coreMetadata></ebuCoreMain>",
+          10)),
+      error::XmlParsingUnresolvedReference);
+}
+
+TEST_CASE("element_splitter_emits_complete_elements") {
+  std::vector<std::string> elements;
+  adm::xml::XmlElementSplitter splitter(
+      true, [&elements](char* xml, std::size_t size) {
+        CHECK(xml[size] == '\0');
+        elements.emplace_back(xml, size);
+      });
+  std::string start = "<audioFormatExtended><a x=\"1\">text</a><b/><c>";
+  splitter.write(start.data(), start.size());
+  REQUIRE(elements.size() == 2);
+  CHECK(elements[0] == "<a x=\"1\">text</a>");
+  CHECK(elements[1] == "<b/>");
+
+  std::string end = "<d/></c></audioFormatExtended>";
+  splitter.write(end.data(), end.size());
+  splitter.finish();
+  REQUIRE(elements.size() == 3);
+  CHECK(elements[2] == "<c><d/></c>");
+}
@@ -0,0 +1,152 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/errors.hpp"
+#include "adm/parse.hpp"
+#include "adm/parser_filter.hpp"
+#include "adm/utilities/id_assignment.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "adm/write.hpp"
+
+namespace {
+  /// XML of a document with `programmes` programmes with `objects` objects
+  std::string createXml(unsigned int programmes, unsigned int objects) {
+    using namespace adm;
+    auto document = Document::create();
+    for (unsigned int i = 0; i < programmes; ++i) {
+      auto programme =
+          AudioProgramme::create(AudioProgrammeName("Programme"));
+      auto content = AudioContent::create(AudioContentName("Content"));
+      for (unsigned int j = 0; j < objects; ++j) {
+        auto result = createSimpleObject("Object");
+        for (int k = 0; k < 10; ++k) {
+          result.audioChannelFormat->add(AudioBlockFormatObjects(
+              SphericalPosition(Azimuth(static_cast<float>(k)))));
+        }
+        content->addReference(result.audioObject);
+      }
+      programme->addReference(content);
+      document->add(programme);
+    }
+    std::ostringstream stream;
+    writeXml(stream, document);
+    return stream.str();
+  }
+
+  std::shared_ptr<adm::Document> parseString(
+      const std::string& xml, const adm::xml::ParserFilter& filter) {
+    std::istringstream stream(xml);
+    return adm::parseXml(stream, filter);
+  }
+
+  template <typename Element>
+  std::size_t count(const std::shared_ptr<adm::Document>& document) {
+    return document->getElements<Element>().size();
+  }
+}  // namespace
+
+TEST_CASE("parser_filter_none") {
+  using namespace adm;
+  auto xml = createXml(2, 2);
+  std::istringstream stream(xml);
+  auto expected = parseXml(stream);
+  auto document = parseString(xml, xml::ParserFilter());
+  CHECK(count<AudioProgramme>(document) == count<AudioProgramme>(expected));
+  CHECK(count<AudioTrackUid>(document) == count<AudioTrackUid>(expected));
+  CHECK(count<AudioChannelFormat>(document) ==
+        count<AudioChannelFormat>(expected));
+}
+
+TEST_CASE("parser_filter_programme") {
+  using namespace adm;
+  auto xml = createXml(3, 2);
+  auto document = parseString(
+      xml, xml::ParserFilter().setProgramme(
+               parseAudioProgrammeId("APR_1002")));
+
+  REQUIRE(count<AudioProgramme>(document) == 1);
+  auto programme = document->lookup(parseAudioProgrammeId("APR_1002"));
+  REQUIRE(programme != nullptr);
+  CHECK(document->lookup(parseAudioProgrammeId("APR_1001")) == nullptr);
+  CHECK(count<AudioContent>(document) == 1);
+  CHECK(count<AudioObject>(document) == 2);
+  CHECK(count<AudioTrackUid>(document) == 2);
+  CHECK(document->lookup(parseAudioTrackUidId("ATU_00000001")) == nullptr);
+
+  auto content = programme->getReferences<AudioContent>()[0];
+  for (auto& object : content->getReferences<AudioObject>()) {
+    auto trackUid = object->getReferences<AudioTrackUid>()[0];
+    auto trackFormat = trackUid->getReference<AudioTrackFormat>();
+    REQUIRE(trackFormat != nullptr);
+    auto streamFormat = trackFormat->getReference<AudioStreamFormat>();
+    REQUIRE(streamFormat != nullptr);
+    auto channelFormat = streamFormat->getReference<AudioChannelFormat>();
+    REQUIRE(channelFormat != nullptr);
+    CHECK(channelFormat->getElements<AudioBlockFormatObjects>().size() == 10);
+  }
+
+  CHECK_THROWS_AS(
+      parseString(xml, xml::ParserFilter().setProgramme(
+                           parseAudioProgrammeId("APR_1004"))),
+      std::runtime_error);
+}
+
+TEST_CASE("parser_filter_skip") {
+  using namespace adm;
+  auto xml = createXml(2, 2);
+  auto document =
+      parseString(xml, xml::ParserFilter()
+                           .skip<AudioTrackUid>()
+                           .skip<AudioChannelFormat>());
+  CHECK(count<AudioTrackUid>(document) == 0);
+  CHECK(count<AudioObject>(document) == 4);
+  // only the common definitions are left
+  for (auto& channelFormat : document->getElements<AudioChannelFormat>()) {
+    CHECK(isCommonDefinitionsId(channelFormat->get<AudioChannelFormatId>()));
+  }
+  for (auto& object : document->getElements<AudioObject>()) {
+    CHECK(object->getReferences<AudioTrackUid>().empty());
+    CHECK(object->getReferences<AudioPackFormat>().size() == 1);
+  }
+}
+
+TEST_CASE("parser_filter_id_predicate") {
+  using namespace adm;
+  auto xml = createXml(2, 2);
+  auto excluded = parseAudioObjectId("AO_1001");
+  xml::ParserFilter filter;
+  filter.setIdPredicate([&excluded](const ElementIdVariant& id) {
+    return !(id == ElementIdVariant(excluded));
+  });
+
+  SECTION("all programmes") {
+    auto document = parseString(xml, filter);
+    CHECK(count<AudioObject>(document) == 3);
+    CHECK(document->lookup(excluded) == nullptr);
+    auto content = document->lookup(parseAudioContentId("ACO_1001"));
+    REQUIRE(content != nullptr);
+    CHECK(content->getReferences<AudioObject>().size() == 1);
+  }
+  SECTION("with programme") {
+    filter.setProgramme(parseAudioProgrammeId("APR_1001"));
+    auto document = parseString(xml, filter);
+    CHECK(count<AudioObject>(document) == 1);
+    // references are not followed through filtered elements
+    CHECK(document->lookup(parseAudioTrackUidId("ATU_00000001")) == nullptr);
+    CHECK(document->lookup(parseAudioTrackUidId("ATU_00000002")) != nullptr);
+  }
+}
+
+TEST_CASE("parser_filter_benchmark") {
+  using namespace adm;
+  auto xml = createXml(8, 4);
+  xml::ParserFilter filter;
+  filter.setProgramme(parseAudioProgrammeId("APR_1001"));
+
+  BENCHMARK("parse all programmes") {
+    return parseString(xml, xml::ParserFilter());
+  };
+
+  BENCHMARK("parse one programme") { return parseString(xml, filter); };
+}
@@ -0,0 +1,282 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/errors.hpp"
+#include "adm/parse.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "adm/write.hpp"
+#include "helper/block_formats.hpp"
+
+namespace {
+  using namespace std::chrono;
+
+  std::string writeFrame(adm::xml::FrameWriter& writer) {
+    std::ostringstream stream;
+    writer.writeFrame(stream);
+    return stream.str();
+  }
+
+  void parseFrame(adm::xml::FrameParser& parser, const std::string& frame) {
+    parser.parseFrame(frame.data(), frame.size());
+  }
+
+  /// Frame with one block format of the channel of `createObjectDocument()`
+  std::string createFrame(nanoseconds start, const std::string& timeReference,
+                          unsigned int counter, nanoseconds rtime) {
+    using namespace adm;
+    auto id = AudioBlockFormatId(TypeDefinition::OBJECTS,
+                                 AudioBlockFormatIdValue(0x1001),
+                                 AudioBlockFormatIdCounter(counter));
+    return "<frame version=\"ITU-R_BS.2125-1\"><frameHeader>"
+           "<frameFormat frameFormatID=\"FF_00000002\" type=\"full\" "
+           "start=\"" +
+           formatTimecode(start) +
+           "\" duration=\"00:00:00.02000\" "
+           "timeReference=\"" +
+           timeReference +
+           "\"/></frameHeader>"
+           "<audioFormatExtended>"
+           "<audioChannelFormat audioChannelFormatID=\"AC_00031001\" "
+           "audioChannelFormatName=\"Object\" typeLabel=\"0003\">"
+           "<audioBlockFormat audioBlockFormatID=\"" +
+           formatId(id) + "\" rtime=\"" + formatTimecode(rtime) +
+           "\" duration=\"00:00:00.01000\">"
+           "<position coordinate=\"azimuth\">0</position>"
+           "<position coordinate=\"elevation\">0</position>"
+           "</audioBlockFormat></audioChannelFormat>"
+           "</audioFormatExtended></frame>";
+  }
+
+  std::shared_ptr<adm::AudioChannelFormat> getChannelFormat(
+      const std::shared_ptr<adm::Document>& document) {
+    return document->lookup(adm::parseAudioChannelFormatId("AC_00031001"));
+  }
+}  // namespace
+
+TEST_CASE("frame_parser_round_trip") {
+  using namespace adm;
+  auto source = createObjectDocument(10);
+  xml::FrameWriter writer(source, milliseconds(20));
+  xml::FrameParser parser;
+  auto document = parser.getDocument();
+  REQUIRE(document->lookup(parseAudioPackFormatId("AP_00010002")) != nullptr);
+
+  parseFrame(parser, writeFrame(writer));
+  auto object = document->lookup(parseAudioObjectId("AO_1001"));
+  auto channelFormat = getChannelFormat(document);
+  REQUIRE(object != nullptr);
+  REQUIRE(channelFormat != nullptr);
+  CHECK(channelFormat->getElements<AudioBlockFormatObjects>().size() == 2);
+
+  for (int i = 0; i < 4; ++i) {
+    parseFrame(parser, writeFrame(writer));
+  }
+  CHECK(channelFormat->getElements<AudioBlockFormatObjects>().size() == 10);
+  // the elements are updated, not replaced
+  CHECK(document->lookup(parseAudioObjectId("AO_1001")) == object);
+  CHECK(getChannelFormat(document) == channelFormat);
+  CHECK(writeXmlToString(document) == writeXmlToString(source));
+}
+
+TEST_CASE("frame_parser_updates_elements") {
+  using namespace adm;
+  auto source = createObjectDocument(4);
+  auto sourceObject = source->lookup(parseAudioObjectId("AO_1001"));
+  auto sourceChannelFormat = getChannelFormat(source);
+  xml::FrameWriter writer(source, milliseconds(20));
+  xml::FrameParser parser;
+  auto document = parser.getDocument();
+  parseFrame(parser, writeFrame(writer));
+  auto object = document->lookup(parseAudioObjectId("AO_1001"));
+  auto channelFormat = getChannelFormat(document);
+
+  // modified parameters, references and block formats
+  sourceObject->set(AudioObjectName("Renamed"));
+  sourceObject->set(Importance(5));
+  auto other = createSimpleObject("Other");
+  sourceObject->addReference(other.audioObject);
+  auto blockFormat = createBlockFormat(1);
+  blockFormat.set(SphericalPosition(Azimuth(30.f)));
+  sourceChannelFormat->getElements<AudioBlockFormatObjects>()[1] = blockFormat;
+  sourceChannelFormat->add(createBlockFormat(4));
+
+  // rewrite the first frame, then continue with the second one
+  xml::FrameWriter newWriter(source, milliseconds(20));
+  auto revision = object->getRevision();
+  parseFrame(parser, writeFrame(newWriter));
+  CHECK(document->lookup(parseAudioObjectId("AO_1001")) == object);
+  CHECK(object->getRevision() != revision);
+  CHECK(object->get<AudioObjectName>() == "Renamed");
+  CHECK(object->get<Importance>() == 5);
+  auto objects = object->getReferences<AudioObject>();
+  REQUIRE(objects.size() == 1);
+  CHECK(objects[0]->get<AudioObjectName>() == "Other");
+  auto blockFormats = channelFormat->getElements<AudioBlockFormatObjects>();
+  REQUIRE(blockFormats.size() == 2);
+  CHECK(blockFormats[1].get<SphericalPosition>().get<Azimuth>() == 30.f);
+
+  parseFrame(parser, writeFrame(newWriter));
+  parseFrame(parser, writeFrame(newWriter));
+  CHECK(channelFormat->getElements<AudioBlockFormatObjects>().size() == 5);
+
+  // removed parameters and references
+  sourceObject->unset<Importance>();
+  sourceObject->removeReference(other.audioObject);
+  parseFrame(parser, writeFrame(newWriter));
+  CHECK_FALSE(object->has<Importance>());
+  CHECK(object->getReferences<AudioObject>().empty());
+  CHECK(writeXmlToString(document) == writeXmlToString(source));
+}
+
+TEST_CASE("frame_parser_skips_unchanged_elements") {
+  using namespace adm;
+  auto source = createObjectDocument(4);
+  xml::FrameWriter writer(source, milliseconds(20));
+  xml::FrameParser parser;
+  auto document = parser.getDocument();
+  parseFrame(parser, writeFrame(writer));
+  auto object = document->lookup(parseAudioObjectId("AO_1001"));
+  auto channelFormat = getChannelFormat(document);
+  auto objectRevision = object->getRevision();
+  auto channelFormatRevision = channelFormat->getRevision();
+
+  parseFrame(parser, writeFrame(writer));
+  CHECK(object->getRevision() == objectRevision);
+  CHECK(channelFormat->getRevision() != channelFormatRevision);
+
+  // a frame which is applied again does not change anything
+  xml::FrameWriter newWriter(source, milliseconds(20));
+  auto frame = writeFrame(newWriter);
+  parseFrame(parser, frame);
+  channelFormatRevision = channelFormat->getRevision();
+  parseFrame(parser, frame);
+  CHECK(channelFormat->getRevision() == channelFormatRevision);
+  CHECK(channelFormat->getElements<AudioBlockFormatObjects>().size() == 4);
+}
+
+TEST_CASE("frame_parser_local_time_reference") {
+  using namespace adm;
+  auto document = createObjectDocument(0);
+  xml::FrameParser parser(document);
+  parseFrame(parser,
+             createFrame(milliseconds(20), "local", 3, milliseconds(5)));
+  auto channelFormat = getChannelFormat(document);
+  auto blockFormats = channelFormat->getElements<AudioBlockFormatObjects>();
+  REQUIRE(blockFormats.size() == 1);
+  CHECK(blockFormats[0].get<Rtime>().get() == milliseconds(25));
+
+  // the same local XML in a frame with a different start is not skipped
+  parseFrame(parser,
+             createFrame(milliseconds(40), "local", 3, milliseconds(5)));
+  blockFormats = channelFormat->getElements<AudioBlockFormatObjects>();
+  REQUIRE(blockFormats.size() == 1);
+  CHECK(blockFormats[0].get<Rtime>().get() == milliseconds(45));
+}
+
+TEST_CASE("frame_parser_keeps_block_formats_shareable") {
+  using namespace adm;
+  auto document = createObjectDocument(0);
+  xml::FrameParser parser(document);
+  parseFrame(parser,
+             createFrame(milliseconds(20), "local", 1, milliseconds(5)));
+  parseFrame(parser,
+             createFrame(milliseconds(40), "local", 1, milliseconds(5)));
+  // the parser does not hand out mutable ranges, so copies still share
+  // the audioBlockFormats
+  std::shared_ptr<const AudioChannelFormat> channelFormat =
+      getChannelFormat(document);
+  std::shared_ptr<const AudioChannelFormat> copy = channelFormat->copy();
+  CHECK(&copy->getElements<AudioBlockFormatObjects>()[0] ==
+        &channelFormat->getElements<AudioBlockFormatObjects>()[0]);
+}
+
+TEST_CASE("frame_parser_modified_between_frames") {
+  using namespace adm;
+  auto document = createObjectDocument(0);
+  xml::FrameParser parser(document);
+  auto channelFormat = getChannelFormat(document);
+  parseFrame(parser, createFrame(milliseconds(0), "total", 1,
+                                 milliseconds(0)));
+
+  // block formats added and changed outside of the parser are found by the
+  // following frames
+  channelFormat->add(createBlockFormat(1));
+  parseFrame(parser, createFrame(milliseconds(20), "total", 2,
+                                 milliseconds(25)));
+  auto renamedId = createBlockFormat(2).get<AudioBlockFormatId>();
+  channelFormat->getElements<AudioBlockFormatObjects>()[0].set(renamedId);
+  parseFrame(parser, createFrame(milliseconds(20), "total", 3,
+                                 milliseconds(30)));
+  parseFrame(parser, createFrame(milliseconds(40), "total", 4,
+                                 milliseconds(40)));
+
+  auto blockFormats = channelFormat->getElements<AudioBlockFormatObjects>();
+  REQUIRE(blockFormats.size() == 3);
+  CHECK(blockFormats[0].get<AudioBlockFormatId>() == renamedId);
+  CHECK(blockFormats[0].get<Rtime>().get() == milliseconds(30));
+  CHECK(blockFormats[1].get<Rtime>().get() == milliseconds(25));
+  CHECK(blockFormats[2].get<Rtime>().get() == milliseconds(40));
+}
+
+TEST_CASE("frame_parser_errors") {
+  using namespace adm;
+  xml::FrameParser parser;
+  std::istringstream noFrame("<ebuCoreMain/>");
+  REQUIRE_THROWS(parser.parseFrame(noFrame));
+
+  std::string unresolved =
+      "<frame><audioFormatExtended>"
+      "<audioObject audioObjectID=\"AO_1001\" audioObjectName=\"Object\">"
+      "<audioPackFormatIDRef>AP_00031002</audioPackFormatIDRef>"
+      "</audioObject></audioFormatExtended></frame>";
+  REQUIRE_THROWS_AS(parseFrame(parser, unresolved),
+                    adm::error::XmlParsingUnresolvedReference);
+}
+
+TEST_CASE("frame_parser_benchmark") {
+  using namespace adm;
+  auto source = createObjectDocument(100);
+  std::vector<std::string> frames;
+  xml::FrameWriter writer(source, milliseconds(20));
+  for (int i = 0; i < 5; ++i) {
+    frames.push_back(writeFrame(writer));
+  }
+
+  BENCHMARK("apply 5 frames to a document") {
+    xml::FrameParser parser(createObjectDocument(0));
+    for (auto& frame : frames) {
+      parseFrame(parser, frame);
+    }
+    return parser.getDocument();
+  };
+
+  BENCHMARK("parse 5 frames as documents") {
+    std::shared_ptr<Document> document;
+    for (auto& frame : frames) {
+      std::istringstream stream(frame);
+      document = parseXml(stream, xml::ParserOptions::recursive_node_search);
+    }
+    return document;
+  };
+}
+
+TEST_CASE("frame_parser_long_stream_benchmark") {
+  using namespace adm;
+  // the time to apply a frame does not depend on the length of the stream
+  const unsigned int existing = 10000;
+  auto document = createObjectDocument(existing);
+  xml::FrameParser parser(document);
+  unsigned int counter = existing;
+
+  BENCHMARK_ADVANCED("apply a frame after 10000 block formats")
+  (Catch::Benchmark::Chronometer meter) {
+    std::vector<std::string> frames;
+    for (int i = 0; i < meter.runs(); ++i) {
+      ++counter;
+      frames.push_back(createFrame(milliseconds(0), "total", counter,
+                                   milliseconds(10) * (counter - 1)));
+    }
+    meter.measure([&](int i) { parseFrame(parser, frames[i]); });
+  };
+}
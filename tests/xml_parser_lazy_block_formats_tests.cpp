@@ -0,0 +1,204 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/parse.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "adm/write.hpp"
+#include "helper/block_formats.hpp"
+
+namespace {
+  using namespace std::chrono;
+
+  const auto LAZY = adm::xml::ParserOptions::lazy_block_formats;
+
+  std::string toXml(const std::shared_ptr<const adm::Document>& document) {
+    std::ostringstream stream;
+    adm::writeXml(stream, document);
+    return stream.str();
+  }
+
+  std::shared_ptr<adm::Document> parseString(
+      const std::string& xml,
+      adm::xml::ParserOptions options = adm::xml::ParserOptions::none) {
+    std::istringstream stream(xml);
+    return adm::parseXml(stream, options);
+  }
+
+  /// XML of a document with `objects` objects with `count` block formats
+  std::string createXml(unsigned int objects, unsigned int count) {
+    using namespace adm;
+    auto document = Document::create();
+    for (unsigned int i = 0; i < objects; ++i) {
+      auto result = createSimpleObject("Object " + std::to_string(i));
+      addBlockFormats(*result.audioChannelFormat, count);
+      document->add(result.audioObject);
+    }
+    return toXml(document);
+  }
+
+  std::shared_ptr<adm::AudioChannelFormat> getChannelFormat(
+      const std::shared_ptr<adm::Document>& document) {
+    return document->lookup(adm::parseAudioChannelFormatId("AC_00031001"));
+  }
+}  // namespace
+
+TEST_CASE("lazy_block_formats_same_result") {
+  using namespace adm;
+  for (auto filename : {"xml_parser/audio_block_format_objects.xml",
+                        "xml_parser/audio_block_format_direct_speakers.xml",
+                        "xml_parser/with_common_definitions.xml"}) {
+    auto eager = parseXml(filename);
+    auto lazy = parseXml(filename, LAZY);
+    CHECK(toXml(lazy) == toXml(eager));
+  }
+}
+
+TEST_CASE("lazy_block_formats_materialised_on_access") {
+  using namespace adm;
+  auto document = parseString(createXml(1, 3), LAZY);
+  auto channelFormat = getChannelFormat(document);
+  auto revision = channelFormat->getRevision();
+
+  std::shared_ptr<const AudioChannelFormat> constChannelFormat =
+      channelFormat;
+  auto blockFormats =
+      constChannelFormat->getElements<AudioBlockFormatObjects>();
+  REQUIRE(blockFormats.size() == 3);
+  CHECK(blockFormats[2].get<AudioBlockFormatId>() ==
+        parseAudioBlockFormatId("AB_00031001_00000003"));
+  CHECK(blockFormats[2].get<Rtime>().get() == milliseconds(20));
+  CHECK(constChannelFormat->getRevision() == revision);
+  CHECK(channelFormat->getElements<AudioBlockFormatDirectSpeakers>().empty());
+}
+
+TEST_CASE("lazy_block_formats_modification") {
+  using namespace adm;
+  auto document = parseString(createXml(1, 3), LAZY);
+
+  SECTION("add") {
+    // added before the parsed audioBlockFormats are accessed, the result
+    // is the same as with eager parsing
+    auto eager = parseString(createXml(1, 3));
+    for (auto& channelFormat :
+         {getChannelFormat(document), getChannelFormat(eager)}) {
+      channelFormat->add(AudioBlockFormatObjects(
+          SphericalPosition(Azimuth(42.f)), Rtime(milliseconds(30))));
+    }
+    auto blockFormats =
+        getChannelFormat(document)->getElements<AudioBlockFormatObjects>();
+    auto expected =
+        getChannelFormat(eager)->getElements<AudioBlockFormatObjects>();
+    REQUIRE(blockFormats.size() == 4);
+    REQUIRE(expected.size() == 4);
+    for (std::size_t i = 0; i < 4; ++i) {
+      auto id = AudioBlockFormatId(TypeDefinition::OBJECTS,
+                                   AudioBlockFormatIdValue(0x1001),
+                                   AudioBlockFormatIdCounter(i + 1));
+      CHECK(expected[i].get<AudioBlockFormatId>() == id);
+      CHECK(blockFormats[i].get<AudioBlockFormatId>() == id);
+      CHECK(blockFormats[i].get<Rtime>().get() ==
+            expected[i].get<Rtime>().get());
+      CHECK(blockFormats[i].get<SphericalPosition>().get<Azimuth>() ==
+            expected[i].get<SphericalPosition>().get<Azimuth>());
+    }
+    CHECK(blockFormats[0].get<SphericalPosition>().get<Azimuth>() == -180.f);
+    CHECK(blockFormats[2].get<Rtime>().get() == milliseconds(20));
+    CHECK(blockFormats[3].get<SphericalPosition>().get<Azimuth>() == 42.f);
+    CHECK(toXml(document) == toXml(eager));
+  }
+  SECTION("clear") {
+    auto channelFormat = getChannelFormat(document);
+    channelFormat->clearAudioBlockFormats();
+    CHECK(channelFormat->getElements<AudioBlockFormatObjects>().empty());
+  }
+  SECTION("copy") {
+    auto copy = document->deepCopy();
+    getChannelFormat(document)->clearAudioBlockFormats();
+    CHECK(getChannelFormat(copy)
+              ->getElements<AudioBlockFormatObjects>()
+              .size() == 3);
+  }
+  SECTION("set id") {
+    auto channelFormat = getChannelFormat(document);
+    channelFormat->set(parseAudioChannelFormatId("AC_00031002"));
+    auto blockFormats = channelFormat->getElements<AudioBlockFormatObjects>();
+    REQUIRE(blockFormats.size() == 3);
+    CHECK(blockFormats[0].get<AudioBlockFormatId>() ==
+          parseAudioBlockFormatId("AB_00031002_00000001"));
+  }
+}
+
+TEST_CASE("lazy_block_formats_errors") {
+  using namespace adm;
+  auto xml = createXml(1, 1);
+  auto blockFormat = xml.find(">", xml.find("<audioBlockFormat "));
+  xml.insert(blockFormat + 1, "<gain>invalid</gain>");
+
+  CHECK_THROWS(parseString(xml));
+  auto document = parseString(xml, LAZY);
+  auto channelFormat = getChannelFormat(document);
+  CHECK_THROWS(channelFormat->getElements<AudioBlockFormatObjects>());
+  // the next access fails again instead of returning partial results
+  CHECK_THROWS(channelFormat->getElements<AudioBlockFormatObjects>());
+  // modifications parse the audioBlockFormats first
+  CHECK_THROWS(
+      channelFormat->add(AudioBlockFormatObjects(SphericalPosition())));
+  CHECK_THROWS(channelFormat->clearAudioBlockFormats());
+  CHECK_THROWS(channelFormat->getElements<AudioBlockFormatObjects>());
+}
+
+TEST_CASE("lazy_block_formats_concurrent_access") {
+  using namespace adm;
+  auto xml = createXml(4, 100);
+  auto eager = parseString(xml);
+  auto expected = toXml(eager);
+  std::shared_ptr<const Document> document = parseString(xml, LAZY);
+  auto generation = document->getGeneration();
+
+  // every thread reads all audioBlockFormats, so that the same
+  // audioChannelFormats are parsed by several threads at once
+  std::vector<std::string> results(4);
+  std::vector<std::size_t> counts(results.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&document, &results, &counts, i]() {
+      for (const auto& channelFormat :
+           document->getElements<AudioChannelFormat>()) {
+        counts[i] +=
+            channelFormat->getElements<AudioBlockFormatObjects>().size();
+      }
+      results[i] = toXml(document);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    CHECK(counts[i] == 400);
+    CHECK(results[i] == expected);
+  }
+  // parsing is not a modification
+  CHECK(document->getGeneration() == generation);
+  CHECK(document->getContentHash() == eager->getContentHash());
+}
+
+TEST_CASE("lazy_block_formats_benchmark") {
+  using namespace adm;
+  auto xml = createXml(4, 500);
+
+  BENCHMARK("parse eagerly") { return parseString(xml); };
+
+  BENCHMARK("parse lazily") { return parseString(xml, LAZY); };
+
+  BENCHMARK("parse lazily and access all block formats") {
+    auto document = parseString(xml, LAZY);
+    std::size_t count = 0;
+    for (auto& channelFormat : document->getElements<AudioChannelFormat>()) {
+      count += channelFormat->getElements<AudioBlockFormatObjects>().size();
+    }
+    return count;
+  };
+}
@@ -1,6 +1,11 @@
 #include <catch2/catch.hpp>
+#include "adm/document.hpp"
+#include "adm/parse.hpp"
+#include "adm/write.hpp"
 #include "adm/private/rapidxml_utils.hpp"
-#include "adm/private/rapidxml_wrapper.hpp"
+#include "rapidxml/rapidxml.hpp"
+#include "rapidxml/rapidxml_utils.hpp"
+#include <sstream>
 
 TEST_CASE("line_number_calculation") {
   using namespace adm;
@@ -27,3 +32,28 @@ TEST_CASE("line_number_calculation") {
     REQUIRE(p == 3);
   }
 }
+
+TEST_CASE("reusable_parser") {
+  using namespace adm;
+  auto options = xml::WriterOptions::write_default_values;
+  xml::Parser parser;
+  for (int i = 0; i < 2; ++i) {
+    for (auto filename : {"xml_parser/audio_channel_format.xml",
+                          "xml_parser/audio_content.xml"}) {
+      auto expected = writeXmlToString(parseXml(filename), options);
+      auto document = parser.parseFile(filename);
+      CHECK(writeXmlToString(document, options) == expected);
+      // common definitions are added to every document
+      CHECK(document->lookup(parseAudioPackFormatId("AP_00010002")));
+    }
+
+    std::istringstream invalid("<audioFormatExtended><audioObject>");
+    REQUIRE_THROWS(parser.parse(invalid));
+    std::istringstream duplicate(
+        "<audioFormatExtended>"
+        "<audioContent audioContentID=\"ACO_1001\"/>"
+        "<audioContent audioContentID=\"ACO_1001\"/>"
+        "</audioFormatExtended>");
+    REQUIRE_THROWS(parser.parse(duplicate));
+  }
+}
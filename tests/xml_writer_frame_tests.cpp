@@ -0,0 +1,139 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/parse.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "adm/write.hpp"
+#include "helper/block_formats.hpp"
+
+namespace {
+  using namespace std::chrono;
+
+  /// Counters of the block formats of channel format AC_00031001 in a frame
+  std::vector<unsigned int> frameBlockFormats(const std::string& frame) {
+    using namespace adm;
+    std::istringstream stream(frame);
+    auto document =
+        parseXml(stream, xml::ParserOptions::recursive_node_search);
+    auto channelFormat =
+        document->lookup(parseAudioChannelFormatId("AC_00031001"));
+    std::vector<unsigned int> counters;
+    for (auto& blockFormat :
+         channelFormat->getElements<AudioBlockFormatObjects>()) {
+      counters.push_back(blockFormat.get<AudioBlockFormatId>()
+                             .get<AudioBlockFormatIdCounter>()
+                             .get());
+    }
+    return counters;
+  }
+
+  std::string writeFrame(adm::xml::FrameWriter& writer) {
+    std::ostringstream stream;
+    writer.writeFrame(stream);
+    return stream.str();
+  }
+}  // namespace
+
+TEST_CASE("frame_writer_time_windows") {
+  using namespace adm;
+  auto document = createObjectDocument(10);
+  xml::FrameWriter writer(document, milliseconds(20));
+
+  CHECK(writer.frameIndex() == 0);
+  auto frame = writeFrame(writer);
+  CHECK(frame.find("<frame version=\"ITU-R_BS.2125-1\">") !=
+        std::string::npos);
+  CHECK(frame.find("<frameFormat frameFormatID=\"FF_00000001\" type=\"full\" "
+                   "start=\"00:00:00.000000000\" "
+                   "duration=\"00:00:00.020000000\" "
+                   "timeReference=\"total\"/>") != std::string::npos);
+  CHECK(frame.find("<audioObject audioObjectID=\"AO_1001\"") !=
+        std::string::npos);
+  CHECK(frameBlockFormats(frame) == std::vector<unsigned int>{1, 2});
+
+  CHECK(writer.frameIndex() == 1);
+  CHECK(writer.frameStart() == milliseconds(20));
+  frame = writeFrame(writer);
+  CHECK(frame.find("frameFormatID=\"FF_00000002\"") != std::string::npos);
+  CHECK(frameBlockFormats(frame) == std::vector<unsigned int>{3, 4});
+
+  // frames which are not aligned with the block formats
+  xml::FrameWriter unaligned(document, milliseconds(15));
+  CHECK(frameBlockFormats(writeFrame(unaligned)) ==
+        std::vector<unsigned int>{1, 2});
+  CHECK(frameBlockFormats(writeFrame(unaligned)) ==
+        std::vector<unsigned int>{2, 3});
+  CHECK(frameBlockFormats(writeFrame(unaligned)) ==
+        std::vector<unsigned int>{4, 5});
+
+  // frames after the last block format
+  xml::FrameWriter late(document, milliseconds(100));
+  CHECK(frameBlockFormats(writeFrame(late)).size() == 10);
+  CHECK(frameBlockFormats(writeFrame(late)).empty());
+
+  REQUIRE_THROWS(xml::FrameWriter(document, milliseconds(0)));
+}
+
+TEST_CASE("frame_writer_block_format_without_duration") {
+  using namespace adm;
+  auto document = Document::create();
+  auto result = createSimpleObject("Object");
+  result.audioChannelFormat->add(
+      AudioBlockFormatObjects(SphericalPosition()));
+  document->add(result.audioObject);
+  xml::FrameWriter writer(document, milliseconds(20));
+  for (int i = 0; i < 3; ++i) {
+    CHECK(frameBlockFormats(writeFrame(writer)).size() == 1);
+  }
+}
+
+TEST_CASE("frame_writer_document_changes") {
+  using namespace adm;
+  auto document = createObjectDocument(2);
+  auto object = document->lookup(parseAudioObjectId("AO_1001"));
+  auto channelFormat =
+      document->lookup(parseAudioChannelFormatId("AC_00031001"));
+  xml::FrameWriter writer(document, milliseconds(20));
+  CHECK(frameBlockFormats(writeFrame(writer)) ==
+        std::vector<unsigned int>{1, 2});
+
+  // block formats for the next frames arrive while streaming
+  channelFormat->add(createBlockFormat(2));
+  channelFormat->add(createBlockFormat(3));
+  object->set(AudioObjectName("Renamed"));
+  auto frame = writeFrame(writer);
+  CHECK(frameBlockFormats(frame) == std::vector<unsigned int>{3, 4});
+  CHECK(frame.find("audioObjectName=\"Renamed\"") != std::string::npos);
+
+  // the frames are the same with a new writer
+  xml::FrameWriter newWriter(document, milliseconds(20));
+  writeFrame(newWriter);
+  CHECK(writeFrame(newWriter) == frame);
+
+  std::vector<char> buffer;
+  xml::FrameWriter bufferWriter(document, milliseconds(20));
+  bufferWriter.writeFrame(buffer);
+  bufferWriter.writeFrame(buffer);
+  auto firstFrameSize = buffer.size() - frame.size();
+  CHECK(std::string(buffer.begin() + firstFrameSize, buffer.end()) == frame);
+}
+
+TEST_CASE("frame_writer_benchmark") {
+  using namespace adm;
+  auto document = createObjectDocument(5000);
+
+  BENCHMARK("write 100 frames of 5000 audioBlockFormats") {
+    xml::FrameWriter writer(document, milliseconds(20));
+    std::vector<char> buffer;
+    for (int i = 0; i < 100; ++i) {
+      buffer.clear();
+      writer.writeFrame(buffer);
+    }
+    return buffer.size();
+  };
+
+  BENCHMARK("write the complete document") {
+    return writeXmlToString(document).size();
+  };
+}
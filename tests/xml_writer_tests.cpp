@@ -1,10 +1,15 @@
 #include <catch2/catch.hpp>
 #include "adm/document.hpp"
 #include "adm/elements.hpp"
+#include "adm/private/xml_writer.hpp"
 #include "adm/utilities/id_assignment.hpp"
 #include "adm/utilities/object_creation.hpp"
 #include "adm/write.hpp"
+#include "helper/block_formats.hpp"
 #include "helper/file_comparator.hpp"
+#include "rapidxml/rapidxml.hpp"
+#include "rapidxml/rapidxml_print.hpp"
+#include <vector>
 
 std::shared_ptr<const adm::Document> createSimpleScene();
 
@@ -57,6 +62,222 @@ TEST_CASE("write_complementary_audio_objects") {
   CHECK_THAT(xml.str(), EqualsXmlFile("write_complementary_audio_objects"));
 }
 
+/// parse xml with rapidxml and print it again
+std::string reprintWithRapidXml(const std::string& xml) {
+  std::vector<char> buffer(xml.begin(), xml.end());
+  buffer.push_back('\0');
+  rapidxml::xml_document<> xmlDocument;
+  xmlDocument.parse<rapidxml::parse_declaration_node>(buffer.data());
+  std::string printed;
+  rapidxml::print(std::back_inserter(printed), xmlDocument);
+  return printed;
+}
+
+TEST_CASE("write_escaped_characters") {
+  using namespace adm;
+  auto document = Document::create();
+  document->add(AudioObject::create(AudioObjectName("<a> & 'b'")));
+  document->add(AudioObject::create(AudioObjectName("\"c\" & 'd'")));
+  auto channelFormat = AudioChannelFormat::create(
+      AudioChannelFormatName("channel"), TypeDefinition::DIRECT_SPEAKERS);
+  AudioBlockFormatDirectSpeakers blockFormat(SpeakerPosition(Azimuth(30)));
+  blockFormat.add(SpeakerLabel("<\"label\" & 'value'>"));
+  channelFormat->add(blockFormat);
+  document->add(channelFormat);
+
+  std::stringstream xml;
+  writeXml(xml, document);
+
+  CHECK(xml.str().find("audioObjectName=\"&lt;a&gt; &amp; 'b'\"") !=
+        std::string::npos);
+  CHECK(xml.str().find("audioObjectName='\"c\" &amp; &apos;d&apos;'") !=
+        std::string::npos);
+  CHECK(xml.str().find(
+            "<speakerLabel>&lt;&quot;label&quot; &amp; &apos;value&apos;&gt;"
+            "</speakerLabel>") != std::string::npos);
+  CHECK(xml.str() == reprintWithRapidXml(xml.str()));
+}
+
+TEST_CASE("write_large_document") {
+  using namespace adm;
+  auto document = createObjectDocument(5000);
+
+  std::stringstream xml;
+  writeXml(xml, document);
+  CHECK(xml.str() == reprintWithRapidXml(xml.str()));
+
+  BENCHMARK("write 5000 audioBlockFormats") {
+    std::ostringstream out;
+    writeXml(out, document);
+    return out.tellp();
+  };
+
+  BENCHMARK("write 5000 audioBlockFormats to string via ostringstream") {
+    std::ostringstream out;
+    writeXml(out, document);
+    return out.str().size();
+  };
+
+  BENCHMARK("write 5000 audioBlockFormats to string") {
+    return writeXmlToString(document).size();
+  };
+
+  BENCHMARK("write 5000 audioBlockFormats to vector") {
+    std::vector<char> buffer;
+    writeXml(buffer, document);
+    return buffer.size();
+  };
+
+  BENCHMARK("get size of 5000 audioBlockFormats") {
+    return getXmlSize(document);
+  };
+
+  CHECK(writeXmlToString(document, xml::WriterOptions::parallel) ==
+        xml.str());
+
+  BENCHMARK("write 5000 audioBlockFormats in parallel") {
+    return writeXmlToString(document, xml::WriterOptions::parallel).size();
+  };
+}
+
+TEST_CASE("write_parallel") {
+  using namespace adm;
+  auto parallel = xml::WriterOptions::parallel;
+  for (auto options :
+       {xml::WriterOptions::none, xml::WriterOptions::itu_structure,
+        xml::WriterOptions::write_default_values}) {
+    auto document = createSimpleScene();
+    CHECK(writeXmlToString(document, options | parallel) ==
+          writeXmlToString(document, options));
+
+    auto empty = Document::create();
+    CHECK(writeXmlToString(empty, options | parallel) ==
+          writeXmlToString(empty, options));
+  }
+
+  // enough audioBlockFormats to split the audioChannelFormats into chunks
+  // and to write them on multiple threads
+  auto document = Document::create();
+  for (unsigned int i = 0; i < 8; ++i) {
+    auto result = createSimpleObject("Object " + std::to_string(i));
+    addBlockFormats(*result.audioChannelFormat, 600);
+    document->add(result.audioObject);
+  }
+  reassignIds(document);
+  auto expected = writeXmlToString(document);
+  CHECK(writeXmlToString(document, parallel) == expected);
+
+  // independent of the number of hardware threads
+  for (unsigned threadCount : {1u, 2u, 4u, 8u, 100u}) {
+    xml::XmlWriter writer(parallel);
+    writer.setThreadCount(threadCount);
+    std::string xml;
+    writer.write(document, xml);
+    CHECK(xml == expected);
+  }
+}
+
+TEST_CASE("write_to_buffer") {
+  using namespace adm;
+  auto document = createSimpleScene();
+  auto options = xml::WriterOptions::itu_structure;
+
+  std::stringstream xml;
+  writeXml(xml, document, options);
+  auto expected = xml.str();
+
+  REQUIRE(getXmlSize(document, options) == expected.size());
+  CHECK(getXmlSize(document) != expected.size());
+  CHECK(writeXmlToString(document, options) == expected);
+
+  std::vector<char> buffer{'a', 'x', 'm', 'l'};
+  writeXml(buffer, document, options);
+  REQUIRE(buffer.size() == expected.size() + 4);
+  CHECK(std::string(buffer.begin(), buffer.begin() + 4) == "axml");
+  CHECK(std::string(buffer.begin() + 4, buffer.end()) == expected);
+}
+
+TEST_CASE("reusable_writer") {
+  using namespace adm;
+  auto options = xml::WriterOptions::itu_structure;
+  xml::Writer writer(options);
+  for (int i = 0; i < 3; ++i) {
+    auto document = createSimpleScene();
+    auto expected = writeXmlToString(document, options);
+
+    std::stringstream xml;
+    writer.write(xml, document);
+    CHECK(xml.str() == expected);
+
+    std::vector<char> buffer;
+    writer.write(buffer, document);
+    CHECK(std::string(buffer.begin(), buffer.end()) == expected);
+  }
+}
+
+TEST_CASE("write_cached") {
+  using namespace adm;
+  auto document = Document::create();
+  auto programme = AudioProgramme::create(AudioProgrammeName("Main"));
+  auto content = AudioContent::create(AudioContentName("Main"));
+  programme->addReference(content);
+  auto first = createSimpleObject("First");
+  auto second = createSimpleObject("Second");
+  content->addReference(first.audioObject);
+  content->addReference(second.audioObject);
+  first.audioChannelFormat->add(
+      AudioBlockFormatObjects(SphericalPosition(Azimuth(30))));
+  second.audioChannelFormat->add(
+      AudioBlockFormatObjects(SphericalPosition(Azimuth(-30))));
+  document->add(programme);
+  reassignIds(document);
+
+  auto checkCached = [&document](xml::WriterCache& cache,
+                                 xml::WriterOptions options) {
+    std::stringstream cached;
+    writeXml(cached, document, cache, options);
+    CHECK(cached.str() == writeXmlToString(document, options));
+  };
+
+  xml::WriterCache cache;
+  checkCached(cache, xml::WriterOptions::none);
+  // programme, content and two times object, pack, channel, stream, track
+  // and uid
+  CHECK(cache.size() == 14);
+  checkCached(cache, xml::WriterOptions::none);
+
+  SECTION("modify elements") {
+    first.audioObject->set(Importance(3));
+    checkCached(cache, xml::WriterOptions::none);
+    second.audioChannelFormat->add(
+        AudioBlockFormatObjects(SphericalPosition(Azimuth(0))));
+    checkCached(cache, xml::WriterOptions::none);
+  }
+  SECTION("modify through a held range") {
+    // the revision only changes when the range is returned
+    auto blockFormats =
+        second.audioChannelFormat->getElements<AudioBlockFormatObjects>();
+    checkCached(cache, xml::WriterOptions::none);
+    blockFormats[0].set(SphericalPosition(Azimuth(10)));
+    checkCached(cache, xml::WriterOptions::none);
+  }
+  SECTION("change ids") {
+    second.audioTrackUid->set(AudioTrackUidId(AudioTrackUidIdValue(0x100)));
+    checkCached(cache, xml::WriterOptions::none);
+    reassignIds(document);
+    checkCached(cache, xml::WriterOptions::none);
+  }
+  SECTION("remove elements") {
+    document->remove(second.audioObject);
+    checkCached(cache, xml::WriterOptions::none);
+    CHECK(cache.size() == 13);
+  }
+  SECTION("change options") {
+    checkCached(cache, xml::WriterOptions::itu_structure);
+    checkCached(cache, xml::WriterOptions::write_default_values);
+  }
+}
+
 std::shared_ptr<const adm::Document> createSimpleScene() {
   using namespace adm;
   auto document = Document::create();